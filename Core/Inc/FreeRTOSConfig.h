@@ -48,9 +48,25 @@
 #endif
 #define configENABLE_FPU                         0
 #define configENABLE_MPU                         0
+/* configENABLE_FPU is only used by the ARMv8-M ports.  The ARM_CM4F port always
+enables the FPU, with 1 here only the tasks that call
+portTASK_USES_FLOATING_POINT() may use it and have a floating point context to
+save on a context switch. */
+#define configUSE_TASK_FPU_SUPPORT               1
+
+/* configENABLE_MPU is only used by the ARMv8-M ports as well.  The Debug_MPU
+build configuration compiles the ARM_CM4_MPU port instead of ARM_CM4F: the
+kernel code and data, the heap included, are privileged.  The tasks created
+with portPRIVILEGE_BIT run privileged, the others are created restricted to
+their static stack and a few regions (see mpu_guard.c).  The settings below are
+only used by that port.  Unprivileged tasks may only enter the kernel through
+the MPU_ wrappers, and may use critical sections, which the standard demo tasks
+do. */
+#define configENFORCE_SYSTEM_CALLS_FROM_KERNEL_ONLY  1
+#define configALLOW_UNPRIVILEGED_CRITICAL_SECTIONS   1
 
 #define configUSE_PREEMPTION                     1
-//#define configSUPPORT_STATIC_ALLOCATION          1
+#define configSUPPORT_STATIC_ALLOCATION          1
 //#define configSUPPORT_DYNAMIC_ALLOCATION         1
 #define configUSE_IDLE_HOOK                      0
 #define configUSE_TICK_HOOK                      1
@@ -58,7 +74,10 @@
 #define configTICK_RATE_HZ                       ((TickType_t)1000)
 #define configMAX_PRIORITIES                     ( 7 )
 #define configMINIMAL_STACK_SIZE                 ((uint16_t)128)
-#define configTOTAL_HEAP_SIZE                    ((size_t)16000)
+/* malloc() takes its memory from this heap too (see newlib_heap.c), the
+newlib heap after .bss is gone.  The stacks of the restricted tasks are static
+(mpu_guard.h), not on the heap. */
+#define configTOTAL_HEAP_SIZE                    ((size_t)22528)
 #define configMAX_TASK_NAME_LEN                  ( 16 )
 #define configUSE_TRACE_FACILITY		         1
 #define configUSE_16_BIT_TICKS                   0
@@ -78,6 +97,12 @@
 #define configMESSAGE_BUFFER_LENGTH_TYPE         size_t
 
 
+/* Periodic tasks registered with xTaskEdfRegister() run at configEDF_PRIORITY
+and are scheduled earliest deadline first, the other priorities keep the fixed
+priority scheduling.  No other task may use configEDF_PRIORITY. */
+#define configUSE_EDF_SCHEDULING                 1
+#define configEDF_PRIORITY                       ( configMAX_PRIORITIES - 2 )
+
 /* Co-routine definitions. */
 #define configUSE_CO_ROUTINES                    0
 #define configMAX_CO_ROUTINE_PRIORITIES          ( 2 )
@@ -88,6 +113,12 @@
 #define configTIMER_QUEUE_LENGTH		         5
 #define configTIMER_TASK_STACK_DEPTH	         ( 80 )
 
+/* Keep the active software timers in a hierarchical timing wheel, so starting,
+stopping and resetting a timer does not depend on the number of active timers.
+Set to 0 to use the sorted timer lists of the stock kernel. */
+#define configUSE_TIMER_WHEEL                    1
+#define configTIMER_WHEEL_LEVELS                 4
+
 /* Set the following definitions to 1 to include the API function, or zero
 to exclude the API function. */
 #define INCLUDE_vTaskPrioritySet                 1
@@ -98,6 +129,9 @@ to exclude the API function. */
 #define INCLUDE_vTaskDelayUntil                  1
 #define INCLUDE_vTaskDelay                       1
 #define INCLUDE_xTaskGetSchedulerState           1
+#define INCLUDE_xTaskGetHandle                   1
+#define INCLUDE_xTimerPendFunctionCall           1
+#define INCLUDE_xTaskGetIdleTaskHandle           1
 
 /* Cortex-M specific definitions. */
 #ifdef __NVIC_PRIO_BITS
@@ -124,29 +158,29 @@ to all Cortex-M ports, and do not rely on any particular library functions. */
 See http://www.FreeRTOS.org/RTOS-Cortex-M3-M4.html. */
 #define configMAX_SYSCALL_INTERRUPT_PRIORITY 	( configLIBRARY_MAX_SYSCALL_INTERRUPT_PRIORITY << (8 - configPRIO_BITS) )
 
-/* Normal assert() semantics without relying on the provision of an assert.h
-header file. */
-#define configASSERT( x ) if ((x) == 0) {taskDISABLE_INTERRUPTS(); for( ;; );}
+/* A failed assertion traps into the fault handler, which writes the crash
+record with the file and the line and resets (see crash_dump.c). */
+void crash_dump_assert( const char *file, uint32_t line ) __attribute__((noreturn));
+#define configASSERT( x ) if ((x) == 0) { crash_dump_assert( __FILE__, __LINE__ ); }
 
 /* Definitions that map the FreeRTOS port interrupt handlers to their CMSIS
 standard names. */
 #define vPortSVCHandler    SVC_Handler
 #define xPortPendSVHandler PendSV_Handler
 
-/* IMPORTANT: This define is commented when used with STM32Cube firmware, when the timebase source is SysTick,
-              to prevent overwriting SysTick_Handler defined within STM32Cube HAL */
-
-#define xPortSysTickHandler SysTick_Handler
+/* The RTOS tick is generated by the TIM2 based timebase (see timebase.c), which
+also provides the HAL tick, so xPortSysTickHandler is not mapped to
+SysTick_Handler and SysTick is left disabled. */
 
 /* Section where parameter definitions can be added (for instance, to override default ones in FreeRTOS.h) */
 #define configCOMMAND_INT_MAX_OUTPUT_SIZE 2048
 
-/* Run time stats related definitions. */
-void vConfigureTimerForRunTimeStats( void );
-extern volatile uint32_t runtime_stats_timer;
+/* Run time stats related definitions.  The counter is derived from the TIM2
+timebase, which is already running when the scheduler starts. */
+uint32_t timebase_get_runtime_counter( void );
 #define configGENERATE_RUN_TIME_STATS	         1
-#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS() vConfigureTimerForRunTimeStats()
-#define portGET_RUN_TIME_COUNTER_VALUE()         runtime_stats_timer
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()
+#define portGET_RUN_TIME_COUNTER_VALUE()         timebase_get_runtime_counter()
 
 /* This demo makes use of one or more example stats formatting functions.  These
 format the raw data provided by the uxTaskGetSystemState() function in to human
@@ -154,5 +188,35 @@ readable ASCII form.  See the notes in the implementation of vTaskList() within
 FreeRTOS/Source/tasks.c for limitations. */
 #define configUSE_STATS_FORMATTING_FUNCTIONS	 1
 
+/* Per task CPU budgets (see task_budget.c).  The budget of a task is kept in a
+thread local storage pointer, so the context switch hooks find it without a
+search, and the time a task runs is measured with the DWT cycle counter. */
+void task_budget_switched_in( void );
+void task_budget_switched_out( void *budget );
+void task_budget_task_deleted( void *budget );
+#define configNUM_THREAD_LOCAL_STORAGE_POINTERS  3
+#define configTASK_BUDGET_TLS_INDEX              0
+#define traceTASK_SWITCHED_IN()                  task_budget_switched_in()
+#define traceTASK_SWITCHED_OUT()                 task_budget_switched_out( pxCurrentTCB->pvThreadLocalStoragePointers[ configTASK_BUDGET_TLS_INDEX ] )
+
+/* Every task has its own newlib reentrancy structure (errno, stdio streams),
+and its own line buffer for the stdout and stderr output (see stdio_uart.c),
+kept in a thread local storage pointer and returned when the task is
+deleted. */
+void stdio_uart_task_deleted( void *line );
+#define configUSE_NEWLIB_REENTRANT               1
+#define configSTDIO_UART_TLS_INDEX               1
+
+/* The heartbeat record of a task supervised by the watchdog (see
+watchdog.c). */
+void watchdog_task_deleted( void *client );
+#define configWATCHDOG_TLS_INDEX                 2
+
+#define traceTASK_DELETE( pxTCB )                do { \
+	task_budget_task_deleted( ( pxTCB )->pvThreadLocalStoragePointers[ configTASK_BUDGET_TLS_INDEX ] ); \
+	stdio_uart_task_deleted( ( pxTCB )->pvThreadLocalStoragePointers[ configSTDIO_UART_TLS_INDEX ] ); \
+	watchdog_task_deleted( ( pxTCB )->pvThreadLocalStoragePointers[ configWATCHDOG_TLS_INDEX ] ); \
+} while( 0 )
+
 
 #endif /* FREERTOS_CONFIG_H */
@@ -0,0 +1,39 @@
+/**
+  ******************************************************************************
+  * @file    art_bench.h
+  * @brief   This file contains all the function prototypes for
+  *          the art_bench.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __ART_BENCH_H__
+#define __ART_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Operations per measurement, the fastest of ART_BENCH_RUNS is kept. */
+#ifndef ART_BENCH_ITERATIONS
+	#define ART_BENCH_ITERATIONS        100U
+#endif
+
+#ifndef ART_BENCH_RUNS
+	#define ART_BENCH_RUNS              5U
+#endif
+
+#ifndef ART_BENCH_TASK_STACK_SIZE
+	#define ART_BENCH_TASK_STACK_SIZE   configMINIMAL_STACK_SIZE
+#endif
+
+void art_bench_run(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ART_BENCH_H__ */
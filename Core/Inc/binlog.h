@@ -0,0 +1,126 @@
+/**
+  ******************************************************************************
+  * @file    binlog.h
+  * @brief   This file contains the logging macros and all the function
+  *          prototypes for the binlog.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __BINLOG_H__
+#define __BINLOG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Number of messages the ring buffer can hold, a power of two. */
+#ifndef BINLOG_SLOTS
+	#define BINLOG_SLOTS                    128U
+#endif
+
+/* The ring buffer is drained this often. */
+#ifndef BINLOG_DRAIN_PERIOD_MS
+	#define BINLOG_DRAIN_PERIOD_MS          10U
+#endif
+
+/* Size of each of the two transmit buffers of the drain task. */
+#ifndef BINLOG_TX_BUFFER_SIZE
+	#define BINLOG_TX_BUFFER_SIZE           256U
+#endif
+
+/* Baud rate of the log output, USART6 TX on PC6. */
+#ifndef BINLOG_BAUD_RATE
+	#define BINLOG_BAUD_RATE                921600UL
+#endif
+
+#ifndef BINLOG_TASK_PRIORITY
+	#define BINLOG_TASK_PRIORITY            ( tskIDLE_PRIORITY + 1 )
+#endif
+
+#ifndef BINLOG_TASK_STACK_SIZE
+	#define BINLOG_TASK_STACK_SIZE          configMINIMAL_STACK_SIZE
+#endif
+
+/* Most arguments of a message. */
+#define BINLOG_MAX_ARGS                 4U
+
+/* A message in the ring buffer: header, timestamp and the arguments. */
+#define BINLOG_MESSAGE_WORDS            ( 2U + BINLOG_MAX_ARGS )
+
+/* Logs a message with up to BINLOG_MAX_ARGS arguments from a task or an
+interrupt of any priority, for example
+
+	BINLOG("OPP %u -> %u", from, to);
+
+The format string is not stored in the program, it is placed into the
+.binlog_formats section of the ELF file, which is not loaded to the target,
+and only its offset in the section and the raw 32 bit arguments are put into
+the ring buffer.  Tools/binlog_decode.py formats the messages on the host.
+The arguments are integers or pointers, %s takes a pointer to a string in
+flash. */
+#define BINLOG(...)                     BINLOG_CAT_(BINLOG_, BINLOG_NARGS_(__VA_ARGS__))(__VA_ARGS__)
+
+#define BINLOG_CAT_(a, b)               BINLOG_CAT2_(a, b)
+#define BINLOG_CAT2_(a, b)              a ## b
+#define BINLOG_NARGS_(...)              BINLOG_NARGS_N_(__VA_ARGS__, 4, 3, 2, 1, 0, _)
+#define BINLOG_NARGS_N_(fmt, a1, a2, a3, a4, n, ...) n
+
+#define BINLOG_FORMAT_(fmt) \
+	static const char binlog_format_[] __attribute__((section(".binlog_formats"), used)) = fmt
+
+/* Offset of the format string in bits 8 to 31, number of arguments in bits 4
+to 6. */
+#define BINLOG_HEADER_(count)           ( ((uint32_t)binlog_format_ << 8) | ((count) << 4) )
+
+#define BINLOG_0(fmt) do { \
+	BINLOG_FORMAT_(fmt); \
+	binlog_write(BINLOG_HEADER_(0U), NULL); \
+} while (0)
+
+#define BINLOG_1(fmt, a1) do { \
+	BINLOG_FORMAT_(fmt); \
+	const uint32_t binlog_args_[] = { (uint32_t)(a1) }; \
+	binlog_write(BINLOG_HEADER_(1U), binlog_args_); \
+} while (0)
+
+#define BINLOG_2(fmt, a1, a2) do { \
+	BINLOG_FORMAT_(fmt); \
+	const uint32_t binlog_args_[] = { (uint32_t)(a1), (uint32_t)(a2) }; \
+	binlog_write(BINLOG_HEADER_(2U), binlog_args_); \
+} while (0)
+
+#define BINLOG_3(fmt, a1, a2, a3) do { \
+	BINLOG_FORMAT_(fmt); \
+	const uint32_t binlog_args_[] = { (uint32_t)(a1), (uint32_t)(a2), (uint32_t)(a3) }; \
+	binlog_write(BINLOG_HEADER_(3U), binlog_args_); \
+} while (0)
+
+#define BINLOG_4(fmt, a1, a2, a3, a4) do { \
+	BINLOG_FORMAT_(fmt); \
+	const uint32_t binlog_args_[] = { (uint32_t)(a1), (uint32_t)(a2), (uint32_t)(a3), (uint32_t)(a4) }; \
+	binlog_write(BINLOG_HEADER_(4U), binlog_args_); \
+} while (0)
+
+void binlog_init(void);
+void binlog_write(uint32_t header, const uint32_t *args);
+void binlog_print(char *buffer, size_t length);
+uint32_t binlog_copy_tail(uint32_t (*messages)[ BINLOG_MESSAGE_WORDS ], uint32_t count);
+
+/* Called around a change of the system clock, see cli_io.h. */
+void binlog_clock_change_begin(void);
+void binlog_clock_change_end(void);
+
+void binlog_uart_irq_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BINLOG_H__ */
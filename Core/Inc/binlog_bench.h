@@ -0,0 +1,32 @@
+/**
+  ******************************************************************************
+  * @file    binlog_bench.h
+  * @brief   This file contains all the function prototypes for
+  *          the binlog_bench.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __BINLOG_BENCH_H__
+#define __BINLOG_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Measurements of every kind of call, the fastest is kept.  Every BINLOG()
+call puts a message into the ring buffer. */
+#ifndef BINLOG_BENCH_RUNS
+	#define BINLOG_BENCH_RUNS           16U
+#endif
+
+void binlog_bench_run(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BINLOG_BENCH_H__ */
@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file    boot_profile.h
+  * @brief   This file contains all the function prototypes for
+  *          the boot_profile.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __BOOT_PROFILE_H__
+#define __BOOT_PROFILE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* Number of phases that can be recorded. */
+#ifndef BOOT_PROFILE_MAX_PHASES
+	#define BOOT_PROFILE_MAX_PHASES     16U
+#endif
+
+/* Ends the phase that started at the previous mark, at the reset for the
+first one.  The marks follow each other, on the path from the reset to the
+console prompt. */
+void boot_profile_mark(const char *name);
+
+/* A phase that runs in parallel with the others, in a task of its own. */
+uint32_t boot_profile_begin(void);
+void boot_profile_end(const char *name, uint32_t start);
+
+void boot_profile_print(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __BOOT_PROFILE_H__ */
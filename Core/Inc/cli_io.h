@@ -41,6 +41,46 @@ typedef BaseType_t ( *cli_callback_t )( const char * const cli_input, char * cli
  */
 void cli_io_task_start( uint16_t usStackSize, unsigned portBASE_TYPE uxPriority, char *cli_output_buffer, cli_callback_t cli_callback );
 
+/*
+ * USART interrupt handler of the console, puts the received characters into
+ * the ring buffer read by the console task.
+ */
+void cli_io_uart_irq_handler( void );
+
+/*
+ * DMA interrupt handler of the console output.
+ */
+void cli_io_dma_irq_handler( void );
+
+/*
+ * Sends a block of text to the console UART and waits until it is out.  May
+ * be called from any privileged task, and before the scheduler is started,
+ * but not from an interrupt or with the scheduler suspended.  The block is not
+ * mixed with the output of the console or of another task.
+ */
+void cli_io_print( const char *pcBuffer, size_t xBufferLength );
+
+/*
+ * Receives a block of the output of cli_io_execute().
+ */
+typedef void ( *cli_output_t )( const char *pcBuffer, size_t xBufferLength, void *pvArg );
+
+/*
+ * Runs a command line as if it was entered on the console, passing each block
+ * of its output to xOutput.  The commands are not reentrant, a command of the
+ * console or of another caller is completed first.  Returns pdFAIL if the
+ * interpreter was not free within xWait.
+ */
+BaseType_t cli_io_execute( const char *pcCommand, char *pcOutput, size_t xOutputSize, cli_output_t xOutput, void *pvArg, TickType_t xWait );
+
+/*
+ * Called around a change of the system clock.  The first one holds back the
+ * console output until the UART is idle, the second one sets the baud rate
+ * divider for the new APB1 clock and resumes the output.
+ */
+void cli_io_clock_change_begin( void );
+void cli_io_clock_change_end( void );
+
 #endif /* CLI_IO_H */
 
 
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file    config_flash.h
+  * @brief   This file contains all the function prototypes for
+  *          the config_flash.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __CONFIG_FLASH_H__
+#define __CONFIG_FLASH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* The configuration store uses two equally sized sectors in turn. */
+#define CONFIG_FLASH_SECTORS            2U
+
+/* Flash operations of the configuration store.  The sectors are read through
+their memory mapped address, erased sectors read as 0xFF and programming can
+only clear bits.  Another implementation, for example one backed by a file on
+a host, can be passed to config_store_init(). */
+typedef struct {
+	uint32_t        sector_size;
+	const uint8_t  *( *address )( uint32_t sector );
+	bool            ( *erase )( uint32_t sector );
+	bool            ( *program )( uint32_t sector, uint32_t offset, const uint32_t *words, uint32_t count );
+} config_flash_t;
+
+/* Sectors 10 and 11 of the internal flash, the CONFIG region of the linker
+script. */
+extern const config_flash_t config_flash_internal;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CONFIG_FLASH_H__ */
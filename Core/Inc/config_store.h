@@ -0,0 +1,61 @@
+/**
+  ******************************************************************************
+  * @file    config_store.h
+  * @brief   This file contains all the function prototypes for
+  *          the config_store.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __CONFIG_STORE_H__
+#define __CONFIG_STORE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "config_flash.h"
+
+/* Longest key, keys are printable characters without spaces. */
+#ifndef CONFIG_STORE_KEY_MAX
+	#define CONFIG_STORE_KEY_MAX            16U
+#endif
+
+/* Longest value, values are printable characters. */
+#ifndef CONFIG_STORE_VALUE_MAX
+	#define CONFIG_STORE_VALUE_MAX          48U
+#endif
+
+/* Number of keys the RAM index can hold. */
+#ifndef CONFIG_STORE_MAX_KEYS
+	#define CONFIG_STORE_MAX_KEYS           24U
+#endif
+
+/* Number of slots of the RAM index, a power of two at least twice
+CONFIG_STORE_MAX_KEYS. */
+#ifndef CONFIG_STORE_INDEX_SIZE
+	#define CONFIG_STORE_INDEX_SIZE         64U
+#endif
+
+/* Used part of the active sector, in percent, above which the records are
+compacted in the background. */
+#ifndef CONFIG_STORE_COMPACT_THRESHOLD
+	#define CONFIG_STORE_COMPACT_THRESHOLD  75U
+#endif
+
+void config_store_init(const config_flash_t *flash);
+bool config_store_get(const char *key, char *value, size_t length);
+bool config_store_get_u32(const char *key, uint32_t *value);
+bool config_store_set(const char *key, const char *value);
+bool config_store_delete(const char *key);
+void config_store_print(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CONFIG_STORE_H__ */
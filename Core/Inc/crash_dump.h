@@ -0,0 +1,90 @@
+/**
+  ******************************************************************************
+  * @file    crash_dump.h
+  * @brief   This file contains the crash record and all the function
+  *          prototypes for the crash_dump.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __CRASH_DUMP_H__
+#define __CRASH_DUMP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "binlog.h"
+
+/* Words copied from the stack of the crashed code. */
+#ifndef CRASH_DUMP_STACK_WORDS
+	#define CRASH_DUMP_STACK_WORDS          64U
+#endif
+
+/* Last messages of the deferred logger kept in the record. */
+#ifndef CRASH_DUMP_LOG_MESSAGES
+	#define CRASH_DUMP_LOG_MESSAGES         16U
+#endif
+
+#define CRASH_DUMP_TASK_NAME_LEN        16U
+
+/* Why the record was written, Tools/crash_decode.py knows these too. */
+typedef enum {
+	CRASH_DUMP_HARD_FAULT = 1,
+	CRASH_DUMP_MEM_MANAGE,
+	CRASH_DUMP_BUS_FAULT,
+	CRASH_DUMP_USAGE_FAULT,
+	CRASH_DUMP_ASSERT,
+	CRASH_DUMP_STACK_OVERFLOW
+} crash_dump_reason_t;
+
+/* Kept in RAM that is not initialized at startup, only words, the host
+decoder reads it as a sequence of them. */
+typedef struct {
+	uint32_t magic;
+	uint32_t layout;                /* Stack words << 16 | log messages << 8 | message words. */
+	uint32_t reason;
+	uint32_t count;                 /* Crashes since the record was cleared. */
+	uint32_t uptime_ms;
+	uint32_t frame[ 8 ];            /* R0-R3, R12, LR, PC and xPSR. */
+	uint32_t callee[ 8 ];           /* R4-R11. */
+	uint32_t sp;                    /* Before the exception. */
+	uint32_t exc_return;
+	uint32_t cfsr;
+	uint32_t hfsr;
+	uint32_t mmfar;
+	uint32_t bfar;
+	uint32_t file;                  /* __FILE__ of a failed assertion. */
+	uint32_t line;
+	char     task[ CRASH_DUMP_TASK_NAME_LEN ];
+	uint32_t stack_words;
+	uint32_t stack[ CRASH_DUMP_STACK_WORDS ];
+	uint32_t log_messages;
+	uint32_t log[ CRASH_DUMP_LOG_MESSAGES ][ BINLOG_MESSAGE_WORDS ];
+	uint32_t crc;                   /* CRC-32/MPEG-2 of the words before. */
+} crash_dump_t;
+
+void crash_dump_init(void);
+void crash_dump_clear(void);
+void crash_dump_print(char *buffer, size_t length);
+bool crash_dump_print_raw(char *buffer, size_t length, uint32_t *offset);
+void crash_dump_task_name(char *name, size_t length);
+
+/* Called by the fault handlers with the exception frame, EXC_RETURN and the
+saved R4-R11, writes the record and resets. */
+void crash_dump_fault(uint32_t *frame, uint32_t exc_return, const uint32_t *callee, uint32_t reason) __attribute__((noreturn));
+
+/* configASSERT() and vApplicationStackOverflowHook(), they trap into the
+fault handlers, which take the arguments from the exception frame. */
+void crash_dump_assert(const char *file, uint32_t line) __attribute__((noreturn));
+void crash_dump_stack_overflow(const char *task) __attribute__((noreturn));
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRASH_DUMP_H__ */
@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file    cron.h
+  * @brief   This file contains all the function prototypes for
+  *          the cron.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __CRON_H__
+#define __CRON_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Number of schedules. */
+#ifndef CRON_MAX_JOBS
+	#define CRON_MAX_JOBS               16U
+#endif
+
+/* Longest command line of a schedule, with the terminator, as long as the
+console input. */
+#ifndef CRON_COMMAND_SIZE
+	#define CRON_COMMAND_SIZE           50U
+#endif
+
+/* Output kept by the log sink, the oldest is overwritten. */
+#ifndef CRON_LOG_SIZE
+	#define CRON_LOG_SIZE               1024U
+#endif
+
+/* Shortest interval of a schedule. */
+#ifndef CRON_MIN_INTERVAL_MS
+	#define CRON_MIN_INTERVAL_MS        100UL
+#endif
+
+/* Longest wait of the worker, for the watchdog and to follow a step of the
+clock with the daily schedules. */
+#ifndef CRON_HEARTBEAT_MS
+	#define CRON_HEARTBEAT_MS           1000UL
+#endif
+
+/* A run is skipped if a console command does not complete within this. */
+#ifndef CRON_COMMAND_WAIT_MS
+	#define CRON_COMMAND_WAIT_MS        5000UL
+#endif
+
+/* The commands may take a while, as on the console. */
+#ifndef CRON_WATCHDOG_PERIOD_MS
+	#define CRON_WATCHDOG_PERIOD_MS     10000UL
+#endif
+
+/* The worker runs at the priority of the console, the two take turns. */
+#ifndef CRON_TASK_PRIORITY
+	#define CRON_TASK_PRIORITY          tskIDLE_PRIORITY
+#endif
+
+/* The commands run on this stack, as large as the console's. */
+#ifndef CRON_TASK_STACK_SIZE
+	#define CRON_TASK_STACK_SIZE        ( configMINIMAL_STACK_SIZE * 3 )
+#endif
+
+typedef enum {
+	CRON_SINK_CONSOLE = 0,      /* Printed on the console. */
+	CRON_SINK_LOG,              /* Kept for cron_log_read(). */
+	CRON_SINK_NONE              /* Discarded. */
+} cron_sink_t;
+
+void cron_init(void);
+
+/* Return the ID of the schedule, 0 if there is no free one or an argument
+is out of range. */
+uint32_t cron_add_interval(const char *command, uint32_t interval_ms, cron_sink_t sink);
+uint32_t cron_add_daily(const char *command, uint32_t time_of_day_s, cron_sink_t sink);
+bool cron_remove(uint32_t id);
+
+bool cron_sink_parse(const char *name, size_t length, cron_sink_t *sink);
+bool cron_log_read(char *buffer, size_t length);
+void cron_print(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CRON_H__ */
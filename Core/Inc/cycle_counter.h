@@ -0,0 +1,52 @@
+/**
+  ******************************************************************************
+  * @file    cycle_counter.h
+  * @brief   Access to the DWT CPU cycle counter, used to time short code
+  *          sequences with single cycle resolution.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __CYCLE_COUNTER_H__
+#define __CYCLE_COUNTER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "stm32f4xx.h"
+
+/**
+  * @brief  Enables the DWT cycle counter if it is not running yet.
+  * @note   The counter keeps running once enabled, calling this function
+  *         again does not reset it.
+  * @param  None
+  * @retval None
+  */
+static inline void cycle_counter_init(void)
+{
+	if ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) == 0) {
+		CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+		DWT->CYCCNT = 0;
+		DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+	}
+}
+
+/**
+  * @brief  Returns the CPU cycle counter.
+  * @note   Wraps around every 2^32 cycles (~25.6 s at 168 MHz), differences
+  *         of two readings are valid as long as they are computed in uint32_t.
+  * @retval Current value of DWT->CYCCNT
+  */
+static inline uint32_t cycle_counter_get(void)
+{
+	return DWT->CYCCNT;
+}
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __CYCLE_COUNTER_H__ */
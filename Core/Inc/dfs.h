@@ -0,0 +1,70 @@
+/**
+  ******************************************************************************
+  * @file    dfs.h
+  * @brief   This file contains all the function prototypes for
+  *          the dfs.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __DFS_H__
+#define __DFS_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* The CPU load is measured over this interval. */
+#ifndef DFS_GOVERNOR_PERIOD_MS
+	#define DFS_GOVERNOR_PERIOD_MS      100U
+#endif
+
+/* Above this load [%] the governor switches to the fastest operating
+point. */
+#ifndef DFS_UP_THRESHOLD
+	#define DFS_UP_THRESHOLD            80U
+#endif
+
+/* Below this load [%], measured DFS_DOWN_PERIODS times in a row, the
+governor steps one operating point down. */
+#ifndef DFS_DOWN_THRESHOLD
+	#define DFS_DOWN_THRESHOLD          30U
+#endif
+
+#ifndef DFS_DOWN_PERIODS
+	#define DFS_DOWN_PERIODS            5U
+#endif
+
+/* The governor must run when the load is high, so it has to preempt the
+tasks that cause it. */
+#ifndef DFS_TASK_PRIORITY
+	#define DFS_TASK_PRIORITY           ( configMAX_PRIORITIES - 1 )
+#endif
+
+#ifndef DFS_TASK_STACK_SIZE
+	#define DFS_TASK_STACK_SIZE         configMINIMAL_STACK_SIZE
+#endif
+
+typedef enum {
+	/* The governor follows the load. */
+	DFS_MODE_AUTO = 0,
+	/* The operating point set from the CLI is kept. */
+	DFS_MODE_FIXED
+} dfs_mode_t;
+
+void dfs_init(void);
+bool dfs_set_mode(dfs_mode_t mode, uint32_t opp);
+void dfs_print(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DFS_H__ */
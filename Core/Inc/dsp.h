@@ -0,0 +1,78 @@
+/**
+  ******************************************************************************
+  * @file    dsp.h
+  * @brief   This file contains all the function prototypes for
+  *          the dsp.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __DSP_H__
+#define __DSP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Largest FFT, the twiddle table is built for this size and shared by the
+smaller ones.  Must be a power of two. */
+#ifndef DSP_FFT_MAX_SIZE
+	#define DSP_FFT_MAX_SIZE            256U
+#endif
+
+/* Number of Q15 coefficients of one biquad stage: b0, 0, b1, b2, a1, a2.  The
+zero keeps the coefficient pairs word aligned for the dual multiply
+instructions. */
+#define DSP_BIQUAD_COEFFS               6U
+
+/* Number of Q15 state values of one biquad stage: x[n-1], x[n-2], y[n-1],
+y[n-2]. */
+#define DSP_BIQUAD_STATE                4U
+
+/* Every kernel has a plain C implementation and one that uses the Cortex-M4
+SIMD instructions, both give bit exact results.  The plain C one is kept as
+the reference for dsp-bench. */
+
+/* FIR filter with optional decimation. */
+typedef struct {
+	const int16_t *coeffs;      /* Q15, in reversed order, even count. */
+	int16_t       *state;       /* taps - 1 + largest block samples. */
+	uint32_t       taps;
+	uint32_t       decimation;  /* Every decimation-th output is computed. */
+} dsp_fir_t;
+
+/* Cascade of Direct Form I biquads, coefficients in Q14 (Q15 scaled by
+one half) so they can reach +-2, a1 and a2 with negated sign. */
+typedef struct {
+	const int16_t *coeffs;      /* DSP_BIQUAD_COEFFS per stage. */
+	int16_t       *state;       /* DSP_BIQUAD_STATE per stage. */
+	uint32_t       stages;
+} dsp_biquad_t;
+
+void dsp_fir_init(dsp_fir_t *fir, const int16_t *coeffs, uint32_t taps, uint32_t decimation, int16_t *state);
+uint32_t dsp_fir(dsp_fir_t *fir, const int16_t *in, int16_t *out, uint32_t count);
+uint32_t dsp_fir_scalar(dsp_fir_t *fir, const int16_t *in, int16_t *out, uint32_t count);
+
+void dsp_biquad_init(dsp_biquad_t *biquad, const int16_t *coeffs, uint32_t stages, int16_t *state);
+void dsp_biquad(dsp_biquad_t *biquad, const int16_t *in, int16_t *out, uint32_t count);
+void dsp_biquad_scalar(dsp_biquad_t *biquad, const int16_t *in, int16_t *out, uint32_t count);
+
+void dsp_fft_init(void);
+void dsp_fft(int16_t *data, uint32_t size);
+void dsp_fft_scalar(int16_t *data, uint32_t size);
+uint32_t dsp_fft_peak_bin(const int16_t *data, uint32_t size, uint32_t *power);
+
+void dsp_stats(const int16_t *in, uint32_t count, uint16_t *rms, uint16_t *peak);
+void dsp_stats_scalar(const int16_t *in, uint32_t count, uint16_t *rms, uint16_t *peak);
+
+int16_t dsp_sine(uint32_t phase);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_H__ */
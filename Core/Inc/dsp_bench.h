@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file    dsp_bench.h
+  * @brief   This file contains all the function prototypes for
+  *          the dsp_bench.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __DSP_BENCH_H__
+#define __DSP_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Number of samples each kernel processes in one measurement. */
+#ifndef DSP_BENCH_SAMPLES
+	#define DSP_BENCH_SAMPLES           256U
+#endif
+
+/* Each kernel is measured this many times, the fastest run is reported. */
+#ifndef DSP_BENCH_RUNS
+	#define DSP_BENCH_RUNS              4U
+#endif
+
+void dsp_bench_run(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_BENCH_H__ */
@@ -0,0 +1,74 @@
+/**
+  ******************************************************************************
+  * @file    dsp_chain.h
+  * @brief   This file contains all the function prototypes for
+  *          the dsp_chain.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __DSP_CHAIN_H__
+#define __DSP_CHAIN_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+#define DSP_CHAIN_SAMPLE_RATE           8000U
+
+/* Samples per block, one block is produced every
+DSP_CHAIN_BLOCK_SIZE / DSP_CHAIN_SAMPLE_RATE seconds (16 ms). */
+#define DSP_CHAIN_BLOCK_SIZE            128U
+
+/* Number of blocks in the pool shared by the producer and the processing
+task. */
+#ifndef DSP_CHAIN_BLOCKS
+	#define DSP_CHAIN_BLOCKS            3U
+#endif
+
+#define DSP_CHAIN_FFT_SIZE              256U
+#define DSP_CHAIN_FIR_TAPS              32U
+#define DSP_CHAIN_IIR_STAGES            2U
+
+/* Decimation factors are powers of two up to this one. */
+#define DSP_CHAIN_MAX_DECIMATION        8U
+
+/* The producer must preempt the processing task to keep its sample rate. */
+#ifndef DSP_CHAIN_PRODUCER_PRIORITY
+	#define DSP_CHAIN_PRODUCER_PRIORITY     ( tskIDLE_PRIORITY + 3 )
+#endif
+
+#ifndef DSP_CHAIN_PROCESSOR_PRIORITY
+	#define DSP_CHAIN_PROCESSOR_PRIORITY    ( tskIDLE_PRIORITY + 2 )
+#endif
+
+#ifndef DSP_CHAIN_TASK_STACK_SIZE
+	#define DSP_CHAIN_TASK_STACK_SIZE       ( configMINIMAL_STACK_SIZE * 2 )
+#endif
+
+typedef enum {
+	DSP_CHAIN_FILTER_NONE = 0,
+	/* Windowed sinc low pass, the decimation is done by the filter. */
+	DSP_CHAIN_FILTER_FIR,
+	/* Fourth order Butterworth low pass made of two biquads. */
+	DSP_CHAIN_FILTER_IIR
+} dsp_chain_filter_t;
+
+void dsp_chain_init(void);
+bool dsp_chain_set_filter(dsp_chain_filter_t filter, uint32_t cutoff_hz);
+bool dsp_chain_set_decimation(uint32_t decimation);
+bool dsp_chain_set_tones(uint32_t tone1_hz, uint32_t tone2_hz);
+void dsp_chain_print(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __DSP_CHAIN_H__ */
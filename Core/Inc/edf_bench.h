@@ -0,0 +1,35 @@
+/**
+  ******************************************************************************
+  * @file    edf_bench.h
+  * @brief   This file contains all the function prototypes for
+  *          the edf_bench.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __EDF_BENCH_H__
+#define __EDF_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Time each scheduler runs the task set for. */
+#ifndef EDF_BENCH_RUN_MS
+	#define EDF_BENCH_RUN_MS            2000U
+#endif
+
+#ifndef EDF_BENCH_TASK_STACK_SIZE
+	#define EDF_BENCH_TASK_STACK_SIZE   configMINIMAL_STACK_SIZE
+#endif
+
+void edf_bench_run(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __EDF_BENCH_H__ */
@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file    hrtimer.h
+  * @brief   This file contains all the function prototypes for
+  *          the hrtimer.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __HRTIMER_H__
+#define __HRTIMER_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Width of one wheel slot is (1 << HRTIMER_SLOT_SHIFT) us. */
+#ifndef HRTIMER_SLOT_SHIFT
+	#define HRTIMER_SLOT_SHIFT          5U
+#endif
+
+/* Number of wheel slots, must be a multiple of 32.  With the defaults the
+wheel covers 256 * 32 us = 8.192 ms, timers further out wait on an overflow
+list that is cascaded into the wheel once per revolution. */
+#ifndef HRTIMER_WHEEL_SLOTS
+	#define HRTIMER_WHEEL_SLOTS         256U
+#endif
+
+/* The task that runs the callbacks of HRTIMER_CONTEXT_TASK timers. */
+#ifndef HRTIMER_TASK_PRIORITY
+	#define HRTIMER_TASK_PRIORITY       ( configMAX_PRIORITIES - 1 )
+#endif
+
+#ifndef HRTIMER_TASK_STACK_SIZE
+	#define HRTIMER_TASK_STACK_SIZE     ( configMINIMAL_STACK_SIZE * 2 )
+#endif
+
+/* Longest delay or period that can be requested. */
+#define HRTIMER_MAX_DELAY_US            0x7FFFFFFFUL
+
+typedef struct hrtimer hrtimer_t;
+
+typedef void ( *hrtimer_callback_t )( hrtimer_t *timer, void *arg );
+
+typedef enum {
+	/* The callback runs in the TIM2 interrupt (TICK_INT_PRIORITY), only
+	FromISR API functions may be used from it. */
+	HRTIMER_CONTEXT_ISR = 0,
+	/* The callback runs in the hrtimer task. */
+	HRTIMER_CONTEXT_TASK
+} hrtimer_context_t;
+
+/* Timer control block, allocated by the user.  The members are private to
+hrtimer.c. */
+struct hrtimer {
+	hrtimer_t          *next;
+	hrtimer_t         **pprev;
+	hrtimer_t          *pending_next;
+	hrtimer_t          *pending_prev;
+	uint32_t            expiry;
+	uint32_t            period;
+	uint32_t            overruns;
+	hrtimer_callback_t  callback;
+	void               *arg;
+	uint8_t             context;
+	uint8_t             state;
+	uint8_t             pending;
+};
+
+typedef struct {
+	uint32_t expired;         /* Number of expirations processed. */
+	uint32_t overruns;        /* Periods lost because a callback was late. */
+	uint32_t max_latency_us;  /* Worst deadline to interrupt entry delay. */
+	uint32_t active;          /* Number of started timers. */
+} hrtimer_stats_t;
+
+void hrtimer_init(void);
+void hrtimer_create(hrtimer_t *timer, hrtimer_callback_t callback, void *arg, hrtimer_context_t context);
+bool hrtimer_start(hrtimer_t *timer, uint32_t delay_us, uint32_t period_us);
+bool hrtimer_start_at(hrtimer_t *timer, uint32_t deadline_us, uint32_t period_us);
+void hrtimer_cancel(hrtimer_t *timer);
+bool hrtimer_is_active(const hrtimer_t *timer);
+uint32_t hrtimer_get_overruns(const hrtimer_t *timer);
+void hrtimer_get_stats(hrtimer_stats_t *stats);
+void hrtimer_irq_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __HRTIMER_H__ */
@@ -0,0 +1,51 @@
+/**
+  ******************************************************************************
+  * @file    mem_placement.h
+  * @brief   Attributes that place code and data in the sections of
+  *          STM32F407VGTx_FLASH.ld.
+  *
+  *          At 168 MHz the flash needs 5 wait states, the ART accelerator
+  *          hides them for code that hits its instruction cache.  A hot
+  *          function that does not, for example one that is evicted by other
+  *          code running between its calls, can be moved to SRAM where it is
+  *          fetched without wait states but shares the bus with the data
+  *          accesses.  art-bench shows what each placement gains.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __MEM_PLACEMENT_H__
+#define __MEM_PLACEMENT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Function executed from SRAM, copied there by the startup code.  Calls
+from flash are too far for a direct branch, long_call makes the compiler
+load the address instead of relying on linker veneers.  The MPU build maps
+SRAM execute never, there the functions must not be called. */
+#define RAMFUNC                         __attribute__((section(".ramfunc"), noinline, long_call))
+
+/* Initialized data in CCM RAM, copied by the startup code.  Zero wait
+state for the core, not reachable by DMA. */
+#define CCMRAM                          __attribute__((section(".ccmram")))
+
+/* Data in CCM RAM that is neither initialized nor zeroed. */
+#define CCMBSS                          __attribute__((section(".ccmbss")))
+
+/* Data in SRAM that is neither initialized nor zeroed, it keeps its contents
+over a reset, not over a power cycle. */
+#define NOINIT                          __attribute__((section(".noinit")))
+
+/* Task stack in SRAM, neither initialized nor zeroed, the kernel fills it
+when the task is created.  The section is sorted by alignment, so the MPU
+aligned stacks of mpu_guard.h pack without gaps. */
+#define TASK_STACK                      __attribute__((section(".task_stacks")))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MEM_PLACEMENT_H__ */
@@ -0,0 +1,37 @@
+/**
+  ******************************************************************************
+  * @file    mpu_bench.h
+  * @brief   This file contains all the function prototypes for
+  *          the mpu_bench.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __MPU_BENCH_H__
+#define __MPU_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Kernel calls and task switch round trips per measurement. */
+#ifndef MPU_BENCH_ITERATIONS
+	#define MPU_BENCH_ITERATIONS        1000U
+#endif
+
+/* Restricted task stacks must be aligned to their size, which must be a
+power of two. */
+#ifndef MPU_BENCH_TASK_STACK_SIZE
+	#define MPU_BENCH_TASK_STACK_SIZE   256U
+#endif
+
+void mpu_bench_run(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MPU_BENCH_H__ */
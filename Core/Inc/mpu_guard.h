@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file    mpu_guard.h
+  * @brief   This file contains all the function prototypes for
+  *          the mpu_guard.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __MPU_GUARD_H__
+#define __MPU_GUARD_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+#include "mem_placement.h"
+
+/* MMFAR value recorded when the fault did not provide the address. */
+#define MPU_GUARD_NO_ADDRESS            0xFFFFFFFFUL
+
+/* Smallest MPU region that holds size bytes, a power of two of at least 32
+bytes.  The base address of a region must be aligned to its size. */
+#define MPU_GUARD_REGION_SIZE(size) ( \
+	((size) <= 32U)    ? 32U    : ((size) <= 64U)    ? 64U    : ((size) <= 128U)   ? 128U   : \
+	((size) <= 256U)   ? 256U   : ((size) <= 512U)   ? 512U   : ((size) <= 1024U)  ? 1024U  : \
+	((size) <= 2048U)  ? 2048U  : ((size) <= 4096U)  ? 4096U  : ((size) <= 8192U)  ? 8192U  : \
+	((size) <= 16384U) ? 16384U : ((size) <= 32768U) ? 32768U : ((size) <= 65536U) ? 65536U : 131072U)
+
+/* A variable of type padded and aligned to the MPU region that covers it, so
+no other data shares the region.  The variable itself is the member data. */
+#define MPU_GUARD_REGION(type) union { \
+	type    data; \
+	uint8_t region[ MPU_GUARD_REGION_SIZE(sizeof(type)) ]; \
+} __attribute__((aligned(MPU_GUARD_REGION_SIZE(sizeof(type)))))
+
+/* The stack of a task created with mpu_guard_create_task(), one MPU region
+covers it exactly.  Without the MPU it is a plain array. */
+#if ( portUSING_MPU_WRAPPERS == 1 )
+	#define MPU_GUARD_STACK(name, depth) \
+		StackType_t name[ MPU_GUARD_REGION_SIZE((depth) * sizeof(StackType_t)) / sizeof(StackType_t) ] \
+		TASK_STACK __attribute__((aligned(MPU_GUARD_REGION_SIZE((depth) * sizeof(StackType_t)))))
+	#define MPU_GUARD_READ_WRITE        ( portMPU_REGION_READ_WRITE | portMPU_REGION_EXECUTE_NEVER )
+#else
+	#define MPU_GUARD_STACK(name, depth) StackType_t name[ depth ] TASK_STACK
+	#define MPU_GUARD_READ_WRITE        0UL
+#endif
+
+typedef struct {
+	uint32_t faults;            /* Trapped since reset. */
+	uint32_t pc;                /* Instruction of the last one. */
+	uint32_t address;           /* Data address of the last one. */
+	char     task[ configMAX_TASK_NAME_LEN ];
+} mpu_guard_stats_t;
+
+TaskHandle_t mpu_guard_create_task(TaskFunction_t code, const char *name, uint32_t depth, void *params,
+	UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb, const MemoryRegion_t *regions);
+TaskHandle_t mpu_guard_create_demo_task(TaskFunction_t code, const char *name, uint32_t depth, void *params,
+	UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb);
+void mpu_guard_memmanage(uint32_t *frame, uint32_t exc_return, const uint32_t *callee);
+void mpu_guard_get_stats(mpu_guard_stats_t *stats);
+void mpu_guard_print(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __MPU_GUARD_H__ */
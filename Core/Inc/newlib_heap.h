@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    newlib_heap.h
+  * @brief   This file contains all the function prototypes for the
+  *          newlib_heap.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __NEWLIB_HEAP_H__
+#define __NEWLIB_HEAP_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+#include <stddef.h>
+
+void newlib_heap_print(char *buffer, size_t length);
+
+/* Tells vApplicationMallocFailedHook() that pvPortMalloc() failed for
+malloc(), which returns NULL instead. */
+bool newlib_heap_in_malloc(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __NEWLIB_HEAP_H__ */
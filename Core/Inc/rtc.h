@@ -17,12 +17,29 @@ extern "C" {
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "stm32f4xx_hal.h"
+
+/* Backup registers, kept with the calendar over a reset. */
+#define RTC_BACKUP_CALENDAR         0U      /* Set once the calendar is set. */
+#define RTC_BACKUP_CLOCK_SOURCE     1U      /* See timekeeping.c */
+#define RTC_BACKUP_CLOCK_DRIFT      2U
+#define RTC_BACKUP_CLOCK_CHECK      3U
+
+/* The calendar starts 4 RTCCLK cycles after the initialization mode ends,
+~125 us at the 32 kHz of the LSI. */
+#define RTC_START_DELAY_US          125U
 
 void RTC_Init(void);
-void RTC_GetTime(uint8_t *hours, uint8_t *minutes, uint8_t *seconds);
-bool RTC_SetTime(uint8_t hours, uint8_t minutes, uint8_t seconds);
-void RTC_GetDate(uint8_t *day, uint8_t *month, uint8_t *year);
-bool RTC_SetDate(uint8_t day, uint8_t month, uint8_t year);
+bool RTC_IsReady(void);
+bool RTC_IsRestored(void);
+bool RTC_GetCalendar(RTC_TimeTypeDef *sTime, RTC_DateTypeDef *sDate);
+bool RTC_SetCalendar(const RTC_TimeTypeDef *sTime, const RTC_DateTypeDef *sDate, uint64_t start_us);
+void RTC_GetPrescalers(uint32_t *asynch_prediv, uint32_t *synch_prediv);
+void RTC_SetPrescalers(uint32_t asynch_prediv, uint32_t synch_prediv);
+uint32_t RTC_GetSmoothCalib(void);
+bool RTC_SetSmoothCalib(uint32_t plus_pulses, uint32_t minus_pulses);
+uint32_t RTC_ReadBackup(uint32_t index);
+void RTC_WriteBackup(uint32_t index, uint32_t value);
 
 #ifdef __cplusplus
 }
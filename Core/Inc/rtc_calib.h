@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    rtc_calib.h
+  * @brief   This file contains all the function prototypes for
+  *          the rtc_calib.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __RTC_CALIB_H__
+#define __RTC_CALIB_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* How often the LSI is measured, it drifts with the temperature and the
+supply voltage. */
+#ifndef RTC_CALIB_PERIOD_S
+	#define RTC_CALIB_PERIOD_S          600UL
+#endif
+
+/* Length of a measurement, the resolution is one timer clock in it, 0.012
+ppm at 84 MHz. */
+#ifndef RTC_CALIB_WINDOW_MS
+	#define RTC_CALIB_WINDOW_MS         1000UL
+#endif
+
+#ifndef RTC_CALIB_TASK_PRIORITY
+	#define RTC_CALIB_TASK_PRIORITY     ( tskIDLE_PRIORITY + 1 )
+#endif
+
+#ifndef RTC_CALIB_TASK_STACK_SIZE
+	#define RTC_CALIB_TASK_STACK_SIZE   configMINIMAL_STACK_SIZE
+#endif
+
+void rtc_calib_init(void);
+void rtc_calib_run(void);
+void rtc_calib_print(char *buffer, size_t length);
+
+/* Called by dfs.c when the clocks changed. */
+void rtc_calib_clock_changed(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __RTC_CALIB_H__ */
@@ -0,0 +1,55 @@
+/**
+  ******************************************************************************
+  * @file    spsc_ring.h
+  * @brief   This file contains all the function prototypes for
+  *          the spsc_ring.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __SPSC_RING_H__
+#define __SPSC_RING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Notification index used to wake the consumer task.  The consumer must not
+use this index for anything else. */
+#ifndef SPSC_RING_NOTIFY_INDEX
+	#define SPSC_RING_NOTIFY_INDEX      0U
+#endif
+
+/* The members are only accessed through the spsc_ring_ functions, the type
+is public so a ring can be allocated statically. */
+typedef struct {
+	uint8_t               *storage;
+	uint32_t               size;        /* Power of two. */
+	volatile uint32_t      head;        /* Free running, written by the producer only. */
+	volatile uint32_t      tail;        /* Free running, written by the consumer only. */
+	volatile TaskHandle_t  consumer;
+	volatile uint32_t      dropped;     /* Bytes that did not fit, written by the producer only. */
+} spsc_ring_t;
+
+void spsc_ring_init(spsc_ring_t *ring, uint8_t *storage, uint32_t size);
+void spsc_ring_set_consumer(spsc_ring_t *ring, TaskHandle_t consumer);
+
+uint32_t spsc_ring_write(spsc_ring_t *ring, const void *data, uint32_t length);
+uint32_t spsc_ring_write_from_isr(spsc_ring_t *ring, const void *data, uint32_t length, BaseType_t *higher_priority_task_woken);
+uint32_t spsc_ring_read(spsc_ring_t *ring, void *data, uint32_t length);
+uint32_t spsc_ring_receive(spsc_ring_t *ring, void *data, uint32_t length, TickType_t ticks_to_wait);
+
+uint32_t spsc_ring_get_used(const spsc_ring_t *ring);
+uint32_t spsc_ring_get_free(const spsc_ring_t *ring);
+uint32_t spsc_ring_get_dropped(const spsc_ring_t *ring);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __SPSC_RING_H__ */
@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    stdio_uart.h
+  * @brief   This file contains the settings and all the function prototypes
+  *          for the stdio_uart.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __STDIO_UART_H__
+#define __STDIO_UART_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Length of the line buffer of a task, a longer line is sent in pieces. */
+#ifndef STDIO_UART_LINE_SIZE
+	#define STDIO_UART_LINE_SIZE            96U
+#endif
+
+/* Number of line buffers.  A task takes one with its first output and keeps
+it until it is deleted, the output of a task that finds none left is sent
+unbuffered. */
+#ifndef STDIO_UART_BUFFERS
+	#define STDIO_UART_BUFFERS              8U
+#endif
+
+void stdio_uart_flush(void);
+void stdio_uart_print(char *buffer, size_t length);
+
+/* Called from traceTASK_DELETE() with the line buffer of the task. */
+void stdio_uart_task_deleted(void *line);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __STDIO_UART_H__ */
@@ -24,7 +24,8 @@ void UsageFault_Handler(void);
 void DebugMon_Handler(void);
 void EXTI0_IRQHandler(void);
 void USART2_IRQHandler(void);
-void TIM7_IRQHandler(void);
+void DMA1_Stream6_IRQHandler(void);
+void USART6_IRQHandler(void);
 void TIM2_IRQHandler(void);
 
 
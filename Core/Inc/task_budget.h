@@ -0,0 +1,73 @@
+/**
+  ******************************************************************************
+  * @file    task_budget.h
+  * @brief   This file contains all the function prototypes for
+  *          the task_budget.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __TASK_BUDGET_H__
+#define __TASK_BUDGET_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Number of tasks that can have a budget at the same time. */
+#ifndef TASK_BUDGET_MAX_TASKS
+	#define TASK_BUDGET_MAX_TASKS       8U
+#endif
+
+/* Longest budget period, keeps the cycle counts of a window in 32 bits. */
+#define TASK_BUDGET_MAX_PERIOD_MS       10000UL
+
+/* The supervisor task applies the overrun policies, it must be able to
+preempt the tasks it supervises. */
+#ifndef TASK_BUDGET_TASK_PRIORITY
+	#define TASK_BUDGET_TASK_PRIORITY   ( configMAX_PRIORITIES - 1 )
+#endif
+
+#ifndef TASK_BUDGET_TASK_STACK_SIZE
+	#define TASK_BUDGET_TASK_STACK_SIZE configMINIMAL_STACK_SIZE
+#endif
+
+/* Priority of a demoted task until its next budget period starts. */
+#ifndef TASK_BUDGET_DEMOTED_PRIORITY
+	#define TASK_BUDGET_DEMOTED_PRIORITY    tskIDLE_PRIORITY
+#endif
+
+typedef enum {
+	/* The overrun is only counted. */
+	TASK_BUDGET_POLICY_LOG = 0,
+	/* The task runs at TASK_BUDGET_DEMOTED_PRIORITY for the rest of the
+	period. */
+	TASK_BUDGET_POLICY_DEMOTE,
+	/* The task is suspended for the rest of the period. */
+	TASK_BUDGET_POLICY_SUSPEND
+} task_budget_policy_t;
+
+void task_budget_init(void);
+bool task_budget_attach(TaskHandle_t task, uint32_t budget_us, uint32_t period_ms, task_budget_policy_t policy);
+void task_budget_detach(TaskHandle_t task);
+void task_budget_print(char *buffer, size_t length);
+void task_budget_clock_changed(void);
+
+/* Called from the kernel hooks, see FreeRTOSConfig.h and hooks.c. */
+void task_budget_switched_in(void);
+void task_budget_switched_out(void *budget);
+void task_budget_task_deleted(void *budget);
+void task_budget_tick_hook(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TASK_BUDGET_H__ */
@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    time_format.h
+  * @brief   This file contains all the function prototypes for
+  *          the time_format.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __TIME_FORMAT_H__
+#define __TIME_FORMAT_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "timekeeping.h"
+
+/* Conversions and literal characters of a compiled format. */
+#ifndef TIME_FORMAT_MAX_ITEMS
+	#define TIME_FORMAT_MAX_ITEMS       32U
+#endif
+
+/* Conversions:
+ *   %Y  year, 4 digits            %y  year in the 2000s, 2 digits
+ *   %m  month, 2 digits           %b  month, Jan - Dec
+ *   %d  day, 2 digits             %e  day, 2 characters, space padded
+ *   %a  weekday, Mon - Sun
+ *   %H  hours, 2 digits           %M  minutes, 2 digits
+ *   %S  seconds, 2 digits
+ *   %L  milliseconds, 3 digits    %f  microseconds, 6 digits
+ *   %s  seconds since 1970, always UTC
+ *   %z  offset from UTC, +hh:mm, or Z for UTC
+ *   %%  a %
+ * A '.' or ',' followed by %L or %f is an optional fraction when parsing,
+ * %L and %f read 1 to 3 and 1 to 6 digits then. */
+#define TIME_FORMAT_ISO8601             "%Y-%m-%dT%H:%M:%S.%f%z"
+#define TIME_FORMAT_EPOCH               "%s.%f"
+#define TIME_FORMAT_DATE                "%d/%m/%y"
+#define TIME_FORMAT_TIME                "%H:%M:%S"
+
+typedef struct {
+	uint8_t field;
+	char    literal;
+} time_format_item_t;
+
+/* A compiled format.  Formatting caches the date of the last call, a
+format must not be used by more than one task at a time. */
+typedef struct {
+	time_format_item_t items[ TIME_FORMAT_MAX_ITEMS ];
+	uint8_t            count;
+	uint16_t           max_length;      /* The longest text, without the terminator. */
+	int16_t            tz_offset_min;   /* Offset of the local time from UTC. */
+	uint32_t           cached_day;      /* Local days since 1970 plus 1, 0 if none. */
+	timekeeping_calendar_t cached;
+} time_format_t;
+
+bool time_format_compile(time_format_t *format, const char *pattern, int32_t tz_offset_min);
+
+size_t time_format_us(time_format_t *format, uint64_t epoch_us, char *buffer, size_t length);
+
+bool time_format_parse(const time_format_t *format, const char *text, size_t length,
+					   timekeeping_calendar_t *calendar, int32_t *tz_offset_min);
+bool time_format_parse_us(const time_format_t *format, const char *text, size_t length,
+						  uint64_t base_us, uint64_t *epoch_us);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIME_FORMAT_H__ */
@@ -0,0 +1,36 @@
+/**
+  ******************************************************************************
+  * @file    time_format_bench.h
+  * @brief   This file contains all the function prototypes for
+  *          the time_format_bench.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __TIME_FORMAT_BENCH_H__
+#define __TIME_FORMAT_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Timestamps converted in one timed batch. */
+#ifndef TIME_FORMAT_BENCH_BATCH
+	#define TIME_FORMAT_BENCH_BATCH     32U
+#endif
+
+/* Timed batches of every kind of call, the fastest is kept. */
+#ifndef TIME_FORMAT_BENCH_RUNS
+	#define TIME_FORMAT_BENCH_RUNS      8U
+#endif
+
+void time_format_bench_run(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIME_FORMAT_BENCH_H__ */
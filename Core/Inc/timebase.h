@@ -0,0 +1,39 @@
+/**
+  ******************************************************************************
+  * @file    timebase.h
+  * @brief   This file contains all the function prototypes for
+  *          the timebase.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __TIMEBASE_H__
+#define __TIMEBASE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+/* TIM2 is a free running 32 bit counter clocked at 1 MHz. */
+#define TIMEBASE_COUNTER_HZ         1000000UL
+
+/* Period of the compare event that drives HAL_IncTick and the kernel tick. */
+#define TIMEBASE_TICK_PERIOD_US     ( TIMEBASE_COUNTER_HZ / 1000UL )
+
+/* The run time stats counter is the microsecond timestamp divided by 2^7
+(128 us units), so it only wraps after ~6.3 days. */
+#define TIMEBASE_RUNTIME_SHIFT      7U
+
+uint32_t timebase_get_us(void);
+uint64_t timebase_get_us64(void);
+uint32_t timebase_get_runtime_counter(void);
+void     timebase_irq_handler(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMEBASE_H__ */
@@ -0,0 +1,93 @@
+/**
+  ******************************************************************************
+  * @file    timekeeping.h
+  * @brief   This file contains all the function prototypes for
+  *          the timekeeping.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __TIMEKEEPING_H__
+#define __TIMEKEEPING_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+/* How often the RTC is set from the clock, which also rebases the clock.
+The RTC is what keeps the time over a reset, it drifts with the LSI in
+between. */
+#ifndef TIMEKEEPING_RTC_UPDATE_MS
+	#define TIMEKEEPING_RTC_UPDATE_MS       60000UL
+#endif
+
+/* A host reference closer to the clock than this is slewed in, a farther
+one steps the clock. */
+#ifndef TIMEKEEPING_STEP_THRESHOLD_US
+	#define TIMEKEEPING_STEP_THRESHOLD_US   128000L
+#endif
+
+/* Rate at which an offset is slewed in, 500 ppm slews 128 ms in 256 s. */
+#ifndef TIMEKEEPING_SLEW_PPM
+	#define TIMEKEEPING_SLEW_PPM            500L
+#endif
+
+/* Two host references must be at least this far apart to estimate the
+drift, the delay of the console is a few milliseconds. */
+#ifndef TIMEKEEPING_DRIFT_MIN_INTERVAL_S
+	#define TIMEKEEPING_DRIFT_MIN_INTERVAL_S    60UL
+#endif
+
+/* Limit of the rate correction, well beyond the tolerance of the HSE
+crystal. */
+#ifndef TIMEKEEPING_MAX_DRIFT_PPM
+	#define TIMEKEEPING_MAX_DRIFT_PPM       500L
+#endif
+
+#define TIMEKEEPING_US_PER_SECOND       1000000ULL
+
+typedef enum {
+	TIMEKEEPING_SOURCE_BUILD_TIME = 0,  /* The RTC was started with the build time. */
+	TIMEKEEPING_SOURCE_SET,             /* Set with timekeeping_set_us(). */
+	TIMEKEEPING_SOURCE_HOST             /* Synchronized to a host reference. */
+} timekeeping_source_t;
+
+/* Broken down UTC time. */
+typedef struct {
+	uint16_t year;                  /* 1970 ... */
+	uint8_t  month;                 /* 1 - 12 */
+	uint8_t  day;                   /* 1 - 31 */
+	uint8_t  hours;
+	uint8_t  minutes;
+	uint8_t  seconds;
+	uint8_t  weekday;               /* 1 - 7, Monday is 1 as in the RTC. */
+	uint32_t microseconds;
+} timekeeping_calendar_t;
+
+void timekeeping_init(void);
+bool timekeeping_is_ready(void);
+
+/* Microseconds since 1970-01-01 00:00:00 UTC, 0 before timekeeping_init(). */
+uint64_t timekeeping_get_us(void);
+void timekeeping_get_calendar(timekeeping_calendar_t *calendar);
+
+bool timekeeping_set_us(uint64_t epoch_us);
+bool timekeeping_sync_us(uint64_t reference_us, int64_t *offset_us);
+void timekeeping_clear_drift(void);
+void timekeeping_request_rtc_update(void);
+
+void timekeeping_to_calendar(uint64_t epoch_us, timekeeping_calendar_t *calendar);
+bool timekeeping_from_calendar(const timekeeping_calendar_t *calendar, uint64_t *epoch_us);
+
+void timekeeping_print(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMEKEEPING_H__ */
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file    timer_bench.h
+  * @brief   This file contains all the function prototypes for
+  *          the timer_bench.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __TIMER_BENCH_H__
+#define __TIMER_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Largest number of active timers measured, the timer control blocks are
+statically allocated in CCM RAM. */
+#ifndef TIMER_BENCH_MAX_TIMERS
+	#define TIMER_BENCH_MAX_TIMERS      1000U
+#endif
+
+/* Number of xTimerReset() calls measured for each timer count. */
+#ifndef TIMER_BENCH_RESETS
+	#define TIMER_BENCH_RESETS          1000U
+#endif
+
+/* Number of commands per batch when the timers are reset with
+xTimerSendCommandBatch(). */
+#ifndef TIMER_BENCH_BATCH_SIZE
+	#define TIMER_BENCH_BATCH_SIZE      50U
+#endif
+
+void timer_bench_run(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __TIMER_BENCH_H__ */
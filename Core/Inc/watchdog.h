@@ -0,0 +1,76 @@
+/**
+  ******************************************************************************
+  * @file    watchdog.h
+  * @brief   This file contains all the function prototypes for
+  *          the watchdog.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __WATCHDOG_H__
+#define __WATCHDOG_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+/* Number of tasks that can be supervised at the same time. */
+#ifndef WATCHDOG_MAX_TASKS
+	#define WATCHDOG_MAX_TASKS          8U
+#endif
+
+/* IWDG timeout at the nominal 32 kHz of the LSI.  The LSI may run up to
+47 kHz, and the erase of a 128 KB flash sector by the configuration store
+stalls the CPU for up to 2 s, the timeout must cover both. */
+#ifndef WATCHDOG_TIMEOUT_MS
+	#define WATCHDOG_TIMEOUT_MS         4000U
+#endif
+
+/* How often the heartbeats are checked and the IWDG is fed. */
+#ifndef WATCHDOG_CHECK_PERIOD_MS
+	#define WATCHDOG_CHECK_PERIOD_MS    250U
+#endif
+
+/* The supervisor must be able to preempt the tasks it supervises, a task
+that keeps the CPU busy starves the others of their heartbeats. */
+#ifndef WATCHDOG_TASK_PRIORITY
+	#define WATCHDOG_TASK_PRIORITY      ( configMAX_PRIORITIES - 1 )
+#endif
+
+#ifndef WATCHDOG_TASK_STACK_SIZE
+	#define WATCHDOG_TASK_STACK_SIZE    configMINIMAL_STACK_SIZE
+#endif
+
+typedef enum {
+	WATCHDOG_RESET_UNKNOWN = 0,
+	WATCHDOG_RESET_POWER_ON,
+	WATCHDOG_RESET_BROWN_OUT,
+	WATCHDOG_RESET_PIN,
+	WATCHDOG_RESET_SOFTWARE,
+	WATCHDOG_RESET_IWDG,
+	WATCHDOG_RESET_WWDG,
+	WATCHDOG_RESET_LOW_POWER
+} watchdog_reset_t;
+
+void watchdog_init(void);
+bool watchdog_attach(TaskHandle_t task, uint32_t period_ms);
+void watchdog_detach(TaskHandle_t task);
+void watchdog_heartbeat(void);
+watchdog_reset_t watchdog_reset_cause(void);
+void watchdog_print(char *buffer, size_t length);
+
+/* Called from traceTASK_DELETE, see FreeRTOSConfig.h. */
+void watchdog_task_deleted(void *client);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __WATCHDOG_H__ */
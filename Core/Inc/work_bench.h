@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    work_bench.h
+  * @brief   This file contains all the function prototypes for
+  *          the work_bench.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __WORK_BENCH_H__
+#define __WORK_BENCH_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stddef.h>
+
+/* Number of interrupts measured for each path. */
+#ifndef WORK_BENCH_SAMPLES
+	#define WORK_BENCH_SAMPLES          200U
+#endif
+
+void work_bench_run(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __WORK_BENCH_H__ */
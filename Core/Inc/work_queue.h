@@ -0,0 +1,84 @@
+/**
+  ******************************************************************************
+  * @file    work_queue.h
+  * @brief   This file contains all the function prototypes for
+  *          the work_queue.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __WORK_QUEUE_H__
+#define __WORK_QUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+typedef enum {
+	WORK_QUEUE_HIGH = 0,
+	WORK_QUEUE_MEDIUM,
+	WORK_QUEUE_LOW,
+	WORK_QUEUE_LEVELS
+} work_queue_level_t;
+
+/* Priorities of the worker tasks, one for each level.  The high level worker
+runs above the EDF priority and next to the hrtimer task, the low level one
+just above the idle task. */
+#ifndef WORK_QUEUE_HIGH_PRIORITY
+	#define WORK_QUEUE_HIGH_PRIORITY        ( configMAX_PRIORITIES - 1 )
+#endif
+
+#ifndef WORK_QUEUE_MEDIUM_PRIORITY
+	#define WORK_QUEUE_MEDIUM_PRIORITY      ( configMAX_PRIORITIES - 3 )
+#endif
+
+#ifndef WORK_QUEUE_LOW_PRIORITY
+	#define WORK_QUEUE_LOW_PRIORITY         ( tskIDLE_PRIORITY + 1 )
+#endif
+
+#ifndef WORK_QUEUE_TASK_STACK_SIZE
+	#define WORK_QUEUE_TASK_STACK_SIZE      configMINIMAL_STACK_SIZE
+#endif
+
+typedef struct work_queue_item work_queue_item_t;
+
+typedef void ( *work_queue_function_t )( work_queue_item_t *item, void *arg );
+
+/* Work item, allocated by the user.  The members are private to
+work_queue.c. */
+struct work_queue_item {
+	work_queue_item_t * volatile  next;
+	work_queue_function_t         function;
+	void                         *arg;
+	volatile uint32_t             pending;
+	uint32_t                      submitted;   /* Cycle counter at submission. */
+	uint8_t                       level;
+};
+
+typedef struct {
+	uint32_t executed;            /* Number of items run. */
+	uint32_t coalesced;           /* Submissions of items that were still pending. */
+	uint32_t max_latency_us;      /* Worst submission to start of execution delay. */
+	uint32_t max_run_us;          /* Longest running item. */
+} work_queue_stats_t;
+
+void work_queue_init(void);
+void work_queue_item_init(work_queue_item_t *item, work_queue_function_t function, void *arg, work_queue_level_t level);
+bool work_queue_submit(work_queue_item_t *item);
+bool work_queue_submit_from_isr(work_queue_item_t *item, BaseType_t *higher_priority_task_woken);
+bool work_queue_is_pending(const work_queue_item_t *item);
+void work_queue_get_stats(work_queue_level_t level, work_queue_stats_t *stats);
+void work_queue_print(char *buffer, size_t length);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __WORK_QUEUE_H__ */
@@ -0,0 +1,45 @@
+/**
+  ******************************************************************************
+  * @file    zc_queue.h
+  * @brief   This file contains all the function prototypes for
+  *          the zc_queue.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __ZC_QUEUE_H__
+#define __ZC_QUEUE_H__
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "FreeRTOS.h"
+
+typedef struct zc_queue zc_queue_t;
+
+zc_queue_t *zc_queue_create(size_t item_size, uint32_t item_count);
+void        zc_queue_delete(zc_queue_t *queue);
+
+void *zc_queue_acquire(zc_queue_t *queue, TickType_t ticks_to_wait);
+void *zc_queue_acquire_from_isr(zc_queue_t *queue, BaseType_t *higher_priority_task_woken);
+void  zc_queue_send(zc_queue_t *queue, void *item);
+void  zc_queue_send_from_isr(zc_queue_t *queue, void *item, BaseType_t *higher_priority_task_woken);
+void *zc_queue_receive(zc_queue_t *queue, TickType_t ticks_to_wait);
+void *zc_queue_receive_from_isr(zc_queue_t *queue, BaseType_t *higher_priority_task_woken);
+void  zc_queue_release(zc_queue_t *queue, void *item);
+void  zc_queue_release_from_isr(zc_queue_t *queue, void *item, BaseType_t *higher_priority_task_woken);
+
+size_t   zc_queue_get_item_size(const zc_queue_t *queue);
+uint32_t zc_queue_get_free_count(const zc_queue_t *queue);
+uint32_t zc_queue_get_waiting_count(const zc_queue_t *queue);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __ZC_QUEUE_H__ */
@@ -75,7 +75,7 @@ static const CLI_Command_Definition_t xHelpCommand =
 
 /* The definition of the list of commands.  Commands that are registered are
 added to this list. */
-static CLI_Definition_List_Item_t xRegisteredCommands =
+PRIVILEGED_DATA static CLI_Definition_List_Item_t xRegisteredCommands =
 {
 	&xHelpCommand,	/* The first command in the list is always the help command, defined in this file. */
 	NULL			/* The next pointer is initialised to NULL, as there are no other registered commands yet. */
@@ -88,13 +88,14 @@ command interpreter by UART and by Ethernet.  Sharing a buffer is done purely
 to save RAM.  Note, however, that the command console itself is not re-entrant,
 so only one command interpreter interface can be used at any one time.  For that
 reason, no attempt at providing mutual exclusion to the cOutputBuffer array is
-attempted.
+attempted.  It is privileged data, in the MPU build only privileged tasks can
+write it.
 
 configAPPLICATION_PROVIDES_cOutputBuffer is provided to allow the application
 writer to provide their own cOutputBuffer declaration in cases where the
 buffer needs to be placed at a fixed address (rather than by the linker). */
 #if( configAPPLICATION_PROVIDES_cOutputBuffer == 0 )
-	static char cOutputBuffer[ configCOMMAND_INT_MAX_OUTPUT_SIZE ];
+	PRIVILEGED_DATA static char cOutputBuffer[ configCOMMAND_INT_MAX_OUTPUT_SIZE ];
 #else
 	extern char cOutputBuffer[ configCOMMAND_INT_MAX_OUTPUT_SIZE ];
 #endif
@@ -145,7 +146,7 @@ BaseType_t xReturn = pdFAIL;
 
 BaseType_t FreeRTOS_CLIProcessCommand( const char * const pcCommandInput, char * pcWriteBuffer, size_t xWriteBufferLen  )
 {
-static const CLI_Definition_List_Item_t *pxCommand = NULL;
+PRIVILEGED_DATA static const CLI_Definition_List_Item_t *pxCommand = NULL;
 BaseType_t xReturn = pdTRUE;
 const char *pcRegisteredCommandString;
 size_t xCommandStringLength;
@@ -282,7 +283,7 @@ const char *pcReturn = NULL;
 
 static BaseType_t prvHelpCommand( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
-static const CLI_Definition_List_Item_t * pxCommand = NULL;
+PRIVILEGED_DATA static const CLI_Definition_List_Item_t * pxCommand = NULL;
 BaseType_t xReturn;
 
 	( void ) pcCommandString;
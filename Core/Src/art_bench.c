@@ -0,0 +1,335 @@
+/**
+  ******************************************************************************
+  * @file    art_bench.c
+  * @brief   Profiles the hot paths under the flash accelerator settings and
+  *          code placements.
+  *
+  *          The flash runs with the wait states set by SystemClock_Config.
+  *          For every combination of the ART instruction and data caches and
+  *          the prefetch buffer the CPU cycles of a task switch, a queue
+  *          send and receive and the parameter parsing of the CLI are
+  *          measured.  The same probe function is built once in flash and
+  *          once in SRAM (RAMFUNC) to show what moving a hot function to
+  *          SRAM gains under each setting.  The caches are reset before
+  *          every setting and the flash configuration is restored at the
+  *          end.
+  *
+  *          The setting changes the speed of everything else that runs at
+  *          the same time, the measurements take about a second.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "art_bench.h"
+#include "mem_placement.h"
+#include "mpu_guard.h"
+#include "cycle_counter.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "queue.h"
+#include "FreeRTOS_CLI.h"
+#include "stm32f4xx.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define ART_BENCH_PRIORITY              ( tskIDLE_PRIORITY + 1 )
+#define ART_BENCH_ACR_MASK              ( FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN )
+#define ART_BENCH_PROBE_SIZE            64U
+
+typedef enum {
+	ART_BENCH_SWITCH = 0,
+	ART_BENCH_QUEUE,
+	ART_BENCH_CLI,
+	ART_BENCH_PROBE_FLASH,
+	ART_BENCH_PROBE_SRAM,
+	ART_BENCH_WORKLOADS
+} art_bench_workload_t;
+
+static const struct {
+	const char *name;
+	uint32_t    acr;
+} art_bench_settings[] = {
+	{ "Prefetch, I+D cache", FLASH_ACR_PRFTEN | FLASH_ACR_ICEN | FLASH_ACR_DCEN },
+	{ "I+D cache",           FLASH_ACR_ICEN | FLASH_ACR_DCEN },
+	{ "Prefetch",            FLASH_ACR_PRFTEN },
+	{ "None",                0 },
+};
+
+static void art_bench_set_acr(uint32_t acr);
+static uint32_t art_bench_measure(art_bench_workload_t workload);
+static const char *art_bench_region(const void *address);
+static void art_bench_echo_task(void *params);
+static uint32_t art_bench_probe_flash(const uint8_t *data, uint32_t size);
+static RAMFUNC uint32_t art_bench_probe_sram(const uint8_t *data, uint32_t size);
+
+static const char art_bench_command[] = "echo-3-parameters first second third";
+
+static TaskHandle_t art_bench_echo;
+static QueueHandle_t art_bench_queue;
+static StaticQueue_t art_bench_queue_buffer;
+static uint32_t art_bench_queue_storage[ 1 ];
+static MPU_GUARD_STACK(art_bench_stack, ART_BENCH_TASK_STACK_SIZE);
+static StaticTask_t art_bench_tcb;
+static uint8_t art_bench_probe_data[ ART_BENCH_PROBE_SIZE ];
+static volatile uint32_t art_bench_sink;
+
+/**
+  * @brief  Runs the benchmark and prints the results.
+  * @param  buffer: Output buffer for the result table
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void art_bench_run(char *buffer, size_t length)
+{
+	uint32_t cycles[ sizeof(art_bench_settings) / sizeof(art_bench_settings[0]) ][ ART_BENCH_WORKLOADS ];
+	uint32_t saved_acr;
+	uint32_t elapsed;
+	uint32_t speedup;
+	size_t written;
+	uint32_t setting;
+	uint32_t workload;
+	uint32_t run;
+	uint32_t i;
+
+	configASSERT(buffer);
+
+	cycle_counter_init();
+
+	for (i = 0; i < ART_BENCH_PROBE_SIZE; i++) {
+		art_bench_probe_data[i] = (uint8_t)(i * 37U + 11U);
+	}
+
+	art_bench_queue = xQueueCreateStatic(1, sizeof(art_bench_queue_storage[0]), ( uint8_t * ) art_bench_queue_storage, &art_bench_queue_buffer);
+	configASSERT(art_bench_queue);
+
+	/* Preempts the calling task as soon as it is notified.  It only uses
+	notifications and needs no memory besides its stack. */
+	art_bench_echo = mpu_guard_create_task(art_bench_echo_task,                     /* Function that implements the task. */
+										   "ARTEcho",                               /* Text name for the task. */
+										   ART_BENCH_TASK_STACK_SIZE,               /* Stack size in words, not bytes. */
+										   xTaskGetCurrentTaskHandle(),             /* Parameter passed into the task. */
+										   ART_BENCH_PRIORITY,                      /* Priority at which the task is created. */
+										   art_bench_stack,                         /* Array to use as the task's stack. */
+										   &art_bench_tcb,                          /* Variable to hold the task's data structure. */
+										   NULL);                                   /* No regions. */
+	configASSERT(art_bench_echo);
+
+	saved_acr = FLASH->ACR;
+
+	for (setting = 0; setting < sizeof(art_bench_settings) / sizeof(art_bench_settings[0]); setting++) {
+		art_bench_set_acr(art_bench_settings[setting].acr);
+
+		for (workload = 0; workload < ART_BENCH_WORKLOADS; workload++) {
+			/* SRAM is execute never in the MPU build. */
+			if ((ART_BENCH_PROBE_SRAM == workload) && (portUSING_MPU_WRAPPERS == 1)) {
+				cycles[setting][workload] = 0;
+				continue;
+			}
+
+			cycles[setting][workload] = UINT32_MAX;
+
+			for (run = 0; run < ART_BENCH_RUNS; run++) {
+				elapsed = art_bench_measure(( art_bench_workload_t ) workload);
+				if (elapsed < cycles[setting][workload]) {
+					cycles[setting][workload] = elapsed;
+				}
+			}
+		}
+	}
+
+	art_bench_set_acr(saved_acr & ART_BENCH_ACR_MASK);
+
+	vTaskDelete(art_bench_echo);
+	vQueueDelete(art_bench_queue);
+
+	written = snprintf(buffer, length,
+		"\r\nFlash: %lu wait states at %lu MHz, ART %s\r\n"
+		"Placement: vTaskSwitchContext %s, xQueueReceive %s, FreeRTOS_CLIGetParameter %s\r\n"
+		"\r\nSetting               Switch   Queue  CLI parse  Probe flash  Probe SRAM  SRAM speedup  [CPU cycles]\r\n",
+		( unsigned long ) (saved_acr & FLASH_ACR_LATENCY), ( unsigned long ) (SystemCoreClock / 1000000U),
+		((saved_acr & ART_BENCH_ACR_MASK) == ART_BENCH_ACR_MASK) ? "fully enabled" : "partly disabled",
+		art_bench_region(( const void * ) vTaskSwitchContext),
+		art_bench_region(( const void * ) xQueueReceive),
+		art_bench_region(( const void * ) FreeRTOS_CLIGetParameter));
+
+	for (setting = 0; (setting < sizeof(art_bench_settings) / sizeof(art_bench_settings[0])) && (written < length); setting++) {
+		speedup = (cycles[setting][ART_BENCH_PROBE_SRAM] != 0) ?
+			((cycles[setting][ART_BENCH_PROBE_FLASH] * 100U) / cycles[setting][ART_BENCH_PROBE_SRAM]) : 0;
+
+		/* A switch is half of a round trip. */
+		written += snprintf(buffer + written, length - written, "%-19s  %7lu  %6lu  %9lu  %11lu",
+			art_bench_settings[setting].name,
+			( unsigned long ) (cycles[setting][ART_BENCH_SWITCH] / (2U * ART_BENCH_ITERATIONS)),
+			( unsigned long ) (cycles[setting][ART_BENCH_QUEUE] / ART_BENCH_ITERATIONS),
+			( unsigned long ) (cycles[setting][ART_BENCH_CLI] / ART_BENCH_ITERATIONS),
+			( unsigned long ) (cycles[setting][ART_BENCH_PROBE_FLASH] / ART_BENCH_ITERATIONS));
+
+		if ((speedup != 0) && (written < length)) {
+			written += snprintf(buffer + written, length - written, "  %10lu  %9lu.%02lu\r\n",
+				( unsigned long ) (cycles[setting][ART_BENCH_PROBE_SRAM] / ART_BENCH_ITERATIONS),
+				( unsigned long ) (speedup / 100U), ( unsigned long ) (speedup % 100U));
+		} else if (written < length) {
+			written += snprintf(buffer + written, length - written, "  %10s  %12s\r\n", "-", "-");
+		}
+	}
+
+	/* Speedup of the hot paths given by the accelerator, all on against all
+	off. */
+	if (written < length) {
+		written += snprintf(buffer + written, length - written, "ART speedup:");
+	}
+
+	for (workload = ART_BENCH_SWITCH; (workload <= ART_BENCH_CLI) && (written < length); workload++) {
+		speedup = (cycles[0][workload] != 0) ? ((cycles[3][workload] * 100U) / cycles[0][workload]) : 0;
+
+		written += snprintf(buffer + written, length - written, "%s %lu.%02lu",
+			(workload == ART_BENCH_SWITCH) ? " switch" : ((workload == ART_BENCH_QUEUE) ? ", queue" : ", CLI parse"),
+			( unsigned long ) (speedup / 100U), ( unsigned long ) (speedup % 100U));
+	}
+
+	if (written < length) {
+		snprintf(buffer + written, length - written, "\r\n");
+	}
+}
+
+/**
+  * @brief  Changes the accelerator setting, the wait states are kept.
+  * @param  acr: FLASH_ACR_PRFTEN, FLASH_ACR_ICEN and FLASH_ACR_DCEN bits
+  * @retval None
+  */
+static void art_bench_set_acr(uint32_t acr)
+{
+	uint32_t base = FLASH->ACR & ~(ART_BENCH_ACR_MASK | FLASH_ACR_ICRST | FLASH_ACR_DCRST);
+
+	/* The caches can only be reset while they are disabled. */
+	FLASH->ACR = base;
+	FLASH->ACR = base | FLASH_ACR_ICRST | FLASH_ACR_DCRST;
+	FLASH->ACR = base;
+	FLASH->ACR = base | acr;
+}
+
+/**
+  * @brief  Measures ART_BENCH_ITERATIONS operations of a workload.
+  * @param  workload: Workload to measure
+  * @retval CPU cycles
+  */
+static uint32_t art_bench_measure(art_bench_workload_t workload)
+{
+	const char *parameter;
+	BaseType_t parameter_length;
+	uint32_t value = 0;
+	uint32_t start;
+	uint32_t i;
+
+	/* The switches can not run with the scheduler suspended, the fastest run
+	leaves out the interrupts. */
+	if (ART_BENCH_SWITCH == workload) {
+		start = cycle_counter_get();
+		for (i = 0; i < ART_BENCH_ITERATIONS; i++) {
+			xTaskNotifyGive(art_bench_echo);
+			( void ) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		}
+
+		return cycle_counter_get() - start;
+	}
+
+	vTaskSuspendAll();
+	{
+		start = cycle_counter_get();
+
+		for (i = 0; i < ART_BENCH_ITERATIONS; i++) {
+			switch (workload) {
+			case ART_BENCH_QUEUE:
+				( void ) xQueueSend(art_bench_queue, &i, 0);
+				( void ) xQueueReceive(art_bench_queue, &value, 0);
+				break;
+
+			case ART_BENCH_CLI:
+				parameter = FreeRTOS_CLIGetParameter(art_bench_command, 1 + (i % 3U), &parameter_length);
+				value += ( uint32_t ) parameter_length + ((parameter != NULL) ? 1U : 0U);
+				break;
+
+			case ART_BENCH_PROBE_FLASH:
+				value += art_bench_probe_flash(art_bench_probe_data, ART_BENCH_PROBE_SIZE);
+				break;
+
+			case ART_BENCH_PROBE_SRAM:
+				value += art_bench_probe_sram(art_bench_probe_data, ART_BENCH_PROBE_SIZE);
+				break;
+
+			default:
+				break;
+			}
+		}
+
+		start = cycle_counter_get() - start;
+	}
+	( void ) xTaskResumeAll();
+
+	art_bench_sink = value;
+
+	return start;
+}
+
+/**
+  * @brief  Names the memory an address belongs to.
+  * @param  address: Address of a function
+  * @retval Name of the memory
+  */
+static const char *art_bench_region(const void *address)
+{
+	uint32_t value = ( uint32_t ) address;
+
+	if ((value >= FLASH_BASE) && (value <= FLASH_END)) {
+		return "FLASH";
+	} else if ((value >= SRAM1_BASE) && (value < SRAM1_BASE + 0x20000U)) {
+		return "SRAM";
+	} else if ((value >= CCMDATARAM_BASE) && (value <= CCMDATARAM_END)) {
+		return "CCM";
+	}
+
+	return "?";
+}
+
+static void art_bench_echo_task(void *params)
+{
+	TaskHandle_t caller = ( TaskHandle_t ) params;
+
+	for (;;) {
+		( void ) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		xTaskNotifyGive(caller);
+	}
+}
+
+/* The probe is a bitwise CRC-32, a branchy loop like most control code.  It
+is built twice from the same body so only the placement differs. */
+static inline __attribute__((always_inline)) uint32_t art_bench_probe(const uint8_t *data, uint32_t size)
+{
+	uint32_t crc = 0xFFFFFFFFUL;
+	uint32_t bit;
+
+	while (size-- != 0) {
+		crc ^= *data++;
+		for (bit = 0; bit < 8; bit++) {
+			if ((crc & 1U) != 0) {
+				crc = (crc >> 1) ^ 0xEDB88320UL;
+			} else {
+				crc >>= 1;
+			}
+		}
+	}
+
+	return ~crc;
+}
+
+static __attribute__((noinline)) uint32_t art_bench_probe_flash(const uint8_t *data, uint32_t size)
+{
+	return art_bench_probe(data, size);
+}
+
+static RAMFUNC uint32_t art_bench_probe_sram(const uint8_t *data, uint32_t size)
+{
+	return art_bench_probe(data, size);
+}
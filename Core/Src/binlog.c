@@ -0,0 +1,470 @@
+/**
+  ******************************************************************************
+  * @file    binlog.c
+  * @brief   Deferred binary logging.
+  *
+  *          BINLOG() stores the offset of its format string in the
+  *          .binlog_formats section, the microsecond timestamp and the raw
+  *          arguments into a slot of a ring buffer, the formatting is left
+  *          to Tools/binlog_decode.py on the host, which reads the format
+  *          strings from the ELF file.  A message costs a few tens of CPU
+  *          cycles instead of a snprintf() on the stack of the caller.
+  *
+  *          Tasks and interrupts of any priority log into the same ring
+  *          buffer.  A slot is reserved by incrementing the head index with
+  *          LDREX/STREX, filled, and then published by writing its header
+  *          word, which has a valid bit.  A message that does not fit is
+  *          dropped and counted, the count is sent with the next message.
+  *
+  *          The drain task runs every BINLOG_DRAIN_PERIOD_MS at low
+  *          priority, takes the published messages out in order, and sends
+  *          them on USART6 (TX on PC6) in batches, encoding one buffer while
+  *          the other is being transmitted.  On the line every message is
+  *          COBS encoded and followed by a zero byte:
+  *
+  *            header (offset << 8 | argument count << 4), timestamp, arguments
+  *
+  *          all of them 32 bit little endian words.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "binlog.h"
+#include "timebase.h"
+#include "watchdog.h"
+#include "semphr.h"
+#include "stm32f4xx_hal.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define BINLOG_SLOT_VALID               0x01UL
+#define BINLOG_COUNT(header)            ( ((header) >> 4) & 0x07UL )
+
+/* Header of the message that reports the number of dropped messages, an
+offset no format string has. */
+#define BINLOG_HEADER_DROPPED           ( (0xFFFFFFUL << 8) | (1UL << 4) )
+
+/* A COBS encoded message is one byte longer, plus the delimiter. */
+#define BINLOG_ENCODED_MAX(count)       ( (2U + (count)) * sizeof(uint32_t) + 2U )
+
+/* Longest wait in microseconds for the last character before a clock
+change. */
+#define BINLOG_CLOCK_CHANGE_TIMEOUT_US  1000UL
+
+/* Longest time between two drains before the watchdog resets, the drain
+task runs at a low priority and a benchmark may hold it off for a while. */
+#define BINLOG_WATCHDOG_PERIOD_MS       5000UL
+
+typedef struct {
+	volatile uint32_t head;         /* Slots reserved by the producers. */
+	volatile uint32_t tail;         /* Slots taken out by the drain task. */
+	volatile uint32_t dropped;
+	uint32_t          dropped_sent;
+	uint32_t          high_water;
+	uint32_t          bytes;
+	uint32_t          batches;
+	volatile uint32_t slots[ BINLOG_SLOTS ][ BINLOG_MESSAGE_WORDS ];
+} binlog_t;
+
+static void binlog_task(void *params);
+static size_t binlog_encode(uint8_t *buffer, size_t size, bool *more, uint32_t *messages);
+static void binlog_add_dropped(uint32_t count);
+static size_t binlog_cobs(const uint32_t *words, uint32_t count, uint8_t *out);
+static void binlog_uart_init(void);
+static void binlog_uart_mspinit(UART_HandleTypeDef *huart);
+static void binlog_tx_complete_callback(UART_HandleTypeDef *huart);
+
+static binlog_t binlog;
+
+static UART_HandleTypeDef h_uart_binlog;
+static SemaphoreHandle_t binlog_tx_done;
+static uint8_t binlog_tx[ 2 ][ BINLOG_TX_BUFFER_SIZE ];
+
+/**
+  * @brief  Configures the log output and creates the drain task.
+  * @note   Must be called before the scheduler is started.  Messages logged
+  *         before are kept and sent once the task runs.
+  * @param  None
+  * @retval None
+  */
+void binlog_init(void)
+{
+	BaseType_t retv;
+
+	configASSERT((BINLOG_SLOTS & (BINLOG_SLOTS - 1U)) == 0);
+	configASSERT(BINLOG_TX_BUFFER_SIZE >= BINLOG_ENCODED_MAX(BINLOG_MAX_ARGS));
+
+	/* Given by the transmit complete interrupt, it starts given as nothing is
+	being transmitted. */
+	binlog_tx_done = xSemaphoreCreateBinary();
+	configASSERT(binlog_tx_done);
+	xSemaphoreGive(binlog_tx_done);
+
+	binlog_uart_init();
+
+	retv = xTaskCreate(binlog_task,					/* The drain task. */
+					   "BinLog",					/* Text name assigned to the task.  This is just to assist debugging. */
+					   BINLOG_TASK_STACK_SIZE,		/* The size of the stack allocated to the task. */
+					   NULL,						/* The parameter is not used, so NULL is passed. */
+					   BINLOG_TASK_PRIORITY | portPRIVILEGE_BIT,	/* The priority allocated to the task, privileged as it checks in with the watchdog. */
+					   NULL );
+	configASSERT( retv == pdPASS );
+}
+
+/**
+  * @brief  Puts a message into the ring buffer, use BINLOG() instead.
+  * @note   Safe to call from tasks and interrupts of any priority, it does
+  *         not mask interrupts.
+  * @param  header: Offset of the format string and number of arguments
+  * @param  args: The arguments
+  * @retval None
+  */
+void binlog_write(uint32_t header, const uint32_t *args)
+{
+	volatile uint32_t *slot;
+	uint32_t count = BINLOG_COUNT(header);
+	uint32_t head;
+	uint32_t i;
+
+	do {
+		head = __LDREXW(&binlog.head);
+
+		if ((head - binlog.tail) >= BINLOG_SLOTS) {
+			__CLREX();
+			binlog_add_dropped(1);
+			return;
+		}
+	} while (__STREXW(head + 1U, &binlog.head) != 0);
+
+	slot = binlog.slots[head & (BINLOG_SLOTS - 1U)];
+
+	slot[1] = timebase_get_us();
+	for (i = 0; i < count; i++) {
+		slot[2U + i] = args[i];
+	}
+
+	/* The drain task may read the slot as soon as the header is valid. */
+	__DMB();
+	slot[0] = header | BINLOG_SLOT_VALID;
+}
+
+/**
+  * @brief  Prints the statistics of the logger.
+  * @param  buffer: Output buffer
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void binlog_print(char *buffer, size_t length)
+{
+	uint32_t head = binlog.head;
+	uint32_t tail = binlog.tail;
+
+	configASSERT(buffer);
+
+	snprintf(buffer, length,
+		"\r\nMessages: %lu, dropped: %lu, waiting: %lu of %lu slots, most waiting: %lu\r\n"
+		"Sent: %lu bytes in %lu batches, USART6 at %lu baud\r\n",
+		( unsigned long ) head, ( unsigned long ) binlog.dropped,
+		( unsigned long ) (head - tail), ( unsigned long ) BINLOG_SLOTS,
+		( unsigned long ) binlog.high_water,
+		( unsigned long ) binlog.bytes, ( unsigned long ) binlog.batches,
+		( unsigned long ) BINLOG_BAUD_RATE);
+}
+
+/**
+  * @brief  Copies the last messages of the ring buffer, sent or not, for the
+  *         crash dump.
+  * @note   Reads the ring buffer without taking anything out and without
+  *         locking, safe to call from a fault handler.  A slot that is still
+  *         being written is skipped.
+  * @param  messages: Destination, BINLOG_MESSAGE_WORDS words a message
+  * @param  count: Most messages to copy
+  * @retval Number of messages copied, the oldest first
+  */
+uint32_t binlog_copy_tail(uint32_t (*messages)[ BINLOG_MESSAGE_WORDS ], uint32_t count)
+{
+	volatile uint32_t *slot;
+	uint32_t head = binlog.head;
+	uint32_t tail = binlog.tail;
+	uint32_t copied = 0;
+	uint32_t index;
+	uint32_t i;
+
+	configASSERT(messages);
+
+	if (count > BINLOG_SLOTS) {
+		count = BINLOG_SLOTS;
+	}
+	if (count > head) {
+		count = head;
+	}
+
+	for (index = head - count; index != head; index++) {
+		slot = binlog.slots[index & (BINLOG_SLOTS - 1U)];
+
+		/* Sent messages keep their header without the valid bit, one that
+		is not sent yet is published by setting it. */
+		if ((slot[0] == 0U) ||
+			(((index - tail) < BINLOG_SLOTS) && ((slot[0] & BINLOG_SLOT_VALID) == 0U))) {
+			continue;
+		}
+
+		messages[copied][0] = slot[0] & ~BINLOG_SLOT_VALID;
+		for (i = 1; i < BINLOG_MESSAGE_WORDS; i++) {
+			messages[copied][i] = slot[i];
+		}
+		copied++;
+	}
+
+	return copied;
+}
+
+/**
+  * @brief  Holds back the log output until the UART is idle.
+  * @retval None
+  */
+void binlog_clock_change_begin(void)
+{
+	uint32_t start;
+
+	HAL_NVIC_DisableIRQ(USART6_IRQn);
+
+	start = timebase_get_us();
+	while (((h_uart_binlog.Instance->SR & USART_SR_TC) == 0U) &&
+		   ((timebase_get_us() - start) < BINLOG_CLOCK_CHANGE_TIMEOUT_US)) {
+	}
+}
+
+/**
+  * @brief  Sets the baud rate divider for the new APB2 clock and resumes the
+  *         log output.
+  * @retval None
+  */
+void binlog_clock_change_end(void)
+{
+	h_uart_binlog.Instance->BRR = UART_BRR_SAMPLING16(HAL_RCC_GetPCLK2Freq(), h_uart_binlog.Init.BaudRate);
+
+	HAL_NVIC_EnableIRQ(USART6_IRQn);
+}
+
+void binlog_uart_irq_handler(void)
+{
+	HAL_UART_IRQHandler(&h_uart_binlog);
+}
+
+static void binlog_task(void *params)
+{
+	TickType_t wake = xTaskGetTickCount();
+	uint32_t buffer = 0;
+	uint32_t dropped_sent;
+	uint32_t messages;
+	size_t length;
+	bool more;
+
+	( void ) params;
+
+	( void ) watchdog_attach(NULL, BINLOG_WATCHDOG_PERIOD_MS);
+
+	for (;;) {
+		vTaskDelayUntil(&wake, pdMS_TO_TICKS(BINLOG_DRAIN_PERIOD_MS));
+		watchdog_heartbeat();
+
+		do {
+			dropped_sent = binlog.dropped_sent;
+			length = binlog_encode(binlog_tx[buffer], sizeof(binlog_tx[buffer]), &more, &messages);
+			if (length == 0) {
+				break;
+			}
+
+			/* Wait for the other buffer to be sent. */
+			xSemaphoreTake(binlog_tx_done, portMAX_DELAY);
+			if (HAL_UART_Transmit_IT(&h_uart_binlog, binlog_tx[buffer], length) != HAL_OK) {
+				/* The messages of the batch are gone from the ring buffer,
+				they are counted as dropped, and a drop report in the batch
+				is sent again, so the decoder shows the gap. */
+				binlog.dropped_sent = dropped_sent;
+				binlog_add_dropped(messages);
+				xSemaphoreGive(binlog_tx_done);
+				continue;
+			}
+
+			binlog.bytes += length;
+			binlog.batches++;
+			buffer ^= 1U;
+		} while (true == more);
+	}
+}
+
+/**
+  * @brief  Takes the published messages out of the ring buffer and encodes
+  *         them for the line.
+  * @param  buffer: Transmit buffer
+  * @param  size: Size of the buffer
+  * @param  more: Set if the buffer is full and there are more messages
+  * @param  messages: Number of messages taken out of the ring buffer
+  * @retval Number of bytes put into the buffer
+  */
+static size_t binlog_encode(uint8_t *buffer, size_t size, bool *more, uint32_t *messages)
+{
+	volatile uint32_t *slot;
+	uint32_t message[ BINLOG_MESSAGE_WORDS ];
+	uint32_t dropped;
+	uint32_t count;
+	uint32_t tail;
+	uint32_t i;
+	size_t written = 0;
+
+	*more = false;
+	*messages = 0;
+
+	for (;;) {
+		tail = binlog.tail;
+		slot = NULL;
+
+		if ((binlog.head - tail) > binlog.high_water) {
+			binlog.high_water = binlog.head - tail;
+		}
+
+		dropped = binlog.dropped;
+		if (dropped != binlog.dropped_sent) {
+			message[0] = BINLOG_HEADER_DROPPED;
+			message[1] = timebase_get_us();
+			message[2] = dropped - binlog.dropped_sent;
+		} else if (tail != binlog.head) {
+			slot = binlog.slots[tail & (BINLOG_SLOTS - 1U)];
+
+			/* Reserved, but still being written. */
+			if ((slot[0] & BINLOG_SLOT_VALID) == 0) {
+				break;
+			}
+
+			message[0] = slot[0] & ~BINLOG_SLOT_VALID;
+			for (i = 1; i < 2U + BINLOG_COUNT(message[0]); i++) {
+				message[i] = slot[i];
+			}
+		} else {
+			break;
+		}
+
+		count = BINLOG_COUNT(message[0]);
+		if (written + BINLOG_ENCODED_MAX(count) > size) {
+			*more = true;
+			break;
+		}
+
+		written += binlog_cobs(message, 2U + count, &buffer[written]);
+
+		if (slot != NULL) {
+			/* The slot is free again once the tail has passed it.  The
+			message stays for binlog_copy_tail() until it is overwritten. */
+			slot[0] = message[0];
+			__DMB();
+			binlog.tail = tail + 1U;
+			(*messages)++;
+		} else {
+			binlog.dropped_sent = dropped;
+		}
+	}
+
+	return written;
+}
+
+/**
+  * @brief  Counts messages that are lost, from any context.
+  * @param  count: Number of messages
+  * @retval None
+  */
+static void binlog_add_dropped(uint32_t count)
+{
+	uint32_t dropped;
+
+	do {
+		dropped = __LDREXW(&binlog.dropped);
+	} while (__STREXW(dropped + count, &binlog.dropped) != 0);
+}
+
+/**
+  * @brief  COBS encodes a message and appends the zero delimiter.
+  * @param  words: The message
+  * @param  count: Number of words, the message is shorter than 254 bytes
+  * @param  out: Output, at least 4 * count + 2 bytes
+  * @retval Number of bytes written
+  */
+static size_t binlog_cobs(const uint32_t *words, uint32_t count, uint8_t *out)
+{
+	const uint8_t *bytes = (const uint8_t *)words;
+	size_t code_index = 0;
+	size_t written = 1;
+	uint8_t code = 1;
+	uint32_t i;
+
+	for (i = 0; i < count * sizeof(uint32_t); i++) {
+		if (bytes[i] == 0) {
+			out[code_index] = code;
+			code_index = written++;
+			code = 1;
+		} else {
+			out[written++] = bytes[i];
+			code++;
+		}
+	}
+
+	out[code_index] = code;
+	out[written++] = 0;
+
+	return written;
+}
+
+static void binlog_uart_init(void)
+{
+	h_uart_binlog.Instance          = USART6;
+	h_uart_binlog.Init.BaudRate     = BINLOG_BAUD_RATE;
+	h_uart_binlog.Init.WordLength   = UART_WORDLENGTH_8B;
+	h_uart_binlog.Init.StopBits     = UART_STOPBITS_1;
+	h_uart_binlog.Init.Parity       = UART_PARITY_NONE;
+	h_uart_binlog.Init.Mode         = UART_MODE_TX;
+	h_uart_binlog.Init.HwFlowCtl    = UART_HWCONTROL_NONE;
+	h_uart_binlog.Init.OverSampling = UART_OVERSAMPLING_16;
+
+	HAL_UART_RegisterCallback(&h_uart_binlog, HAL_UART_MSPINIT_CB_ID, binlog_uart_mspinit);
+	while (HAL_UART_Init(&h_uart_binlog) != HAL_OK) {
+	}
+
+	HAL_UART_RegisterCallback(&h_uart_binlog, HAL_UART_TX_COMPLETE_CB_ID, binlog_tx_complete_callback);
+}
+
+static void binlog_uart_mspinit(UART_HandleTypeDef *huart)
+{
+	GPIO_InitTypeDef GPIO_InitStruct = {0};
+
+	( void ) huart;
+
+	__HAL_RCC_USART6_CLK_ENABLE();
+	__HAL_RCC_GPIOC_CLK_ENABLE();
+
+	/**USART6 GPIO Configuration
+	PC6     ------> USART6_TX */
+	GPIO_InitStruct.Pin       = GPIO_PIN_6;
+	GPIO_InitStruct.Mode      = GPIO_MODE_AF_PP;
+	GPIO_InitStruct.Pull      = GPIO_NOPULL;
+	GPIO_InitStruct.Speed     = GPIO_SPEED_FREQ_VERY_HIGH;
+	GPIO_InitStruct.Alternate = GPIO_AF8_USART6;
+	HAL_GPIO_Init(GPIOC, &GPIO_InitStruct);
+
+	/* Below the console, the log output is the least urgent. */
+	HAL_NVIC_SetPriority(USART6_IRQn, 6, 0);
+	HAL_NVIC_EnableIRQ(USART6_IRQn);
+}
+
+static void binlog_tx_complete_callback(UART_HandleTypeDef *huart)
+{
+	BaseType_t higher_priority_task_woken = pdFALSE;
+
+	( void ) huart;
+
+	xSemaphoreGiveFromISR(binlog_tx_done, &higher_priority_task_woken);
+	portYIELD_FROM_ISR(higher_priority_task_woken);
+}
@@ -0,0 +1,121 @@
+/**
+  ******************************************************************************
+  * @file    binlog_bench.c
+  * @brief   Compares the cost of a BINLOG() call with formatting the same
+  *          message with snprintf().
+  *
+  *          Each call is timed with the CPU cycle counter while the
+  *          scheduler is suspended, the fastest of BINLOG_BENCH_RUNS calls
+  *          is kept to leave out the interrupts.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "binlog_bench.h"
+#include "binlog.h"
+#include "cycle_counter.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdint.h>
+#include <stdio.h>
+
+typedef uint32_t ( *binlog_bench_call_t )( uint32_t value );
+
+static uint32_t binlog_bench_no_args(uint32_t value);
+static uint32_t binlog_bench_four_args(uint32_t value);
+static uint32_t binlog_bench_snprintf(uint32_t value);
+
+static const struct {
+	const char          *name;
+	binlog_bench_call_t  call;
+} binlog_bench_calls[] = {
+	{ "BINLOG, no arguments",  binlog_bench_no_args },
+	{ "BINLOG, 4 arguments",   binlog_bench_four_args },
+	{ "snprintf, 4 arguments", binlog_bench_snprintf },
+};
+
+#define BINLOG_BENCH_CALLS              ( sizeof(binlog_bench_calls) / sizeof(binlog_bench_calls[0]) )
+
+static char binlog_bench_text[ 64 ];
+
+/**
+  * @brief  Runs the benchmark and prints the results.
+  * @param  buffer: Output buffer for the result table
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void binlog_bench_run(char *buffer, size_t length)
+{
+	uint32_t cycles[ BINLOG_BENCH_CALLS ];
+	uint32_t elapsed;
+	uint32_t i;
+	uint32_t run;
+	size_t written;
+
+	configASSERT(buffer);
+
+	cycle_counter_init();
+
+	for (i = 0; i < BINLOG_BENCH_CALLS; i++) {
+		cycles[i] = UINT32_MAX;
+
+		for (run = 0; run < BINLOG_BENCH_RUNS; run++) {
+			vTaskSuspendAll();
+			{
+				elapsed = binlog_bench_calls[i].call(run);
+			}
+			( void ) xTaskResumeAll();
+
+			if (elapsed < cycles[i]) {
+				cycles[i] = elapsed;
+			}
+		}
+	}
+
+	written = snprintf(buffer, length, "\r\nCall                   CPU cycles\r\n");
+
+	for (i = 0; (i < BINLOG_BENCH_CALLS) && (written < length); i++) {
+		written += snprintf(buffer + written, length - written, "%-21s  %10lu\r\n",
+			binlog_bench_calls[i].name, ( unsigned long ) cycles[i]);
+	}
+
+	if ((written < length) && (cycles[1] != 0)) {
+		snprintf(buffer + written, length - written, "snprintf / BINLOG: %lu.%02lu\r\n",
+			( unsigned long ) (cycles[2] / cycles[1]), ( unsigned long ) ((cycles[2] * 100U / cycles[1]) % 100U));
+	}
+}
+
+static uint32_t binlog_bench_no_args(uint32_t value)
+{
+	uint32_t start;
+
+	( void ) value;
+
+	start = cycle_counter_get();
+	BINLOG("binlog-bench");
+
+	return cycle_counter_get() - start;
+}
+
+static uint32_t binlog_bench_four_args(uint32_t value)
+{
+	uint32_t start;
+
+	start = cycle_counter_get();
+	BINLOG("binlog-bench %u %u %08x %08x", value, value * 3U, value << 16, ~value);
+
+	return cycle_counter_get() - start;
+}
+
+static uint32_t binlog_bench_snprintf(uint32_t value)
+{
+	uint32_t start;
+
+	start = cycle_counter_get();
+	snprintf(binlog_bench_text, sizeof(binlog_bench_text), "binlog-bench %lu %lu %08lx %08lx",
+		( unsigned long ) value, ( unsigned long ) (value * 3U), ( unsigned long ) (value << 16), ( unsigned long ) ~value);
+
+	return cycle_counter_get() - start;
+}
@@ -0,0 +1,173 @@
+/**
+  ******************************************************************************
+  * @file    boot_profile.c
+  * @brief   Durations of the boot phases, from the reset to the console
+  *          prompt.
+  *
+  *          Reset_Handler starts the DWT cycle counter from zero before it
+  *          copies the data sections, so the first mark, at the start of
+  *          main(), measures the startup code.  The time the reset itself
+  *          takes, until the first instruction, is not included.
+  *
+  *          The marks on the path to the prompt each end the phase the
+  *          previous one started, the phases that run in parallel in tasks
+  *          of their own have a begin and an end.  The cycles are converted
+  *          to microseconds when a phase is recorded: the core runs from the
+  *          16 MHz HSI until SystemClock_Config(), a phase is counted at the
+  *          clock it started with, which assumes the clock only changes right
+  *          before a mark.  The counter wraps after ~25 s at 168 MHz.
+  *
+  *          A phase takes its slot with an exclusive access, it may be
+  *          recorded before the scheduler starts, when a critical section
+  *          would mask the HAL tick, and from any task afterwards.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "boot_profile.h"
+#include "cycle_counter.h"
+#include "FreeRTOS.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+typedef struct {
+	const char *name;           /* Set last, NULL until the phase is recorded. */
+	uint32_t    start_us;
+	uint32_t    end_us;
+	bool        parallel;
+} boot_profile_phase_t;
+
+static void boot_profile_add(const char *name, uint32_t start_us, uint32_t end_us, bool parallel);
+static uint32_t boot_profile_us(uint32_t cycles);
+
+PRIVILEGED_DATA static boot_profile_phase_t boot_profile_phases[ BOOT_PROFILE_MAX_PHASES ];
+PRIVILEGED_DATA static volatile uint32_t boot_profile_count;
+
+/* Cycle counter value, time and core clock of the last clock change, the
+reset for the first. */
+PRIVILEGED_DATA static uint32_t boot_profile_base_cycles;
+PRIVILEGED_DATA static uint32_t boot_profile_base_us;
+PRIVILEGED_DATA static uint32_t boot_profile_base_hz = HSI_VALUE;
+
+/* End of the last mark, the start of the next. */
+PRIVILEGED_DATA static uint32_t boot_profile_last_us;
+
+/**
+  * @brief  Ends the phase that started at the previous mark.
+  * @param  name: Name of the phase, must stay valid
+  * @retval None
+  */
+void boot_profile_mark(const char *name)
+{
+	uint32_t now = cycle_counter_get();
+	uint32_t end_us = boot_profile_us(now);
+
+	boot_profile_add(name, boot_profile_last_us, end_us, false);
+	boot_profile_last_us = end_us;
+
+	/* The next phase runs with the clock set by this one. */
+	if (SystemCoreClock != boot_profile_base_hz) {
+		boot_profile_base_cycles = now;
+		boot_profile_base_us     = end_us;
+		boot_profile_base_hz     = SystemCoreClock;
+	}
+}
+
+/**
+  * @brief  Starts a phase that runs in parallel with the others.
+  * @retval The start, for boot_profile_end()
+  */
+uint32_t boot_profile_begin(void)
+{
+	return cycle_counter_get();
+}
+
+/**
+  * @brief  Ends a phase started with boot_profile_begin().
+  * @param  name: Name of the phase, must stay valid
+  * @param  start: Value returned by boot_profile_begin()
+  * @retval None
+  */
+void boot_profile_end(const char *name, uint32_t start)
+{
+	uint32_t end_us = boot_profile_us(cycle_counter_get());
+
+	boot_profile_add(name, boot_profile_us(start), end_us, true);
+}
+
+/**
+  * @brief  Writes the recorded phases into a buffer.
+  * @param  buffer: the output buffer
+  * @param  length: size of the buffer
+  * @retval None
+  */
+void boot_profile_print(char *buffer, size_t length)
+{
+	const boot_profile_phase_t *phase;
+	uint32_t count = boot_profile_count;
+	uint32_t last = 0;
+	size_t written;
+	uint32_t i;
+
+	configASSERT(buffer);
+
+	written = snprintf(buffer, length, "\r\nPhase                   Start[us]  Duration[us]\r\n");
+
+	for (i = 0; (i < count) && (i < BOOT_PROFILE_MAX_PHASES) && (written < length); i++) {
+		phase = &boot_profile_phases[i];
+
+		/* A phase being recorded right now is skipped. */
+		if (phase->name == NULL) {
+			continue;
+		}
+
+		written += snprintf(buffer + written, length - written, "%-22s %10lu  %12lu%s\r\n",
+			phase->name, ( unsigned long ) phase->start_us,
+			( unsigned long ) (phase->end_us - phase->start_us),
+			(true == phase->parallel) ? "  parallel" : "");
+
+		if (phase->end_us > last) {
+			last = phase->end_us;
+		}
+	}
+
+	if (written < length) {
+		snprintf(buffer + written, length - written, "Boot completed %lu us after the reset%s\r\n",
+			( unsigned long ) last, (count > BOOT_PROFILE_MAX_PHASES) ? ", some phases are not recorded" : "");
+	}
+}
+
+static void boot_profile_add(const char *name, uint32_t start_us, uint32_t end_us, bool parallel)
+{
+	boot_profile_phase_t *phase;
+	uint32_t index;
+
+	do {
+		index = __LDREXW(&boot_profile_count);
+	} while (__STREXW(index + 1U, &boot_profile_count) != 0U);
+
+	if (index >= BOOT_PROFILE_MAX_PHASES) {
+		return;
+	}
+
+	phase = &boot_profile_phases[index];
+	phase->start_us = start_us;
+	phase->end_us   = end_us;
+	phase->parallel = parallel;
+
+	/* The name marks the phase as complete for boot_profile_print(). */
+	__DMB();
+	phase->name = name;
+}
+
+/**
+  * @brief  Converts a cycle counter value to microseconds since the reset.
+  * @param  cycles: Cycle counter value
+  * @retval Microseconds
+  */
+static uint32_t boot_profile_us(uint32_t cycles)
+{
+	return boot_profile_base_us + (cycles - boot_profile_base_cycles) / (boot_profile_base_hz / 1000000UL);
+}
@@ -3,6 +3,11 @@
  */
 
 #include "cli_io.h"
+#include "spsc_ring.h"
+#include "timebase.h"
+#include "config_store.h"
+#include "watchdog.h"
+#include "boot_profile.h"
 
 /* Standard includes. */
 #include <string.h>
@@ -19,25 +24,43 @@
 /* The maximum time in ticks to wait for the UART access mutex. */
 #define cmdMAX_MUTEX_WAIT					( 200 / portTICK_PERIOD_MS )
 
-/* Characters are only ever received slowly on the CLI so it is ok to pass
-received characters from the UART interrupt to the task on a queue.  This sets
-the length of the queue used for that purpose. */
-#define cmdRXED_CHARS_QUEUE_LENGTH			( 10 )
+/* Received characters are passed from the UART interrupt to the task through
+a lock free ring buffer, so none are lost while the task is busy writing the
+output of a command.  This sets the size of the ring buffer, it must be a
+power of two. */
+#define cmdRX_RING_SIZE						( 128 )
+
+/* Number of characters taken out of the ring buffer at once. */
+#define cmdRX_CHUNK_SIZE					( 16 )
 
 /* DEL acts as a backspace. */
 #define cmdASCII_DEL						( 0x7F )
 
+/* Longest wait in microseconds for the character being shifted out before a
+clock change, one character takes 87us at 115200 baud. */
+#define cmdCLOCK_CHANGE_TIMEOUT_US			( 1000UL )
+
+/* The baud rate is read from the configuration store at startup, "config set
+cli.baud <rate>" takes effect after the next reset. */
+#define cmdBAUD_RATE_KEY					"cli.baud"
+#define cmdDEFAULT_BAUD_RATE				( 115200UL )
+
+/* The console task runs at the idle priority and the commands may take a
+while, the watchdog resets if it has not been back for input for this long.
+Without input it comes back every cmdHEARTBEAT_WAIT. */
+#define cmdWATCHDOG_PERIOD_MS				( 10000UL )
+#define cmdHEARTBEAT_WAIT					( 1000 / portTICK_PERIOD_MS )
+
 /*
  * The task that implements the command console processing.
  */
 static void cli_io_task(void *pvParameters);
 
 /*
- * Ensure a previous interrupt driven Tx has completed before sending the next
- * data block to the UART.
+ * Ensure a previous DMA driven Tx has completed before sending the next data
+ * block to the UART.
  */
 static void cli_io_write(const char *pcBuffer, size_t xBufferLength);
-static void cli_io_read(uint8_t *buf, uint16_t size);
 
 /*
  * Register the 'standard' sample CLI commands with FreeRTOS+CLI.
@@ -48,15 +71,17 @@ extern void vRegisterSampleCLICommands( void );
  * Configure the UART used for IO.
  */
 static void cli_io_init(void);
+static uint32_t cli_io_baud_rate(void);
 static void cli_io_mspinit(UART_HandleTypeDef *huart);
+static void cli_io_dma_init(UART_HandleTypeDef *huart);
 
 /*
- * Callback functions registered with the UART driver.  Both functions
- * just 'give' a semaphore to unblock a task that may be waiting for a
- * character to be received, or a transmission to complete.
+ * Callback function registered with the UART driver.  It just 'gives' a
+ * semaphore to unblock a task that may be waiting for a transmission to
+ * complete.
  */
 static void cli_io_tx_complete_callback(UART_HandleTypeDef *huart);
-static void cli_io_rx_complete_callback(UART_HandleTypeDef *huart);
+static void cli_io_error_callback(UART_HandleTypeDef *huart);
 
 static bool is_end_of_line(char ch);
 static void process_command();
@@ -66,24 +91,42 @@ static void process_input(char *received_char);
 static const char * const welcome_message      = "\r\n\r\nFreeRTOS command server.\r\nType Help to view a list of registered commands.\r\n\r\n>";
 static const char * const pcEndOfOutputMessage = "\r\n[Press ENTER to execute the previous command again]\r\n>";
 static const char * const new_line             = "\r\n";
-static char input_string_buffer[ cmdMAX_INPUT_SIZE ];
-static char last_input_string[ cmdMAX_INPUT_SIZE ];
-char *output_string;
-uint8_t input_index = 0;
+/* The state of the console is privileged data, in the MPU build a stray write
+from an unprivileged task faults instead of corrupting it. */
+PRIVILEGED_DATA static char input_string_buffer[ cmdMAX_INPUT_SIZE ];
+PRIVILEGED_DATA static char last_input_string[ cmdMAX_INPUT_SIZE ];
+PRIVILEGED_DATA char *output_string;
+PRIVILEGED_DATA uint8_t input_index = 0;
 
 /* This semaphore is used to allow the task to wait for a Tx to complete without wasting any CPU time. */
-static SemaphoreHandle_t xTxCompleteSemaphore = NULL;
+PRIVILEGED_DATA static SemaphoreHandle_t xTxCompleteSemaphore = NULL;
+
+/* The console task and the stdio output of the other tasks (see stdio_uart.c)
+share the UART, this mutex keeps a block from being mixed with another. */
+PRIVILEGED_DATA static SemaphoreHandle_t xUartMutex = NULL;
+
+/* The command interpreter and the commands keep state between the calls that
+return the blocks of a command's output, this mutex is held by the console or
+cli_io_execute() from the first call of a command to the last. */
+PRIVILEGED_DATA static SemaphoreHandle_t xCommandMutex = NULL;
 
-/* This semaphore is sued to allow the task to wait for an Rx to complete without wasting any CPU time. */
-static SemaphoreHandle_t xRxCompleteSemaphore = NULL;
+/* Set if a DMA transfer was held back by cli_io_clock_change_begin(). */
+PRIVILEGED_DATA static uint32_t ulTxDmaPaused = 0;
 
-UART_HandleTypeDef h_uart_cli;
+/* Characters received by the UART interrupt, read by the CLI task.  The task
+is notified when the ring buffer becomes non-empty, so it does not use any CPU
+time until data has arrived. */
+PRIVILEGED_DATA static uint8_t ucRxRingStorage[ cmdRX_RING_SIZE ];
+PRIVILEGED_DATA static spsc_ring_t xRxRing;
 
-cli_callback_t commandline_interpreter;
+PRIVILEGED_DATA UART_HandleTypeDef h_uart_cli;
+PRIVILEGED_DATA static DMA_HandleTypeDef h_dma_cli_tx;
+
+PRIVILEGED_DATA cli_callback_t commandline_interpreter;
 
 void cli_io_task_start( uint16_t usStackSize, unsigned portBASE_TYPE uxPriority, char *cli_output_buffer, cli_callback_t cli_callback )
 {
-	vRegisterSampleCLICommands();
+	TaskHandle_t xCliTask = NULL;
 
 	/* Obtain the address of the output buffer.  Note there is no mutual
 	exclusion on this buffer as it is assumed only one command console
@@ -91,42 +134,65 @@ void cli_io_task_start( uint16_t usStackSize, unsigned portBASE_TYPE uxPriority,
 	output_string = cli_output_buffer;
 	commandline_interpreter = cli_callback;
 
+	/* The UART is configured before the scheduler is started, the other
+	tasks may print before the console task first runs. */
+	cli_io_init();
+
 	/* Create that task that handles the console itself. */
 	xTaskCreate(cli_io_task,			/* The task that implements the command console. */
 				"CLI_IO",				/* Text name assigned to the task.  This is just to assist debugging.  The kernel does not use this name itself. */
 				usStackSize,			/* The size of the stack allocated to the task. */
 				NULL,					/* The parameter is not used, so NULL is passed. */
-				uxPriority,				/* The priority allocated to the task. */
-				NULL );					/* A handle is not required, so just pass NULL. */		
+				uxPriority | portPRIVILEGE_BIT,	/* The priority allocated to the task, privileged as the commands reach the data of every module. */
+				&xCliTask );			/* The task reads the received characters. */
+	configASSERT( xCliTask );
+
+	/* This task is the only reader of the received characters. */
+	spsc_ring_set_consumer( &xRxRing, xCliTask );
 }
 
 static void cli_io_task( void *pvParameters )
 {
 	( void ) pvParameters;
-	char cRxedChar;
+	char cRxedChars[ cmdRX_CHUNK_SIZE ];
+	uint32_t ulRxedCount;
+	uint32_t i;
 
-	/* A UART is used for printf() output and CLI input and output.  Note there
-	is no mutual exclusion on the UART, but the demo as it stands does not
-	require mutual exclusion. */
-	cli_io_init();
+	/* The command output is formatted with the newlib printf family, which
+	may use the floating point registers. */
+	portTASK_USES_FLOATING_POINT();
+
+	/* The console task runs at the idle priority, it gets here once the
+	other tasks are waiting. */
+	boot_profile_mark( "scheduler start" );
+
+	/* No command can be entered before the prompt, they are registered here
+	instead of before the scheduler is started. */
+	vRegisterSampleCLICommands();
+	boot_profile_mark( "command registration" );
 
 	/* Send the welcome message. */
 	cli_io_write( welcome_message, strlen( welcome_message ) );
+	boot_profile_mark( "console prompt" );
+
+	( void ) watchdog_attach( NULL, cmdWATCHDOG_PERIOD_MS );
 
 	for( ;; )
 	{
-		/* Wait for the next character to arrive.  A semaphore is used to
-		ensure no CPU time is used until data has arrived. */
-		cli_io_read( ( uint8_t * ) &cRxedChar, sizeof( cRxedChar ) );
-		if( xSemaphoreTake( xRxCompleteSemaphore, portMAX_DELAY ) == pdPASS ) {
+		watchdog_heartbeat();
+
+		/* Wait for the next characters to arrive. */
+		ulRxedCount = spsc_ring_receive( &xRxRing, cRxedChars, sizeof( cRxedChars ), cmdHEARTBEAT_WAIT );
+
+		for( i = 0; i < ulRxedCount; i++ ) {
 			/* Echo the character back. */
-			cli_io_write( &cRxedChar, sizeof( cRxedChar ) );
+			cli_io_write( &cRxedChars[ i ], sizeof( cRxedChars[ i ] ) );
 
 			/* Was it the end of the line? */
-			if (true == is_end_of_line(cRxedChar)) {
+			if (true == is_end_of_line(cRxedChars[ i ])) {
 				process_command();				
 			} else {
-				process_input(&cRxedChar);
+				process_input(&cRxedChars[ i ]);
 			}
 		}
 	}
@@ -187,7 +253,9 @@ static void process_command(void)
 	(indicating there is no more output) as it might generate more than	one string. */
 
 	portBASE_TYPE xReturned;
-	
+
+	xSemaphoreTake( xCommandMutex, portMAX_DELAY );
+
 	do {
 		/* Get the next output string from the command interpreter. */
 		xReturned = commandline_interpreter( input_string_buffer, output_string, configCOMMAND_INT_MAX_OUTPUT_SIZE );
@@ -197,6 +265,8 @@ static void process_command(void)
 	
 	} while( xReturned != pdFALSE );
 
+	xSemaphoreGive( xCommandMutex );
+
 	/* All the strings generated by the input command have been sent.
 	Clear the input	string ready to receive the next command.  Remember
 	the command that was just processed first in case it is to be
@@ -210,23 +280,81 @@ static void process_command(void)
 	cli_io_write( pcEndOfOutputMessage, strlen( pcEndOfOutputMessage ) );
 }
 
+BaseType_t cli_io_execute( const char *pcCommand, char *pcOutput, size_t xOutputSize, cli_output_t xOutput, void *pvArg, TickType_t xWait )
+{
+	portBASE_TYPE xReturned;
+
+	configASSERT( pcCommand );
+	configASSERT( pcOutput );
+	configASSERT( xOutput );
+
+	if( xSemaphoreTake( xCommandMutex, xWait ) != pdPASS ) {
+		return pdFAIL;
+	}
+
+	do {
+		pcOutput[ 0 ] = '\0';
+		xReturned = commandline_interpreter( pcCommand, pcOutput, xOutputSize );
+
+		xOutput( pcOutput, strlen( pcOutput ), pvArg );
+
+	} while( xReturned != pdFALSE );
+
+	xSemaphoreGive( xCommandMutex );
+
+	return pdPASS;
+}
+
+void cli_io_print( const char *pcBuffer, size_t xBufferLength )
+{
+	cli_io_write( pcBuffer, xBufferLength );
+}
+
 static void cli_io_write(const char * pcBuffer, size_t xBufferLength )
 {
 	const TickType_t xBlockMax100ms = 100UL / portTICK_PERIOD_MS;
+	TickType_t xBlockTime;
+	HAL_StatusTypeDef xStatus;
+
+	if( xBufferLength == 0 ) {
+		return;
+	}
+
+	if( xTaskGetSchedulerState() == taskSCHEDULER_NOT_STARTED ) {
+		/* Nothing else can use the UART before the scheduler is started, and
+		there is no task to block. */
+		HAL_UART_Transmit( &h_uart_cli, ( uint8_t * ) pcBuffer, xBufferLength, HAL_MAX_DELAY );
+		return;
+	}
+
+	/* The time the block takes on the line, 10 bits a character, plus a
+	margin. */
+	xBlockTime = pdMS_TO_TICKS( ( xBufferLength * 10000UL ) / h_uart_cli.Init.BaudRate ) + xBlockMax100ms;
 
-	if( xBufferLength > 0 )
+	if( xSemaphoreTake( xUartMutex, cmdMAX_MUTEX_WAIT ) == pdPASS )
 	{
-		HAL_UART_Transmit_IT( &h_uart_cli, ( uint8_t * ) pcBuffer, xBufferLength );
-		
+		/* DMA1 cannot reach the CCM RAM, a block there is sent by the
+		interrupt. */
+		if( ( ( uint32_t ) pcBuffer & 0xFFFF0000UL ) != CCMDATARAM_BASE ) {
+			xStatus = HAL_UART_Transmit_DMA( &h_uart_cli, ( uint8_t * ) pcBuffer, xBufferLength );
+		} else {
+			xStatus = HAL_UART_Transmit_IT( &h_uart_cli, ( uint8_t * ) pcBuffer, xBufferLength );
+		}
+
 		/* Wait for the Tx to complete so the buffer can be reused without
-		corrupting the data that is being sent. */
-		xSemaphoreTake( xTxCompleteSemaphore, xBlockMax100ms );
-	}
-}
+		corrupting the data that is being sent.  Nothing was started if the
+		UART refused the block, so there is nothing to wait for. */
+		if( ( xStatus == HAL_OK ) && ( xSemaphoreTake( xTxCompleteSemaphore, xBlockTime ) != pdPASS ) ) {
+			/* The handle stays busy after a timeout and the DMA would go on
+			reading the buffer.  Stop the transfer, and take a completion that
+			came in meanwhile, so it does not release the next writer before
+			its own block is sent. */
+			( void ) HAL_UART_AbortTransmit( &h_uart_cli );
+			( void ) xSemaphoreTake( xTxCompleteSemaphore, 0 );
+		}
 
-static void cli_io_read(uint8_t *buf, uint16_t size)
-{
-	HAL_UART_Receive_IT(&h_uart_cli, buf, size);
+		xSemaphoreGive( xUartMutex );
+	}
 }
 
 static void cli_io_init(void)
@@ -236,20 +364,23 @@ static void cli_io_init(void)
 	vSemaphoreCreateBinary( xTxCompleteSemaphore );
 	configASSERT( xTxCompleteSemaphore );
 
-	/* This semaphore is used to allow the task to block for an Rx to complete
-	without wasting any CPU time. */
-	vSemaphoreCreateBinary( xRxCompleteSemaphore );
-	configASSERT( xRxCompleteSemaphore );
-
-	/* Take the semaphores so they start in the wanted state.  A block time is
-	not necessary, and is therefore set to 0, as it is known that the semaphores
-	exists - they have just been created. */
+	/* Take the semaphore so it starts in the wanted state.  A block time is
+	not necessary, and is therefore set to 0, as it is known that the semaphore
+	exists - it has just been created. */
 	xSemaphoreTake( xTxCompleteSemaphore, 0 );
-	xSemaphoreTake( xRxCompleteSemaphore, 0 );
+
+	xUartMutex = xSemaphoreCreateMutex();
+	configASSERT( xUartMutex );
+
+	xCommandMutex = xSemaphoreCreateMutex();
+	configASSERT( xCommandMutex );
+
+	/* The consumer is set once the console task is created. */
+	spsc_ring_init( &xRxRing, ucRxRingStorage, sizeof( ucRxRingStorage ) );
 
 	/* Configure the hardware. */
 	h_uart_cli.Instance          = USART2;
-	h_uart_cli.Init.BaudRate     = 115200;
+	h_uart_cli.Init.BaudRate     = cli_io_baud_rate();
 	h_uart_cli.Init.WordLength   = UART_WORDLENGTH_8B;
 	h_uart_cli.Init.StopBits     = UART_STOPBITS_1;
 	h_uart_cli.Init.Parity       = UART_PARITY_NONE;
@@ -265,7 +396,30 @@ static void cli_io_init(void)
 	
 	/* Register the driver callbacks. */
 	HAL_UART_RegisterCallback(&h_uart_cli, HAL_UART_TX_COMPLETE_CB_ID, cli_io_tx_complete_callback);
-	HAL_UART_RegisterCallback(&h_uart_cli, HAL_UART_RX_COMPLETE_CB_ID, cli_io_rx_complete_callback);
+	HAL_UART_RegisterCallback(&h_uart_cli, HAL_UART_ERROR_CB_ID, cli_io_error_callback);
+
+	/* Reception is never stopped, the characters are taken out of the data
+	register by cli_io_uart_irq_handler(). */
+	__HAL_UART_ENABLE_IT(&h_uart_cli, UART_IT_RXNE);
+}
+
+static uint32_t cli_io_baud_rate(void)
+{
+	static const uint32_t ulRates[] = { 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600 };
+	uint32_t ulRate;
+	uint32_t i;
+
+	/* Only a standard rate is taken, a mistyped one would make the console
+	unusable. */
+	if( true == config_store_get_u32( cmdBAUD_RATE_KEY, &ulRate ) ) {
+		for( i = 0; i < sizeof( ulRates ) / sizeof( ulRates[ 0 ] ); i++ ) {
+			if( ulRate == ulRates[ i ] ) {
+				return ulRate;
+			}
+		}
+	}
+
+	return cmdDEFAULT_BAUD_RATE;
 }
 
 static void cli_io_mspinit(UART_HandleTypeDef* huart)
@@ -286,28 +440,107 @@ static void cli_io_mspinit(UART_HandleTypeDef* huart)
 	GPIO_InitStruct.Alternate = GPIO_AF7_USART2;
 	HAL_GPIO_Init(GPIOA, &GPIO_InitStruct);
 
+	cli_io_dma_init(huart);
+
 	/* USART2 interrupt Init */
 	HAL_NVIC_SetPriority(USART2_IRQn, 5, 0);
 	HAL_NVIC_EnableIRQ(USART2_IRQn);
 }
 
-static void cli_io_rx_complete_callback(UART_HandleTypeDef * huart)
+static void cli_io_dma_init(UART_HandleTypeDef *huart)
 {
-	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+	/* USART2_TX is on DMA1 stream 6, channel 4.  At the end of a transfer the
+	HAL enables the transmit complete interrupt of the UART, the completion is
+	reported by the same callback as for an interrupt driven Tx. */
+	__HAL_RCC_DMA1_CLK_ENABLE();
+
+	h_dma_cli_tx.Instance                 = DMA1_Stream6;
+	h_dma_cli_tx.Init.Channel             = DMA_CHANNEL_4;
+	h_dma_cli_tx.Init.Direction           = DMA_MEMORY_TO_PERIPH;
+	h_dma_cli_tx.Init.PeriphInc           = DMA_PINC_DISABLE;
+	h_dma_cli_tx.Init.MemInc              = DMA_MINC_ENABLE;
+	h_dma_cli_tx.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;
+	h_dma_cli_tx.Init.MemDataAlignment    = DMA_MDATAALIGN_BYTE;
+	h_dma_cli_tx.Init.Mode                = DMA_NORMAL;
+	h_dma_cli_tx.Init.Priority            = DMA_PRIORITY_LOW;
+	h_dma_cli_tx.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
+
+	while( HAL_DMA_Init( &h_dma_cli_tx ) != HAL_OK ) {
+		/* Init code only, as for the UART. */
+	}
 
-	/* Remove compiler warnings. */
-	( void ) huart;
+	__HAL_LINKDMA(huart, hdmatx, h_dma_cli_tx);
 
-	/* Give the semaphore  to unblock any tasks that might be waiting for an Rx
-	to complete.  If a task is unblocked, and the unblocked task has a priority
-	above the currently running task, then xHigherPriorityTaskWoken will be set
-	to pdTRUE inside the xSemaphoreGiveFromISR() function. */
-	xSemaphoreGiveFromISR( xRxCompleteSemaphore, &xHigherPriorityTaskWoken );
+	HAL_NVIC_SetPriority(DMA1_Stream6_IRQn, 5, 0);
+	HAL_NVIC_EnableIRQ(DMA1_Stream6_IRQn);
+}
+
+void cli_io_uart_irq_handler( void )
+{
+	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
+	uint32_t ulStatus;
+	uint8_t ucRxedChar;
+
+	/* The received character is read here instead of by the HAL, which would
+	need HAL_UART_Receive_IT() to be called again for every character.  Reading
+	SR and then DR clears RXNE together with the error flags, so the HAL only
+	sees the Tx events.  DR is also read for an error without RXNE, an overrun
+	left to the HAL would end the reception by disabling RXNEIE. */
+	ulStatus = h_uart_cli.Instance->SR;
+	if( ( ulStatus & ( USART_SR_RXNE | USART_SR_ORE | USART_SR_NE | USART_SR_FE | USART_SR_PE ) ) != 0U ) {
+		ucRxedChar = ( uint8_t ) h_uart_cli.Instance->DR;
+
+		/* A character that does not fit is dropped and counted by the ring
+		buffer. */
+		if( ( ulStatus & USART_SR_RXNE ) != 0U ) {
+			spsc_ring_write_from_isr( &xRxRing, &ucRxedChar, sizeof( ucRxedChar ), &xHigherPriorityTaskWoken );
+		}
+	}
+
+	HAL_UART_IRQHandler( &h_uart_cli );
 
-	/* portEND_SWITCHING_ISR() or portYIELD_FROM_ISR() can be used here. */
 	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
+void cli_io_dma_irq_handler( void )
+{
+	HAL_DMA_IRQHandler( &h_dma_cli_tx );
+}
+
+void cli_io_clock_change_begin( void )
+{
+	uint32_t ulStart;
+
+	/* Stop the interrupt and the DMA from loading the next character, then
+	let the one in the shift register finish.  TC is set once the data
+	register is empty and the last stop bit has been sent.  The DMA interrupt
+	clears DMAT at the end of a transfer, so the bit is read and cleared with
+	it masked. */
+	HAL_NVIC_DisableIRQ( USART2_IRQn );
+
+	taskENTER_CRITICAL();
+	ulTxDmaPaused = h_uart_cli.Instance->CR3 & USART_CR3_DMAT;
+	CLEAR_BIT( h_uart_cli.Instance->CR3, USART_CR3_DMAT );
+	taskEXIT_CRITICAL();
+
+	ulStart = timebase_get_us();
+	while( ( ( h_uart_cli.Instance->SR & USART_SR_TC ) == 0U ) &&
+		   ( ( timebase_get_us() - ulStart ) < cmdCLOCK_CHANGE_TIMEOUT_US ) ) {
+	}
+}
+
+void cli_io_clock_change_end( void )
+{
+	/* The baud rate divider is derived from PCLK1, which may have changed
+	together with the system clock.  A pending transmission or a received
+	character is picked up once the interrupt is enabled again. */
+	h_uart_cli.Instance->BRR = UART_BRR_SAMPLING16( HAL_RCC_GetPCLK1Freq(), h_uart_cli.Init.BaudRate );
+
+	SET_BIT( h_uart_cli.Instance->CR3, ulTxDmaPaused );
+
+	HAL_NVIC_EnableIRQ( USART2_IRQn );
+}
+
 static void cli_io_tx_complete_callback(UART_HandleTypeDef * huart)
 {
 	portBASE_TYPE xHigherPriorityTaskWoken = pdFALSE;
@@ -325,4 +558,12 @@ static void cli_io_tx_complete_callback(UART_HandleTypeDef * huart)
 	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
+static void cli_io_error_callback(UART_HandleTypeDef * huart)
+{
+	/* A receive error that came in after cli_io_uart_irq_handler() read SR
+	makes the HAL abort the reception, which clears RXNEIE.  Reception is
+	never stopped on the console, so it is enabled again. */
+	__HAL_UART_ENABLE_IT( huart, UART_IT_RXNE );
+}
+
 
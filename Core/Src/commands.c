@@ -45,7 +45,30 @@
 /* FreeRTOS+CLI includes. */
 #include "FreeRTOS_CLI.h"
 
-#include "rtc.h"
+#include "timekeeping.h"
+#include "time_format.h"
+#include "timer_bench.h"
+#include "task_budget.h"
+#include "edf_bench.h"
+#include "work_queue.h"
+#include "work_bench.h"
+#include "dsp_chain.h"
+#include "dsp_bench.h"
+#include "mpu_guard.h"
+#include "mpu_bench.h"
+#include "art_bench.h"
+#include "dfs.h"
+#include "config_store.h"
+#include "binlog.h"
+#include "binlog_bench.h"
+#include "stdio_uart.h"
+#include "newlib_heap.h"
+#include "crash_dump.h"
+#include "watchdog.h"
+#include "boot_profile.h"
+#include "rtc_calib.h"
+#include "time_format_bench.h"
+#include "cron.h"
 
 #ifndef  configINCLUDE_TRACE_RELATED_CLI_COMMANDS
 	#define configINCLUDE_TRACE_RELATED_CLI_COMMANDS 0
@@ -85,14 +108,35 @@ static portBASE_TYPE get_date( char *pcWriteBuffer, size_t xWriteBufferLen, cons
 static portBASE_TYPE get_time( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
 static portBASE_TYPE set_date( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
 static portBASE_TYPE set_time( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE run_timer_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE task_budget( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE run_edf_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE edf_stats( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE work_queue_stats( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE run_work_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE fpu_stats( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE dsp_chain( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE run_dsp_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE mpu_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE run_mpu_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE run_art_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE dfs_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE config_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE binlog_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE run_binlog_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE stdio_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE heap_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE crash_dump_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE watchdog_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE boot_profile_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE clock_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE rtc_calib_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE run_time_format_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
+static portBASE_TYPE cron_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString );
 
-static void convert_time_to_string(uint8_t hours, uint8_t minutes, uint8_t seconds, char *time_string);
-static void convert_date_to_string(uint8_t day, uint8_t month, uint8_t year, char *date_string);
-static void convert_string_to_time(uint8_t *hours, uint8_t *minutes, uint8_t *seconds, char *time_string);
-static void convert_string_to_date(uint8_t *day, uint8_t *month, uint8_t *year, char *date_string);
 static bool is_number(char s);
-static bool is_time_command_string_valid(char *time_string, BaseType_t len);
-static bool is_date_command_string_valid(char *date_string, BaseType_t len);
+static bool parse_number(const char *param, BaseType_t len, uint32_t *value);
+static bool parse_time_us(const char *param, BaseType_t len, uint64_t *epoch_us);
 
 /* Structure that defines the "run-time-stats" command line command.   This
 generates a table that shows how much run time each task has */
@@ -161,9 +205,9 @@ static const CLI_Command_Definition_t kernel_version =
 static const CLI_Command_Definition_t get_date_cmd = 
 {
 	"date",
-	"\r\ndate:\r\n Displays the date in dd/mm/yy format\r\n",
+	"\r\ndate [<format>]:\r\n Displays the date in dd/mm/yy format, or the UTC time in a format such as %Y-%m-%dT%H:%M:%S.%f%z (see time_format.h)\r\n",
 	get_date,
-	0
+	-1
 };
 
 
@@ -191,6 +235,206 @@ static const CLI_Command_Definition_t set_time_cmd =
 	1
 };
 
+static const CLI_Command_Definition_t timer_bench_cmd =
+{
+	"timer-bench",
+	"\r\ntimer-bench:\r\n Measures the CPU cycles of xTimerStart/Reset/Stop and of batched resets with 10, 100 and 1000 active timers\r\n",
+	run_timer_bench,
+	0
+};
+
+static const CLI_Command_Definition_t task_budget_cmd =
+{
+	"task-budget",
+	"\r\ntask-budget [<task> <budget_us> <period_ms> <log|demote|suspend> | <task> off]:\r\n Without parameters displays the CPU time used by the tasks that have a budget, otherwise sets or removes the budget of a task\r\n",
+	task_budget,
+	-1
+};
+
+static const CLI_Command_Definition_t edf_bench_cmd =
+{
+	"edf-bench",
+	"\r\nedf-bench:\r\n Runs a periodic task set with rate monotonic priorities and with EDF scheduling and displays the deadline misses of both\r\n",
+	run_edf_bench,
+	0
+};
+
+static const CLI_Command_Definition_t edf_stats_cmd =
+{
+	"edf-stats",
+	"\r\nedf-stats:\r\n Displays the deadline parameters (in ticks), the jobs and the deadline misses of the EDF scheduled tasks\r\n",
+	edf_stats,
+	0
+};
+
+static const CLI_Command_Definition_t work_queue_cmd =
+{
+	"work-queue",
+	"\r\nwork-queue:\r\n Displays the number of work items run by each worker task, their worst latency and run time\r\n",
+	work_queue_stats,
+	0
+};
+
+static const CLI_Command_Definition_t work_bench_cmd =
+{
+	"work-bench",
+	"\r\nwork-bench:\r\n Measures the delay from an interrupt to its deferred work for each work queue level and for the timer daemon\r\n",
+	run_work_bench,
+	0
+};
+
+static const CLI_Command_Definition_t fpu_stats_cmd =
+{
+	"fpu-stats",
+	"\r\nfpu-stats:\r\n Displays the number of context switches and how many of them saved floating point state\r\n",
+	fpu_stats,
+	0
+};
+
+static const CLI_Command_Definition_t dsp_cmd =
+{
+	"dsp",
+	"\r\ndsp [filter <off|fir <hz>|iir <hz>> | decimate <n> | tone <hz> <hz>]:\r\n Without parameters displays the state of the signal chain, otherwise sets the filter, the decimation or the test tones\r\n",
+	dsp_chain,
+	-1
+};
+
+static const CLI_Command_Definition_t dsp_bench_cmd =
+{
+	"dsp-bench",
+	"\r\ndsp-bench:\r\n Measures the CPU cycles per sample of the plain C and the SIMD signal processing kernels\r\n",
+	run_dsp_bench,
+	0
+};
+
+static const CLI_Command_Definition_t mpu_cmd =
+{
+	"mpu",
+	"\r\nmpu:\r\n Displays the state of the MPU, the size of the privileged sections and the faults trapped from unprivileged tasks\r\n",
+	mpu_state,
+	0
+};
+
+static const CLI_Command_Definition_t mpu_bench_cmd =
+{
+	"mpu-bench",
+	"\r\nmpu-bench:\r\n Measures the CPU cycles of kernel calls and task switches of privileged and unprivileged tasks\r\n",
+	run_mpu_bench,
+	0
+};
+
+static const CLI_Command_Definition_t art_bench_cmd =
+{
+	"art-bench",
+	"\r\nart-bench:\r\n Measures the CPU cycles of the scheduler, queue and CLI hot paths with each flash accelerator setting, and of code in flash against code in SRAM\r\n",
+	run_art_bench,
+	0
+};
+
+static const CLI_Command_Definition_t dfs_cmd =
+{
+	"dfs",
+	"\r\ndfs [auto | opp <n>]:\r\n Without parameters displays the operating point, the CPU load and the time spent at each operating point, otherwise lets the governor choose the operating point or fixes it\r\n",
+	dfs_state,
+	-1
+};
+
+static const CLI_Command_Definition_t config_cmd =
+{
+	"config",
+	"\r\nconfig [list | get <key> | set <key> <value> | delete <key>]:\r\n Displays, sets or removes the settings kept in flash, without parameters lists them\r\n",
+	config_command,
+	-1
+};
+
+static const CLI_Command_Definition_t binlog_cmd =
+{
+	"binlog",
+	"\r\nbinlog:\r\n Displays the number of logged, dropped and waiting messages of the deferred binary logger\r\n",
+	binlog_state,
+	0
+};
+
+static const CLI_Command_Definition_t binlog_bench_cmd =
+{
+	"binlog-bench",
+	"\r\nbinlog-bench:\r\n Measures the CPU cycles of a deferred log call and of formatting the same message with snprintf\r\n",
+	run_binlog_bench,
+	0
+};
+
+static const CLI_Command_Definition_t stdio_cmd =
+{
+	"stdio",
+	"\r\nstdio:\r\n Displays the number of lines and bytes printed through stdout and stderr, and the line buffers in use\r\n",
+	stdio_state,
+	0
+};
+
+static const CLI_Command_Definition_t heap_cmd =
+{
+	"heap",
+	"\r\nheap:\r\n Displays the blocks and bytes allocated by malloc() and the free space of the FreeRTOS heap\r\n",
+	heap_state,
+	0
+};
+
+static const CLI_Command_Definition_t crash_dump_cmd =
+{
+	"crash-dump",
+	"\r\ncrash-dump [raw | clear]:\r\n Displays the record of the last fault, failed assertion or stack overflow, raw prints it for Tools/crash_decode.py, clear removes it\r\n",
+	crash_dump_command,
+	-1
+};
+
+static const CLI_Command_Definition_t watchdog_cmd =
+{
+	"watchdog",
+	"\r\nwatchdog [hang]:\r\n Displays the last reset cause, the task that caused the last watchdog reset and the heartbeats, hang stops the heartbeat of the console task\r\n",
+	watchdog_command,
+	-1
+};
+
+static const CLI_Command_Definition_t boot_profile_cmd =
+{
+	"boot-profile",
+	"\r\nboot-profile:\r\n Displays the start and the duration of the boot phases, from the reset to the console prompt\r\n",
+	boot_profile_state,
+	0
+};
+
+static const CLI_Command_Definition_t clock_cmd =
+{
+	"clock",
+	"\r\nclock [set <time> | sync <time> | clear-drift]:\r\n Displays the time and its corrections, set steps the clock to a time in seconds since 1970 with up to 6 decimals or in ISO 8601, sync corrects it with a host reference (see Tools/clock_sync.py), clear-drift removes the rate correction\r\n",
+	clock_command,
+	-1
+};
+
+static const CLI_Command_Definition_t rtc_calib_cmd =
+{
+	"rtc-calib",
+	"\r\nrtc-calib [run]:\r\n Displays the LSI frequency measured against the HSE, the error of the RTC and its calibration, run measures it now\r\n",
+	rtc_calib_command,
+	-1
+};
+
+static const CLI_Command_Definition_t time_format_bench_cmd =
+{
+	"time-format-bench",
+	"\r\ntime-format-bench:\r\n Measures the CPU cycles of formatting and parsing ISO 8601 timestamps with time_format.c and of formatting them with snprintf\r\n",
+	run_time_format_bench,
+	0
+};
+
+static const CLI_Command_Definition_t cron_cmd =
+{
+	"cron",
+	"\r\ncron [(every <s> | at <hh:mm:ss>) [console | log | none] <command> | remove <id> | output]:\r\n Lists the scheduled commands, every runs a command at an interval in seconds, at runs it daily at a UTC time, its output goes to the console (default), to the log that output prints, or nowhere\r\n",
+	cron_command,
+	-1
+};
+
 
 /*-----------------------------------------------------------*/
 
@@ -206,6 +450,31 @@ void vRegisterSampleCLICommands( void )
 	FreeRTOS_CLIRegisterCommand( &get_time_cmd );
 	FreeRTOS_CLIRegisterCommand( &set_date_cmd );
 	FreeRTOS_CLIRegisterCommand( &set_time_cmd );
+	FreeRTOS_CLIRegisterCommand( &timer_bench_cmd );
+	FreeRTOS_CLIRegisterCommand( &task_budget_cmd );
+	FreeRTOS_CLIRegisterCommand( &edf_bench_cmd );
+	FreeRTOS_CLIRegisterCommand( &edf_stats_cmd );
+	FreeRTOS_CLIRegisterCommand( &work_queue_cmd );
+	FreeRTOS_CLIRegisterCommand( &work_bench_cmd );
+	FreeRTOS_CLIRegisterCommand( &fpu_stats_cmd );
+	FreeRTOS_CLIRegisterCommand( &dsp_cmd );
+	FreeRTOS_CLIRegisterCommand( &dsp_bench_cmd );
+	FreeRTOS_CLIRegisterCommand( &mpu_cmd );
+	FreeRTOS_CLIRegisterCommand( &mpu_bench_cmd );
+	FreeRTOS_CLIRegisterCommand( &art_bench_cmd );
+	FreeRTOS_CLIRegisterCommand( &dfs_cmd );
+	FreeRTOS_CLIRegisterCommand( &config_cmd );
+	FreeRTOS_CLIRegisterCommand( &binlog_cmd );
+	FreeRTOS_CLIRegisterCommand( &binlog_bench_cmd );
+	FreeRTOS_CLIRegisterCommand( &stdio_cmd );
+	FreeRTOS_CLIRegisterCommand( &heap_cmd );
+	FreeRTOS_CLIRegisterCommand( &crash_dump_cmd );
+	FreeRTOS_CLIRegisterCommand( &watchdog_cmd );
+	FreeRTOS_CLIRegisterCommand( &boot_profile_cmd );
+	FreeRTOS_CLIRegisterCommand( &clock_cmd );
+	FreeRTOS_CLIRegisterCommand( &rtc_calib_cmd );
+	FreeRTOS_CLIRegisterCommand( &time_format_bench_cmd );
+	FreeRTOS_CLIRegisterCommand( &cron_cmd );
 
 	#if( configINCLUDE_TRACE_RELATED_CLI_COMMANDS == 1 )
 	{
@@ -460,18 +729,40 @@ static portBASE_TYPE get_kernel_version( char *pcWriteBuffer, size_t xWriteBuffe
 
 static portBASE_TYPE get_date( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
-	( void ) pcCommandString;
-	( void ) xWriteBufferLen;
+	const char *pattern = TIME_FORMAT_DATE;
+	char pattern_text[ TIME_FORMAT_MAX_ITEMS * 2U + 1U ];
+	const char *param;
+	BaseType_t param_len;
+	BaseType_t extra_len;
+	time_format_t format;
+
 	configASSERT( pcWriteBuffer );
 
-	uint8_t day;
-	uint8_t month;
-	uint8_t year;
-	RTC_GetDate(&day, &month, &year);
+	if (true != timekeeping_is_ready()) {
+		strcpy(pcWriteBuffer, "Clock not ready.\r\n");
+		return pdFALSE;
+	}
 
-	strcpy(pcWriteBuffer, "\r\n");
-	convert_date_to_string(day, month, year, pcWriteBuffer + 2);
-	strcpy(pcWriteBuffer + 10, "\r\n"); 	
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
+	if (param != NULL) {
+		if ((FreeRTOS_CLIGetParameter(pcCommandString, 2, &extra_len) != NULL) ||
+			((size_t)param_len >= sizeof(pattern_text))) {
+			strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+			return pdFALSE;
+		}
+		memcpy(pattern_text, param, (size_t)param_len);
+		pattern_text[param_len] = '\0';
+		pattern = pattern_text;
+	}
+
+	if ((true != time_format_compile(&format, pattern, 0)) || (xWriteBufferLen < 5U) ||
+		(0U == time_format_us(&format, timekeeping_get_us(), pcWriteBuffer + 2, xWriteBufferLen - 4U))) {
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+		return pdFALSE;
+	}
+
+	memcpy(pcWriteBuffer, "\r\n", 2U);
+	strcat(pcWriteBuffer, "\r\n");
 
 	return pdFALSE;
 }
@@ -479,246 +770,781 @@ static portBASE_TYPE get_date( char *pcWriteBuffer, size_t xWriteBufferLen, cons
 static portBASE_TYPE get_time( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
 	( void ) pcCommandString;
-	( void ) xWriteBufferLen;
 	configASSERT( pcWriteBuffer );
 
-	uint8_t hours;
-	uint8_t minutes;
-	uint8_t seconds;
-	RTC_GetTime(&hours, &minutes, &seconds);
+	if (true != timekeeping_is_ready()) {
+		strcpy(pcWriteBuffer, "Clock not ready.\r\n");
+		return pdFALSE;
+	}
+
+	time_format_t format;
+	( void ) time_format_compile(&format, TIME_FORMAT_TIME, 0);
 
 	strcpy(pcWriteBuffer, "\r\n");
-	convert_time_to_string(hours, minutes, seconds, pcWriteBuffer + 2);
-	strcpy(pcWriteBuffer + 10, "\r\n");
+	( void ) time_format_us(&format, timekeeping_get_us(), pcWriteBuffer + 2, xWriteBufferLen - 4U);
+	strcat(pcWriteBuffer, "\r\n");
 
 	return pdFALSE;
 }
 
 static portBASE_TYPE set_date( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
-	( void ) xWriteBufferLen;
 	configASSERT( pcWriteBuffer );
+
+	if (true != timekeeping_is_ready()) {
+		strcpy(pcWriteBuffer, "Clock not ready.\r\n");
+		return pdFALSE;
+	}
 	BaseType_t param_len;
 
 	const char *date_to_set = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
 	configASSERT( date_to_set );
-	if (true != is_date_command_string_valid(date_to_set, param_len)) {
-		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+
+	time_format_t format;
+	uint64_t epoch_us;
+	( void ) time_format_compile(&format, TIME_FORMAT_DATE, 0);
+
+	/* The time of the day is kept. */
+	if ((true == time_format_parse_us(&format, date_to_set, (size_t)param_len, timekeeping_get_us(), &epoch_us)) &&
+		(true == timekeeping_set_us(epoch_us))) {
+		char *date_set_to_string = "\r\nDate set to ";
+		strcpy(pcWriteBuffer, date_set_to_string);
+
+		( void ) time_format_us(&format, timekeeping_get_us(), pcWriteBuffer + strlen(date_set_to_string),
+			xWriteBufferLen - strlen(date_set_to_string) - 2U);
+		strcat(pcWriteBuffer, "\r\n");
 	} else {
-		uint8_t day;
-		uint8_t month;
-		uint8_t year;
-		
-		convert_string_to_date(&day, &month, &year, date_to_set);
-
-		if (true == RTC_SetDate(day, month, year)) {
-			char *date_set_to_string = "\r\nDate set to ";
-			strcpy(pcWriteBuffer, date_set_to_string);
-
-			uint8_t gday;
-			uint8_t gmonth;
-			uint8_t gyear;
-			RTC_GetDate(&gday, &gmonth, &gyear);
-			convert_date_to_string(gday, gmonth, gyear, pcWriteBuffer + strlen(date_set_to_string));
-			strcpy(pcWriteBuffer + strlen(date_set_to_string) + 8, "\r\n");
-		} else {
-			strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
-		}
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
 	}
-	
+
 	return pdFALSE;
 }
 
 static portBASE_TYPE set_time( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
-	( void ) xWriteBufferLen;
 	configASSERT( pcWriteBuffer );
+
+	if (true != timekeeping_is_ready()) {
+		strcpy(pcWriteBuffer, "Clock not ready.\r\n");
+		return pdFALSE;
+	}
 	BaseType_t param_len;
 
 	const char *time_to_set = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
 	configASSERT( time_to_set );
-	if (true != is_time_command_string_valid(time_to_set, param_len)) {
-		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+
+	time_format_t format;
+	uint64_t epoch_us;
+	uint64_t now_us = timekeeping_get_us();
+	( void ) time_format_compile(&format, TIME_FORMAT_TIME, 0);
+
+	/* The date is kept, the second starts now. */
+	now_us = now_us - (now_us % TIMEKEEPING_US_PER_SECOND);
+	if ((true == time_format_parse_us(&format, time_to_set, (size_t)param_len, now_us, &epoch_us)) &&
+		(true == timekeeping_set_us(epoch_us))) {
+		char *time_set_to_string = "\r\nTime set to ";
+		strcpy(pcWriteBuffer, time_set_to_string);
+
+		( void ) time_format_us(&format, timekeeping_get_us(), pcWriteBuffer + strlen(time_set_to_string),
+			xWriteBufferLen - strlen(time_set_to_string) - 2U);
+		strcat(pcWriteBuffer, "\r\n");
 	} else {
-		uint8_t hours;
-		uint8_t minutes;
-		uint8_t seconds;
-		
-		convert_string_to_time(&hours, &minutes, &seconds, time_to_set);
-
-		if (true == RTC_SetTime(hours, minutes, seconds)) {
-			char *time_set_to_string = "\r\nTime set to ";
-			strcpy(pcWriteBuffer, time_set_to_string);
-
-			uint8_t ghours;
-			uint8_t gminutes;
-			uint8_t gseconds;
-			RTC_GetTime(&ghours, &gminutes, &gseconds);
-			convert_time_to_string(ghours, gminutes, gseconds, pcWriteBuffer + strlen(time_set_to_string));
-			strcpy(pcWriteBuffer + strlen(time_set_to_string) + 8, "\r\n");
-		} else {
-			strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
-		}
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
 	}
 
 	return pdFALSE;
 }
 
-static void convert_date_to_string(uint8_t day, uint8_t month, uint8_t year, char *date_string)
+static portBASE_TYPE run_timer_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
-	configASSERT( date_string );
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
 
-	if (day < 10) {
-		date_string[0] = '0';
-		date_string[1] = (char)day + '0';
-	} else if (day <= 31) {
-		date_string[0] = (char)(day / 10) + '0';
-		date_string[1] = (char)(day % 10) + '0';
-	} else {
-		date_string[0] = '?';
-		date_string[1] = '?';
+	timer_bench_run(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE task_budget( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	static const char * const policy_names[] = { "log", "demote", "suspend" };
+	char task_name[ configMAX_TASK_NAME_LEN ];
+	TaskHandle_t task;
+	const char *param;
+	BaseType_t param_len;
+	uint32_t budget_us;
+	uint32_t period_ms;
+	uint32_t policy;
+
+	configASSERT( pcWriteBuffer );
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
+	if (param == NULL) {
+		task_budget_print(pcWriteBuffer, xWriteBufferLen);
+		return pdFALSE;
 	}
 
-	date_string[2] = '/';
+	task = NULL;
+	if ((size_t)param_len < sizeof(task_name)) {
+		memcpy(task_name, param, param_len);
+		task_name[param_len] = '\0';
+		task = xTaskGetHandle(task_name);
+	}
 
-	if (month < 10) {
-		date_string[3] = '0';
-		date_string[4] = (char)month + '0';
-	} else if (month <= 12) {
-		date_string[3] = (char)(month / 10) + '0';
-		date_string[4] = (char)(month % 10) + '0';
-	} else {
-		date_string[3] = '?';
-		date_string[4] = '?';
+	if (task == NULL) {
+		strcpy(pcWriteBuffer, "Unknown task.\r\n");
+		return pdFALSE;
 	}
 
-	date_string[5] = '/';
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 2, &param_len);
+	if ((param != NULL) && (param_len == 3) && (strncmp(param, "off", 3) == 0) &&
+		(FreeRTOS_CLIGetParameter(pcCommandString, 3, &param_len) == NULL)) {
+		task_budget_detach(task);
+		snprintf(pcWriteBuffer, xWriteBufferLen, "\r\nBudget of %s removed\r\n", task_name);
+		return pdFALSE;
+	}
 
-	if (year < 10) {
-		date_string[6] = '0';
-		date_string[7] = (char)year + '0';
-	} else {
-		date_string[6] = (char)(year / 10) + '0';
-		date_string[7] = (char)(year % 10) + '0';
+	if ((param == NULL) || (true != parse_number(param, param_len, &budget_us))) {
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+		return pdFALSE;
+	}
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 3, &param_len);
+	if ((param == NULL) || (true != parse_number(param, param_len, &period_ms))) {
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+		return pdFALSE;
+	}
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 4, &param_len);
+	for (policy = 0; (param != NULL) && (policy < sizeof(policy_names) / sizeof(policy_names[0])); policy++) {
+		if (((size_t)param_len == strlen(policy_names[policy])) && (strncmp(param, policy_names[policy], param_len) == 0)) {
+			break;
+		}
+	}
+
+	if ((param == NULL) || (policy == sizeof(policy_names) / sizeof(policy_names[0])) ||
+		(FreeRTOS_CLIGetParameter(pcCommandString, 5, &param_len) != NULL) ||
+		(true != task_budget_attach(task, budget_us, period_ms, (task_budget_policy_t)policy))) {
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+		return pdFALSE;
 	}
+
+	snprintf(pcWriteBuffer, xWriteBufferLen, "\r\nBudget of %s set to %lu us every %lu ms, %s on overrun\r\n",
+		task_name, ( unsigned long ) budget_us, ( unsigned long ) period_ms, policy_names[policy]);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE run_edf_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	edf_bench_run(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
 }
 
-static void convert_time_to_string(uint8_t hours, uint8_t minutes, uint8_t seconds, char *time_string)
+static portBASE_TYPE edf_stats( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
-	configASSERT( time_string );
+	TaskStatus_t *status;
+	EdfTaskStatus_t edf_status;
+	UBaseType_t count;
+	UBaseType_t i;
+	size_t written;
 
-	if (hours < 10) {
-		time_string[0] = '0';
-		time_string[1] = (char)hours + '0';
-	} else if (hours <= 23) {
-		time_string[0] = (char)(hours / 10) + '0';
-		time_string[1] = (char)(hours % 10) + '0';
-	} else {
-		time_string[0] = '?';
-		time_string[1] = '?';
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	/* A few spare entries in case tasks are created in the meantime. */
+	count = uxTaskGetNumberOfTasks() + 2U;
+	status = pvPortMalloc(count * sizeof(TaskStatus_t));
+	if (status == NULL) {
+		strcpy(pcWriteBuffer, "Not enough heap.\r\n");
+		return pdFALSE;
 	}
 
-	time_string[2] = ':';
+	count = uxTaskGetSystemState(status, count, NULL);
 
-	if (minutes < 10) {
-		time_string[3] = '0';
-		time_string[4] = (char)minutes + '0';
-	} else if (minutes <= 59) {
-		time_string[3] = (char)(minutes / 10) + '0';
-		time_string[4] = (char)(minutes % 10) + '0';
-	} else {
-		time_string[3] = '?';
-		time_string[4] = '?';
+	written = snprintf(pcWriteBuffer, xWriteBufferLen,
+		"\r\nDensity: %lu ppm\r\n"
+		"Task              Period  Deadline  WCET us      Jobs  Misses  Max late\r\n",
+		( unsigned long ) ulTaskEdfGetDensity());
+
+	for (i = 0; (i < count) && (written < xWriteBufferLen); i++) {
+		if (xTaskEdfGetInfo(status[i].xHandle, &edf_status) != pdTRUE) {
+			continue;
+		}
+
+		written += snprintf(pcWriteBuffer + written, xWriteBufferLen - written, "%-16s  %6lu  %8lu  %7lu  %8lu  %6lu  %8lu\r\n",
+			status[i].pcTaskName,
+			( unsigned long ) edf_status.xPeriod,
+			( unsigned long ) edf_status.xRelativeDeadline,
+			( unsigned long ) edf_status.ulWcetUs,
+			( unsigned long ) edf_status.ulJobs,
+			( unsigned long ) edf_status.ulMisses,
+			( unsigned long ) edf_status.xMaxLateness);
 	}
 
-	time_string[5] = ':';
+	vPortFree(status);
 
-	if (seconds < 10) {
-		time_string[6] = '0';
-		time_string[7] = (char)seconds + '0';
-	} else if (seconds <= 59) {
-		time_string[6] = (char)(seconds / 10) + '0';
-		time_string[7] = (char)(seconds % 10) + '0';
-	} else {
-		time_string[6] = '?';
-		time_string[7] = '?';
+	return pdFALSE;
+}
+
+static portBASE_TYPE work_queue_stats( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	work_queue_print(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE run_work_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	work_bench_run(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE fpu_stats( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	uint32_t switches;
+	uint32_t fpu_switches;
+	uint32_t permille;
+
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	/* The counters wrap around together after 2^32 switches. */
+	switches = ulPortGetContextSwitchCount();
+	fpu_switches = ulPortGetFpuContextSwitchCount();
+	permille = (switches != 0) ? (uint32_t)(((uint64_t)fpu_switches * 1000U) / switches) : 0;
+
+	snprintf(pcWriteBuffer, xWriteBufferLen,
+		"\r\nFPU access: %s\r\n"
+		"Context switches: %lu\r\n"
+		"With floating point state: %lu (%lu.%lu %%)\r\n",
+		(configUSE_TASK_FPU_SUPPORT == 1) ? "declared tasks only" : "all tasks",
+		( unsigned long ) switches,
+		( unsigned long ) fpu_switches,
+		( unsigned long ) (permille / 10U),
+		( unsigned long ) (permille % 10U));
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE dsp_chain( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	const char *param;
+	const char *value;
+	BaseType_t param_len;
+	BaseType_t value_len;
+	uint32_t number;
+	uint32_t number2;
+	bool retv = false;
+
+	configASSERT( pcWriteBuffer );
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
+	if (param == NULL) {
+		dsp_chain_print(pcWriteBuffer, xWriteBufferLen);
+		return pdFALSE;
+	}
+
+	value = FreeRTOS_CLIGetParameter(pcCommandString, 2, &value_len);
+
+	if ((param_len == 6) && (strncmp(param, "filter", 6) == 0) && (value != NULL)) {
+		if ((value_len == 3) && (strncmp(value, "off", 3) == 0)) {
+			retv = (FreeRTOS_CLIGetParameter(pcCommandString, 3, &param_len) == NULL) &&
+				dsp_chain_set_filter(DSP_CHAIN_FILTER_NONE, 0);
+		} else if ((value_len == 3) && ((strncmp(value, "fir", 3) == 0) || (strncmp(value, "iir", 3) == 0))) {
+			param = FreeRTOS_CLIGetParameter(pcCommandString, 3, &param_len);
+			retv = (param != NULL) && (true == parse_number(param, param_len, &number)) &&
+				(FreeRTOS_CLIGetParameter(pcCommandString, 4, &param_len) == NULL) &&
+				dsp_chain_set_filter((value[0] == 'f') ? DSP_CHAIN_FILTER_FIR : DSP_CHAIN_FILTER_IIR, number);
+		}
+	} else if ((param_len == 8) && (strncmp(param, "decimate", 8) == 0) && (value != NULL)) {
+		retv = (true == parse_number(value, value_len, &number)) &&
+			(FreeRTOS_CLIGetParameter(pcCommandString, 3, &param_len) == NULL) &&
+			dsp_chain_set_decimation(number);
+	} else if ((param_len == 4) && (strncmp(param, "tone", 4) == 0) && (value != NULL)) {
+		param = FreeRTOS_CLIGetParameter(pcCommandString, 3, &param_len);
+		retv = (true == parse_number(value, value_len, &number)) &&
+			(param != NULL) && (true == parse_number(param, param_len, &number2)) &&
+			(FreeRTOS_CLIGetParameter(pcCommandString, 4, &param_len) == NULL) &&
+			dsp_chain_set_tones(number, number2);
+	}
+
+	if (true != retv) {
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+		return pdFALSE;
 	}
+
+	dsp_chain_print(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
 }
 
-static bool is_number(char s)
+static portBASE_TYPE run_dsp_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	dsp_bench_run(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE mpu_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	mpu_guard_print(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE run_mpu_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	mpu_bench_run(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE run_art_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	art_bench_run(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE dfs_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	const char *param;
+	const char *value;
+	BaseType_t param_len;
+	BaseType_t value_len;
+	uint32_t number;
 	bool retv = false;
 
-	if (s >= '0' && s <= '9') {
-		retv = true;
+	configASSERT( pcWriteBuffer );
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
+	if (param == NULL) {
+		dfs_print(pcWriteBuffer, xWriteBufferLen);
+		return pdFALSE;
 	}
 
-	return retv;
+	value = FreeRTOS_CLIGetParameter(pcCommandString, 2, &value_len);
+
+	if ((param_len == 4) && (strncmp(param, "auto", 4) == 0) && (value == NULL)) {
+		retv = dfs_set_mode(DFS_MODE_AUTO, 0);
+	} else if ((param_len == 3) && (strncmp(param, "opp", 3) == 0) && (value != NULL)) {
+		retv = (true == parse_number(value, value_len, &number)) &&
+			(FreeRTOS_CLIGetParameter(pcCommandString, 3, &param_len) == NULL) &&
+			dfs_set_mode(DFS_MODE_FIXED, number);
+	}
+
+	if (true != retv) {
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+		return pdFALSE;
+	}
+
+	dfs_print(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
 }
 
-static bool is_time_command_string_valid(char *time_string, BaseType_t len)
+static portBASE_TYPE config_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
-	bool retv = true;
-	if (len < 8) {
-		retv = false;
+	char key[ CONFIG_STORE_KEY_MAX + 1U ];
+	const char *param;
+	const char *value;
+	BaseType_t param_len;
+	BaseType_t key_len;
+	size_t value_len;
+	bool retv = false;
+
+	configASSERT( pcWriteBuffer );
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
+	if ((param == NULL) || ((param_len == 4) && (strncmp(param, "list", 4) == 0))) {
+		config_store_print(pcWriteBuffer, xWriteBufferLen);
+		return pdFALSE;
 	}
 
-	if (time_string[2] != ':' || time_string[5] != ':') {
-		retv = false;
+	value = FreeRTOS_CLIGetParameter(pcCommandString, 2, &key_len);
+	if ((value == NULL) || (key_len > (BaseType_t)CONFIG_STORE_KEY_MAX)) {
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+		return pdFALSE;
 	}
 
-	uint8_t non_number_chars = 0;
-	for (uint8_t i = 0; i < len; i++) {
-		if (true != is_number(time_string[i])) {
-			non_number_chars = non_number_chars + 1;
+	memcpy(key, value, key_len);
+	key[key_len] = '\0';
+
+	if ((param_len == 3) && (strncmp(param, "get", 3) == 0) &&
+		(FreeRTOS_CLIGetParameter(pcCommandString, 3, &param_len) == NULL)) {
+		if ((xWriteBufferLen > 2) && (true == config_store_get(key, pcWriteBuffer, xWriteBufferLen - 2))) {
+			strcat(pcWriteBuffer, "\r\n");
+		} else {
+			strcpy(pcWriteBuffer, "Not found.\r\n");
+		}
+		return pdFALSE;
+	} else if ((param_len == 3) && (strncmp(param, "set", 3) == 0)) {
+		/* The value is the rest of the line, it may contain spaces. */
+		value = FreeRTOS_CLIGetParameter(pcCommandString, 3, &param_len);
+		if (value != NULL) {
+			value_len = strlen(value);
+			while ((value_len > 0) && (value[value_len - 1U] == ' ')) {
+				value_len--;
+			}
+
+			if (value_len < xWriteBufferLen) {
+				/* The output buffer is free until the command returns. */
+				memmove(pcWriteBuffer, value, value_len);
+				pcWriteBuffer[value_len] = '\0';
+				retv = config_store_set(key, pcWriteBuffer);
+			}
 		}
+	} else if ((param_len == 6) && (strncmp(param, "delete", 6) == 0) &&
+		(FreeRTOS_CLIGetParameter(pcCommandString, 3, &param_len) == NULL)) {
+		retv = config_store_delete(key);
 	}
 
-	if (2 != non_number_chars) {
-		retv = false;
+	if (true != retv) {
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+		return pdFALSE;
 	}
 
-	return retv;
+	snprintf(pcWriteBuffer, xWriteBufferLen, "%s %s.\r\n", key, (param[0] == 's') ? "set" : "deleted");
+
+	return pdFALSE;
 }
 
-static bool is_date_command_string_valid(char *date_string, BaseType_t len)
+static portBASE_TYPE binlog_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
-	bool retv = true;
-	if (len < 8) {
-		retv = false;
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	binlog_print(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE run_binlog_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	binlog_bench_run(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE stdio_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	stdio_uart_print(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE heap_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	newlib_heap_print(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE crash_dump_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	static uint32_t offset = 0;
+	const char *param;
+	BaseType_t param_len;
+	BaseType_t extra_len;
+
+	configASSERT( pcWriteBuffer );
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
+	if (param == NULL) {
+		crash_dump_print(pcWriteBuffer, xWriteBufferLen);
+		return pdFALSE;
 	}
 
-	if (date_string[2] != '/' || date_string[5] != '/') {
-		retv = false;
+	if (FreeRTOS_CLIGetParameter(pcCommandString, 2, &extra_len) == NULL) {
+		if ((param_len == 3) && (strncmp(param, "raw", 3) == 0)) {
+			/* The record is longer than the output buffer, the command is
+			called again until it is printed. */
+			if (true == crash_dump_print_raw(pcWriteBuffer, xWriteBufferLen, &offset)) {
+				return pdTRUE;
+			}
+			offset = 0;
+			return pdFALSE;
+		} else if ((param_len == 5) && (strncmp(param, "clear", 5) == 0)) {
+			crash_dump_clear();
+			strcpy(pcWriteBuffer, "Crash record cleared.\r\n");
+			return pdFALSE;
+		}
 	}
 
-	uint8_t non_number_chars = 0;
-	for (uint8_t i = 0; i < len; i++) {
-		if (true != is_number(date_string[i])) {
-			non_number_chars = non_number_chars + 1;
+	strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE watchdog_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	const char *param;
+	BaseType_t param_len;
+
+	configASSERT( pcWriteBuffer );
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
+	if (param == NULL) {
+		watchdog_print(pcWriteBuffer, xWriteBufferLen);
+		return pdFALSE;
+	}
+
+	if ((param_len == 4) && (strncmp(param, "hang", 4) == 0) &&
+		(FreeRTOS_CLIGetParameter(pcCommandString, 2, &param_len) == NULL)) {
+		/* The console task runs at the idle priority, the other tasks go on
+		until the watchdog resets. */
+		for (;;) {
 		}
 	}
 
-	if (2 != non_number_chars) {
-		retv = false;
+	strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE boot_profile_state( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	boot_profile_print(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE clock_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	const char *param;
+	const char *value;
+	BaseType_t param_len;
+	BaseType_t value_len;
+	BaseType_t extra_len;
+	uint64_t epoch_us;
+	int64_t offset_us;
+
+	configASSERT( pcWriteBuffer );
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
+	if (param == NULL) {
+		timekeeping_print(pcWriteBuffer, xWriteBufferLen);
+		return pdFALSE;
 	}
 
-	return retv;
+	value = FreeRTOS_CLIGetParameter(pcCommandString, 2, &value_len);
+
+	if ((value == NULL) && (param_len == 11) && (strncmp(param, "clear-drift", 11) == 0)) {
+		timekeeping_clear_drift();
+		strcpy(pcWriteBuffer, "Drift correction removed.\r\n");
+		return pdFALSE;
+	}
+
+	if ((value != NULL) && (FreeRTOS_CLIGetParameter(pcCommandString, 3, &extra_len) == NULL) &&
+		(true == parse_time_us(value, value_len, &epoch_us))) {
+
+		if ((param_len == 3) && (strncmp(param, "set", 3) == 0)) {
+			if (true == timekeeping_set_us(epoch_us)) {
+				strcpy(pcWriteBuffer, "Clock set.\r\n");
+				return pdFALSE;
+			}
+		} else if ((param_len == 4) && (strncmp(param, "sync", 4) == 0)) {
+			if (true == timekeeping_sync_us(epoch_us, &offset_us)) {
+				if ((offset_us > TIMEKEEPING_STEP_THRESHOLD_US) || (offset_us < -TIMEKEEPING_STEP_THRESHOLD_US)) {
+					snprintf(pcWriteBuffer, xWriteBufferLen, "Offset %ld s, stepped.\r\n", ( long ) (offset_us / 1000000LL));
+				} else {
+					snprintf(pcWriteBuffer, xWriteBufferLen, "Offset %ld us, slewing.\r\n", ( long ) offset_us);
+				}
+				return pdFALSE;
+			}
+		}
+	}
+
+	strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+
+	return pdFALSE;
+}
+
+static portBASE_TYPE rtc_calib_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
+{
+	const char *param;
+	BaseType_t param_len;
+	BaseType_t extra_len;
+
+	configASSERT( pcWriteBuffer );
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
+	if (param == NULL) {
+		rtc_calib_print(pcWriteBuffer, xWriteBufferLen);
+		return pdFALSE;
+	}
+
+	if ((FreeRTOS_CLIGetParameter(pcCommandString, 2, &extra_len) == NULL) &&
+		(param_len == 3) && (strncmp(param, "run", 3) == 0)) {
+		rtc_calib_run();
+		strcpy(pcWriteBuffer, "Measuring, the result is ready in about a second.\r\n");
+		return pdFALSE;
+	}
+
+	strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+
+	return pdFALSE;
 }
 
-static void convert_string_to_time(uint8_t *hours, uint8_t *minutes, uint8_t *seconds, char *time_string)
+static portBASE_TYPE run_time_format_bench( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
-	*hours   = (uint8_t)((time_string[0] - '0')*10) + (uint8_t)(time_string[1] - '0');
-	*minutes = (uint8_t)((time_string[3] - '0')*10) + (uint8_t)(time_string[4] - '0');
-	*seconds = (uint8_t)((time_string[6] - '0')*10) + (uint8_t)(time_string[7] - '0');
+	( void ) pcCommandString;
+	configASSERT( pcWriteBuffer );
+
+	time_format_bench_run(pcWriteBuffer, xWriteBufferLen);
+
+	return pdFALSE;
 }
 
-static void convert_string_to_date(uint8_t *day, uint8_t *month, uint8_t *year, char *date_string)
+static portBASE_TYPE cron_command( char *pcWriteBuffer, size_t xWriteBufferLen, const char *pcCommandString )
 {
-	*day   = (uint8_t)((date_string[0] - '0')*10) + (uint8_t)(date_string[1] - '0');
-	*month = (uint8_t)((date_string[3] - '0')*10) + (uint8_t)(date_string[4] - '0');
-	*year  = (uint8_t)((date_string[6] - '0')*10) + (uint8_t)(date_string[7] - '0');
+	const char *param;
+	const char *value;
+	const char *command;
+	BaseType_t param_len;
+	BaseType_t value_len;
+	BaseType_t command_len;
+	cron_sink_t sink = CRON_SINK_CONSOLE;
+	UBaseType_t command_index = 3;
+	time_format_t format;
+	uint64_t time_of_day_us;
+	uint32_t number;
+	uint32_t id = 0;
+
+	configASSERT( pcWriteBuffer );
+
+	param = FreeRTOS_CLIGetParameter(pcCommandString, 1, &param_len);
+	if (param == NULL) {
+		cron_print(pcWriteBuffer, xWriteBufferLen);
+		return pdFALSE;
+	}
+
+	value = FreeRTOS_CLIGetParameter(pcCommandString, 2, &value_len);
+
+	if ((value == NULL) && (param_len == 6) && (strncmp(param, "output", 6) == 0)) {
+		/* The log may be longer than the output buffer, the command is
+		called again until it is empty. */
+		return (true == cron_log_read(pcWriteBuffer, xWriteBufferLen)) ? pdTRUE : pdFALSE;
+	}
+
+	if ((value != NULL) && (param_len == 6) && (strncmp(param, "remove", 6) == 0)) {
+		if ((FreeRTOS_CLIGetParameter(pcCommandString, 3, &command_len) == NULL) &&
+			(true == parse_number(value, value_len, &number)) && (true == cron_remove(number))) {
+			strcpy(pcWriteBuffer, "Schedule removed.\r\n");
+			return pdFALSE;
+		}
+		strcpy(pcWriteBuffer, "Invalid parameter.\r\n");
+		return pdFALSE;
+	}
+
+	/* The sink is optional, the command line is the rest of the line. */
+	command = FreeRTOS_CLIGetParameter(pcCommandString, command_index, &command_len);
+	if ((command != NULL) && (true == cron_sink_parse(command, (size_t)command_len, &sink))) {
+		command_index++;
+		command = FreeRTOS_CLIGetParameter(pcCommandString, command_index, &command_len);
+	}
+
+	if ((value != NULL) && (command != NULL)) {
+		if ((param_len == 5) && (strncmp(param, "every", 5) == 0)) {
+			if ((true == parse_number(value, value_len, &number)) && (number <= (UINT32_MAX / 1000U))) {
+				id = cron_add_interval(command, number * 1000U, sink);
+			}
+		} else if ((param_len == 2) && (strncmp(param, "at", 2) == 0)) {
+			( void ) time_format_compile(&format, TIME_FORMAT_TIME, 0);
+			if (true == time_format_parse_us(&format, value, (size_t)value_len, 0, &time_of_day_us)) {
+				id = cron_add_daily(command, (uint32_t)(time_of_day_us / TIMEKEEPING_US_PER_SECOND), sink);
+			}
+		}
+	}
+
+	if (id != 0U) {
+		snprintf(pcWriteBuffer, xWriteBufferLen, "Schedule %lu added.\r\n", ( unsigned long ) id);
+	} else {
+		strcpy(pcWriteBuffer, "Invalid parameter, or no free schedule.\r\n");
+	}
+
+	return pdFALSE;
 }
 
+static bool is_number(char s)
+{
+	bool retv = false;
+
+	if (s >= '0' && s <= '9') {
+		retv = true;
+	}
+
+	return retv;
+}
+
+static bool parse_number(const char *param, BaseType_t len, uint32_t *value)
+{
+	bool retv = true;
+
+	/* At most 9 digits, so the value fits in 32 bits. */
+	if (len < 1 || len > 9) {
+		retv = false;
+	}
+
+	*value = 0;
+	for (BaseType_t i = 0; (true == retv) && (i < len); i++) {
+		if (true != is_number(param[i])) {
+			retv = false;
+		} else {
+			*value = (*value * 10) + (uint32_t)(param[i] - '0');
+		}
+	}
+
+	return retv;
+}
 
+/* Seconds since 1970 with up to 6 decimals, or ISO 8601. */
+static bool parse_time_us(const char *param, BaseType_t len, uint64_t *epoch_us)
+{
+	time_format_t format;
 
+	( void ) time_format_compile(&format, TIME_FORMAT_EPOCH, 0);
+	if (true == time_format_parse_us(&format, param, (size_t)len, 0, epoch_us)) {
+		return true;
+	}
+
+	( void ) time_format_compile(&format, TIME_FORMAT_ISO8601, 0);
+
+	return time_format_parse_us(&format, param, (size_t)len, 0, epoch_us);
+}
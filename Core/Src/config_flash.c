@@ -0,0 +1,111 @@
+/**
+  ******************************************************************************
+  * @file    config_flash.c
+  * @brief   Internal flash operations of the configuration store.
+  *
+  *          The store uses the two last 128 Kbyte sectors, 10 and 11, which
+  *          the linker script keeps out of the FLASH region.  Words are
+  *          programmed with 32 bit parallelism, which needs a supply of
+  *          2.7 V - 3.6 V.
+  *
+  *          The CPU stalls on every instruction fetch from flash while a
+  *          sector is erased (1 - 2 s for 128 Kbyte) or a word is programmed,
+  *          code that runs meanwhile is delayed, interrupts included.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "config_flash.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stm32f4xx_hal.h"
+
+#include <string.h>
+
+#define CONFIG_FLASH_SECTOR_SIZE        ( 128UL * 1024UL )
+
+static const uint8_t *config_flash_address(uint32_t sector);
+static bool config_flash_erase(uint32_t sector);
+static bool config_flash_program(uint32_t sector, uint32_t offset, const uint32_t *words, uint32_t count);
+static void config_flash_flush_data_cache(void);
+
+/* Start of the CONFIG region, defined in the linker script. */
+extern uint8_t _sconfig[];
+
+static const uint32_t config_flash_sectors[ CONFIG_FLASH_SECTORS ] = { FLASH_SECTOR_10, FLASH_SECTOR_11 };
+
+const config_flash_t config_flash_internal = {
+	CONFIG_FLASH_SECTOR_SIZE,
+	config_flash_address,
+	config_flash_erase,
+	config_flash_program
+};
+
+static const uint8_t *config_flash_address(uint32_t sector)
+{
+	configASSERT(sector < CONFIG_FLASH_SECTORS);
+
+	return &_sconfig[ sector * CONFIG_FLASH_SECTOR_SIZE ];
+}
+
+static bool config_flash_erase(uint32_t sector)
+{
+	FLASH_EraseInitTypeDef erase = {0};
+	HAL_StatusTypeDef status;
+	uint32_t sector_error;
+
+	configASSERT(sector < CONFIG_FLASH_SECTORS);
+
+	erase.TypeErase    = FLASH_TYPEERASE_SECTORS;
+	erase.Sector       = config_flash_sectors[sector];
+	erase.NbSectors    = 1;
+	erase.VoltageRange = FLASH_VOLTAGE_RANGE_3;
+
+	/* HAL_FLASHEx_Erase() flushes the caches. */
+	HAL_FLASH_Unlock();
+	status = HAL_FLASHEx_Erase(&erase, &sector_error);
+	HAL_FLASH_Lock();
+
+	return (status == HAL_OK);
+}
+
+static bool config_flash_program(uint32_t sector, uint32_t offset, const uint32_t *words, uint32_t count)
+{
+	HAL_StatusTypeDef status = HAL_OK;
+	uint32_t address;
+	uint32_t i;
+
+	configASSERT(words);
+	configASSERT((offset % sizeof(uint32_t)) == 0);
+	configASSERT(offset + count * sizeof(uint32_t) <= CONFIG_FLASH_SECTOR_SIZE);
+
+	address = (uint32_t)config_flash_address(sector) + offset;
+
+	HAL_FLASH_Unlock();
+	for (i = 0; (i < count) && (status == HAL_OK); i++) {
+		status = HAL_FLASH_Program(FLASH_TYPEPROGRAM_WORD, address + i * sizeof(uint32_t), words[i]);
+	}
+	HAL_FLASH_Lock();
+
+	config_flash_flush_data_cache();
+
+	/* Read back, a word that was not erased before keeps some of its old
+	bits. */
+	return (status == HAL_OK) && (memcmp((const void *)address, words, count * sizeof(uint32_t)) == 0);
+}
+
+/**
+  * @brief  Drops the lines of the flash data cache.
+  * @note   The cache is not updated by programming, it could still return the
+  *         erased value of a word read before.
+  * @retval None
+  */
+static void config_flash_flush_data_cache(void)
+{
+	if ((FLASH->ACR & FLASH_ACR_DCEN) != 0U) {
+		__HAL_FLASH_DATA_CACHE_DISABLE();
+		__HAL_FLASH_DATA_CACHE_RESET();
+		__HAL_FLASH_DATA_CACHE_ENABLE();
+	}
+}
@@ -0,0 +1,769 @@
+/**
+  ******************************************************************************
+  * @file    config_store.c
+  * @brief   Non-volatile key-value store for the configuration, in flash.
+  *
+  *          The records are appended to a log in the active sector, a new
+  *          value of a key is a new record and the older ones become
+  *          garbage.  A record is a header word with the key and value
+  *          lengths, the key and the value padded to whole words, and a
+  *          CRC-32 of the record, which is programmed last.  A record whose
+  *          CRC does not match was interrupted by a reset and is skipped, a
+  *          deleted key is a record without a value.
+  *
+  *          The RAM index is a hash table of the flash offsets of the latest
+  *          record of every key, a read hashes the key and copies the value
+  *          from flash, without walking the log.  The index is rebuilt by
+  *          reading the log once at startup.
+  *
+  *          When the active sector is filling up the live records are
+  *          copied to the other sector, which becomes the active one once
+  *          its header is programmed.  The header holds a generation number
+  *          incremented by every compaction, after a reset in the middle of
+  *          a compaction the sector with the higher one that has a complete
+  *          header is used.  The two sectors take turns, so they wear
+  *          equally, and a value that does not change is not written again.
+  *          The compaction and the erase of the sector left behind are done
+  *          by the low priority worker of work_queue.c, so the erase, which
+  *          stalls the CPU for a second or two, is not done by config_store_set()
+  *          unless the active sector is full.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "config_store.h"
+#include "work_queue.h"
+#include "binlog.h"
+#include "FreeRTOS.h"
+#include "semphr.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* "CFG1", programmed last into the sector header. */
+#define CONFIG_STORE_MAGIC              0x31474643UL
+
+#define CONFIG_STORE_HEADER_SIZE        16U
+#define CONFIG_STORE_RECORD_TAG         0xC5UL
+#define CONFIG_STORE_ERASED_WORD        0xFFFFFFFFUL
+
+/* Index slots that do not point at a record, records start after the sector
+header. */
+#define CONFIG_STORE_SLOT_EMPTY         0U
+#define CONFIG_STORE_SLOT_REMOVED       1U
+
+/* Header word, CRC word and the key and value padded to whole words. */
+#define CONFIG_STORE_RECORD_WORDS(key_len, value_len)   ( 2U + ((key_len) + (value_len) + 3U) / 4U )
+#define CONFIG_STORE_RECORD_SIZE(key_len, value_len)    ( CONFIG_STORE_RECORD_WORDS(key_len, value_len) * sizeof(uint32_t) )
+
+#define CONFIG_STORE_KEY_LEN(header)    ( (header) & 0xFFUL )
+#define CONFIG_STORE_VALUE_LEN(header)  ( ((header) >> 8) & 0xFFUL )
+#define CONFIG_STORE_TAG(header)        ( (header) >> 24 )
+
+typedef struct {
+	uint32_t magic;
+	uint32_t generation;
+	uint32_t generation_inv;
+	uint32_t reserved;
+} config_store_header_t;
+
+typedef struct {
+	const config_flash_t *flash;
+	SemaphoreHandle_t     mutex;
+	work_queue_item_t     work;
+	uint32_t              active;         /* Sector of the log. */
+	uint32_t              generation;
+	uint32_t              write_offset;   /* End of the log. */
+	uint32_t              live_bytes;     /* Size of the latest records of the keys. */
+	uint32_t              keys;
+	bool                  spare_erased;   /* The other sector is ready for a compaction. */
+	uint32_t              writes;
+	uint32_t              compactions;
+	uint32_t              erases;
+	uint32_t              corrupt;        /* Records skipped because of their CRC. */
+	uint32_t              index[ CONFIG_STORE_INDEX_SIZE ];
+} config_store_t;
+
+static bool config_store_open(uint32_t sector, uint32_t *generation);
+static bool config_store_format(uint32_t sector, uint32_t generation);
+static bool config_store_write_header(uint32_t sector, uint32_t generation);
+static void config_store_scan(void);
+static bool config_store_append(const char *key, uint32_t key_len, const char *value, uint32_t value_len);
+static bool config_store_compact(void);
+static bool config_store_erase_spare(void);
+static bool config_store_is_blank(uint32_t sector);
+static void config_store_work(work_queue_item_t *item, void *arg);
+static void config_store_schedule(void);
+static bool config_store_needs_compaction(void);
+static int32_t config_store_lookup(const char *key, uint32_t key_len, bool *found);
+static void config_store_index_update(uint32_t offset);
+static const uint32_t *config_store_record(uint32_t offset);
+static bool config_store_key_is_valid(const char *key, uint32_t key_len);
+static uint32_t config_store_hash(const char *key, uint32_t key_len);
+static uint32_t config_store_crc32(const void *data, uint32_t length);
+
+static PRIVILEGED_DATA config_store_t config_store;
+
+/**
+  * @brief  Opens the store and builds the RAM index.
+  * @note   Must be called before the scheduler is started.  Formats the
+  *         store if none of the sectors has a valid header.
+  * @param  flash: The flash operations, &config_flash_internal on the target
+  * @retval None
+  */
+void config_store_init(const config_flash_t *flash)
+{
+	uint32_t generation[ CONFIG_FLASH_SECTORS ];
+	bool valid[ CONFIG_FLASH_SECTORS ];
+	bool retv;
+
+	configASSERT(flash);
+	configASSERT((CONFIG_STORE_INDEX_SIZE & (CONFIG_STORE_INDEX_SIZE - 1U)) == 0);
+	configASSERT(CONFIG_STORE_INDEX_SIZE >= 2U * CONFIG_STORE_MAX_KEYS);
+
+	config_store.flash = flash;
+
+	valid[0] = config_store_open(0, &generation[0]);
+	valid[1] = config_store_open(1, &generation[1]);
+
+	if ((true == valid[0]) && (true == valid[1])) {
+		/* A compaction was interrupted after the new header was written. */
+		config_store.active = ((int32_t)(generation[1] - generation[0]) > 0) ? 1U : 0U;
+	} else if (true == valid[1]) {
+		config_store.active = 1U;
+	} else if (true == valid[0]) {
+		config_store.active = 0U;
+	} else {
+		config_store.active = 0U;
+		generation[0] = 0;
+
+		retv = config_store_format(0, generation[0]);
+		configASSERT(true == retv);
+		( void ) retv;
+	}
+
+	config_store.generation = generation[config_store.active];
+	config_store_scan();
+
+	config_store.spare_erased = config_store_is_blank(config_store.active ^ 1U);
+
+	config_store.mutex = xSemaphoreCreateMutex();
+	configASSERT(config_store.mutex);
+
+	work_queue_item_init(&config_store.work, config_store_work, NULL, WORK_QUEUE_LOW);
+}
+
+/**
+  * @brief  Reads the value of a key.
+  * @param  key: The key, a NUL terminated string
+  * @param  value: Buffer for the value, which is NUL terminated
+  * @param  length: Size of the buffer
+  * @retval true if the key exists and the value fits into the buffer
+  */
+bool config_store_get(const char *key, char *value, size_t length)
+{
+	const uint32_t *record;
+	uint32_t key_len;
+	uint32_t value_len;
+	int32_t slot;
+	bool found;
+	bool retv = false;
+
+	configASSERT(key);
+	configASSERT(value);
+
+	key_len = strlen(key);
+	if (true != config_store_key_is_valid(key, key_len)) {
+		return false;
+	}
+
+	xSemaphoreTake(config_store.mutex, portMAX_DELAY);
+	{
+		slot = config_store_lookup(key, key_len, &found);
+		if (true == found) {
+			record = config_store_record(config_store.index[slot]);
+			value_len = CONFIG_STORE_VALUE_LEN(record[0]);
+
+			if (value_len < length) {
+				memcpy(value, (const char *)&record[1] + key_len, value_len);
+				value[value_len] = '\0';
+				retv = true;
+			}
+		}
+	}
+	xSemaphoreGive(config_store.mutex);
+
+	return retv;
+}
+
+/**
+  * @brief  Reads a numeric value, decimal or hexadecimal with 0x.
+  * @param  key: The key, a NUL terminated string
+  * @param  value: The number
+  * @retval true if the key exists and its value is a number
+  */
+bool config_store_get_u32(const char *key, uint32_t *value)
+{
+	char text[ CONFIG_STORE_VALUE_MAX + 1U ];
+	char *end;
+
+	configASSERT(value);
+
+	if (true != config_store_get(key, text, sizeof(text))) {
+		return false;
+	}
+
+	*value = strtoul(text, &end, 0);
+
+	return (end != text) && (*end == '\0');
+}
+
+/**
+  * @brief  Sets the value of a key.
+  * @param  key: The key, at most CONFIG_STORE_KEY_MAX printable characters
+  *         without spaces
+  * @param  value: The value, 1 to CONFIG_STORE_VALUE_MAX printable characters
+  * @retval true if the value was stored, false if the parameters are invalid,
+  *         the key is new and there are already CONFIG_STORE_MAX_KEYS keys, or
+  *         the flash could not be programmed
+  */
+bool config_store_set(const char *key, const char *value)
+{
+	const uint32_t *record;
+	uint32_t key_len;
+	uint32_t value_len;
+	uint32_t i;
+	int32_t slot;
+	bool found;
+	bool retv = false;
+
+	configASSERT(key);
+	configASSERT(value);
+
+	key_len = strlen(key);
+	value_len = strlen(value);
+
+	if ((true != config_store_key_is_valid(key, key_len)) ||
+		(value_len == 0) || (value_len > CONFIG_STORE_VALUE_MAX)) {
+		return false;
+	}
+
+	for (i = 0; i < value_len; i++) {
+		if ((value[i] < ' ') || (value[i] > '~')) {
+			return false;
+		}
+	}
+
+	xSemaphoreTake(config_store.mutex, portMAX_DELAY);
+	{
+		slot = config_store_lookup(key, key_len, &found);
+
+		if (true == found) {
+			record = config_store_record(config_store.index[slot]);
+
+			/* An unchanged value is not written again. */
+			retv = (CONFIG_STORE_VALUE_LEN(record[0]) == value_len) &&
+				(memcmp((const char *)&record[1] + key_len, value, value_len) == 0);
+		}
+
+		if ((true != retv) && ((true == found) || ((slot >= 0) && (config_store.keys < CONFIG_STORE_MAX_KEYS)))) {
+			retv = config_store_append(key, key_len, value, value_len);
+		}
+
+		config_store_schedule();
+	}
+	xSemaphoreGive(config_store.mutex);
+
+	return retv;
+}
+
+/**
+  * @brief  Removes a key.
+  * @param  key: The key, a NUL terminated string
+  * @retval true if the key was removed, false if it does not exist or the
+  *         flash could not be programmed
+  */
+bool config_store_delete(const char *key)
+{
+	uint32_t key_len;
+	bool found;
+	bool retv = false;
+
+	configASSERT(key);
+
+	key_len = strlen(key);
+	if (true != config_store_key_is_valid(key, key_len)) {
+		return false;
+	}
+
+	xSemaphoreTake(config_store.mutex, portMAX_DELAY);
+	{
+		( void ) config_store_lookup(key, key_len, &found);
+		if (true == found) {
+			retv = config_store_append(key, key_len, NULL, 0);
+		}
+
+		config_store_schedule();
+	}
+	xSemaphoreGive(config_store.mutex);
+
+	return retv;
+}
+
+/**
+  * @brief  Prints the keys with their values and the state of the store.
+  * @param  buffer: Output buffer
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void config_store_print(char *buffer, size_t length)
+{
+	const uint32_t *record;
+	const char *key;
+	uint32_t key_len;
+	size_t written;
+	uint32_t i;
+
+	configASSERT(buffer);
+
+	xSemaphoreTake(config_store.mutex, portMAX_DELAY);
+	{
+		written = snprintf(buffer, length,
+			"\r\nSector %lu, generation %lu, used %lu of %lu bytes, live %lu bytes, %lu of %lu keys\r\n"
+			"Writes: %lu, compactions: %lu, erases: %lu, corrupt records: %lu, spare sector %s\r\n\r\n",
+			( unsigned long ) config_store.active, ( unsigned long ) config_store.generation,
+			( unsigned long ) config_store.write_offset, ( unsigned long ) config_store.flash->sector_size,
+			( unsigned long ) config_store.live_bytes,
+			( unsigned long ) config_store.keys, ( unsigned long ) CONFIG_STORE_MAX_KEYS,
+			( unsigned long ) config_store.writes, ( unsigned long ) config_store.compactions,
+			( unsigned long ) config_store.erases, ( unsigned long ) config_store.corrupt,
+			(true == config_store.spare_erased) ? "erased" : "not erased");
+
+		for (i = 0; (i < CONFIG_STORE_INDEX_SIZE) && (written < length); i++) {
+			if (config_store.index[i] > CONFIG_STORE_SLOT_REMOVED) {
+				record = config_store_record(config_store.index[i]);
+				key = (const char *)&record[1];
+				key_len = CONFIG_STORE_KEY_LEN(record[0]);
+
+				written += snprintf(buffer + written, length - written, "%.*s = %.*s\r\n",
+					( int ) key_len, key,
+					( int ) CONFIG_STORE_VALUE_LEN(record[0]), key + key_len);
+			}
+		}
+	}
+	xSemaphoreGive(config_store.mutex);
+}
+
+/**
+  * @brief  Checks the header of a sector.
+  * @param  sector: The sector
+  * @param  generation: The generation of the sector if the header is valid
+  * @retval true if the sector has a complete header
+  */
+static bool config_store_open(uint32_t sector, uint32_t *generation)
+{
+	const config_store_header_t *header;
+
+	header = (const config_store_header_t *)config_store.flash->address(sector);
+
+	if ((header->magic != CONFIG_STORE_MAGIC) || (header->generation != ~header->generation_inv)) {
+		return false;
+	}
+
+	*generation = header->generation;
+
+	return true;
+}
+
+/**
+  * @brief  Creates an empty store in a sector.
+  * @param  sector: The sector
+  * @param  generation: Generation of the sector
+  * @retval true on success
+  */
+static bool config_store_format(uint32_t sector, uint32_t generation)
+{
+	if (true != config_store_is_blank(sector)) {
+		if (true != config_store.flash->erase(sector)) {
+			return false;
+		}
+
+		config_store.erases++;
+	}
+
+	return config_store_write_header(sector, generation);
+}
+
+/**
+  * @brief  Programs the header that makes a sector the active one.
+  * @note   The magic number is programmed last, so the header is complete
+  *         only when everything before it is.
+  * @param  sector: The sector, its header must be erased
+  * @param  generation: Generation of the sector
+  * @retval true on success
+  */
+static bool config_store_write_header(uint32_t sector, uint32_t generation)
+{
+	uint32_t words[ 2 ];
+	uint32_t magic = CONFIG_STORE_MAGIC;
+
+	words[0] = generation;
+	words[1] = ~generation;
+
+	return (true == config_store.flash->program(sector, offsetof(config_store_header_t, generation), words, 2)) &&
+		(true == config_store.flash->program(sector, offsetof(config_store_header_t, magic), &magic, 1));
+}
+
+/**
+  * @brief  Reads the log of the active sector and rebuilds the index.
+  * @retval None
+  */
+static void config_store_scan(void)
+{
+	const uint32_t *record;
+	uint32_t sector_size = config_store.flash->sector_size;
+	uint32_t offset = CONFIG_STORE_HEADER_SIZE;
+	uint32_t key_len;
+	uint32_t size;
+
+	memset(config_store.index, 0, sizeof(config_store.index));
+	config_store.keys = 0;
+	config_store.live_bytes = 0;
+
+	while (offset + sizeof(uint32_t) <= sector_size) {
+		record = config_store_record(offset);
+		if (record[0] == CONFIG_STORE_ERASED_WORD) {
+			break;
+		}
+
+		key_len = CONFIG_STORE_KEY_LEN(record[0]);
+		size = CONFIG_STORE_RECORD_SIZE(key_len, CONFIG_STORE_VALUE_LEN(record[0]));
+
+		/* A damaged header word, the rest of the sector can not be used until
+		the next compaction. */
+		if ((CONFIG_STORE_TAG(record[0]) != CONFIG_STORE_RECORD_TAG) ||
+			(key_len == 0) || (key_len > CONFIG_STORE_KEY_MAX) ||
+			(CONFIG_STORE_VALUE_LEN(record[0]) > CONFIG_STORE_VALUE_MAX) ||
+			(offset + size > sector_size)) {
+			config_store.corrupt++;
+			offset = sector_size;
+			break;
+		}
+
+		if (config_store_crc32(record, size - sizeof(uint32_t)) == record[size / sizeof(uint32_t) - 1U]) {
+			config_store_index_update(offset);
+		} else {
+			config_store.corrupt++;
+		}
+
+		offset += size;
+	}
+
+	config_store.write_offset = offset;
+}
+
+/**
+  * @brief  Appends a record to the log, compacting it first if it is full.
+  * @param  key: The key
+  * @param  key_len: Length of the key
+  * @param  value: The value, NULL to delete the key
+  * @param  value_len: Length of the value, 0 to delete the key
+  * @retval true on success
+  */
+static bool config_store_append(const char *key, uint32_t key_len, const char *value, uint32_t value_len)
+{
+	uint32_t words[ CONFIG_STORE_RECORD_WORDS(CONFIG_STORE_KEY_MAX, CONFIG_STORE_VALUE_MAX) ];
+	uint32_t count = CONFIG_STORE_RECORD_WORDS(key_len, value_len);
+	uint32_t size = count * sizeof(uint32_t);
+	uint32_t offset;
+
+	memset(words, 0xFF, sizeof(words));
+	words[0] = (CONFIG_STORE_RECORD_TAG << 24) | (0xFFUL << 16) | (value_len << 8) | key_len;
+	memcpy(&words[1], key, key_len);
+	if (value_len != 0) {
+		memcpy((char *)&words[1] + key_len, value, value_len);
+	}
+	words[count - 1U] = config_store_crc32(words, size - sizeof(uint32_t));
+
+	if ((config_store.write_offset + size > config_store.flash->sector_size) &&
+		(true != config_store_compact())) {
+		return false;
+	}
+
+	if (config_store.write_offset + size > config_store.flash->sector_size) {
+		return false;
+	}
+
+	offset = config_store.write_offset;
+
+	/* The CRC is programmed last, it completes the record. */
+	if ((true != config_store.flash->program(config_store.active, offset, words, count - 1U)) ||
+		(true != config_store.flash->program(config_store.active, offset + size - sizeof(uint32_t), &words[count - 1U], 1))) {
+		/* Nothing is written after a record that may be damaged. */
+		config_store.write_offset = config_store.flash->sector_size;
+		return false;
+	}
+
+	config_store.write_offset = offset + size;
+	config_store.writes++;
+	config_store_index_update(offset);
+
+	return true;
+}
+
+/**
+  * @brief  Copies the live records to the other sector and makes it active.
+  * @retval true on success, false if the flash could not be erased or
+  *         programmed, the active sector is not changed then
+  */
+static bool config_store_compact(void)
+{
+	const uint32_t *record;
+	uint32_t spare = config_store.active ^ 1U;
+	uint32_t offset = CONFIG_STORE_HEADER_SIZE;
+	uint32_t count;
+	uint32_t i;
+
+	if ((true != config_store.spare_erased) && (true != config_store_erase_spare())) {
+		return false;
+	}
+
+	config_store.spare_erased = false;
+
+	for (i = 0; i < CONFIG_STORE_INDEX_SIZE; i++) {
+		if (config_store.index[i] > CONFIG_STORE_SLOT_REMOVED) {
+			record = config_store_record(config_store.index[i]);
+			count = CONFIG_STORE_RECORD_WORDS(CONFIG_STORE_KEY_LEN(record[0]), CONFIG_STORE_VALUE_LEN(record[0]));
+
+			if (true != config_store.flash->program(spare, offset, record, count)) {
+				return false;
+			}
+
+			offset += count * sizeof(uint32_t);
+		}
+	}
+
+	if (true != config_store_write_header(spare, config_store.generation + 1U)) {
+		return false;
+	}
+
+	config_store.active = spare;
+	config_store.generation++;
+	config_store.compactions++;
+	config_store_scan();
+
+	BINLOG("config: compacted into sector %u, generation %u, %u live bytes",
+		config_store.active, config_store.generation, config_store.live_bytes);
+
+	return true;
+}
+
+/**
+  * @brief  Erases the sector that is not active.
+  * @retval true on success
+  */
+static bool config_store_erase_spare(void)
+{
+	if (true != config_store.flash->erase(config_store.active ^ 1U)) {
+		return false;
+	}
+
+	config_store.erases++;
+	config_store.spare_erased = true;
+
+	return true;
+}
+
+static bool config_store_is_blank(uint32_t sector)
+{
+	const uint32_t *words = (const uint32_t *)config_store.flash->address(sector);
+	uint32_t i;
+
+	for (i = 0; i < config_store.flash->sector_size / sizeof(uint32_t); i++) {
+		if (words[i] != CONFIG_STORE_ERASED_WORD) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+  * @brief  Compacts the log and erases the spare sector in the background.
+  * @param  item: The work item
+  * @param  arg: Not used
+  * @retval None
+  */
+static void config_store_work(work_queue_item_t *item, void *arg)
+{
+	( void ) item;
+	( void ) arg;
+
+	xSemaphoreTake(config_store.mutex, portMAX_DELAY);
+	{
+		if (true == config_store_needs_compaction()) {
+			( void ) config_store_compact();
+		}
+
+		if (true != config_store.spare_erased) {
+			( void ) config_store_erase_spare();
+		}
+	}
+	xSemaphoreGive(config_store.mutex);
+}
+
+/**
+  * @brief  Submits the background work if there is something to do.
+  * @note   Called with the mutex held.
+  * @retval None
+  */
+static void config_store_schedule(void)
+{
+	if ((true != config_store.spare_erased) || (true == config_store_needs_compaction())) {
+		( void ) work_queue_submit(&config_store.work);
+	}
+}
+
+/**
+  * @brief  Checks if the log is filling up and a compaction frees at least a
+  *         quarter of the sector.
+  * @retval true if the log should be compacted
+  */
+static bool config_store_needs_compaction(void)
+{
+	uint32_t sector_size = config_store.flash->sector_size;
+
+	return (config_store.write_offset > (sector_size / 100U) * CONFIG_STORE_COMPACT_THRESHOLD) &&
+		(config_store.write_offset - CONFIG_STORE_HEADER_SIZE - config_store.live_bytes > sector_size / 4U);
+}
+
+/**
+  * @brief  Finds the index slot of a key.
+  * @param  key: The key
+  * @param  key_len: Length of the key
+  * @param  found: Set if the slot holds the key
+  * @retval The slot of the key, or the slot for a new key if it was not
+  *         found, -1 if the index is full
+  */
+static int32_t config_store_lookup(const char *key, uint32_t key_len, bool *found)
+{
+	const uint32_t *record;
+	uint32_t slot = config_store_hash(key, key_len) & (CONFIG_STORE_INDEX_SIZE - 1U);
+	int32_t free_slot = -1;
+	uint32_t i;
+
+	*found = false;
+
+	for (i = 0; i < CONFIG_STORE_INDEX_SIZE; i++) {
+		if (config_store.index[slot] == CONFIG_STORE_SLOT_EMPTY) {
+			return (free_slot >= 0) ? free_slot : (int32_t)slot;
+		}
+
+		if (config_store.index[slot] == CONFIG_STORE_SLOT_REMOVED) {
+			if (free_slot < 0) {
+				free_slot = (int32_t)slot;
+			}
+		} else {
+			record = config_store_record(config_store.index[slot]);
+			if ((CONFIG_STORE_KEY_LEN(record[0]) == key_len) && (memcmp(&record[1], key, key_len) == 0)) {
+				*found = true;
+				return (int32_t)slot;
+			}
+		}
+
+		slot = (slot + 1U) & (CONFIG_STORE_INDEX_SIZE - 1U);
+	}
+
+	return free_slot;
+}
+
+/**
+  * @brief  Points the index at a record that was read or written.
+  * @param  offset: Offset of the record in the active sector
+  * @retval None
+  */
+static void config_store_index_update(uint32_t offset)
+{
+	const uint32_t *record = config_store_record(offset);
+	uint32_t key_len = CONFIG_STORE_KEY_LEN(record[0]);
+	uint32_t value_len = CONFIG_STORE_VALUE_LEN(record[0]);
+	const uint32_t *old;
+	int32_t slot;
+	bool found;
+
+	slot = config_store_lookup((const char *)&record[1], key_len, &found);
+	if (slot < 0) {
+		return;
+	}
+
+	if (true == found) {
+		old = config_store_record(config_store.index[slot]);
+		config_store.live_bytes -= CONFIG_STORE_RECORD_SIZE(key_len, CONFIG_STORE_VALUE_LEN(old[0]));
+		config_store.keys--;
+		config_store.index[slot] = CONFIG_STORE_SLOT_REMOVED;
+	}
+
+	if ((value_len != 0) && (config_store.keys < CONFIG_STORE_MAX_KEYS)) {
+		config_store.index[slot] = offset;
+		config_store.live_bytes += CONFIG_STORE_RECORD_SIZE(key_len, value_len);
+		config_store.keys++;
+	}
+}
+
+static const uint32_t *config_store_record(uint32_t offset)
+{
+	return (const uint32_t *)(config_store.flash->address(config_store.active) + offset);
+}
+
+static bool config_store_key_is_valid(const char *key, uint32_t key_len)
+{
+	uint32_t i;
+
+	if ((key_len == 0) || (key_len > CONFIG_STORE_KEY_MAX)) {
+		return false;
+	}
+
+	for (i = 0; i < key_len; i++) {
+		if ((key[i] <= ' ') || (key[i] > '~')) {
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/* FNV-1a. */
+static uint32_t config_store_hash(const char *key, uint32_t key_len)
+{
+	uint32_t hash = 2166136261UL;
+	uint32_t i;
+
+	for (i = 0; i < key_len; i++) {
+		hash = (hash ^ (uint8_t)key[i]) * 16777619UL;
+	}
+
+	return hash;
+}
+
+/* CRC-32 (IEEE 802.3), four bits at a time. */
+static uint32_t config_store_crc32(const void *data, uint32_t length)
+{
+	static const uint32_t table[ 16 ] = {
+		0x00000000UL, 0x1DB71064UL, 0x3B6E20C8UL, 0x26D930ACUL,
+		0x76DC4190UL, 0x6B6B51F4UL, 0x4DB26158UL, 0x5005713CUL,
+		0xEDB88320UL, 0xF00F9344UL, 0xD6D6A3E8UL, 0xCB61B38CUL,
+		0x9B64C2B0UL, 0x86D3D2D4UL, 0xA00AE278UL, 0xBDBDF21CUL
+	};
+	const uint8_t *bytes = data;
+	uint32_t crc = 0xFFFFFFFFUL;
+	uint32_t i;
+
+	for (i = 0; i < length; i++) {
+		crc = table[(crc ^ bytes[i]) & 0x0FU] ^ (crc >> 4);
+		crc = table[(crc ^ (bytes[i] >> 4)) & 0x0FU] ^ (crc >> 4);
+	}
+
+	return ~crc;
+}
@@ -0,0 +1,531 @@
+/**
+  ******************************************************************************
+  * @file    crash_dump.c
+  * @brief   Post-mortem record of faults, failed assertions and stack
+  *          overflows.
+  *
+  *          The hard fault, bus fault and usage fault handlers, and the
+  *          memory management faults mpu_guard.c does not contain, pass the
+  *          exception frame, EXC_RETURN and R4-R11 to crash_dump_fault().
+  *          It saves the registers, CFSR/HFSR/MMFAR/BFAR, the running task,
+  *          the words at the stack pointer of the crashed code and the last
+  *          messages of the deferred logger into RAM the startup code does
+  *          not initialize, and resets.  With a debugger attached it stops at
+  *          a breakpoint first.
+  *
+  *          configASSERT() and the stack overflow hook trap into the same
+  *          path: they execute a UDF instruction with their arguments in R0
+  *          and R1, so the record has the registers of the failing code, and
+  *          an unprivileged task of the MPU build, which could not write the
+  *          record itself, is handled as well.
+  *
+  *          The record survives the reset, not a power cycle.  It is checked
+  *          with the CRC unit at startup, "crash-dump" shows it, "crash-dump
+  *          raw" prints it for Tools/crash_decode.py, which resolves the
+  *          addresses with the ELF file.
+  *
+  *          Nothing on the capture path may assert or fault again, a fault
+  *          in the hard fault handler locks the core up: the addresses taken
+  *          from the frame are checked before they are read, and the kernel
+  *          is only read, not called through the MPU system calls.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+
+/* The capture runs in handler mode, the kernel functions are called
+directly instead of through the MPU wrappers, which would raise privilege
+with an SVC. */
+#define MPU_WRAPPERS_INCLUDED_FROM_API_FILE
+
+#include "crash_dump.h"
+#include "mem_placement.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stm32f4xx_hal.h"
+
+#include <stdarg.h>
+#include <stdio.h>
+#include <string.h>
+
+#define CRASH_DUMP_MAGIC                0x43525348UL    /* "CRSH" */
+
+#define CRASH_DUMP_LAYOUT               ( (CRASH_DUMP_STACK_WORDS << 16) | \
+										  (CRASH_DUMP_LOG_MESSAGES << 8) | \
+										  BINLOG_MESSAGE_WORDS )
+
+#define CRASH_DUMP_WORDS                ( sizeof(crash_dump_t) / sizeof(uint32_t) )
+
+/* Immediate of the UDF instruction of an assertion and a stack overflow. */
+#define CRASH_DUMP_UDF_ASSERT           0xA5U
+#define CRASH_DUMP_UDF_STACK_OVERFLOW   0xA6U
+#define CRASH_DUMP_UDF(imm)             ( 0xDE00U | (imm) )
+
+/* Offsets of the stacked registers in the exception frame. */
+#define CRASH_DUMP_FRAME_R0             0U
+#define CRASH_DUMP_FRAME_R1             1U
+#define CRASH_DUMP_FRAME_PC             6U
+#define CRASH_DUMP_FRAME_XPSR           7U
+#define CRASH_DUMP_FRAME_WORDS          8U
+#define CRASH_DUMP_FRAME_FP_WORDS       18U
+
+/* EXC_RETURN bit 4 is clear with a floating point frame, xPSR bit 9 is set
+if the stack was aligned to 8 bytes at the exception entry. */
+#define CRASH_DUMP_EXC_RETURN_NO_FP     0x00000010UL
+#define CRASH_DUMP_XPSR_ALIGNED         0x00000200UL
+
+/* Lines of the raw output. */
+#define CRASH_DUMP_RAW_WORDS_PER_LINE   8U
+#define CRASH_DUMP_RAW_LINE_LENGTH      ( 6U + CRASH_DUMP_RAW_WORDS_PER_LINE * 9U + 3U )
+
+typedef struct {
+	uint32_t    start;
+	uint32_t    end;
+} crash_dump_region_t;
+
+typedef struct {
+	uint32_t    mask;
+	const char *name;
+} crash_dump_flag_t;
+
+static uint32_t crash_dump_readable(uint32_t address, uint32_t words);
+static bool crash_dump_in_flash(uint32_t address, uint32_t bytes);
+static bool crash_dump_is_valid(void);
+static uint32_t crash_dump_crc(const uint32_t *words, uint32_t count);
+static uint32_t crash_dump_trap_reason(const uint32_t *frame, uint32_t cfsr, uint32_t reason);
+static size_t crash_dump_print_flags(char *buffer, size_t length, uint32_t value, const crash_dump_flag_t *flags, size_t count);
+static size_t crash_dump_append(char *buffer, size_t length, size_t written, const char *format, ...);
+
+/* Memory the frame, the stack and the name of a task may be read from. */
+static const crash_dump_region_t crash_dump_ram[] = {
+	{ SRAM1_BASE,      SRAM1_BASE + 0x20000UL },        /* SRAM1 and SRAM2 */
+	{ CCMDATARAM_BASE, CCMDATARAM_BASE + 0x10000UL },
+};
+
+static const char * const crash_dump_reasons[] = {
+	"none", "hard fault", "memory management fault", "bus fault", "usage fault",
+	"assertion failed", "stack overflow"
+};
+
+static const crash_dump_flag_t crash_dump_cfsr_flags[] = {
+	{ SCB_CFSR_IACCVIOL_Msk,    "IACCVIOL" },
+	{ SCB_CFSR_DACCVIOL_Msk,    "DACCVIOL" },
+	{ SCB_CFSR_MUNSTKERR_Msk,   "MUNSTKERR" },
+	{ SCB_CFSR_MSTKERR_Msk,     "MSTKERR" },
+	{ SCB_CFSR_MLSPERR_Msk,     "MLSPERR" },
+	{ SCB_CFSR_MMARVALID_Msk,   "MMARVALID" },
+	{ SCB_CFSR_IBUSERR_Msk,     "IBUSERR" },
+	{ SCB_CFSR_PRECISERR_Msk,   "PRECISERR" },
+	{ SCB_CFSR_IMPRECISERR_Msk, "IMPRECISERR" },
+	{ SCB_CFSR_UNSTKERR_Msk,    "UNSTKERR" },
+	{ SCB_CFSR_STKERR_Msk,      "STKERR" },
+	{ SCB_CFSR_LSPERR_Msk,      "LSPERR" },
+	{ SCB_CFSR_BFARVALID_Msk,   "BFARVALID" },
+	{ SCB_CFSR_UNDEFINSTR_Msk,  "UNDEFINSTR" },
+	{ SCB_CFSR_INVSTATE_Msk,    "INVSTATE" },
+	{ SCB_CFSR_INVPC_Msk,       "INVPC" },
+	{ SCB_CFSR_NOCP_Msk,        "NOCP" },
+	{ SCB_CFSR_UNALIGNED_Msk,   "UNALIGNED" },
+	{ SCB_CFSR_DIVBYZERO_Msk,   "DIVBYZERO" },
+};
+
+static const crash_dump_flag_t crash_dump_hfsr_flags[] = {
+	{ SCB_HFSR_VECTTBL_Msk,     "VECTTBL" },
+	{ SCB_HFSR_FORCED_Msk,      "FORCED" },
+	{ SCB_HFSR_DEBUGEVT_Msk,    "DEBUGEVT" },
+};
+
+static crash_dump_t crash_dump NOINIT;
+
+/**
+  * @brief  Enables the configurable fault handlers and drops a record that
+  *         does not check out, the contents of RAM after a power on.
+  * @note   Called first thing in main().
+  * @param  None
+  * @retval None
+  */
+void crash_dump_init(void)
+{
+	/* Memory management, bus and usage faults get their own handlers instead
+	of escalating to a hard fault, so CFSR tells which one it was. */
+	SCB->SHCSR |= SCB_SHCSR_MEMFAULTENA_Msk | SCB_SHCSR_BUSFAULTENA_Msk | SCB_SHCSR_USGFAULTENA_Msk;
+
+	if (false == crash_dump_is_valid()) {
+		memset(&crash_dump, 0, sizeof(crash_dump));
+	}
+}
+
+void crash_dump_clear(void)
+{
+	memset(&crash_dump, 0, sizeof(crash_dump));
+}
+
+/**
+  * @brief  Writes the record into a buffer, readable without the ELF file.
+  * @param  buffer: Output buffer
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void crash_dump_print(char *buffer, size_t length)
+{
+	const crash_dump_t *dump = &crash_dump;
+	size_t written;
+
+	configASSERT(buffer);
+
+	if (dump->magic != CRASH_DUMP_MAGIC) {
+		snprintf(buffer, length, "\r\nNo crash recorded.\r\n");
+		return;
+	}
+
+	written = crash_dump_append(buffer, length, 0,
+		"\r\nCrash %lu: %s, task \"%.*s\", %lu ms after the start\r\n"
+		"PC   0x%08lx  LR  0x%08lx  SP  0x%08lx  xPSR 0x%08lx\r\n"
+		"R0   0x%08lx  R1  0x%08lx  R2  0x%08lx  R3   0x%08lx\r\n"
+		"R4   0x%08lx  R5  0x%08lx  R6  0x%08lx  R7   0x%08lx\r\n"
+		"R8   0x%08lx  R9  0x%08lx  R10 0x%08lx  R11  0x%08lx\r\n"
+		"R12  0x%08lx  EXC_RETURN 0x%08lx\r\n"
+		"MMFAR 0x%08lx  BFAR 0x%08lx\r\nCFSR 0x%08lx",
+		( unsigned long ) dump->count,
+		(dump->reason < (sizeof(crash_dump_reasons) / sizeof(crash_dump_reasons[0]))) ? crash_dump_reasons[dump->reason] : "unknown",
+		( int ) CRASH_DUMP_TASK_NAME_LEN, dump->task, ( unsigned long ) dump->uptime_ms,
+		( unsigned long ) dump->frame[6], ( unsigned long ) dump->frame[5],
+		( unsigned long ) dump->sp, ( unsigned long ) dump->frame[7],
+		( unsigned long ) dump->frame[0], ( unsigned long ) dump->frame[1],
+		( unsigned long ) dump->frame[2], ( unsigned long ) dump->frame[3],
+		( unsigned long ) dump->callee[0], ( unsigned long ) dump->callee[1],
+		( unsigned long ) dump->callee[2], ( unsigned long ) dump->callee[3],
+		( unsigned long ) dump->callee[4], ( unsigned long ) dump->callee[5],
+		( unsigned long ) dump->callee[6], ( unsigned long ) dump->callee[7],
+		( unsigned long ) dump->frame[4], ( unsigned long ) dump->exc_return,
+		( unsigned long ) dump->mmfar, ( unsigned long ) dump->bfar,
+		( unsigned long ) dump->cfsr);
+
+	written += crash_dump_print_flags(buffer + written, length - written, dump->cfsr,
+		crash_dump_cfsr_flags, sizeof(crash_dump_cfsr_flags) / sizeof(crash_dump_cfsr_flags[0]));
+	written = crash_dump_append(buffer, length, written, "\r\nHFSR 0x%08lx", ( unsigned long ) dump->hfsr);
+	written += crash_dump_print_flags(buffer + written, length - written, dump->hfsr,
+		crash_dump_hfsr_flags, sizeof(crash_dump_hfsr_flags) / sizeof(crash_dump_hfsr_flags[0]));
+
+	if (dump->reason == CRASH_DUMP_ASSERT) {
+		/* The file name is in the flash of the program that crashed, it is
+		only printed if it is still there. */
+		if (true == crash_dump_in_flash(dump->file, 1U)) {
+			written = crash_dump_append(buffer, length, written, "\r\nAssertion in %.64s, line %lu",
+				( const char * ) dump->file, ( unsigned long ) dump->line);
+		} else {
+			written = crash_dump_append(buffer, length, written, "\r\nAssertion in 0x%08lx, line %lu",
+				( unsigned long ) dump->file, ( unsigned long ) dump->line);
+		}
+	}
+
+	( void ) crash_dump_append(buffer, length, written,
+		"\r\nStack: %lu words, log: %lu messages, \"crash-dump raw\" prints them for Tools/crash_decode.py\r\n",
+		( unsigned long ) dump->stack_words, ( unsigned long ) dump->log_messages);
+}
+
+/**
+  * @brief  Writes the next part of the record as hexadecimal words.
+  * @param  buffer: Output buffer
+  * @param  length: Size of the output buffer
+  * @param  offset: Next word to write, 0 to start
+  * @retval true if there is more to write
+  */
+bool crash_dump_print_raw(char *buffer, size_t length, uint32_t *offset)
+{
+	const uint32_t *words = ( const uint32_t * ) &crash_dump;
+	size_t written = 0;
+	uint32_t i;
+
+	configASSERT(buffer);
+	configASSERT(offset);
+	configASSERT(length > CRASH_DUMP_RAW_LINE_LENGTH);
+
+	buffer[0] = '\0';
+
+	if (crash_dump.magic != CRASH_DUMP_MAGIC) {
+		snprintf(buffer, length, "\r\nNo crash recorded.\r\n");
+		return false;
+	}
+
+	if (*offset == 0U) {
+		written = crash_dump_append(buffer, length, 0, "\r\n");
+	}
+
+	while ((*offset < CRASH_DUMP_WORDS) && (length - written > CRASH_DUMP_RAW_LINE_LENGTH)) {
+		written = crash_dump_append(buffer, length, written, "%04lx:", ( unsigned long ) (*offset * sizeof(uint32_t)));
+		for (i = 0; (i < CRASH_DUMP_RAW_WORDS_PER_LINE) && (*offset < CRASH_DUMP_WORDS); i++) {
+			written = crash_dump_append(buffer, length, written, " %08lx", ( unsigned long ) words[*offset]);
+			(*offset)++;
+		}
+		written = crash_dump_append(buffer, length, written, "\r\n");
+	}
+
+	return (*offset < CRASH_DUMP_WORDS);
+}
+
+/**
+  * @brief  Writes the record and resets.
+  * @note   Called from the fault handlers, see stm32f4xx_it.c.
+  * @param  frame: Stacked R0-R3, R12, LR, PC and xPSR
+  * @param  exc_return: EXC_RETURN value of the exception
+  * @param  callee: R4-R11 of the crashed code, NULL if not saved
+  * @param  reason: The exception, crash_dump_reason_t
+  * @retval None
+  */
+void crash_dump_fault(uint32_t *frame, uint32_t exc_return, const uint32_t *callee, uint32_t reason)
+{
+	crash_dump_t *dump = &crash_dump;
+	uint32_t sp;
+	uint32_t i;
+
+	__disable_irq();
+
+	dump->count      = (true == crash_dump_is_valid()) ? dump->count + 1U : 1U;
+	dump->magic      = 0U;
+	dump->layout     = CRASH_DUMP_LAYOUT;
+	dump->uptime_ms  = xTaskGetTickCount() * portTICK_PERIOD_MS;
+	dump->exc_return = exc_return;
+	dump->cfsr       = SCB->CFSR;
+	dump->hfsr       = SCB->HFSR;
+	dump->mmfar      = SCB->MMFAR;
+	dump->bfar       = SCB->BFAR;
+	dump->file       = 0U;
+	dump->line       = 0U;
+	memset(dump->task, 0, sizeof(dump->task));
+
+	/* A frame that was not stacked completely may point anywhere. */
+	sp = ( uint32_t ) frame;
+	if (crash_dump_readable(( uint32_t ) frame, CRASH_DUMP_FRAME_WORDS) != 0U) {
+		memcpy(dump->frame, frame, sizeof(dump->frame));
+
+		sp += CRASH_DUMP_FRAME_WORDS * sizeof(uint32_t);
+		if ((exc_return & CRASH_DUMP_EXC_RETURN_NO_FP) == 0U) {
+			sp += CRASH_DUMP_FRAME_FP_WORDS * sizeof(uint32_t);
+		}
+		if ((frame[CRASH_DUMP_FRAME_XPSR] & CRASH_DUMP_XPSR_ALIGNED) != 0U) {
+			sp += sizeof(uint32_t);
+		}
+
+		reason = crash_dump_trap_reason(frame, dump->cfsr, reason);
+	} else {
+		memset(dump->frame, 0, sizeof(dump->frame));
+	}
+	dump->sp     = sp;
+	dump->reason = reason;
+
+	if (callee != NULL) {
+		memcpy(dump->callee, callee, sizeof(dump->callee));
+	} else {
+		memset(dump->callee, 0, sizeof(dump->callee));
+	}
+
+	if (reason == CRASH_DUMP_ASSERT) {
+		dump->file = frame[CRASH_DUMP_FRAME_R0];
+		dump->line = frame[CRASH_DUMP_FRAME_R1];
+	}
+
+	/* The overflowed task passes its name, otherwise it is the running
+	task's, if there is one yet. */
+	if ((reason == CRASH_DUMP_STACK_OVERFLOW) &&
+		(crash_dump_readable(frame[CRASH_DUMP_FRAME_R0], CRASH_DUMP_TASK_NAME_LEN / sizeof(uint32_t)) != 0U)) {
+		memcpy(dump->task, ( const char * ) frame[CRASH_DUMP_FRAME_R0], sizeof(dump->task));
+	} else {
+		crash_dump_task_name(dump->task, sizeof(dump->task));
+	}
+
+	dump->stack_words = crash_dump_readable(sp, CRASH_DUMP_STACK_WORDS);
+	for (i = 0; i < dump->stack_words; i++) {
+		dump->stack[i] = (( const uint32_t * ) sp)[i];
+	}
+
+	dump->log_messages = binlog_copy_tail(dump->log, CRASH_DUMP_LOG_MESSAGES);
+
+	dump->magic = CRASH_DUMP_MAGIC;
+	dump->crc = crash_dump_crc(( const uint32_t * ) dump, CRASH_DUMP_WORDS - 1U);
+
+	if ((CoreDebug->DHCSR & CoreDebug_DHCSR_C_DEBUGEN_Msk) != 0U) {
+		__BKPT(0);
+	}
+
+	NVIC_SystemReset();
+}
+
+/**
+  * @brief  Copies the name of the running task, from handler mode as well.
+  * @param  name: Destination, the name is always terminated
+  * @param  length: Size of the destination
+  * @retval None
+  */
+void crash_dump_task_name(char *name, size_t length)
+{
+	TaskHandle_t task;
+
+	name[0] = '\0';
+
+	/* Before the first task is created there is none. */
+	task = xTaskGetCurrentTaskHandle();
+	if (task != NULL) {
+		strncpy(name, pcTaskGetName(task), length - 1U);
+		name[length - 1U] = '\0';
+	}
+}
+
+/**
+  * @brief  Failed assertion, traps into the fault handler with the file in
+  *         R0 and the line in R1.
+  * @param  file: __FILE__
+  * @param  line: __LINE__
+  * @retval None
+  */
+__attribute__((naked, noreturn)) void crash_dump_assert(const char *file, uint32_t line)
+{
+	__asm volatile
+	(
+		"	udf %0	\n"
+		:: "i" ( CRASH_DUMP_UDF_ASSERT )
+	);
+}
+
+/**
+  * @brief  Stack overflow, traps into the fault handler with the name of the
+  *         task in R0.
+  * @param  task: Name of the task
+  * @retval None
+  */
+__attribute__((naked, noreturn)) void crash_dump_stack_overflow(const char *task)
+{
+	__asm volatile
+	(
+		"	udf %0	\n"
+		:: "i" ( CRASH_DUMP_UDF_STACK_OVERFLOW )
+	);
+}
+
+/**
+  * @brief  Tells an assertion or a stack overflow from other undefined
+  *         instructions.
+  * @param  frame: The exception frame
+  * @param  cfsr: The fault status
+  * @param  reason: The exception
+  * @retval The reason for the record
+  */
+static uint32_t crash_dump_trap_reason(const uint32_t *frame, uint32_t cfsr, uint32_t reason)
+{
+	uint32_t pc = frame[CRASH_DUMP_FRAME_PC];
+	uint16_t instruction;
+
+	if (((cfsr & SCB_CFSR_UNDEFINSTR_Msk) == 0U) || (false == crash_dump_in_flash(pc, sizeof(uint16_t)))) {
+		return reason;
+	}
+
+	instruction = *( const uint16_t * ) pc;
+	if (instruction == CRASH_DUMP_UDF(CRASH_DUMP_UDF_ASSERT)) {
+		reason = CRASH_DUMP_ASSERT;
+	} else if (instruction == CRASH_DUMP_UDF(CRASH_DUMP_UDF_STACK_OVERFLOW)) {
+		reason = CRASH_DUMP_STACK_OVERFLOW;
+	}
+
+	return reason;
+}
+
+/**
+  * @brief  Tells how many of the words at an address are in RAM.
+  * @param  address: Start, must be word aligned
+  * @param  words: Most words wanted
+  * @retval Number of words that may be read, 0 if none
+  */
+static uint32_t crash_dump_readable(uint32_t address, uint32_t words)
+{
+	uint32_t available;
+	uint32_t i;
+
+	if ((address % sizeof(uint32_t)) != 0U) {
+		return 0U;
+	}
+
+	for (i = 0; i < sizeof(crash_dump_ram) / sizeof(crash_dump_ram[0]); i++) {
+		if ((address >= crash_dump_ram[i].start) && (address < crash_dump_ram[i].end)) {
+			available = (crash_dump_ram[i].end - address) / sizeof(uint32_t);
+			return (available < words) ? available : words;
+		}
+	}
+
+	return 0U;
+}
+
+static bool crash_dump_in_flash(uint32_t address, uint32_t bytes)
+{
+	return (address >= FLASH_BASE) && (address <= FLASH_END + 1U - bytes);
+}
+
+static bool crash_dump_is_valid(void)
+{
+	return (crash_dump.magic == CRASH_DUMP_MAGIC) &&
+		   (crash_dump.layout == CRASH_DUMP_LAYOUT) &&
+		   (crash_dump.crc == crash_dump_crc(( const uint32_t * ) &crash_dump, CRASH_DUMP_WORDS - 1U));
+}
+
+/**
+  * @brief  CRC-32/MPEG-2 of words, computed by the CRC unit.
+  * @param  words: The data
+  * @param  count: Number of words
+  * @retval The CRC
+  */
+static uint32_t crash_dump_crc(const uint32_t *words, uint32_t count)
+{
+	uint32_t i;
+
+	__HAL_RCC_CRC_CLK_ENABLE();
+
+	CRC->CR = CRC_CR_RESET;
+	for (i = 0; i < count; i++) {
+		CRC->DR = words[i];
+	}
+
+	return CRC->DR;
+}
+
+static size_t crash_dump_print_flags(char *buffer, size_t length, uint32_t value, const crash_dump_flag_t *flags, size_t count)
+{
+	size_t written = 0;
+	size_t i;
+
+	for (i = 0; (i < count) && (written < length); i++) {
+		if ((value & flags[i].mask) != 0U) {
+			written = crash_dump_append(buffer, length, written, " %s", flags[i].name);
+		}
+	}
+
+	return written;
+}
+
+/**
+  * @brief  Appends to the text in a buffer, as much as fits.
+  * @param  buffer: Output buffer
+  * @param  length: Size of the output buffer
+  * @param  written: Length of the text in the buffer, at most length
+  * @param  format: printf() format
+  * @retval The new length of the text, at most length, so the next call can
+  *         not write past the end of the buffer
+  */
+static size_t crash_dump_append(char *buffer, size_t length, size_t written, const char *format, ...)
+{
+	va_list args;
+	int n;
+
+	if (written >= length) {
+		return length;
+	}
+
+	va_start(args, format);
+	n = vsnprintf(buffer + written, length - written, format, args);
+	va_end(args);
+
+	if (n < 0) {
+		return written;
+	}
+
+	return ((size_t)n < length - written) ? written + (size_t)n : length;
+}
@@ -0,0 +1,612 @@
+/**
+  ******************************************************************************
+  * @file    cron.c
+  * @brief   Command lines run at intervals or daily at a time of day.
+  *
+  *          The worker task runs the command lines of the schedules with
+  *          cli_io_execute(), as if they were entered on the console, and
+  *          passes their output, after a line with the time and the
+  *          schedule, to the sink of the schedule.  A console command is
+  *          completed before a scheduled one starts and the other way
+  *          round, the commands are not reentrant.
+  *
+  *          The schedules wait in two binary min-heaps ordered by their next
+  *          run: the intervals by timebase_get_us64(), the daily schedules
+  *          by the UTC time of timekeeping.c, so they follow a step of the
+  *          clock.  Adding, removing and taking the next schedule are
+  *          O(log n), the worker sleeps until the earlier of the two roots
+  *          or CRON_HEARTBEAT_MS.  An interval run that is late by whole
+  *          periods skips them, the schedule keeps its phase.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "cron.h"
+#include "cli_io.h"
+#include "timebase.h"
+#include "timekeeping.h"
+#include "time_format.h"
+#include "watchdog.h"
+#include "semphr.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define CRON_SECONDS_PER_DAY            86400UL
+
+typedef enum {
+	CRON_JOB_FREE = 0,
+	CRON_JOB_INTERVAL,              /* In heap 0, due in timebase microseconds. */
+	CRON_JOB_DAILY                  /* In heap 1, due in UTC microseconds. */
+} cron_job_kind_t;
+
+typedef struct {
+	char     command[ CRON_COMMAND_SIZE ];
+	uint64_t due_us;
+	uint64_t period_us;             /* The interval, or the time of day. */
+	uint32_t runs;
+	uint32_t skipped;               /* Periods missed and runs the console held off. */
+	uint32_t last_us;               /* Duration of the last run. */
+	uint32_t max_us;
+	uint16_t generation;            /* Counts the schedules the slot held. */
+	uint8_t  kind;
+	uint8_t  sink;
+	uint8_t  position;              /* Index in the heap. */
+} cron_job_t;
+
+typedef struct {
+	uint8_t  slots[ CRON_MAX_JOBS ];
+	uint32_t count;
+} cron_heap_t;
+
+/* The output of a run, the header goes before the first block. */
+typedef struct {
+	cli_output_t  sink;
+	const char   *header;
+} cron_output_t;
+
+typedef struct {
+	char     data[ CRON_LOG_SIZE ];
+	uint32_t head;                  /* Next byte written. */
+	uint32_t used;
+	uint32_t lost;                  /* Bytes overwritten before they were read. */
+} cron_log_t;
+
+static void cron_task(void *params);
+static bool cron_next(uint32_t *slot, TickType_t *wait);
+static void cron_run(uint32_t slot);
+static void cron_output(const char *buffer, size_t length, void *arg);
+static void cron_reschedule(cron_job_t *job, uint64_t now_us);
+static uint32_t cron_add(const char *command, cron_job_kind_t kind, uint64_t period_us, cron_sink_t sink);
+static void cron_heap_push(cron_heap_t *heap, uint32_t slot);
+static void cron_heap_remove(cron_heap_t *heap, uint32_t position);
+static void cron_heap_sift(cron_heap_t *heap, uint32_t position);
+static void cron_heap_set(cron_heap_t *heap, uint32_t position, uint32_t slot);
+static void cron_sink_console(const char *buffer, size_t length, void *arg);
+static void cron_sink_log(const char *buffer, size_t length, void *arg);
+static void cron_sink_none(const char *buffer, size_t length, void *arg);
+
+static const struct {
+	const char   *name;
+	cli_output_t  output;
+} cron_sinks[] = {
+	{ "console", cron_sink_console },
+	{ "log",     cron_sink_log },
+	{ "none",    cron_sink_none },
+};
+
+#define CRON_SINKS                      ( sizeof(cron_sinks) / sizeof(cron_sinks[0]) )
+
+PRIVILEGED_DATA static TaskHandle_t cron_task_handle;
+
+/* Protects the schedules, the heaps and the log. */
+PRIVILEGED_DATA static SemaphoreHandle_t cron_mutex;
+
+PRIVILEGED_DATA static cron_job_t cron_jobs[ CRON_MAX_JOBS ];
+PRIVILEGED_DATA static cron_heap_t cron_heaps[ 2 ];
+PRIVILEGED_DATA static cron_log_t cron_log;
+
+/* Used by the worker only. */
+PRIVILEGED_DATA static char cron_output_buffer[ configCOMMAND_INT_MAX_OUTPUT_SIZE ];
+PRIVILEGED_DATA static time_format_t cron_time_format;
+
+/**
+  * @brief  Creates the worker task.
+  * @retval None
+  */
+void cron_init(void)
+{
+	BaseType_t retv;
+	bool compiled;
+
+	cron_mutex = xSemaphoreCreateMutex();
+	configASSERT(cron_mutex);
+
+	compiled = time_format_compile(&cron_time_format, "%Y-%m-%d %H:%M:%S.%L", 0);
+	configASSERT(true == compiled);
+	( void ) compiled;
+
+	retv = xTaskCreate(cron_task,					/* The worker that runs the scheduled commands. */
+					   "Cron",						/* Text name assigned to the task.  This is just to assist debugging. */
+					   CRON_TASK_STACK_SIZE,		/* The size of the stack allocated to the task. */
+					   NULL,						/* The parameter is not used, so NULL is passed. */
+					   CRON_TASK_PRIORITY | portPRIVILEGE_BIT,	/* The priority allocated to the task, privileged as it runs command lines like the console. */
+					   &cron_task_handle );
+	configASSERT( retv == pdPASS );
+}
+
+/**
+  * @brief  Runs a command line at an interval, the first time one interval
+  *         from now.
+  * @param  command: the command line, copied
+  * @param  interval_ms: the interval, at least CRON_MIN_INTERVAL_MS
+  * @param  sink: where the output goes
+  * @retval ID of the schedule, 0 if none is free or an argument is invalid
+  */
+uint32_t cron_add_interval(const char *command, uint32_t interval_ms, cron_sink_t sink)
+{
+	if (interval_ms < CRON_MIN_INTERVAL_MS) {
+		return 0;
+	}
+
+	return cron_add(command, CRON_JOB_INTERVAL, (uint64_t)interval_ms * 1000ULL, sink);
+}
+
+/**
+  * @brief  Runs a command line every day at a UTC time of day.
+  * @param  command: the command line, copied
+  * @param  time_of_day_s: seconds since midnight
+  * @param  sink: where the output goes
+  * @retval ID of the schedule, 0 if none is free, the clock is not ready or
+  *         an argument is invalid
+  */
+uint32_t cron_add_daily(const char *command, uint32_t time_of_day_s, cron_sink_t sink)
+{
+	if ((time_of_day_s >= CRON_SECONDS_PER_DAY) || (true != timekeeping_is_ready())) {
+		return 0;
+	}
+
+	return cron_add(command, CRON_JOB_DAILY, (uint64_t)time_of_day_s * TIMEKEEPING_US_PER_SECOND, sink);
+}
+
+/**
+  * @brief  Removes a schedule, a run in progress is completed.
+  * @param  id: ID of the schedule
+  * @retval false if there is no such schedule
+  */
+bool cron_remove(uint32_t id)
+{
+	cron_job_t *job;
+	bool retv = false;
+
+	if ((id == 0U) || (id > CRON_MAX_JOBS)) {
+		return false;
+	}
+
+	job = &cron_jobs[id - 1U];
+
+	xSemaphoreTake(cron_mutex, portMAX_DELAY);
+	{
+		if (job->kind != CRON_JOB_FREE) {
+			cron_heap_remove(&cron_heaps[job->kind - 1U], job->position);
+			job->kind = CRON_JOB_FREE;
+			retv = true;
+		}
+	}
+	xSemaphoreGive(cron_mutex);
+
+	return retv;
+}
+
+/**
+  * @brief  Finds a sink by its name.
+  * @param  name: the name, which need not be terminated
+  * @param  length: length of the name
+  * @param  sink: the sink
+  * @retval false if there is no such sink
+  */
+bool cron_sink_parse(const char *name, size_t length, cron_sink_t *sink)
+{
+	uint32_t i;
+
+	for (i = 0; i < CRON_SINKS; i++) {
+		if ((strlen(cron_sinks[i].name) == length) && (strncmp(name, cron_sinks[i].name, length) == 0)) {
+			*sink = (cron_sink_t)i;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/**
+  * @brief  Takes the oldest output of the log sink.
+  * @param  buffer: the output buffer, the text is terminated
+  * @param  length: size of the buffer
+  * @retval true if there is more output
+  */
+bool cron_log_read(char *buffer, size_t length)
+{
+	uint32_t tail;
+	uint32_t count;
+	uint32_t i;
+	size_t written = 0;
+	bool more;
+
+	configASSERT(buffer);
+	configASSERT(length > 0U);
+
+	xSemaphoreTake(cron_mutex, portMAX_DELAY);
+	{
+		if (cron_log.lost != 0U) {
+			written = snprintf(buffer, length, "\r\n[%lu bytes lost]\r\n", ( unsigned long ) cron_log.lost);
+			written = (written < length) ? written : length - 1U;
+			cron_log.lost = 0;
+		}
+
+		tail  = (cron_log.head + CRON_LOG_SIZE - cron_log.used) % CRON_LOG_SIZE;
+		count = ((length - 1U - written) < cron_log.used) ? (uint32_t)(length - 1U - written) : cron_log.used;
+
+		for (i = 0; i < count; i++) {
+			buffer[written++] = cron_log.data[(tail + i) % CRON_LOG_SIZE];
+		}
+		cron_log.used -= count;
+		more = (cron_log.used != 0U);
+	}
+	xSemaphoreGive(cron_mutex);
+
+	buffer[written] = '\0';
+
+	return more;
+}
+
+/**
+  * @brief  Writes the schedules into a buffer.
+  * @param  buffer: the output buffer
+  * @param  length: size of the buffer
+  * @retval None
+  */
+void cron_print(char *buffer, size_t length)
+{
+	cron_job_t job;
+	uint64_t now_us;
+	uint64_t next_s;
+	uint32_t i;
+	size_t written;
+
+	configASSERT(buffer);
+
+	written = snprintf(buffer, length, "\r\nID  Schedule             Sink       Runs  Skipped  Last ms   Max ms  Next in s  Command\r\n");
+
+	for (i = 0; (i < CRON_MAX_JOBS) && (written < length); i++) {
+		xSemaphoreTake(cron_mutex, portMAX_DELAY);
+		{
+			job = cron_jobs[i];
+		}
+		xSemaphoreGive(cron_mutex);
+
+		if (job.kind == CRON_JOB_FREE) {
+			continue;
+		}
+
+		now_us = (job.kind == CRON_JOB_INTERVAL) ? timebase_get_us64() : timekeeping_get_us();
+		next_s = (job.due_us > now_us) ? (job.due_us - now_us) / TIMEKEEPING_US_PER_SECOND : 0U;
+
+		if (job.kind == CRON_JOB_INTERVAL) {
+			written += snprintf(buffer + written, length - written, "%2lu  every %7lu.%03lu s",
+				( unsigned long ) (i + 1U), ( unsigned long ) (job.period_us / 1000000ULL),
+				( unsigned long ) ((job.period_us / 1000ULL) % 1000ULL));
+		} else {
+			written += snprintf(buffer + written, length - written, "%2lu  daily %02lu:%02lu:%02lu UTC ",
+				( unsigned long ) (i + 1U), ( unsigned long ) (job.period_us / 3600000000ULL),
+				( unsigned long ) ((job.period_us / 60000000ULL) % 60ULL), ( unsigned long ) ((job.period_us / 1000000ULL) % 60ULL));
+		}
+
+		if (written < length) {
+			written += snprintf(buffer + written, length - written, "  %-7s  %6lu  %7lu  %7lu  %7lu  %9lu  %s\r\n",
+				cron_sinks[job.sink].name, ( unsigned long ) job.runs, ( unsigned long ) job.skipped,
+				( unsigned long ) (job.last_us / 1000U), ( unsigned long ) (job.max_us / 1000U),
+				( unsigned long ) next_s, job.command);
+		}
+	}
+}
+
+static void cron_task(void *params)
+{
+	TickType_t wait;
+	uint32_t slot;
+
+	( void ) params;
+
+	/* The commands format with the newlib printf family, which may use the
+	floating point registers. */
+	portTASK_USES_FLOATING_POINT();
+
+	( void ) watchdog_attach(NULL, CRON_WATCHDOG_PERIOD_MS);
+
+	for (;;) {
+		watchdog_heartbeat();
+
+		if (true == cron_next(&slot, &wait)) {
+			cron_run(slot);
+		} else {
+			( void ) ulTaskNotifyTake(pdTRUE, wait);
+		}
+	}
+}
+
+/**
+  * @brief  Takes the next schedule that is due and sets its next run.
+  * @param  slot: the schedule that is due
+  * @param  wait: ticks until the next one is due otherwise
+  * @retval true if a schedule is due
+  */
+static bool cron_next(uint32_t *slot, TickType_t *wait)
+{
+	uint64_t now_us[ 2 ];
+	uint64_t until_us = CRON_HEARTBEAT_MS * 1000ULL;
+	cron_job_t *job;
+	uint32_t kind;
+	bool due = false;
+
+	xSemaphoreTake(cron_mutex, portMAX_DELAY);
+	{
+		now_us[0] = timebase_get_us64();
+		now_us[1] = timekeeping_get_us();
+
+		for (kind = 0; (kind < 2U) && (true != due); kind++) {
+			if (cron_heaps[kind].count == 0U) {
+				continue;
+			}
+
+			job = &cron_jobs[cron_heaps[kind].slots[0]];
+			if (job->due_us <= now_us[kind]) {
+				*slot = cron_heaps[kind].slots[0];
+				cron_reschedule(job, now_us[kind]);
+				cron_heap_sift(&cron_heaps[kind], 0);
+				due = true;
+			} else if ((job->due_us - now_us[kind]) < until_us) {
+				until_us = job->due_us - now_us[kind];
+			}
+		}
+	}
+	xSemaphoreGive(cron_mutex);
+
+	/* Rounded up, so the schedule is due when the worker wakes. */
+	*wait = pdMS_TO_TICKS((uint32_t)((until_us + 999ULL) / 1000ULL));
+	if (*wait == 0U) {
+		*wait = 1;
+	}
+
+	return due;
+}
+
+/**
+  * @brief  Runs a schedule and updates its statistics.
+  * @param  slot: the schedule
+  * @retval None
+  */
+static void cron_run(uint32_t slot)
+{
+	cron_job_t *job = &cron_jobs[slot];
+	char command[ CRON_COMMAND_SIZE ];
+	char header[ 96 ];
+	cron_output_t output;
+	uint16_t generation;
+	uint32_t start;
+	uint32_t elapsed;
+	size_t written;
+	BaseType_t ran;
+
+	xSemaphoreTake(cron_mutex, portMAX_DELAY);
+	{
+		memcpy(command, job->command, sizeof(command));
+		generation  = job->generation;
+		output.sink = cron_sinks[job->sink].output;
+	}
+	xSemaphoreGive(cron_mutex);
+
+	written = snprintf(header, sizeof(header), "\r\n[");
+	written += time_format_us(&cron_time_format, timekeeping_get_us(), header + written, sizeof(header) - written);
+	snprintf(header + written, sizeof(header) - written, "] cron %lu: %s\r\n", ( unsigned long ) (slot + 1U), command);
+
+	output.header = header;
+
+	/* The duration includes the wait for a console command. */
+	start   = timebase_get_us();
+	ran     = cli_io_execute(command, cron_output_buffer, sizeof(cron_output_buffer), cron_output, &output,
+						 pdMS_TO_TICKS(CRON_COMMAND_WAIT_MS));
+	elapsed = timebase_get_us() - start;
+
+	xSemaphoreTake(cron_mutex, portMAX_DELAY);
+	{
+		/* Unless it was removed meanwhile. */
+		if ((job->kind != CRON_JOB_FREE) && (job->generation == generation)) {
+			if (ran == pdPASS) {
+				job->runs++;
+				job->last_us = elapsed;
+				job->max_us  = (elapsed > job->max_us) ? elapsed : job->max_us;
+			} else {
+				job->skipped++;
+			}
+		}
+	}
+	xSemaphoreGive(cron_mutex);
+}
+
+static void cron_output(const char *buffer, size_t length, void *arg)
+{
+	cron_output_t *output = ( cron_output_t * ) arg;
+
+	if (output->header != NULL) {
+		output->sink(output->header, strlen(output->header), NULL);
+		output->header = NULL;
+	}
+
+	output->sink(buffer, length, NULL);
+}
+
+/* Sets the run after the one that is due. */
+static void cron_reschedule(cron_job_t *job, uint64_t now_us)
+{
+	uint64_t period_us = (job->kind == CRON_JOB_INTERVAL) ? job->period_us : CRON_SECONDS_PER_DAY * TIMEKEEPING_US_PER_SECOND;
+	uint64_t missed;
+
+	missed = (now_us - job->due_us) / period_us;
+	if (job->kind == CRON_JOB_INTERVAL) {
+		job->skipped += (uint32_t)missed;
+	}
+
+	job->due_us += (missed + 1U) * period_us;
+}
+
+static uint32_t cron_add(const char *command, cron_job_kind_t kind, uint64_t period_us, cron_sink_t sink)
+{
+	cron_job_t *job;
+	uint64_t now_us;
+	uint32_t id = 0;
+	uint32_t i;
+
+	configASSERT(command);
+
+	if ((strlen(command) == 0U) || (strlen(command) >= CRON_COMMAND_SIZE) || ((uint32_t)sink >= CRON_SINKS)) {
+		return 0;
+	}
+
+	xSemaphoreTake(cron_mutex, portMAX_DELAY);
+	{
+		for (i = 0; (i < CRON_MAX_JOBS) && (cron_jobs[i].kind != CRON_JOB_FREE); i++) {
+		}
+
+		if (i < CRON_MAX_JOBS) {
+			job = &cron_jobs[i];
+			strcpy(job->command, command);
+			job->kind      = (uint8_t)kind;
+			job->sink      = (uint8_t)sink;
+			job->period_us = period_us;
+			job->runs      = 0;
+			job->skipped   = 0;
+			job->last_us   = 0;
+			job->max_us    = 0;
+			job->generation++;
+
+			if (kind == CRON_JOB_INTERVAL) {
+				job->due_us = timebase_get_us64() + period_us;
+			} else {
+				/* The next time of day, today or tomorrow. */
+				now_us      = timekeeping_get_us();
+				job->due_us = now_us - (now_us % (CRON_SECONDS_PER_DAY * TIMEKEEPING_US_PER_SECOND)) + period_us;
+				if (job->due_us <= now_us) {
+					job->due_us += CRON_SECONDS_PER_DAY * TIMEKEEPING_US_PER_SECOND;
+				}
+			}
+
+			cron_heap_push(&cron_heaps[kind - 1U], i);
+			id = i + 1U;
+		}
+	}
+	xSemaphoreGive(cron_mutex);
+
+	/* The worker may wait for a later schedule. */
+	if (id != 0U) {
+		xTaskNotifyGive(cron_task_handle);
+	}
+
+	return id;
+}
+
+static void cron_heap_push(cron_heap_t *heap, uint32_t slot)
+{
+	configASSERT(heap->count < CRON_MAX_JOBS);
+
+	cron_heap_set(heap, heap->count, slot);
+	heap->count++;
+	cron_heap_sift(heap, heap->count - 1U);
+}
+
+static void cron_heap_remove(cron_heap_t *heap, uint32_t position)
+{
+	heap->count--;
+	if (position < heap->count) {
+		cron_heap_set(heap, position, heap->slots[heap->count]);
+		cron_heap_sift(heap, position);
+	}
+}
+
+/* Moves the schedule at a position up or down to its place. */
+static void cron_heap_sift(cron_heap_t *heap, uint32_t position)
+{
+	uint32_t slot = heap->slots[position];
+	uint64_t due_us = cron_jobs[slot].due_us;
+	uint32_t parent;
+	uint32_t child;
+
+	while (position > 0U) {
+		parent = (position - 1U) / 2U;
+		if (cron_jobs[heap->slots[parent]].due_us <= due_us) {
+			break;
+		}
+		cron_heap_set(heap, position, heap->slots[parent]);
+		position = parent;
+	}
+
+	for (;;) {
+		child = position * 2U + 1U;
+		if (child >= heap->count) {
+			break;
+		}
+		if (((child + 1U) < heap->count) &&
+			(cron_jobs[heap->slots[child + 1U]].due_us < cron_jobs[heap->slots[child]].due_us)) {
+			child++;
+		}
+		if (due_us <= cron_jobs[heap->slots[child]].due_us) {
+			break;
+		}
+		cron_heap_set(heap, position, heap->slots[child]);
+		position = child;
+	}
+
+	cron_heap_set(heap, position, slot);
+}
+
+static void cron_heap_set(cron_heap_t *heap, uint32_t position, uint32_t slot)
+{
+	heap->slots[position]        = (uint8_t)slot;
+	cron_jobs[slot].position     = (uint8_t)position;
+}
+
+static void cron_sink_console(const char *buffer, size_t length, void *arg)
+{
+	( void ) arg;
+
+	cli_io_print(buffer, length);
+}
+
+static void cron_sink_log(const char *buffer, size_t length, void *arg)
+{
+	( void ) arg;
+
+	xSemaphoreTake(cron_mutex, portMAX_DELAY);
+	{
+		while (length > 0U) {
+			cron_log.data[cron_log.head] = *buffer++;
+			cron_log.head = (cron_log.head + 1U) % CRON_LOG_SIZE;
+			length--;
+
+			if (cron_log.used < CRON_LOG_SIZE) {
+				cron_log.used++;
+			} else {
+				cron_log.lost++;
+			}
+		}
+	}
+	xSemaphoreGive(cron_mutex);
+}
+
+static void cron_sink_none(const char *buffer, size_t length, void *arg)
+{
+	( void ) buffer;
+	( void ) length;
+	( void ) arg;
+}
@@ -37,6 +37,7 @@
 
 /* Demo program include files. */
 #include "QueueOverwrite.h"
+#include "mpu_guard.h"
 
 /* A block time of 0 just means "don't block". */
 #define qoDONT_BLOCK    0
@@ -59,6 +60,9 @@ static BaseType_t xISRTestStatus = pdPASS;
  * created inside the task itself. */
 static QueueHandle_t xISRQueue = NULL;
 
+static MPU_GUARD_STACK( uxQueueOverwriteStack, configMINIMAL_STACK_SIZE );
+PRIVILEGED_DATA static StaticTask_t xQueueOverwriteTCB;
+
 /*-----------------------------------------------------------*/
 
 void vStartQueueOverwriteTask( UBaseType_t uxPriority )
@@ -71,7 +75,7 @@ void vStartQueueOverwriteTask( UBaseType_t uxPriority )
 
     /* Create the test task.  The queue used by the test task is created inside
      * the task itself. */
-    xTaskCreate( prvQueueOverwriteTask, "QOver", configMINIMAL_STACK_SIZE, NULL, uxPriority, ( TaskHandle_t * ) NULL );
+    mpu_guard_create_demo_task( prvQueueOverwriteTask, "QOver", configMINIMAL_STACK_SIZE, NULL, uxPriority, uxQueueOverwriteStack, &xQueueOverwriteTCB );
 }
 /*-----------------------------------------------------------*/
 
@@ -50,6 +50,7 @@
 
 /* Demo includes. */
 #include "QueueSet.h"
+#include "mpu_guard.h"
 
 
 #if ( configUSE_QUEUE_SETS == 1 ) /* Remove the tests if queue sets are not defined. */
@@ -206,16 +207,20 @@
 /* The task handles are stored so their priorities can be changed. */
     TaskHandle_t xQueueSetSendingTask, xQueueSetReceivingTask;
 
+    static MPU_GUARD_STACK( uxQueueSetSendingStack, configMINIMAL_STACK_SIZE );
+    static MPU_GUARD_STACK( uxQueueSetReceivingStack, configMINIMAL_STACK_SIZE );
+    PRIVILEGED_DATA static StaticTask_t xQueueSetSendingTCB, xQueueSetReceivingTCB;
+
 /*-----------------------------------------------------------*/
 
     void vStartQueueSetTasks( void )
     {
         /* Create the tasks. */
-        xTaskCreate( prvQueueSetSendingTask, "SetTx", configMINIMAL_STACK_SIZE, NULL, queuesetMEDIUM_PRIORITY, &xQueueSetSendingTask );
+        xQueueSetSendingTask = mpu_guard_create_demo_task( prvQueueSetSendingTask, "SetTx", configMINIMAL_STACK_SIZE, NULL, queuesetMEDIUM_PRIORITY, uxQueueSetSendingStack, &xQueueSetSendingTCB );
 
         if( xQueueSetSendingTask != NULL )
         {
-            xTaskCreate( prvQueueSetReceivingTask, "SetRx", configMINIMAL_STACK_SIZE, ( void * ) xQueueSetSendingTask, queuesetMEDIUM_PRIORITY, &xQueueSetReceivingTask );
+            xQueueSetReceivingTask = mpu_guard_create_demo_task( prvQueueSetReceivingTask, "SetRx", configMINIMAL_STACK_SIZE, ( void * ) xQueueSetSendingTask, queuesetMEDIUM_PRIORITY, uxQueueSetReceivingStack, &xQueueSetReceivingTCB );
 
             /* It is important that the sending task does not attempt to write to a
              * queue before the queue has been created.  It is therefore placed into
@@ -38,6 +38,7 @@
 
 /* Demo includes. */
 #include "blocktim.h"
+#include "mpu_guard.h"
 
 /* Task priorities and stack sizes.  Allow these to be overridden. */
 #ifndef bktPRIMARY_PRIORITY
@@ -97,6 +98,10 @@ static volatile BaseType_t xErrorOccurred = pdFALSE;
  * secondary task has executed. */
 static volatile UBaseType_t xRunIndicator;
 
+static MPU_GUARD_STACK( uxPrimaryStack, bktBLOCK_TIME_TASK_STACK_SIZE );
+static MPU_GUARD_STACK( uxSecondaryStack, bktBLOCK_TIME_TASK_STACK_SIZE );
+PRIVILEGED_DATA static StaticTask_t xPrimaryTCB, xSecondaryTCB;
+
 /*-----------------------------------------------------------*/
 
 void vCreateBlockTimeTasks( void )
@@ -115,8 +120,8 @@ void vCreateBlockTimeTasks( void )
         vQueueAddToRegistry( xTestQueue, "Block_Time_Queue" );
 
         /* Create the two test tasks. */
-        xTaskCreate( vPrimaryBlockTimeTestTask, "BTest1", bktBLOCK_TIME_TASK_STACK_SIZE, NULL, bktPRIMARY_PRIORITY, NULL );
-        xTaskCreate( vSecondaryBlockTimeTestTask, "BTest2", bktBLOCK_TIME_TASK_STACK_SIZE, NULL, bktSECONDARY_PRIORITY, &xSecondary );
+        mpu_guard_create_demo_task( vPrimaryBlockTimeTestTask, "BTest1", bktBLOCK_TIME_TASK_STACK_SIZE, NULL, bktPRIMARY_PRIORITY, uxPrimaryStack, &xPrimaryTCB );
+        xSecondary = mpu_guard_create_demo_task( vSecondaryBlockTimeTestTask, "BTest2", bktBLOCK_TIME_TASK_STACK_SIZE, NULL, bktSECONDARY_PRIORITY, uxSecondaryStack, &xSecondaryTCB );
     }
 }
 /*-----------------------------------------------------------*/
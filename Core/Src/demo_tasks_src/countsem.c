@@ -37,6 +37,7 @@
 
 /* Demo program include files. */
 #include "countsem.h"
+#include "mpu_guard.h"
 
 /* The maximum count value that the semaphore used for the demo can hold. */
 #define countMAX_COUNT_VALUE       ( 200 )
@@ -104,6 +105,9 @@ typedef struct COUNT_SEM_STRUCT
 /* Two structures are defined, one is passed to each test task. */
 static xCountSemStruct xParameters[ countNUM_TEST_TASKS ];
 
+static MPU_GUARD_STACK( uxStacks[ countNUM_TEST_TASKS ], configMINIMAL_STACK_SIZE );
+PRIVILEGED_DATA static StaticTask_t xTCBs[ countNUM_TEST_TASKS ];
+
 /*-----------------------------------------------------------*/
 
 void vStartCountingSemaphoreTasks( void )
@@ -132,8 +136,8 @@ void vStartCountingSemaphoreTasks( void )
         vQueueAddToRegistry( ( QueueHandle_t ) xParameters[ 1 ].xSemaphore, "Counting_Sem_2" );
 
         /* Create the demo tasks, passing in the semaphore to use as the parameter. */
-        xTaskCreate( prvCountingSemaphoreTask, "CNT1", configMINIMAL_STACK_SIZE, ( void * ) &( xParameters[ 0 ] ), tskIDLE_PRIORITY, NULL );
-        xTaskCreate( prvCountingSemaphoreTask, "CNT2", configMINIMAL_STACK_SIZE, ( void * ) &( xParameters[ 1 ] ), tskIDLE_PRIORITY, NULL );
+        mpu_guard_create_demo_task( prvCountingSemaphoreTask, "CNT1", configMINIMAL_STACK_SIZE, ( void * ) &( xParameters[ 0 ] ), tskIDLE_PRIORITY, uxStacks[ 0 ], &( xTCBs[ 0 ] ) );
+        mpu_guard_create_demo_task( prvCountingSemaphoreTask, "CNT2", configMINIMAL_STACK_SIZE, ( void * ) &( xParameters[ 1 ] ), tskIDLE_PRIORITY, uxStacks[ 1 ], &( xTCBs[ 1 ] ) );
     }
 }
 /*-----------------------------------------------------------*/
@@ -91,6 +91,7 @@
 
 /* Demo app include files. */
 #include "dynamic.h"
+#include "mpu_guard.h"
 
 /* Function that implements the "limited count" task as described above. */
 static portTASK_FUNCTION_PROTO( vLimitedIncrementTask, pvParameters );
@@ -141,6 +142,13 @@ QueueHandle_t xSuspendedTestQueue;
  * incrementing. */
 static uint32_t ulExpectedValue = ( uint32_t ) 0;
 
+static MPU_GUARD_STACK( uxContinuousIncrementStack, priSTACK_SIZE );
+static MPU_GUARD_STACK( uxLimitedIncrementStack, priSTACK_SIZE );
+static MPU_GUARD_STACK( uxCounterControlStack, priSUSPENDED_RX_TASK_STACK_SIZE );
+static MPU_GUARD_STACK( uxQueueSendStack, priSTACK_SIZE );
+static MPU_GUARD_STACK( uxQueueReceiveStack, priSUSPENDED_RX_TASK_STACK_SIZE );
+PRIVILEGED_DATA static StaticTask_t xContinuousIncrementTCB, xLimitedIncrementTCB, xCounterControlTCB, xQueueSendTCB, xQueueReceiveTCB;
+
 /*-----------------------------------------------------------*/
 
 /*
@@ -161,11 +169,11 @@ void vStartDynamicPriorityTasks( void )
          * defined to be less than 1. */
         vQueueAddToRegistry( xSuspendedTestQueue, "Suspended_Test_Queue" );
 
-        xTaskCreate( vContinuousIncrementTask, "CNT_INC", priSTACK_SIZE, ( void * ) &ulCounter, tskIDLE_PRIORITY, &xContinuousIncrementHandle );
-        xTaskCreate( vLimitedIncrementTask, "LIM_INC", priSTACK_SIZE, ( void * ) &ulCounter, tskIDLE_PRIORITY + 1, &xLimitedIncrementHandle );
-        xTaskCreate( vCounterControlTask, "C_CTRL", priSUSPENDED_RX_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL );
-        xTaskCreate( vQueueSendWhenSuspendedTask, "SUSP_TX", priSTACK_SIZE, NULL, tskIDLE_PRIORITY, NULL );
-        xTaskCreate( vQueueReceiveWhenSuspendedTask, "SUSP_RX", priSUSPENDED_RX_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL );
+        xContinuousIncrementHandle = mpu_guard_create_demo_task( vContinuousIncrementTask, "CNT_INC", priSTACK_SIZE, ( void * ) &ulCounter, tskIDLE_PRIORITY, uxContinuousIncrementStack, &xContinuousIncrementTCB );
+        xLimitedIncrementHandle = mpu_guard_create_demo_task( vLimitedIncrementTask, "LIM_INC", priSTACK_SIZE, ( void * ) &ulCounter, tskIDLE_PRIORITY + 1, uxLimitedIncrementStack, &xLimitedIncrementTCB );
+        mpu_guard_create_demo_task( vCounterControlTask, "C_CTRL", priSUSPENDED_RX_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY, uxCounterControlStack, &xCounterControlTCB );
+        mpu_guard_create_demo_task( vQueueSendWhenSuspendedTask, "SUSP_TX", priSTACK_SIZE, NULL, tskIDLE_PRIORITY, uxQueueSendStack, &xQueueSendTCB );
+        mpu_guard_create_demo_task( vQueueReceiveWhenSuspendedTask, "SUSP_RX", priSUSPENDED_RX_TASK_STACK_SIZE, NULL, tskIDLE_PRIORITY, uxQueueReceiveStack, &xQueueReceiveTCB );
     }
 }
 /*-----------------------------------------------------------*/
@@ -68,6 +68,7 @@
 
 /* Demo app include files. */
 #include "recmutex.h"
+#include "mpu_guard.h"
 
 /* Priorities assigned to the three tasks.  recmuCONTROLLING_TASK_PRIORITY can
  * be overridden by a definition in FreeRTOSConfig.h. */
@@ -105,6 +106,11 @@ static volatile UBaseType_t uxControllingCycles = 0, uxBlockingCycles = 0, uxPol
  * (unsuspended). */
 static TaskHandle_t xControllingTaskHandle, xBlockingTaskHandle;
 
+static MPU_GUARD_STACK( uxControllingStack, recmuRECURSIVE_MUTEX_TEST_TASK_STACK_SIZE );
+static MPU_GUARD_STACK( uxBlockingStack, recmuRECURSIVE_MUTEX_TEST_TASK_STACK_SIZE );
+static MPU_GUARD_STACK( uxPollingStack, recmuRECURSIVE_MUTEX_TEST_TASK_STACK_SIZE );
+PRIVILEGED_DATA static StaticTask_t xControllingTCB, xBlockingTCB, xPollingTCB;
+
 /*-----------------------------------------------------------*/
 
 void vStartRecursiveMutexTasks( void )
@@ -123,9 +129,9 @@ void vStartRecursiveMutexTasks( void )
          * defined to be less than 1. */
         vQueueAddToRegistry( ( QueueHandle_t ) xMutex, "Recursive_Mutex" );
 
-        xTaskCreate( prvRecursiveMutexControllingTask, "Rec1", recmuRECURSIVE_MUTEX_TEST_TASK_STACK_SIZE, NULL, recmuCONTROLLING_TASK_PRIORITY, &xControllingTaskHandle );
-        xTaskCreate( prvRecursiveMutexBlockingTask, "Rec2", recmuRECURSIVE_MUTEX_TEST_TASK_STACK_SIZE, NULL, recmuBLOCKING_TASK_PRIORITY, &xBlockingTaskHandle );
-        xTaskCreate( prvRecursiveMutexPollingTask, "Rec3", recmuRECURSIVE_MUTEX_TEST_TASK_STACK_SIZE, NULL, recmuPOLLING_TASK_PRIORITY, NULL );
+        xControllingTaskHandle = mpu_guard_create_demo_task( prvRecursiveMutexControllingTask, "Rec1", recmuRECURSIVE_MUTEX_TEST_TASK_STACK_SIZE, NULL, recmuCONTROLLING_TASK_PRIORITY, uxControllingStack, &xControllingTCB );
+        xBlockingTaskHandle = mpu_guard_create_demo_task( prvRecursiveMutexBlockingTask, "Rec2", recmuRECURSIVE_MUTEX_TEST_TASK_STACK_SIZE, NULL, recmuBLOCKING_TASK_PRIORITY, uxBlockingStack, &xBlockingTCB );
+        mpu_guard_create_demo_task( prvRecursiveMutexPollingTask, "Rec3", recmuRECURSIVE_MUTEX_TEST_TASK_STACK_SIZE, NULL, recmuPOLLING_TASK_PRIORITY, uxPollingStack, &xPollingTCB );
     }
 }
 /*-----------------------------------------------------------*/
@@ -0,0 +1,393 @@
+/**
+  ******************************************************************************
+  * @file    dfs.c
+  * @brief   Dynamic frequency scaling driven by the CPU load.
+  *
+  *          The system clock is switched between the operating points (OPP)
+  *          of dfs_opps, each one a validated combination of PLL setting,
+  *          regulator voltage scale, flash wait states and bus dividers.
+  *          The governor task measures the CPU load from the run time
+  *          statistics of the idle task every DFS_GOVERNOR_PERIOD_MS.  A
+  *          load above DFS_UP_THRESHOLD switches straight to the fastest
+  *          OPP, a load below DFS_DOWN_THRESHOLD for DFS_DOWN_PERIODS
+  *          periods steps one OPP down, if the load projected to the slower
+  *          clock stays below DFS_UP_THRESHOLD.
+  *
+  *          A switch runs the system from HSE while the PLL is stopped and
+  *          reprogrammed, the regulator scale is changed while the PLL is
+  *          off.  Everything derived from the clocks is then updated:
+  *          - TIM2, the tick and timestamp counter, by HAL_InitTick() which
+  *            HAL_RCC_ClockConfig() calls and which keeps the counter value,
+  *            so the tick, the timestamps and the run time statistics do
+  *            not jump (SysTick and TIM7 are not used, see timebase.c)
+  *          - the baud rates of the console and the binlog.c UART
+  *          - the cycle budgets of task_budget.c
+  *          - the LSI measurement of rtc_calib.c, which is discarded
+  *          Cycle counts measured with the DWT counter are CPU cycles at
+  *          the clock of the moment.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "dfs.h"
+#include "timebase.h"
+#include "cli_io.h"
+#include "task_budget.h"
+#include "rtc_calib.h"
+#include "binlog.h"
+#include "watchdog.h"
+#include "stm32f4xx_hal.h"
+
+#include <stdio.h>
+
+/* HSE is 8 MHz, PLLM divides it to the 2 MHz PLL input. */
+#define DFS_PLLM                        4U
+
+/* Time the PLL may take to stop. */
+#define DFS_PLL_TIMEOUT_MS              2U
+
+/* Longest time between two governor periods before the watchdog resets. */
+#define DFS_WATCHDOG_PERIOD_MS          2000UL
+
+typedef struct {
+	uint32_t sysclk_hz;
+	uint32_t plln;
+	uint32_t pllp;
+	uint32_t pllq;
+	uint32_t voltage_scale;
+	uint32_t latency;
+	uint32_t apb1_divider;
+	uint32_t apb2_divider;
+} dfs_opp_t;
+
+/* Fastest first.  VCO 336 or 192 MHz, APB1 at most 42 MHz, APB2 at most
+84 MHz, scale 2 up to 144 MHz, wait states for 2.7 V - 3.6 V.  The first one
+is the clock set by SystemClock_Config. */
+static const dfs_opp_t dfs_opps[] = {
+	{ 168000000UL, 168, RCC_PLLP_DIV2, 7, PWR_REGULATOR_VOLTAGE_SCALE1, FLASH_LATENCY_5, RCC_HCLK_DIV4, RCC_HCLK_DIV2 },
+	{  84000000UL, 168, RCC_PLLP_DIV4, 7, PWR_REGULATOR_VOLTAGE_SCALE2, FLASH_LATENCY_2, RCC_HCLK_DIV2, RCC_HCLK_DIV1 },
+	{  48000000UL,  96, RCC_PLLP_DIV4, 4, PWR_REGULATOR_VOLTAGE_SCALE2, FLASH_LATENCY_1, RCC_HCLK_DIV2, RCC_HCLK_DIV1 },
+	{  24000000UL,  96, RCC_PLLP_DIV8, 4, PWR_REGULATOR_VOLTAGE_SCALE2, FLASH_LATENCY_0, RCC_HCLK_DIV1, RCC_HCLK_DIV1 },
+};
+
+#define DFS_OPPS                        ( sizeof(dfs_opps) / sizeof(dfs_opps[0]) )
+
+typedef struct {
+	dfs_mode_t mode;
+	uint32_t   opp;
+	uint32_t   load_permille;
+	uint32_t   transitions;
+	uint32_t   failures;
+	uint32_t   last_switch_us;
+	uint32_t   max_switch_us;
+	uint64_t   entered_us;
+	uint32_t   entries[ DFS_OPPS ];
+	uint64_t   time_us[ DFS_OPPS ];
+} dfs_state_t;
+
+static void dfs_task(void *params);
+static bool dfs_switch(uint32_t opp);
+static bool dfs_apply(const dfs_opp_t *opp);
+static uint32_t dfs_pclk_hz(uint32_t hclk_hz, uint32_t divider);
+
+static dfs_state_t dfs_state;
+
+/**
+  * @brief  Creates the governor task.
+  * @note   Must be called before the scheduler is started, with the clock
+  *         set by SystemClock_Config().
+  * @param  None
+  * @retval None
+  */
+void dfs_init(void)
+{
+	BaseType_t retv;
+
+	configASSERT(SystemCoreClock == dfs_opps[0].sysclk_hz);
+
+	dfs_state.mode = DFS_MODE_AUTO;
+	dfs_state.opp = 0;
+	dfs_state.entries[0] = 1;
+	dfs_state.entered_us = timebase_get_us64();
+
+	retv = xTaskCreate(dfs_task,					/* The governor. */
+					   "DFS",						/* Text name assigned to the task.  This is just to assist debugging. */
+					   DFS_TASK_STACK_SIZE,			/* The size of the stack allocated to the task. */
+					   NULL,						/* The parameter is not used, so NULL is passed. */
+					   DFS_TASK_PRIORITY | portPRIVILEGE_BIT,	/* The priority allocated to the task, privileged as a clock switch sets the tick interrupt up in the NVIC. */
+					   NULL );
+	configASSERT( retv == pdPASS );
+}
+
+/**
+  * @brief  Lets the governor follow the load or fixes the operating point.
+  * @param  mode: DFS_MODE_AUTO or DFS_MODE_FIXED
+  * @param  opp: Index of the operating point in fixed mode, 0 is the fastest
+  * @retval true if the mode was set, false if the operating point does not
+  *         exist or the clock could not be switched
+  */
+bool dfs_set_mode(dfs_mode_t mode, uint32_t opp)
+{
+	bool retv = true;
+
+	if ((mode == DFS_MODE_FIXED) && (opp >= DFS_OPPS)) {
+		return false;
+	}
+
+	vTaskSuspendAll();
+	{
+		dfs_state.mode = mode;
+
+		if (mode == DFS_MODE_FIXED) {
+			retv = dfs_switch(opp);
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	return retv;
+}
+
+/**
+  * @brief  Prints the operating points, the current one and the transitions.
+  * @param  buffer: Output buffer
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void dfs_print(char *buffer, size_t length)
+{
+	dfs_state_t state;
+	const dfs_opp_t *opp;
+	size_t written;
+	uint32_t i;
+
+	configASSERT(buffer);
+
+	vTaskSuspendAll();
+	{
+		state = dfs_state;
+		state.time_us[state.opp] += timebase_get_us64() - state.entered_us;
+	}
+	( void ) xTaskResumeAll();
+
+	written = snprintf(buffer, length,
+		"\r\nMode: %s, load: %lu.%lu %%\r\n"
+		"\r\n   OPP  SYSCLK[MHz]  PCLK1/PCLK2[MHz]  Scale  Wait states  Entered   Time[s]\r\n",
+		(state.mode == DFS_MODE_AUTO) ? "auto" : "fixed",
+		( unsigned long ) (state.load_permille / 10U), ( unsigned long ) (state.load_permille % 10U));
+
+	for (i = 0; (i < DFS_OPPS) && (written < length); i++) {
+		opp = &dfs_opps[i];
+
+		written += snprintf(buffer + written, length - written, "%c  %3lu  %11lu  %8lu/%-7lu  %5u  %11lu  %7lu  %8lu\r\n",
+			(i == state.opp) ? '*' : ' ',
+			( unsigned long ) i,
+			( unsigned long ) (opp->sysclk_hz / 1000000UL),
+			( unsigned long ) (dfs_pclk_hz(opp->sysclk_hz, opp->apb1_divider) / 1000000UL),
+			( unsigned long ) (dfs_pclk_hz(opp->sysclk_hz, opp->apb2_divider) / 1000000UL),
+			(opp->voltage_scale == PWR_REGULATOR_VOLTAGE_SCALE1) ? 1U : 2U,
+			( unsigned long ) opp->latency,
+			( unsigned long ) state.entries[i],
+			( unsigned long ) (state.time_us[i] / 1000000ULL));
+	}
+
+	if (written < length) {
+		snprintf(buffer + written, length - written,
+			"Transitions: %lu, failed: %lu, last switch: %lu us, longest: %lu us\r\n",
+			( unsigned long ) state.transitions, ( unsigned long ) state.failures,
+			( unsigned long ) state.last_switch_us, ( unsigned long ) state.max_switch_us);
+	}
+}
+
+static void dfs_task(void *params)
+{
+	TickType_t wake = xTaskGetTickCount();
+	uint32_t last_total = portGET_RUN_TIME_COUNTER_VALUE();
+	uint32_t last_idle = ulTaskGetIdleRunTimeCounter();
+	uint32_t low_periods = 0;
+	uint32_t total;
+	uint32_t idle;
+	uint32_t load;
+	uint32_t opp;
+
+	( void ) params;
+
+	( void ) watchdog_attach(NULL, DFS_WATCHDOG_PERIOD_MS);
+
+	for (;;) {
+		vTaskDelayUntil(&wake, pdMS_TO_TICKS(DFS_GOVERNOR_PERIOD_MS));
+		watchdog_heartbeat();
+
+		/* Both counters are in run time stats units, independent of the CPU
+		clock. */
+		total = portGET_RUN_TIME_COUNTER_VALUE();
+		idle = ulTaskGetIdleRunTimeCounter();
+
+		load = 0;
+		if ((total - last_total) != 0) {
+			load = (uint32_t)(((uint64_t)(idle - last_idle) * 1000U) / (total - last_total));
+			load = (load < 1000U) ? (1000U - load) : 0;
+		}
+
+		last_total = total;
+		last_idle = idle;
+
+		vTaskSuspendAll();
+		{
+			dfs_state.load_permille = load;
+			opp = dfs_state.opp;
+
+			if (dfs_state.mode == DFS_MODE_AUTO) {
+				if (load > DFS_UP_THRESHOLD * 10U) {
+					low_periods = 0;
+					opp = 0;
+				} else if ((load < DFS_DOWN_THRESHOLD * 10U) && (opp + 1U < DFS_OPPS)) {
+					low_periods++;
+
+					/* The same work takes longer on the slower clock. */
+					if ((low_periods >= DFS_DOWN_PERIODS) &&
+						((uint64_t)load * dfs_opps[opp].sysclk_hz < (uint64_t)DFS_UP_THRESHOLD * 10U * dfs_opps[opp + 1U].sysclk_hz)) {
+						low_periods = 0;
+						opp++;
+					}
+				} else {
+					low_periods = 0;
+				}
+
+				if (opp != dfs_state.opp) {
+					( void ) dfs_switch(opp);
+				}
+			}
+		}
+		( void ) xTaskResumeAll();
+	}
+}
+
+/**
+  * @brief  Switches to an operating point and updates the statistics.
+  * @note   Called with the scheduler suspended.
+  * @param  opp: Index of the operating point
+  * @retval true on success, false if the clock could not be switched
+  */
+static bool dfs_switch(uint32_t opp)
+{
+	uint64_t now;
+	uint32_t start;
+	bool retv;
+
+	if (opp == dfs_state.opp) {
+		return true;
+	}
+
+	start = timebase_get_us();
+
+	/* A character on the line would be garbled by the baud rate change. */
+	cli_io_clock_change_begin();
+	binlog_clock_change_begin();
+
+	retv = dfs_apply(&dfs_opps[opp]);
+	if (true != retv) {
+		/* Go back to the current operating point from wherever the failed
+		step left the clock. */
+		( void ) dfs_apply(&dfs_opps[dfs_state.opp]);
+	}
+
+	binlog_clock_change_end();
+	cli_io_clock_change_end();
+	task_budget_clock_changed();
+	rtc_calib_clock_changed();
+
+	if (true != retv) {
+		dfs_state.failures++;
+		BINLOG("dfs: switch from OPP %u to OPP %u failed", dfs_state.opp, opp);
+		return false;
+	}
+
+	now = timebase_get_us64();
+	dfs_state.time_us[dfs_state.opp] += now - dfs_state.entered_us;
+	dfs_state.entered_us = now;
+	dfs_state.opp = opp;
+	dfs_state.entries[opp]++;
+	dfs_state.transitions++;
+	dfs_state.last_switch_us = timebase_get_us() - start;
+	if (dfs_state.last_switch_us > dfs_state.max_switch_us) {
+		dfs_state.max_switch_us = dfs_state.last_switch_us;
+	}
+
+	BINLOG("dfs: OPP %u, %u MHz, load %u permille, switched in %u us",
+		opp, dfs_opps[opp].sysclk_hz / 1000000UL, dfs_state.load_permille, dfs_state.last_switch_us);
+
+	return true;
+}
+
+/**
+  * @brief  Programs the clock tree for an operating point.
+  * @param  opp: The operating point
+  * @retval true on success, false if a step failed
+  */
+static bool dfs_apply(const dfs_opp_t *opp)
+{
+	RCC_OscInitTypeDef osc = {0};
+	RCC_ClkInitTypeDef clk = {0};
+	uint32_t start;
+
+	/* Run from HSE, the wait states are kept until the final clock is
+	set. */
+	clk.ClockType      = RCC_CLOCKTYPE_HCLK | RCC_CLOCKTYPE_SYSCLK | RCC_CLOCKTYPE_PCLK1 | RCC_CLOCKTYPE_PCLK2;
+	clk.SYSCLKSource   = RCC_SYSCLKSOURCE_HSE;
+	clk.AHBCLKDivider  = RCC_SYSCLK_DIV1;
+	clk.APB1CLKDivider = RCC_HCLK_DIV1;
+	clk.APB2CLKDivider = RCC_HCLK_DIV1;
+
+	if (HAL_RCC_ClockConfig(&clk, __HAL_FLASH_GET_LATENCY()) != HAL_OK) {
+		return false;
+	}
+
+	/* The regulator scale is changed with the PLL off. */
+	__HAL_RCC_PLL_DISABLE();
+
+	start = HAL_GetTick();
+	while (__HAL_RCC_GET_FLAG(RCC_FLAG_PLLRDY) != RESET) {
+		if ((HAL_GetTick() - start) > DFS_PLL_TIMEOUT_MS) {
+			return false;
+		}
+	}
+
+	__HAL_PWR_VOLTAGESCALING_CONFIG(opp->voltage_scale);
+
+	osc.OscillatorType = RCC_OSCILLATORTYPE_NONE;
+	osc.PLL.PLLState   = RCC_PLL_ON;
+	osc.PLL.PLLSource  = RCC_PLLSOURCE_HSE;
+	osc.PLL.PLLM       = DFS_PLLM;
+	osc.PLL.PLLN       = opp->plln;
+	osc.PLL.PLLP       = opp->pllp;
+	osc.PLL.PLLQ       = opp->pllq;
+
+	if (HAL_RCC_OscConfig(&osc) != HAL_OK) {
+		return false;
+	}
+
+	/* Sets the wait states before a faster clock and after a slower one,
+	then reloads the TIM2 prescaler. */
+	clk.SYSCLKSource   = RCC_SYSCLKSOURCE_PLLCLK;
+	clk.APB1CLKDivider = opp->apb1_divider;
+	clk.APB2CLKDivider = opp->apb2_divider;
+
+	return (HAL_RCC_ClockConfig(&clk, opp->latency) == HAL_OK);
+}
+
+/**
+  * @brief  Computes an APB clock.
+  * @param  hclk_hz: AHB clock, equal to SYSCLK
+  * @param  divider: RCC_HCLK_DIV1 ... RCC_HCLK_DIV16
+  * @retval The APB clock in Hz
+  */
+static uint32_t dfs_pclk_hz(uint32_t hclk_hz, uint32_t divider)
+{
+	/* DIV2 to DIV16 are encoded as 4 to 7. */
+	if (divider == RCC_HCLK_DIV1) {
+		return hclk_hz;
+	}
+
+	return hclk_hz >> ((divider >> RCC_CFGR_PPRE1_Pos) - 3U);
+}
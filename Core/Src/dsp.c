@@ -0,0 +1,585 @@
+/**
+  ******************************************************************************
+  * @file    dsp.c
+  * @brief   Q15 signal processing kernels: FIR and decimating FIR filters,
+  *          biquad IIR filters, radix-2 FFT, RMS and peak level.
+  *
+  *          Each kernel comes in two versions.  The SIMD one works on pairs
+  *          of 16-bit samples held in one 32-bit register and uses the
+  *          Cortex-M4 DSP extension: SMLALD does two multiply-accumulates of
+  *          a filter in one cycle, SMUAD and SMUSDX compute a complex
+  *          product, SHADD16, QADD16 and QSUB16 do both halves of an FFT
+  *          butterfly at once and SSUB16 with SEL finds two maxima at a time.
+  *          The scalar version does the same arithmetic one sample at a time
+  *          in plain C, with the same rounding and saturation, so the two
+  *          give bit exact results and dsp-bench can compare them.
+  *
+  *          Accumulators are 64 bits wide, a 32 tap filter can not overflow.
+  *          Results are truncated and saturated to Q15.  The FFT scales by
+  *          one half in every stage, its output is the transform divided by
+  *          the size.  Pairs are read with unaligned 32-bit loads, which the
+  *          Cortex-M4 supports for LDR.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "dsp.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stm32f4xx.h"
+
+#include <math.h>
+#include <string.h>
+
+/* cos(2 pi k / N) and sin(2 pi k / N) for k < N / 2, interleaved. */
+static int16_t dsp_twiddles[ DSP_FFT_MAX_SIZE ];
+
+static inline int32_t dsp_read_q15x2(const int16_t *p);
+static inline void dsp_write_q15x2(int16_t *p, int32_t value);
+static inline int16_t dsp_saturate(int64_t value);
+static void dsp_fft_bit_reverse(int16_t *data, uint32_t size);
+static uint32_t dsp_sqrt(uint32_t value);
+
+/**
+  * @brief  Initializes a FIR filter.
+  * @param  fir: The filter to initialize
+  * @param  coeffs: Q15 coefficients in reversed order, h[taps - 1] first
+  * @param  taps: Number of coefficients, must be even
+  * @param  decimation: Output rate divider, 1 for no decimation
+  * @param  state: taps - 1 plus the largest block of samples, cleared here
+  * @retval None
+  */
+void dsp_fir_init(dsp_fir_t *fir, const int16_t *coeffs, uint32_t taps, uint32_t decimation, int16_t *state)
+{
+	configASSERT(fir);
+	configASSERT(coeffs);
+	configASSERT(state);
+	configASSERT((taps >= 2) && ((taps & 1U) == 0));
+	configASSERT(decimation >= 1);
+
+	fir->coeffs     = coeffs;
+	fir->state      = state;
+	fir->taps       = taps;
+	fir->decimation = decimation;
+
+	memset(state, 0, (taps - 1U) * sizeof(int16_t));
+}
+
+/**
+  * @brief  Filters a block of samples, SIMD version.
+  * @param  fir: The filter
+  * @param  in: Input samples
+  * @param  out: Output samples, count / decimation of them
+  * @param  count: Number of input samples, a multiple of the decimation
+  * @retval Number of output samples
+  */
+uint32_t dsp_fir(dsp_fir_t *fir, const int16_t *in, int16_t *out, uint32_t count)
+{
+	const int16_t *coeffs = fir->coeffs;
+	const int16_t *x;
+	uint32_t taps = fir->taps;
+	uint32_t produced = 0;
+	uint32_t n;
+	uint32_t k;
+	int64_t acc;
+
+	configASSERT((count % fir->decimation) == 0);
+
+	/* The new samples follow the last taps - 1 of the previous block. */
+	memcpy(&fir->state[taps - 1U], in, count * sizeof(int16_t));
+
+	for (n = fir->decimation - 1U; n < count; n += fir->decimation) {
+		x = &fir->state[n];
+		acc = 0;
+
+		/* Four taps per iteration, two in each SMLALD. */
+		for (k = 0; k + 4U <= taps; k += 4U) {
+			acc = __SMLALD(dsp_read_q15x2(&x[k]), dsp_read_q15x2(&coeffs[k]), acc);
+			acc = __SMLALD(dsp_read_q15x2(&x[k + 2U]), dsp_read_q15x2(&coeffs[k + 2U]), acc);
+		}
+
+		if (k < taps) {
+			acc = __SMLALD(dsp_read_q15x2(&x[k]), dsp_read_q15x2(&coeffs[k]), acc);
+		}
+
+		out[produced++] = dsp_saturate(acc >> 15);
+	}
+
+	memmove(fir->state, &fir->state[count], (taps - 1U) * sizeof(int16_t));
+
+	return produced;
+}
+
+/**
+  * @brief  Filters a block of samples, scalar version.
+  * @param  fir: The filter
+  * @param  in: Input samples
+  * @param  out: Output samples, count / decimation of them
+  * @param  count: Number of input samples, a multiple of the decimation
+  * @retval Number of output samples
+  */
+uint32_t dsp_fir_scalar(dsp_fir_t *fir, const int16_t *in, int16_t *out, uint32_t count)
+{
+	const int16_t *x;
+	uint32_t taps = fir->taps;
+	uint32_t produced = 0;
+	uint32_t n;
+	uint32_t k;
+	int64_t acc;
+
+	configASSERT((count % fir->decimation) == 0);
+
+	memcpy(&fir->state[taps - 1U], in, count * sizeof(int16_t));
+
+	for (n = fir->decimation - 1U; n < count; n += fir->decimation) {
+		x = &fir->state[n];
+		acc = 0;
+
+		for (k = 0; k < taps; k++) {
+			acc += (int32_t)x[k] * fir->coeffs[k];
+		}
+
+		out[produced++] = dsp_saturate(acc >> 15);
+	}
+
+	memmove(fir->state, &fir->state[count], (taps - 1U) * sizeof(int16_t));
+
+	return produced;
+}
+
+/**
+  * @brief  Initializes a biquad cascade.
+  * @param  biquad: The filter to initialize
+  * @param  coeffs: DSP_BIQUAD_COEFFS Q14 coefficients per stage
+  * @param  stages: Number of biquad stages
+  * @param  state: DSP_BIQUAD_STATE values per stage, cleared here
+  * @retval None
+  */
+void dsp_biquad_init(dsp_biquad_t *biquad, const int16_t *coeffs, uint32_t stages, int16_t *state)
+{
+	configASSERT(biquad);
+	configASSERT(coeffs);
+	configASSERT(state);
+	configASSERT(stages > 0);
+
+	biquad->coeffs = coeffs;
+	biquad->state  = state;
+	biquad->stages = stages;
+
+	memset(state, 0, stages * DSP_BIQUAD_STATE * sizeof(int16_t));
+}
+
+/**
+  * @brief  Filters a block of samples, SIMD version.
+  * @param  biquad: The filter
+  * @param  in: Input samples
+  * @param  out: Output samples, may be the same buffer as the input
+  * @param  count: Number of samples
+  * @retval None
+  */
+void dsp_biquad(dsp_biquad_t *biquad, const int16_t *in, int16_t *out, uint32_t count)
+{
+	const int16_t *coeffs = biquad->coeffs;
+	int16_t *state = biquad->state;
+	const int16_t *src = in;
+	int32_t b0;
+	int32_t b1b2;
+	int32_t a1a2;
+	int32_t x1x2;
+	int32_t y1y2;
+	int32_t x;
+	int32_t y;
+	int64_t acc;
+	uint32_t stage;
+	uint32_t n;
+
+	for (stage = 0; stage < biquad->stages; stage++) {
+		b0   = coeffs[0];
+		b1b2 = dsp_read_q15x2(&coeffs[2]);
+		a1a2 = dsp_read_q15x2(&coeffs[4]);
+		x1x2 = dsp_read_q15x2(&state[0]);
+		y1y2 = dsp_read_q15x2(&state[2]);
+
+		for (n = 0; n < count; n++) {
+			x = src[n];
+
+			acc = (int64_t)(b0 * x);
+			acc = __SMLALD(x1x2, b1b2, acc);
+			acc = __SMLALD(y1y2, a1a2, acc);
+			y = dsp_saturate(acc >> 14);
+
+			/* The new sample goes to the low half, the older one moves up. */
+			x1x2 = __PKHBT(x, x1x2, 16);
+			y1y2 = __PKHBT(y, y1y2, 16);
+
+			out[n] = (int16_t)y;
+		}
+
+		dsp_write_q15x2(&state[0], x1x2);
+		dsp_write_q15x2(&state[2], y1y2);
+
+		/* The next stage filters the output of this one in place. */
+		src = out;
+		coeffs += DSP_BIQUAD_COEFFS;
+		state  += DSP_BIQUAD_STATE;
+	}
+}
+
+/**
+  * @brief  Filters a block of samples, scalar version.
+  * @param  biquad: The filter
+  * @param  in: Input samples
+  * @param  out: Output samples, may be the same buffer as the input
+  * @param  count: Number of samples
+  * @retval None
+  */
+void dsp_biquad_scalar(dsp_biquad_t *biquad, const int16_t *in, int16_t *out, uint32_t count)
+{
+	const int16_t *coeffs = biquad->coeffs;
+	int16_t *state = biquad->state;
+	const int16_t *src = in;
+	int16_t x;
+	int16_t y;
+	int64_t acc;
+	uint32_t stage;
+	uint32_t n;
+
+	for (stage = 0; stage < biquad->stages; stage++) {
+		for (n = 0; n < count; n++) {
+			x = src[n];
+
+			acc = (int64_t)coeffs[0] * x;
+			acc += (int32_t)coeffs[2] * state[0];
+			acc += (int32_t)coeffs[3] * state[1];
+			acc += (int32_t)coeffs[4] * state[2];
+			acc += (int32_t)coeffs[5] * state[3];
+			y = dsp_saturate(acc >> 14);
+
+			state[1] = state[0];
+			state[0] = x;
+			state[3] = state[2];
+			state[2] = y;
+
+			out[n] = y;
+		}
+
+		src = out;
+		coeffs += DSP_BIQUAD_COEFFS;
+		state  += DSP_BIQUAD_STATE;
+	}
+}
+
+/**
+  * @brief  Builds the twiddle factor table.
+  * @note   Uses the FPU, must be called before the scheduler is started or
+  *         from a task that declared floating point use.
+  * @param  None
+  * @retval None
+  */
+void dsp_fft_init(void)
+{
+	float angle;
+	uint32_t k;
+
+	for (k = 0; k < DSP_FFT_MAX_SIZE / 2U; k++) {
+		angle = (2.0f * (float)M_PI * (float)k) / (float)DSP_FFT_MAX_SIZE;
+
+		/* cos(0) = 1 is one LSB short in Q15. */
+		dsp_twiddles[2U * k]      = (int16_t)fminf(32767.0f, roundf(cosf(angle) * 32768.0f));
+		dsp_twiddles[2U * k + 1U] = (int16_t)fminf(32767.0f, roundf(sinf(angle) * 32768.0f));
+	}
+}
+
+/**
+  * @brief  In place complex forward FFT, SIMD version.
+  * @param  data: size complex Q15 samples, real and imaginary parts
+  *         interleaved.  Replaced by the transform divided by size, in
+  *         natural order.
+  * @param  size: Power of two, at most DSP_FFT_MAX_SIZE
+  * @retval None
+  */
+void dsp_fft(int16_t *data, uint32_t size)
+{
+	uint32_t half;
+	uint32_t stride;
+	uint32_t start;
+	uint32_t k;
+	int32_t w;
+	int32_t a;
+	int32_t b;
+	int32_t t;
+	int32_t *x = (int32_t *)(void *)data;
+
+	configASSERT((size >= 2) && (size <= DSP_FFT_MAX_SIZE) && ((size & (size - 1U)) == 0));
+
+	dsp_fft_bit_reverse(data, size);
+
+	for (half = 1; half < size; half <<= 1) {
+		stride = DSP_FFT_MAX_SIZE / (2U * half);
+
+		for (k = 0; k < half; k++) {
+			w = dsp_read_q15x2(&dsp_twiddles[2U * k * stride]);
+
+			for (start = k; start < size; start += 2U * half) {
+				a = dsp_read_q15x2((int16_t *)&x[start]);
+				b = dsp_read_q15x2((int16_t *)&x[start + half]);
+
+				/* t = b * (cos - j sin) / 2, the real part in the low half. */
+				t = __PKHTB(__SMUSDX(w, b), __SMUAD(b, w), 16);
+
+				/* Halving a keeps both outputs in range. */
+				a = __SHADD16(a, 0);
+
+				dsp_write_q15x2((int16_t *)&x[start], __QADD16(a, t));
+				dsp_write_q15x2((int16_t *)&x[start + half], __QSUB16(a, t));
+			}
+		}
+	}
+}
+
+/**
+  * @brief  In place complex forward FFT, scalar version.
+  * @param  data: size complex Q15 samples, real and imaginary parts
+  *         interleaved.  Replaced by the transform divided by size, in
+  *         natural order.
+  * @param  size: Power of two, at most DSP_FFT_MAX_SIZE
+  * @retval None
+  */
+void dsp_fft_scalar(int16_t *data, uint32_t size)
+{
+	uint32_t half;
+	uint32_t stride;
+	uint32_t start;
+	uint32_t k;
+	int32_t c;
+	int32_t s;
+	int32_t ar;
+	int32_t ai;
+	int32_t br;
+	int32_t bi;
+	int32_t tr;
+	int32_t ti;
+
+	configASSERT((size >= 2) && (size <= DSP_FFT_MAX_SIZE) && ((size & (size - 1U)) == 0));
+
+	dsp_fft_bit_reverse(data, size);
+
+	for (half = 1; half < size; half <<= 1) {
+		stride = DSP_FFT_MAX_SIZE / (2U * half);
+
+		for (k = 0; k < half; k++) {
+			c = dsp_twiddles[2U * k * stride];
+			s = dsp_twiddles[2U * k * stride + 1U];
+
+			for (start = k; start < size; start += 2U * half) {
+				ar = data[2U * start];
+				ai = data[2U * start + 1U];
+				br = data[2U * (start + half)];
+				bi = data[2U * (start + half) + 1U];
+
+				tr = (br * c + bi * s) >> 16;
+				ti = (c * bi - s * br) >> 16;
+
+				ar >>= 1;
+				ai >>= 1;
+
+				data[2U * start]                = dsp_saturate(ar + tr);
+				data[2U * start + 1U]           = dsp_saturate(ai + ti);
+				data[2U * (start + half)]       = dsp_saturate(ar - tr);
+				data[2U * (start + half) + 1U]  = dsp_saturate(ai - ti);
+			}
+		}
+	}
+}
+
+/**
+  * @brief  Finds the strongest bin of a transform.
+  * @note   Only the first half of the bins is searched, the input of the
+  *         FFT is expected to be real.  The DC bin is skipped.
+  * @param  data: Output of dsp_fft()
+  * @param  size: Number of complex samples
+  * @param  power: Set to the squared magnitude of the bin in Q30, may be NULL
+  * @retval Index of the strongest bin
+  */
+uint32_t dsp_fft_peak_bin(const int16_t *data, uint32_t size, uint32_t *power)
+{
+	uint32_t best = 1;
+	uint32_t best_power = 0;
+	uint32_t bin_power;
+	int32_t bin;
+	uint32_t k;
+
+	for (k = 1; k < size / 2U; k++) {
+		bin = dsp_read_q15x2(&data[2U * k]);
+		bin_power = (uint32_t)__SMUAD(bin, bin);
+
+		if (bin_power > best_power) {
+			best_power = bin_power;
+			best = k;
+		}
+	}
+
+	if (power != NULL) {
+		*power = best_power;
+	}
+
+	return best;
+}
+
+/**
+  * @brief  Computes the RMS and peak level of a block, SIMD version.
+  * @param  in: Samples
+  * @param  count: Number of samples, must be even
+  * @param  rms: Set to the root mean square level in Q15
+  * @param  peak: Set to the largest absolute value in Q15, -1.0 counts as
+  *         the largest positive value
+  * @retval None
+  */
+void dsp_stats(const int16_t *in, uint32_t count, uint16_t *rms, uint16_t *peak)
+{
+	uint64_t sum = 0;
+	int32_t max = 0;
+	int32_t x;
+	int32_t magnitude;
+	uint32_t n;
+
+	configASSERT((count > 0) && ((count & 1U) == 0));
+
+	for (n = 0; n < count; n += 2U) {
+		x = dsp_read_q15x2(&in[n]);
+
+		sum = (uint64_t)__SMLALD(x, x, (int64_t)sum);
+
+		/* |x| of both halves, SSUB16 sets the GE flags where x >= -x and
+		SEL picks the larger one. */
+		magnitude = __QSUB16(0, x);
+		( void ) __SSUB16(x, magnitude);
+		magnitude = __SEL(x, magnitude);
+
+		( void ) __SSUB16(magnitude, max);
+		max = __SEL(magnitude, max);
+	}
+
+	*rms = (uint16_t)dsp_sqrt((uint32_t)(sum / count));
+	*peak = (uint16_t)(((int16_t)max > (int16_t)(max >> 16)) ? (int16_t)max : (int16_t)(max >> 16));
+}
+
+/**
+  * @brief  Computes the RMS and peak level of a block, scalar version.
+  * @param  in: Samples
+  * @param  count: Number of samples, must be even
+  * @param  rms: Set to the root mean square level in Q15
+  * @param  peak: Set to the largest absolute value in Q15, -1.0 counts as
+  *         the largest positive value
+  * @retval None
+  */
+void dsp_stats_scalar(const int16_t *in, uint32_t count, uint16_t *rms, uint16_t *peak)
+{
+	uint64_t sum = 0;
+	int32_t max = 0;
+	int32_t x;
+	uint32_t n;
+
+	configASSERT((count > 0) && ((count & 1U) == 0));
+
+	for (n = 0; n < count; n++) {
+		x = in[n];
+		sum += (uint32_t)(x * x);
+
+		x = dsp_saturate((x < 0) ? -x : x);
+		if (x > max) {
+			max = x;
+		}
+	}
+
+	*rms = (uint16_t)dsp_sqrt((uint32_t)(sum / count));
+	*peak = (uint16_t)max;
+}
+
+/**
+  * @brief  Looks up the sine of a phase.
+  * @note   dsp_fft_init() must have been called, the resolution is
+  *         DSP_FFT_MAX_SIZE points per period.
+  * @param  phase: Angle, 2^32 is a full period
+  * @retval Sine of the phase in Q15
+  */
+int16_t dsp_sine(uint32_t phase)
+{
+	uint32_t index = (uint32_t)(((uint64_t)phase * DSP_FFT_MAX_SIZE) >> 32);
+
+	if (index < DSP_FFT_MAX_SIZE / 2U) {
+		return dsp_twiddles[2U * index + 1U];
+	}
+
+	return (int16_t)-dsp_twiddles[2U * (index - DSP_FFT_MAX_SIZE / 2U) + 1U];
+}
+
+static inline int32_t dsp_read_q15x2(const int16_t *p)
+{
+	int32_t value;
+
+	/* Compiles to a single, possibly unaligned, LDR. */
+	memcpy(&value, p, sizeof(value));
+
+	return value;
+}
+
+static inline void dsp_write_q15x2(int16_t *p, int32_t value)
+{
+	memcpy(p, &value, sizeof(value));
+}
+
+static inline int16_t dsp_saturate(int64_t value)
+{
+	if (value > INT16_MAX) {
+		return INT16_MAX;
+	}
+
+	if (value < INT16_MIN) {
+		return INT16_MIN;
+	}
+
+	return (int16_t)value;
+}
+
+static void dsp_fft_bit_reverse(int16_t *data, uint32_t size)
+{
+	uint32_t *x = (uint32_t *)(void *)data;
+	uint32_t shift = __CLZ(size) + 1U;
+	uint32_t reversed;
+	uint32_t tmp;
+	uint32_t i;
+
+	/* Swaps whole complex samples, each one is a 32-bit word. */
+	for (i = 1; i < size - 1U; i++) {
+		reversed = __RBIT(i) >> shift;
+		if (i < reversed) {
+			tmp = x[i];
+			x[i] = x[reversed];
+			x[reversed] = tmp;
+		}
+	}
+}
+
+static uint32_t dsp_sqrt(uint32_t value)
+{
+	uint32_t root = 0;
+	uint32_t bit = 1UL << 30;
+
+	while (bit > value) {
+		bit >>= 2;
+	}
+
+	while (bit != 0) {
+		if (value >= root + bit) {
+			value -= root + bit;
+			root = (root >> 1) + bit;
+		} else {
+			root >>= 1;
+		}
+		bit >>= 2;
+	}
+
+	return root;
+}
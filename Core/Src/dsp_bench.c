@@ -0,0 +1,215 @@
+/**
+  ******************************************************************************
+  * @file    dsp_bench.c
+  * @brief   Compares the scalar and the SIMD versions of the dsp.c kernels.
+  *
+  *          Every kernel processes the same DSP_BENCH_SAMPLES pseudo random
+  *          samples with both versions.  The CPU cycles per input sample are
+  *          measured with the scheduler suspended, the fastest of
+  *          DSP_BENCH_RUNS runs is kept to leave out the interrupts, and the
+  *          two outputs are compared, they must be bit exact.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "dsp_bench.h"
+#include "dsp.h"
+#include "cycle_counter.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+#define DSP_BENCH_FIR_TAPS              32U
+#define DSP_BENCH_BIQUAD_STAGES         2U
+
+typedef uint32_t ( *dsp_bench_kernel_t )( bool simd, int16_t *out );
+
+static uint32_t dsp_bench_fir(bool simd, int16_t *out);
+static uint32_t dsp_bench_fir_decimate(bool simd, int16_t *out);
+static uint32_t dsp_bench_biquad(bool simd, int16_t *out);
+static uint32_t dsp_bench_fft(bool simd, int16_t *out);
+static uint32_t dsp_bench_stats(bool simd, int16_t *out);
+
+static const struct {
+	const char         *name;
+	dsp_bench_kernel_t  kernel;
+} dsp_bench_kernels[] = {
+	{ "FIR 32 taps",       dsp_bench_fir },
+	{ "FIR 32 taps, 4:1",  dsp_bench_fir_decimate },
+	{ "Biquad x2",         dsp_bench_biquad },
+	{ "FFT 256",           dsp_bench_fft },
+	{ "RMS and peak",      dsp_bench_stats },
+};
+
+/* Fourth order low pass at 1/8 of the sample rate, Q14. */
+static const int16_t dsp_bench_biquad_coeffs[ DSP_BENCH_BIQUAD_STAGES * DSP_BIQUAD_COEFFS ] = {
+	1600, 0, 3199, 1600, 15447, -5461,
+	1600, 0, 3199, 1600, 15447, -5461,
+};
+
+static int16_t dsp_bench_input[ DSP_BENCH_SAMPLES ];
+static int16_t dsp_bench_fir_coeffs[ DSP_BENCH_FIR_TAPS ];
+static int16_t dsp_bench_fir_state[ DSP_BENCH_FIR_TAPS - 1U + DSP_BENCH_SAMPLES ];
+static int16_t dsp_bench_biquad_state[ DSP_BENCH_BIQUAD_STAGES * DSP_BIQUAD_STATE ];
+static int16_t dsp_bench_outputs[ 2 ][ 2U * DSP_BENCH_SAMPLES ] __attribute__((aligned(4)));
+
+/**
+  * @brief  Runs the benchmark and prints the results.
+  * @param  buffer: Output buffer for the result table
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void dsp_bench_run(char *buffer, size_t length)
+{
+	uint32_t cycles[ 2 ];
+	uint32_t elapsed;
+	uint32_t seed = 1;
+	uint32_t speedup;
+	uint32_t i;
+	uint32_t run;
+	uint32_t simd;
+	size_t written;
+
+	configASSERT(buffer);
+
+	cycle_counter_init();
+
+	/* Full scale input, and coefficients that can not saturate the FIR. */
+	for (i = 0; i < DSP_BENCH_SAMPLES; i++) {
+		seed = seed * 1664525UL + 1013904223UL;
+		dsp_bench_input[i] = (int16_t)(seed >> 16);
+	}
+
+	for (i = 0; i < DSP_BENCH_FIR_TAPS; i++) {
+		seed = seed * 1664525UL + 1013904223UL;
+		dsp_bench_fir_coeffs[i] = (int16_t)((int16_t)(seed >> 16) / 64);
+	}
+
+	written = snprintf(buffer, length,
+		"\r\nKernel              Scalar    SIMD  Speedup  Output  [CPU cycles per sample]\r\n");
+
+	for (i = 0; (i < sizeof(dsp_bench_kernels) / sizeof(dsp_bench_kernels[0])) && (written < length); i++) {
+		for (simd = 0; simd < 2; simd++) {
+			memset(dsp_bench_outputs[simd], 0, sizeof(dsp_bench_outputs[simd]));
+			cycles[simd] = UINT32_MAX;
+
+			for (run = 0; run < DSP_BENCH_RUNS; run++) {
+				vTaskSuspendAll();
+				{
+					elapsed = dsp_bench_kernels[i].kernel(simd != 0, dsp_bench_outputs[simd]);
+				}
+				( void ) xTaskResumeAll();
+
+				if (elapsed < cycles[simd]) {
+					cycles[simd] = elapsed;
+				}
+			}
+		}
+
+		speedup = (cycles[1] != 0) ? ((cycles[0] * 100U) / cycles[1]) : 0;
+
+		written += snprintf(buffer + written, length - written, "%-18s  %4lu.%lu  %4lu.%lu  %4lu.%02lu  %s\r\n",
+			dsp_bench_kernels[i].name,
+			( unsigned long ) ((cycles[0] * 10U / DSP_BENCH_SAMPLES) / 10U), ( unsigned long ) ((cycles[0] * 10U / DSP_BENCH_SAMPLES) % 10U),
+			( unsigned long ) ((cycles[1] * 10U / DSP_BENCH_SAMPLES) / 10U), ( unsigned long ) ((cycles[1] * 10U / DSP_BENCH_SAMPLES) % 10U),
+			( unsigned long ) (speedup / 100U), ( unsigned long ) (speedup % 100U),
+			(memcmp(dsp_bench_outputs[0], dsp_bench_outputs[1], sizeof(dsp_bench_outputs[0])) == 0) ? "match" : "DIFFER");
+	}
+}
+
+static uint32_t dsp_bench_fir(bool simd, int16_t *out)
+{
+	dsp_fir_t fir;
+	uint32_t start;
+
+	dsp_fir_init(&fir, dsp_bench_fir_coeffs, DSP_BENCH_FIR_TAPS, 1, dsp_bench_fir_state);
+
+	start = cycle_counter_get();
+	if (true == simd) {
+		dsp_fir(&fir, dsp_bench_input, out, DSP_BENCH_SAMPLES);
+	} else {
+		dsp_fir_scalar(&fir, dsp_bench_input, out, DSP_BENCH_SAMPLES);
+	}
+
+	return cycle_counter_get() - start;
+}
+
+static uint32_t dsp_bench_fir_decimate(bool simd, int16_t *out)
+{
+	dsp_fir_t fir;
+	uint32_t start;
+
+	dsp_fir_init(&fir, dsp_bench_fir_coeffs, DSP_BENCH_FIR_TAPS, 4, dsp_bench_fir_state);
+
+	start = cycle_counter_get();
+	if (true == simd) {
+		dsp_fir(&fir, dsp_bench_input, out, DSP_BENCH_SAMPLES);
+	} else {
+		dsp_fir_scalar(&fir, dsp_bench_input, out, DSP_BENCH_SAMPLES);
+	}
+
+	return cycle_counter_get() - start;
+}
+
+static uint32_t dsp_bench_biquad(bool simd, int16_t *out)
+{
+	dsp_biquad_t biquad;
+	uint32_t start;
+
+	dsp_biquad_init(&biquad, dsp_bench_biquad_coeffs, DSP_BENCH_BIQUAD_STAGES, dsp_bench_biquad_state);
+
+	start = cycle_counter_get();
+	if (true == simd) {
+		dsp_biquad(&biquad, dsp_bench_input, out, DSP_BENCH_SAMPLES);
+	} else {
+		dsp_biquad_scalar(&biquad, dsp_bench_input, out, DSP_BENCH_SAMPLES);
+	}
+
+	return cycle_counter_get() - start;
+}
+
+static uint32_t dsp_bench_fft(bool simd, int16_t *out)
+{
+	uint32_t start;
+	uint32_t i;
+
+	/* Real input, zero imaginary parts. */
+	for (i = 0; i < DSP_BENCH_SAMPLES; i++) {
+		out[2U * i]      = dsp_bench_input[i];
+		out[2U * i + 1U] = 0;
+	}
+
+	start = cycle_counter_get();
+	if (true == simd) {
+		dsp_fft(out, DSP_BENCH_SAMPLES);
+	} else {
+		dsp_fft_scalar(out, DSP_BENCH_SAMPLES);
+	}
+
+	return cycle_counter_get() - start;
+}
+
+static uint32_t dsp_bench_stats(bool simd, int16_t *out)
+{
+	uint16_t rms;
+	uint16_t peak;
+	uint32_t start;
+
+	start = cycle_counter_get();
+	if (true == simd) {
+		dsp_stats(dsp_bench_input, DSP_BENCH_SAMPLES, &rms, &peak);
+	} else {
+		dsp_stats_scalar(dsp_bench_input, DSP_BENCH_SAMPLES, &rms, &peak);
+	}
+
+	start = cycle_counter_get() - start;
+
+	out[0] = (int16_t)rms;
+	out[1] = (int16_t)peak;
+
+	return start;
+}
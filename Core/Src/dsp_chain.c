@@ -0,0 +1,443 @@
+/**
+  ******************************************************************************
+  * @file    dsp_chain.c
+  * @brief   Sensor front end signal chain built on the dsp.c kernels.
+  *
+  *          A producer task stands in for the sampled sensor: every block
+  *          period it fills a block with two tones and some noise at
+  *          DSP_CHAIN_SAMPLE_RATE and hands it over through a zero copy
+  *          queue.  The processing task low pass filters each block with a
+  *          FIR or an IIR filter, decimates it, measures the RMS and peak
+  *          level of the result and collects DSP_CHAIN_FFT_SIZE output
+  *          samples for an FFT that finds the dominant frequency.  A block
+  *          that finds no free buffer is dropped and counted, which happens
+  *          when the processing falls behind.
+  *
+  *          The configuration set from the CLI is picked up by the tasks at
+  *          the next block.  The processing task designs the filters in
+  *          floating point and declares its FPU use, every other step works
+  *          on Q15 samples.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "dsp_chain.h"
+#include "dsp.h"
+#include "zc_queue.h"
+#include "cycle_counter.h"
+
+#include <math.h>
+#include <stdio.h>
+
+typedef struct {
+	dsp_chain_filter_t filter;
+	uint32_t           cutoff_hz;
+	uint32_t           decimation;
+	uint32_t           tone_hz[ 2 ];
+} dsp_chain_config_t;
+
+typedef struct {
+	uint32_t blocks;
+	uint32_t dropped;
+	uint64_t cycles_total;
+	uint32_t cycles_max;
+	uint16_t rms;
+	uint16_t peak;
+	uint32_t dominant_hz;
+} dsp_chain_stats_t;
+
+static zc_queue_t *dsp_chain_queue;
+
+/* Written by the CLI, copied by the tasks when the version changes.  Both
+are only accessed in critical sections. */
+static dsp_chain_config_t dsp_chain_config = {
+	.filter     = DSP_CHAIN_FILTER_NONE,
+	.cutoff_hz  = 1000U,
+	.decimation = 1U,
+	.tone_hz    = { 440U, 2500U },
+};
+static uint32_t dsp_chain_config_version;
+
+static dsp_chain_stats_t dsp_chain_stats;
+
+/* Owned by the processing task. */
+static int16_t dsp_chain_fir_coeffs[ DSP_CHAIN_FIR_TAPS ];
+static int16_t dsp_chain_fir_state[ DSP_CHAIN_FIR_TAPS - 1U + DSP_CHAIN_BLOCK_SIZE ];
+static int16_t dsp_chain_iir_coeffs[ DSP_CHAIN_IIR_STAGES * DSP_BIQUAD_COEFFS ];
+static int16_t dsp_chain_iir_state[ DSP_CHAIN_IIR_STAGES * DSP_BIQUAD_STATE ];
+static int16_t dsp_chain_output[ DSP_CHAIN_BLOCK_SIZE ];
+static int16_t dsp_chain_fft_frame[ 2U * DSP_CHAIN_FFT_SIZE ] __attribute__((aligned(4)));
+
+static const char * const dsp_chain_filter_names[] = { "none", "FIR low pass", "IIR low pass" };
+
+static void dsp_chain_producer_task(void *params);
+static void dsp_chain_processor_task(void *params);
+static void dsp_chain_design_fir(uint32_t cutoff_hz);
+static void dsp_chain_design_iir(uint32_t cutoff_hz);
+static int16_t dsp_chain_quantize(float value, float scale);
+
+/**
+  * @brief  Builds the FFT tables and creates the producer and the
+  *         processing task.
+  * @note   Must be called before the scheduler is started.
+  * @param  None
+  * @retval None
+  */
+void dsp_chain_init(void)
+{
+	BaseType_t retv;
+
+	cycle_counter_init();
+	dsp_fft_init();
+
+	dsp_chain_queue = zc_queue_create(DSP_CHAIN_BLOCK_SIZE * sizeof(int16_t), DSP_CHAIN_BLOCKS);
+	configASSERT(dsp_chain_queue);
+
+	retv = xTaskCreate(dsp_chain_producer_task,		/* The task that generates the samples. */
+					   "DSPProducer",				/* Text name assigned to the task.  This is just to assist debugging. */
+					   configMINIMAL_STACK_SIZE,		/* The size of the stack allocated to the task. */
+					   NULL,						/* The parameter is not used, so NULL is passed. */
+					   DSP_CHAIN_PRODUCER_PRIORITY | portPRIVILEGE_BIT,	/* The priority allocated to the task, privileged as the blocks are on the kernel heap. */
+					   NULL );
+	configASSERT( retv == pdPASS );
+
+	retv = xTaskCreate(dsp_chain_processor_task,	/* The task that filters and analyses the blocks. */
+					   "DSP",						/* Text name assigned to the task.  This is just to assist debugging. */
+					   DSP_CHAIN_TASK_STACK_SIZE,	/* The size of the stack allocated to the task. */
+					   NULL,						/* The parameter is not used, so NULL is passed. */
+					   DSP_CHAIN_PROCESSOR_PRIORITY | portPRIVILEGE_BIT,	/* The priority allocated to the task, privileged for the heap blocks and the DWT cycle counter. */
+					   NULL );
+	configASSERT( retv == pdPASS );
+}
+
+/**
+  * @brief  Selects the filter of the signal chain.
+  * @param  filter: The filter type
+  * @param  cutoff_hz: Cutoff frequency of the low pass, below half the
+  *         sample rate.  Ignored without a filter.
+  * @retval true if the parameters were valid
+  */
+bool dsp_chain_set_filter(dsp_chain_filter_t filter, uint32_t cutoff_hz)
+{
+	if ((filter != DSP_CHAIN_FILTER_NONE) && ((cutoff_hz == 0) || (cutoff_hz >= DSP_CHAIN_SAMPLE_RATE / 2U))) {
+		return false;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		dsp_chain_config.filter = filter;
+		if (filter != DSP_CHAIN_FILTER_NONE) {
+			dsp_chain_config.cutoff_hz = cutoff_hz;
+		}
+		dsp_chain_config_version++;
+	}
+	taskEXIT_CRITICAL();
+
+	return true;
+}
+
+/**
+  * @brief  Sets the decimation factor of the signal chain.
+  * @note   Only the FIR filter is designed for it, with no filter or the IIR
+  *         filter the samples are just dropped.
+  * @param  decimation: Power of two up to DSP_CHAIN_MAX_DECIMATION
+  * @retval true if the parameter was valid
+  */
+bool dsp_chain_set_decimation(uint32_t decimation)
+{
+	if ((decimation == 0) || (decimation > DSP_CHAIN_MAX_DECIMATION) || ((decimation & (decimation - 1U)) != 0)) {
+		return false;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		dsp_chain_config.decimation = decimation;
+		dsp_chain_config_version++;
+	}
+	taskEXIT_CRITICAL();
+
+	return true;
+}
+
+/**
+  * @brief  Sets the frequencies of the two generated tones.
+  * @param  tone1_hz: First tone, below half the sample rate
+  * @param  tone2_hz: Second tone, below half the sample rate
+  * @retval true if the parameters were valid
+  */
+bool dsp_chain_set_tones(uint32_t tone1_hz, uint32_t tone2_hz)
+{
+	if ((tone1_hz >= DSP_CHAIN_SAMPLE_RATE / 2U) || (tone2_hz >= DSP_CHAIN_SAMPLE_RATE / 2U)) {
+		return false;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		dsp_chain_config.tone_hz[0] = tone1_hz;
+		dsp_chain_config.tone_hz[1] = tone2_hz;
+		dsp_chain_config_version++;
+	}
+	taskEXIT_CRITICAL();
+
+	return true;
+}
+
+/**
+  * @brief  Prints the configuration and the results of the signal chain.
+  * @param  buffer: Output buffer
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void dsp_chain_print(char *buffer, size_t length)
+{
+	dsp_chain_config_t config;
+	dsp_chain_stats_t stats;
+
+	configASSERT(buffer);
+
+	taskENTER_CRITICAL();
+	{
+		config = dsp_chain_config;
+		stats  = dsp_chain_stats;
+	}
+	taskEXIT_CRITICAL();
+
+	snprintf(buffer, length,
+		"\r\nSample rate: %u Hz, block: %u samples, decimation: %lu\r\n"
+		"Filter: %s, cutoff: %lu Hz\r\n"
+		"Tones: %lu Hz, %lu Hz\r\n"
+		"Blocks: %lu, dropped: %lu\r\n"
+		"Processing: avg %lu, max %lu cycles per block\r\n"
+		"Output RMS: %u, peak: %u [Q15]\r\n"
+		"Dominant frequency: %lu Hz\r\n",
+		DSP_CHAIN_SAMPLE_RATE, DSP_CHAIN_BLOCK_SIZE, ( unsigned long ) config.decimation,
+		dsp_chain_filter_names[config.filter], ( unsigned long ) config.cutoff_hz,
+		( unsigned long ) config.tone_hz[0], ( unsigned long ) config.tone_hz[1],
+		( unsigned long ) stats.blocks, ( unsigned long ) stats.dropped,
+		( unsigned long ) ((stats.blocks != 0) ? (stats.cycles_total / stats.blocks) : 0), ( unsigned long ) stats.cycles_max,
+		( unsigned ) stats.rms, ( unsigned ) stats.peak,
+		( unsigned long ) stats.dominant_hz);
+}
+
+static void dsp_chain_producer_task(void *params)
+{
+	TickType_t wake = xTaskGetTickCount();
+	uint32_t phase[ 2 ] = { 0, 0 };
+	uint32_t increment[ 2 ] = { 0, 0 };
+	uint32_t version = UINT32_MAX;
+	uint32_t noise = 1;
+	int16_t *block;
+	int32_t sample;
+	uint32_t i;
+
+	( void ) params;
+
+	for (;;) {
+		vTaskDelayUntil(&wake, pdMS_TO_TICKS((DSP_CHAIN_BLOCK_SIZE * 1000U) / DSP_CHAIN_SAMPLE_RATE));
+
+		taskENTER_CRITICAL();
+		{
+			if (version != dsp_chain_config_version) {
+				version = dsp_chain_config_version;
+
+				/* 2^32 phase steps per period. */
+				increment[0] = (uint32_t)(((uint64_t)dsp_chain_config.tone_hz[0] << 32) / DSP_CHAIN_SAMPLE_RATE);
+				increment[1] = (uint32_t)(((uint64_t)dsp_chain_config.tone_hz[1] << 32) / DSP_CHAIN_SAMPLE_RATE);
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		block = zc_queue_acquire(dsp_chain_queue, 0);
+		if (block == NULL) {
+			dsp_chain_stats.dropped++;
+			continue;
+		}
+
+		/* 0.4 and 0.3 full scale tones with 1/32 full scale noise. */
+		for (i = 0; i < DSP_CHAIN_BLOCK_SIZE; i++) {
+			noise = noise * 1664525UL + 1013904223UL;
+
+			sample  = (13107 * dsp_sine(phase[0])) >> 15;
+			sample += (9830 * dsp_sine(phase[1])) >> 15;
+			sample += (int32_t)noise >> 21;
+
+			block[i] = (int16_t)sample;
+
+			phase[0] += increment[0];
+			phase[1] += increment[1];
+		}
+
+		zc_queue_send(dsp_chain_queue, block);
+	}
+}
+
+static void dsp_chain_processor_task(void *params)
+{
+	dsp_chain_config_t config = { 0 };
+	dsp_fir_t fir = { 0 };
+	dsp_biquad_t iir = { 0 };
+	uint32_t version = UINT32_MAX;
+	bool changed;
+	uint32_t fft_fill = 0;
+	uint32_t dominant_hz = 0;
+	uint32_t produced;
+	uint32_t cycles;
+	uint32_t start;
+	uint16_t rms;
+	uint16_t peak;
+	int16_t *block;
+	uint32_t i;
+
+	( void ) params;
+
+	/* The filters are designed in floating point. */
+	portTASK_USES_FLOATING_POINT();
+
+	for (;;) {
+		block = zc_queue_receive(dsp_chain_queue, portMAX_DELAY);
+
+		changed = false;
+
+		taskENTER_CRITICAL();
+		{
+			if (version != dsp_chain_config_version) {
+				version = dsp_chain_config_version;
+				config = dsp_chain_config;
+				changed = true;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		/* A new configuration restarts the filters and the FFT frame. */
+		if (true == changed) {
+			if (config.filter == DSP_CHAIN_FILTER_FIR) {
+				dsp_chain_design_fir(config.cutoff_hz);
+				dsp_fir_init(&fir, dsp_chain_fir_coeffs, DSP_CHAIN_FIR_TAPS, config.decimation, dsp_chain_fir_state);
+			} else if (config.filter == DSP_CHAIN_FILTER_IIR) {
+				dsp_chain_design_iir(config.cutoff_hz);
+				dsp_biquad_init(&iir, dsp_chain_iir_coeffs, DSP_CHAIN_IIR_STAGES, dsp_chain_iir_state);
+			}
+
+			fft_fill = 0;
+			dominant_hz = 0;
+		}
+
+		start = cycle_counter_get();
+
+		switch (config.filter) {
+		case DSP_CHAIN_FILTER_FIR:
+			produced = dsp_fir(&fir, block, dsp_chain_output, DSP_CHAIN_BLOCK_SIZE);
+			break;
+
+		case DSP_CHAIN_FILTER_IIR:
+			dsp_biquad(&iir, block, block, DSP_CHAIN_BLOCK_SIZE);
+			/* Fall through, the filtered block is decimated by dropping
+			samples. */
+
+		default:
+			produced = 0;
+			for (i = config.decimation - 1U; i < DSP_CHAIN_BLOCK_SIZE; i += config.decimation) {
+				dsp_chain_output[produced++] = block[i];
+			}
+			break;
+		}
+
+		zc_queue_release(dsp_chain_queue, block);
+
+		dsp_stats(dsp_chain_output, produced, &rms, &peak);
+
+		/* The FFT input is real, the imaginary parts are zero. */
+		for (i = 0; (i < produced) && (fft_fill < DSP_CHAIN_FFT_SIZE); i++, fft_fill++) {
+			dsp_chain_fft_frame[2U * fft_fill]      = dsp_chain_output[i];
+			dsp_chain_fft_frame[2U * fft_fill + 1U] = 0;
+		}
+
+		if (fft_fill == DSP_CHAIN_FFT_SIZE) {
+			dsp_fft(dsp_chain_fft_frame, DSP_CHAIN_FFT_SIZE);
+			dominant_hz = (dsp_fft_peak_bin(dsp_chain_fft_frame, DSP_CHAIN_FFT_SIZE, NULL) * DSP_CHAIN_SAMPLE_RATE) /
+				(config.decimation * DSP_CHAIN_FFT_SIZE);
+			fft_fill = 0;
+		}
+
+		cycles = cycle_counter_get() - start;
+
+		taskENTER_CRITICAL();
+		{
+			dsp_chain_stats.blocks++;
+			dsp_chain_stats.cycles_total += cycles;
+			if (cycles > dsp_chain_stats.cycles_max) {
+				dsp_chain_stats.cycles_max = cycles;
+			}
+			dsp_chain_stats.rms = rms;
+			dsp_chain_stats.peak = peak;
+			dsp_chain_stats.dominant_hz = dominant_hz;
+		}
+		taskEXIT_CRITICAL();
+	}
+}
+
+/* Hamming windowed sinc, the odd length keeps it symmetric around the middle
+tap, the last coefficient pads it to an even length for the SIMD kernel. */
+static void dsp_chain_design_fir(uint32_t cutoff_hz)
+{
+	const uint32_t taps = DSP_CHAIN_FIR_TAPS - 1U;
+	const float middle = (float)(taps - 1U) / 2.0f;
+	float fc = (float)cutoff_hz / (float)DSP_CHAIN_SAMPLE_RATE;
+	float h[ DSP_CHAIN_FIR_TAPS - 1U ];
+	float sum = 0.0f;
+	float t;
+	uint32_t n;
+
+	for (n = 0; n < taps; n++) {
+		t = (float)n - middle;
+		h[n] = (t == 0.0f) ? (2.0f * fc) : (sinf(2.0f * (float)M_PI * fc * t) / ((float)M_PI * t));
+		h[n] *= 0.54f - 0.46f * cosf((2.0f * (float)M_PI * (float)n) / (float)(taps - 1U));
+		sum += h[n];
+	}
+
+	/* Unity gain at DC, the coefficients are stored in reversed order. */
+	dsp_chain_fir_coeffs[0] = 0;
+	for (n = 0; n < taps; n++) {
+		dsp_chain_fir_coeffs[taps - n] = dsp_chain_quantize(h[n] / sum, 32768.0f);
+	}
+}
+
+/* Butterworth low pass as two identical second order sections (RBJ cookbook
+low pass with Q = 1/sqrt(2)), which gives a fourth order response with a
+slightly lower -3 dB point than the cutoff. */
+static void dsp_chain_design_iir(uint32_t cutoff_hz)
+{
+	float w0 = (2.0f * (float)M_PI * (float)cutoff_hz) / (float)DSP_CHAIN_SAMPLE_RATE;
+	float alpha = sinf(w0) / (2.0f * 0.70710678f);
+	float cosw0 = cosf(w0);
+	float a0 = 1.0f + alpha;
+	int16_t *coeffs;
+	uint32_t stage;
+
+	for (stage = 0; stage < DSP_CHAIN_IIR_STAGES; stage++) {
+		coeffs = &dsp_chain_iir_coeffs[stage * DSP_BIQUAD_COEFFS];
+
+		coeffs[0] = dsp_chain_quantize(((1.0f - cosw0) / 2.0f) / a0, 16384.0f);
+		coeffs[1] = 0;
+		coeffs[2] = dsp_chain_quantize((1.0f - cosw0) / a0, 16384.0f);
+		coeffs[3] = coeffs[0];
+		coeffs[4] = dsp_chain_quantize((2.0f * cosw0) / a0, 16384.0f);
+		coeffs[5] = dsp_chain_quantize(-(1.0f - alpha) / a0, 16384.0f);
+	}
+}
+
+static int16_t dsp_chain_quantize(float value, float scale)
+{
+	value = roundf(value * scale);
+
+	if (value > 32767.0f) {
+		return INT16_MAX;
+	}
+
+	if (value < -32768.0f) {
+		return INT16_MIN;
+	}
+
+	return (int16_t)value;
+}
@@ -0,0 +1,329 @@
+/**
+  ******************************************************************************
+  * @file    edf_bench.c
+  * @brief   Compares rate monotonic and earliest deadline first scheduling
+  *          on the same periodic task set.
+  *
+  *          The three tasks below load the CPU to 93.3 %, which is within
+  *          the EDF bound of 100 % but above what rate monotonic priorities
+  *          can guarantee: the response time analysis puts the completion of
+  *          the longest period task after its deadline.  The task set is run
+  *          for EDF_BENCH_RUN_MS with fixed rate monotonic priorities and
+  *          again registered with xTaskEdfRegister(), and the jobs and the
+  *          deadline misses of each task are printed.  Every deadline is
+  *          equal to the period.
+  *
+  *          A job burns its execution time in a calibrated busy loop, so the
+  *          time it spends preempted is not counted towards it.  The higher
+  *          priority system tasks and the tick interrupt still take their
+  *          share, and the tasks below the benchmark priorities are starved
+  *          while it runs, which may trip the timing checks of the standard
+  *          demo tasks.
+  *
+  *          In the MPU build the benchmark tasks are restricted to their
+  *          stacks and to the shared state below.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "edf_bench.h"
+#include "cycle_counter.h"
+#include "mpu_guard.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define EDF_BENCH_TASKS                 3U
+
+/* The rate monotonic priorities are the ones just below the EDF priority, the
+shortest period gets the highest one. */
+#if ( configEDF_PRIORITY < ( EDF_BENCH_TASKS + 1 ) )
+	#error configEDF_PRIORITY leaves no room for the rate monotonic priorities
+#endif
+
+/* Number of loop iterations used to calibrate the busy loop. */
+#define EDF_BENCH_CALIBRATION_LOOPS     20000UL
+
+typedef struct {
+	const uint32_t         wcet_us;
+	const uint32_t         period_ms;
+	TaskHandle_t           handle;
+	volatile uint32_t      jobs;
+	volatile uint32_t      misses;
+	volatile bool          done;
+} edf_bench_task_t;
+
+/* The only memory the benchmark tasks reach besides their stacks. */
+typedef struct {
+	edf_bench_task_t       tasks[ EDF_BENCH_TASKS ];
+	volatile bool          use_edf;
+	volatile bool          stop;
+	TickType_t             start;
+	uint32_t               loops_per_ms;
+} edf_bench_shared_t;
+
+static MPU_GUARD_REGION(edf_bench_shared_t) edf_bench = {
+	.data = {
+		.tasks = {
+			{ .wcet_us = 2000UL, .period_ms =  6UL },
+			{ .wcet_us = 4000UL, .period_ms = 10UL },
+			{ .wcet_us = 3000UL, .period_ms = 15UL },
+		},
+	},
+};
+
+static MPU_GUARD_STACK(edf_bench_stacks[ EDF_BENCH_TASKS ], EDF_BENCH_TASK_STACK_SIZE);
+static StaticTask_t edf_bench_tcbs[ EDF_BENCH_TASKS ];
+
+static void edf_bench_task(void *parameters);
+static void edf_bench_spin(uint32_t us);
+static void edf_bench_calibrate(void);
+static uint32_t edf_bench_rm_response_time(uint32_t index);
+static bool edf_bench_execute(bool use_edf, uint32_t *density);
+
+/**
+  * @brief  Runs the benchmark and prints the results.
+  * @note   Blocks the caller for twice EDF_BENCH_RUN_MS.
+  * @param  buffer: Output buffer for the result table
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void edf_bench_run(char *buffer, size_t length)
+{
+	uint32_t rm_jobs[ EDF_BENCH_TASKS ];
+	uint32_t rm_misses[ EDF_BENCH_TASKS ];
+	uint32_t utilization = 0;
+	uint32_t response_us;
+	uint32_t density;
+	size_t written;
+	uint32_t i;
+
+	configASSERT(buffer);
+
+	written = snprintf(buffer, length, "\r\nTask set (D = T):");
+	for (i = 0; i < EDF_BENCH_TASKS; i++) {
+		written += snprintf(buffer + written, length - written, " %lu us / %lu ms",
+			( unsigned long ) edf_bench.data.tasks[i].wcet_us,
+			( unsigned long ) edf_bench.data.tasks[i].period_ms);
+		utilization += edf_bench.data.tasks[i].wcet_us * 1000UL / edf_bench.data.tasks[i].period_ms;
+		if (written >= length) {
+			return;
+		}
+	}
+
+	written += snprintf(buffer + written, length - written, "\r\nUtilization: %lu.%lu %%\r\nRM response times:",
+		( unsigned long ) (utilization / 10000UL), ( unsigned long ) ((utilization / 1000UL) % 10UL));
+	for (i = 0; i < EDF_BENCH_TASKS; i++) {
+		response_us = edf_bench_rm_response_time(i);
+		if (response_us > edf_bench.data.tasks[i].period_ms * 1000UL) {
+			written += snprintf(buffer + written, length - written, " >%lu ms", ( unsigned long ) edf_bench.data.tasks[i].period_ms);
+		} else {
+			written += snprintf(buffer + written, length - written, " %lu us", ( unsigned long ) response_us);
+		}
+		if (written >= length) {
+			return;
+		}
+	}
+
+	/* The benchmark tasks only preempt the caller if it runs below all of
+	them. */
+	if (uxTaskPriorityGet(NULL) >= (configEDF_PRIORITY - EDF_BENCH_TASKS)) {
+		snprintf(buffer + written, length - written, "\r\nMust run below priority %u.\r\n",
+			( unsigned ) (configEDF_PRIORITY - EDF_BENCH_TASKS));
+		return;
+	}
+
+	edf_bench_calibrate();
+
+	if (true != edf_bench_execute(false, NULL)) {
+		snprintf(buffer + written, length - written, "\r\nThe tasks could not be created.\r\n");
+		return;
+	}
+
+	for (i = 0; i < EDF_BENCH_TASKS; i++) {
+		rm_jobs[i]   = edf_bench.data.tasks[i].jobs;
+		rm_misses[i] = edf_bench.data.tasks[i].misses;
+	}
+
+	if (true != edf_bench_execute(true, &density)) {
+		snprintf(buffer + written, length - written, "\r\nThe task set was not admitted or the tasks could not be created.\r\n");
+		return;
+	}
+
+	written += snprintf(buffer + written, length - written,
+		"\r\nEDF density: %lu ppm\r\n"
+		"Task  Period   RM jobs  RM misses   EDF jobs  EDF misses\r\n",
+		( unsigned long ) density);
+
+	for (i = 0; (i < EDF_BENCH_TASKS) && (written < length); i++) {
+		written += snprintf(buffer + written, length - written, "%4lu  %3lu ms  %8lu  %9lu  %9lu  %10lu\r\n",
+			( unsigned long ) (i + 1),
+			( unsigned long ) edf_bench.data.tasks[i].period_ms,
+			( unsigned long ) rm_jobs[i],
+			( unsigned long ) rm_misses[i],
+			( unsigned long ) edf_bench.data.tasks[i].jobs,
+			( unsigned long ) edf_bench.data.tasks[i].misses);
+	}
+}
+
+static bool edf_bench_execute(bool use_edf, uint32_t *density)
+{
+	const MemoryRegion_t regions[ portNUM_CONFIGURABLE_REGIONS ] = {
+		{ &edf_bench, sizeof(edf_bench), MPU_GUARD_READ_WRITE }
+	};
+	bool admitted = true;
+	uint32_t i;
+
+	edf_bench.data.use_edf = use_edf;
+	edf_bench.data.stop = false;
+
+	/* All tasks are created and registered before any of them runs, so their
+	first jobs are released on the same tick. */
+	vTaskSuspendAll();
+	{
+		edf_bench.data.start = xTaskGetTickCount();
+
+		for (i = 0; i < EDF_BENCH_TASKS; i++) {
+			edf_bench.data.tasks[i].jobs   = 0;
+			edf_bench.data.tasks[i].misses = 0;
+			edf_bench.data.tasks[i].done   = false;
+
+			edf_bench.data.tasks[i].handle = mpu_guard_create_task(edf_bench_task,	/* The task that runs the jobs. */
+							   "EDFBench",							/* Text name assigned to the task.  This is just to assist debugging. */
+							   EDF_BENCH_TASK_STACK_SIZE,			/* The size of the stack allocated to the task. */
+							   &edf_bench.data.tasks[i],			/* The parameter is the timing of the task. */
+							   (true == use_edf) ? configEDF_PRIORITY : (configEDF_PRIORITY - 1 - i),	/* The priority allocated to the task. */
+							   edf_bench_stacks[i],					/* Array to use as the task's stack. */
+							   &edf_bench_tcbs[i],					/* Variable to hold the task's data structure. */
+							   regions);							/* The shared state. */
+			if (NULL == edf_bench.data.tasks[i].handle) {
+				admitted = false;
+			} else if ((true == use_edf) && (true == admitted)) {
+				admitted = (xTaskEdfRegister(edf_bench.data.tasks[i].handle,
+					pdMS_TO_TICKS(edf_bench.data.tasks[i].period_ms),
+					pdMS_TO_TICKS(edf_bench.data.tasks[i].period_ms),
+					edf_bench.data.tasks[i].wcet_us) == pdPASS);
+			}
+		}
+
+		if ((true == use_edf) && (density != NULL)) {
+			*density = ulTaskEdfGetDensity();
+		}
+
+		if (true != admitted) {
+			for (i = 0; i < EDF_BENCH_TASKS; i++) {
+				if (edf_bench.data.tasks[i].handle != NULL) {
+					vTaskDelete(edf_bench.data.tasks[i].handle);
+				}
+			}
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	if (true != admitted) {
+		return false;
+	}
+
+	vTaskDelay(pdMS_TO_TICKS(EDF_BENCH_RUN_MS));
+	edf_bench.data.stop = true;
+
+	/* Each task finishes its current job and suspends itself.  Deleted here
+	instead of by the idle task, their static buffers are reused by the next
+	run. */
+	for (i = 0; i < EDF_BENCH_TASKS; i++) {
+		while (true != edf_bench.data.tasks[i].done) {
+			vTaskDelay(pdMS_TO_TICKS(10));
+		}
+		vTaskDelete(edf_bench.data.tasks[i].handle);
+	}
+
+	return true;
+}
+
+static void edf_bench_task(void *parameters)
+{
+	edf_bench_task_t *task = parameters;
+	TickType_t release = edf_bench.data.start;
+	TickType_t period = pdMS_TO_TICKS(task->period_ms);
+
+	while (true != edf_bench.data.stop) {
+		edf_bench_spin(task->wcet_us);
+		task->jobs++;
+
+		if (true == edf_bench.data.use_edf) {
+			if (xTaskEdfWaitForNextPeriod() != pdPASS) {
+				task->misses++;
+			}
+		} else {
+			/* Same test as the kernel does for an EDF task, a job that
+			completes on the tick of its deadline is in time. */
+			if ((TickType_t)(xTaskGetTickCount() - release) > period) {
+				task->misses++;
+			}
+
+			xTaskDelayUntil(&release, period);
+		}
+	}
+
+	task->done = true;
+	for (;;) {
+		vTaskSuspend(NULL);
+	}
+}
+
+static void edf_bench_spin(uint32_t us)
+{
+	volatile uint32_t loops;
+
+	for (loops = (us * edf_bench.data.loops_per_ms) / 1000UL; loops > 0; loops--) {
+	}
+}
+
+static void edf_bench_calibrate(void)
+{
+	volatile uint32_t loops;
+	uint32_t start;
+	uint32_t cycles;
+
+	cycle_counter_init();
+
+	/* Nothing may interrupt the calibration loop, it is a fraction of a
+	millisecond long. */
+	taskENTER_CRITICAL();
+	{
+		start = cycle_counter_get();
+		for (loops = EDF_BENCH_CALIBRATION_LOOPS; loops > 0; loops--) {
+		}
+		cycles = cycle_counter_get() - start;
+	}
+	taskEXIT_CRITICAL();
+
+	edf_bench.data.loops_per_ms = (uint32_t)(((uint64_t)EDF_BENCH_CALIBRATION_LOOPS * (SystemCoreClock / 1000UL)) / cycles);
+}
+
+/* Worst case response time of a task under rate monotonic priorities, in
+microseconds.  Stops iterating once the period is exceeded. */
+static uint32_t edf_bench_rm_response_time(uint32_t index)
+{
+	uint32_t response = edf_bench.data.tasks[index].wcet_us;
+	uint32_t next;
+	uint32_t period_us;
+	uint32_t i;
+
+	for (;;) {
+		next = edf_bench.data.tasks[index].wcet_us;
+		for (i = 0; i < index; i++) {
+			period_us = edf_bench.data.tasks[i].period_ms * 1000UL;
+			next += ((response + period_us - 1U) / period_us) * edf_bench.data.tasks[i].wcet_us;
+		}
+
+		if ((next == response) || (next > edf_bench.data.tasks[index].period_ms * 1000UL)) {
+			return next;
+		}
+
+		response = next;
+	}
+}
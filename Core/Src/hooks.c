@@ -12,10 +12,16 @@
 #include "main.h"
 
 #include "QueueSet.h"
+#include "task_budget.h"
+#include "newlib_heap.h"
+#include "crash_dump.h"
 
 /* GetIdleTaskMemory prototype (linked to static allocation support) */
 void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackType_t **ppxIdleTaskStackBuffer, uint32_t *pulIdleTaskStackSize );
 
+/* GetTimerTaskMemory prototype (linked to static allocation support) */
+void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize );
+
 /* Hook prototypes */
 void vApplicationIdleHook(void);
 void vApplicationTickHook(void);
@@ -50,19 +56,21 @@ void vApplicationTickHook( void )
 	/* Write to a queue that is in use as part of the queue set demo to
 	demonstrate using queue sets from an ISR. */
 	vQueueSetAccessQueueSetFromISR();
+
+	/* Charge the running task and apply the budget policies. */
+	task_budget_tick_hook();
 }
 
 
 void vApplicationStackOverflowHook(TaskHandle_t xTask, char *pcTaskName)
 {
-	( void ) pcTaskName;
 	( void ) xTask;
 
 	/* Run time stack overflow checking is performed if
 	configCHECK_FOR_STACK_OVERFLOW is defined to 1 or 2.  This hook
-	function is called if a stack overflow is detected. */
-	taskDISABLE_INTERRUPTS();
-	for( ;; );
+	function is called if a stack overflow is detected.  The crash record
+	gets the name of the task. */
+	crash_dump_stack_overflow(pcTaskName);
 }
 
 
@@ -78,6 +86,12 @@ void vApplicationMallocFailedHook(void)
 	FreeRTOSConfig.h, and the xPortGetFreeHeapSize() API function can be used
 	to query the size of free heap space that remains (although it does not
 	provide information on how the remaining heap might be fragmented). */
+
+	/* malloc() is on the FreeRTOS heap as well, it returns NULL. */
+	if( true == newlib_heap_in_malloc() ) {
+		return;
+	}
+
 	taskDISABLE_INTERRUPTS();
 	for( ;; );
 }
@@ -95,3 +109,12 @@ void vApplicationGetIdleTaskMemory( StaticTask_t **ppxIdleTaskTCBBuffer, StackTy
 }
 
 
+static StaticTask_t xTimerTaskTCBBuffer;
+static StackType_t xTimerStack[configTIMER_TASK_STACK_DEPTH];
+
+void vApplicationGetTimerTaskMemory( StaticTask_t **ppxTimerTaskTCBBuffer, StackType_t **ppxTimerTaskStackBuffer, uint32_t *pulTimerTaskStackSize )
+{
+  *ppxTimerTaskTCBBuffer = &xTimerTaskTCBBuffer;
+  *ppxTimerTaskStackBuffer = &xTimerStack[0];
+  *pulTimerTaskStackSize = configTIMER_TASK_STACK_DEPTH;
+}
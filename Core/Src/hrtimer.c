@@ -0,0 +1,587 @@
+/**
+  ******************************************************************************
+  * @file    hrtimer.c
+  * @brief   High resolution software timers on the TIM2 timebase.
+  *
+  *          Timers are kept in a hashed timing wheel indexed by expiry time.
+  *          Starting and cancelling a timer is O(1): the timer is linked into
+  *          (or unlinked from) the list of its slot and the slot occupancy
+  *          bitmap is updated.  The channel 2 compare register of TIM2 is
+  *          always programmed to the earliest deadline, so the interrupt only
+  *          fires when a timer actually expires and the resolution is the
+  *          1 us resolution of the timebase counter, not the slot width.
+  *
+  *          Callbacks run either directly in the TIM2 interrupt or in the
+  *          hrtimer task, which is woken with a task notification.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "hrtimer.h"
+#include "timebase.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stm32f4xx_hal.h"
+
+#define HRTIMER_SLOT_WIDTH          ( 1UL << HRTIMER_SLOT_SHIFT )
+#define HRTIMER_SLOT_MASK           ( HRTIMER_WHEEL_SLOTS - 1U )
+#define HRTIMER_HORIZON             ( HRTIMER_WHEEL_SLOTS << HRTIMER_SLOT_SHIFT )
+#define HRTIMER_BITMAP_WORDS        ( HRTIMER_WHEEL_SLOTS / 32U )
+
+#define HRTIMER_STATE_IDLE          0U
+#define HRTIMER_STATE_WHEEL         1U
+#define HRTIMER_STATE_OVERFLOW      2U
+#define HRTIMER_STATE_DUE           3U
+
+#if ( ( HRTIMER_WHEEL_SLOTS & HRTIMER_SLOT_MASK ) != 0 ) || ( ( HRTIMER_WHEEL_SLOTS % 32U ) != 0 )
+	#error HRTIMER_WHEEL_SLOTS must be a power of two and a multiple of 32
+#endif
+
+extern TIM_HandleTypeDef htim2;
+
+static hrtimer_t *wheel[ HRTIMER_WHEEL_SLOTS ];
+static uint32_t   wheel_bitmap[ HRTIMER_BITMAP_WORDS ];
+static hrtimer_t *overflow_list = NULL;
+static hrtimer_t *due_list      = NULL;
+
+/* Start time of the slot under the cursor, always a multiple of the slot
+width and never ahead of the counter.  Every timer in the wheel expires in
+[ wheel_base, wheel_base + HRTIMER_HORIZON ). */
+static uint32_t wheel_base = 0;
+
+static bool     compare_armed  = false;
+static uint32_t compare_value  = 0;
+
+/* Timers waiting for the hrtimer task, in expiry order. */
+static hrtimer_t *pending_head = NULL;
+static hrtimer_t *pending_tail = NULL;
+
+static TaskHandle_t hrtimer_task_handle = NULL;
+
+static hrtimer_stats_t stats;
+
+static void hrtimer_task(void *pvParameters);
+static void list_insert(hrtimer_t **head, hrtimer_t *timer);
+static void list_remove(hrtimer_t *timer);
+static void pending_push(hrtimer_t *timer);
+static void pending_remove(hrtimer_t *timer);
+static void timer_enqueue(hrtimer_t *timer, uint32_t now);
+static void timer_dequeue(hrtimer_t *timer);
+static hrtimer_t *timer_pop_expired(uint32_t now);
+static void wheel_advance(uint32_t now);
+static void wheel_cascade(uint32_t now);
+static uint32_t wheel_find_slot(uint32_t from, uint32_t to);
+static void compare_arm(uint32_t deadline);
+static void compare_update(uint32_t now);
+static bool timer_arm(hrtimer_t *timer, uint32_t deadline_us, uint32_t period_us);
+
+void hrtimer_init(void)
+{
+	BaseType_t retv;
+
+	/* Channel 2 of the free running TIM2 counter is used in frozen output
+	compare mode (reset value of CCMR1), only its interrupt is enabled on
+	demand. */
+	__HAL_TIM_DISABLE_IT(&htim2, TIM_IT_CC2);
+	__HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_CC2);
+
+	retv = xTaskCreate(hrtimer_task,				/* The task that runs the deferred callbacks. */
+					   "HRTimer",					/* Text name assigned to the task.  This is just to assist debugging. */
+					   HRTIMER_TASK_STACK_SIZE,		/* The size of the stack allocated to the task. */
+					   NULL,						/* The parameter is not used, so NULL is passed. */
+					   HRTIMER_TASK_PRIORITY | portPRIVILEGE_BIT,	/* The priority allocated to the task, privileged as it runs the callbacks of the other modules. */
+					   &hrtimer_task_handle );
+	configASSERT( retv == pdPASS );
+}
+
+void hrtimer_create(hrtimer_t *timer, hrtimer_callback_t callback, void *arg, hrtimer_context_t context)
+{
+	configASSERT( timer );
+	configASSERT( callback );
+
+	timer->next         = NULL;
+	timer->pprev        = NULL;
+	timer->pending_next = NULL;
+	timer->pending_prev = NULL;
+	timer->expiry       = 0;
+	timer->period       = 0;
+	timer->overruns     = 0;
+	timer->callback     = callback;
+	timer->arg          = arg;
+	timer->context      = (uint8_t)context;
+	timer->state        = HRTIMER_STATE_IDLE;
+	timer->pending      = 0;
+}
+
+/**
+  * @brief  Starts (or restarts) a timer relative to the current time.
+  * @note   Can be called from tasks and from interrupts with a priority not
+  *         above configMAX_SYSCALL_INTERRUPT_PRIORITY.
+  * @param  timer: the timer
+  * @param  delay_us: time to the first expiry
+  * @param  period_us: reload period, 0 for a one-shot timer
+  * @retval false if a parameter is out of range
+  */
+bool hrtimer_start(hrtimer_t *timer, uint32_t delay_us, uint32_t period_us)
+{
+	if (delay_us > HRTIMER_MAX_DELAY_US) {
+		return false;
+	}
+
+	return timer_arm(timer, timebase_get_us() + delay_us, period_us);
+}
+
+/**
+  * @brief  Starts (or restarts) a timer at an absolute timebase_get_us() time.
+  * @note   Using the previous deadline plus the period as the next deadline
+  *         gives drift free scheduling from a one-shot callback.
+  * @param  timer: the timer
+  * @param  deadline_us: timestamp of the first expiry
+  * @param  period_us: reload period, 0 for a one-shot timer
+  * @retval false if a parameter is out of range
+  */
+bool hrtimer_start_at(hrtimer_t *timer, uint32_t deadline_us, uint32_t period_us)
+{
+	return timer_arm(timer, deadline_us, period_us);
+}
+
+void hrtimer_cancel(hrtimer_t *timer)
+{
+	UBaseType_t saved_mask;
+
+	configASSERT( timer );
+
+	saved_mask = taskENTER_CRITICAL_FROM_ISR();
+	timer_dequeue(timer);
+	if (timer->pending != 0) {
+		pending_remove(timer);
+	}
+	taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+
+	/* The compare register is left as it is, an interrupt for a cancelled
+	timer finds nothing to do and re-arms for the next deadline. */
+}
+
+bool hrtimer_is_active(const hrtimer_t *timer)
+{
+	return (timer->state != HRTIMER_STATE_IDLE);
+}
+
+uint32_t hrtimer_get_overruns(const hrtimer_t *timer)
+{
+	return timer->overruns;
+}
+
+void hrtimer_get_stats(hrtimer_stats_t *s)
+{
+	UBaseType_t saved_mask;
+
+	saved_mask = taskENTER_CRITICAL_FROM_ISR();
+	*s = stats;
+	taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+}
+
+/**
+  * @brief  Channel 2 compare handler, called from TIM2_IRQHandler().
+  * @param  None
+  * @retval None
+  */
+void hrtimer_irq_handler(void)
+{
+	UBaseType_t saved_mask;
+	BaseType_t  xHigherPriorityTaskWoken = pdFALSE;
+	bool        notify = false;
+	hrtimer_t  *timer;
+	uint32_t    now;
+	uint32_t    missed;
+
+	if ((htim2.Instance->SR & htim2.Instance->DIER & TIM_SR_CC2IF) == 0) {
+		return;
+	}
+
+	htim2.Instance->SR = ~TIM_SR_CC2IF;
+	now = timebase_get_us();
+
+	saved_mask = taskENTER_CRITICAL_FROM_ISR();
+	compare_armed = false;
+	if ((now - compare_value) > stats.max_latency_us && (int32_t)(now - compare_value) >= 0) {
+		stats.max_latency_us = now - compare_value;
+	}
+	taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+
+	for (;;) {
+		saved_mask = taskENTER_CRITICAL_FROM_ISR();
+
+		timer = timer_pop_expired(now);
+
+		if (timer != NULL) {
+			stats.expired = stats.expired + 1;
+
+			if (timer->period != 0) {
+				/* Reload relative to the deadline, not to now, so periodic
+				timers do not drift.  Periods that already elapsed are
+				skipped and counted as overruns. */
+				timer->expiry += timer->period;
+				if ((int32_t)(now - timer->expiry) >= 0) {
+					missed = ((now - timer->expiry) / timer->period) + 1;
+					timer->expiry += missed * timer->period;
+					timer->overruns += missed;
+					stats.overruns += missed;
+				}
+				timer_enqueue(timer, now);
+			}
+
+			if (timer->context == HRTIMER_CONTEXT_TASK) {
+				if (timer->pending == 0) {
+					pending_push(timer);
+					notify = true;
+				} else {
+					/* The task has not run the previous expiry yet. */
+					timer->overruns = timer->overruns + 1;
+					stats.overruns = stats.overruns + 1;
+				}
+			}
+		} else {
+			compare_update(now);
+		}
+
+		taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+
+		if (timer == NULL) {
+			break;
+		}
+
+		if (timer->context == HRTIMER_CONTEXT_ISR) {
+			timer->callback(timer, timer->arg);
+		}
+	}
+
+	if (notify == true) {
+		vTaskNotifyGiveFromISR(hrtimer_task_handle, &xHigherPriorityTaskWoken);
+	}
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+static void hrtimer_task(void *pvParameters)
+{
+	( void ) pvParameters;
+	hrtimer_t *timer;
+
+	for (;;) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		for (;;) {
+			taskENTER_CRITICAL();
+			timer = pending_head;
+			if (timer != NULL) {
+				pending_remove(timer);
+			}
+			taskEXIT_CRITICAL();
+
+			if (timer == NULL) {
+				break;
+			}
+
+			timer->callback(timer, timer->arg);
+		}
+	}
+}
+
+static bool timer_arm(hrtimer_t *timer, uint32_t deadline_us, uint32_t period_us)
+{
+	UBaseType_t saved_mask;
+	uint32_t    now;
+
+	configASSERT( timer );
+
+	if (period_us > HRTIMER_MAX_DELAY_US) {
+		return false;
+	}
+
+	saved_mask = taskENTER_CRITICAL_FROM_ISR();
+
+	now = timebase_get_us();
+
+	if ((deadline_us - now) > HRTIMER_MAX_DELAY_US) {
+		taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+		return false;
+	}
+
+	timer_dequeue(timer);
+
+	timer->expiry = deadline_us;
+	timer->period = period_us;
+
+	timer_enqueue(timer, now);
+
+	/* Bring the compare event forward if this is the new earliest deadline. */
+	if ((compare_armed == false) || ((int32_t)(timer->expiry - compare_value) < 0)) {
+		compare_arm(timer->state == HRTIMER_STATE_DUE ? now : timer->expiry);
+	}
+
+	taskEXIT_CRITICAL_FROM_ISR(saved_mask);
+
+	return true;
+}
+
+/* Must be called with interrupts masked. */
+static void timer_enqueue(hrtimer_t *timer, uint32_t now)
+{
+	uint32_t slot;
+
+	if (stats.active == 0) {
+		/* The wheel is empty so it is free to jump to the current time. */
+		wheel_base = now & ~(HRTIMER_SLOT_WIDTH - 1U);
+	}
+
+	if ((int32_t)(now - timer->expiry) >= 0) {
+		timer->state = HRTIMER_STATE_DUE;
+		list_insert(&due_list, timer);
+	} else if ((timer->expiry - wheel_base) < HRTIMER_HORIZON) {
+		slot = (timer->expiry >> HRTIMER_SLOT_SHIFT) & HRTIMER_SLOT_MASK;
+		timer->state = HRTIMER_STATE_WHEEL;
+		list_insert(&wheel[ slot ], timer);
+		wheel_bitmap[ slot >> 5 ] |= (1UL << (slot & 31U));
+	} else {
+		timer->state = HRTIMER_STATE_OVERFLOW;
+		list_insert(&overflow_list, timer);
+	}
+
+	stats.active = stats.active + 1;
+}
+
+/* Must be called with interrupts masked. */
+static void timer_dequeue(hrtimer_t *timer)
+{
+	uint32_t slot;
+
+	if (timer->state == HRTIMER_STATE_IDLE) {
+		return;
+	}
+
+	list_remove(timer);
+
+	if (timer->state == HRTIMER_STATE_WHEEL) {
+		slot = (timer->expiry >> HRTIMER_SLOT_SHIFT) & HRTIMER_SLOT_MASK;
+		if (wheel[ slot ] == NULL) {
+			wheel_bitmap[ slot >> 5 ] &= ~(1UL << (slot & 31U));
+		}
+	}
+
+	timer->state = HRTIMER_STATE_IDLE;
+	stats.active = stats.active - 1;
+}
+
+/* Returns an expired timer removed from the wheel, advancing the wheel up to
+the current time as needed, or NULL if nothing has expired.  Must be called
+with interrupts masked. */
+static hrtimer_t *timer_pop_expired(uint32_t now)
+{
+	hrtimer_t *timer;
+	uint32_t   slot;
+
+	for (;;) {
+		timer = due_list;
+
+		if (timer == NULL) {
+			slot = (wheel_base >> HRTIMER_SLOT_SHIFT) & HRTIMER_SLOT_MASK;
+			for (timer = wheel[ slot ]; timer != NULL; timer = timer->next) {
+				if ((int32_t)(now - timer->expiry) >= 0) {
+					break;
+				}
+			}
+		}
+
+		if (timer != NULL) {
+			timer_dequeue(timer);
+			return timer;
+		}
+
+		if ((now - wheel_base) < HRTIMER_SLOT_WIDTH) {
+			/* The slot under the cursor is still current. */
+			return NULL;
+		}
+
+		wheel_advance(now);
+	}
+}
+
+/* Moves the cursor forward to the next occupied slot, the slot of the current
+time or the end of the revolution, whichever comes first. */
+static void wheel_advance(uint32_t now)
+{
+	uint32_t cursor = (wheel_base >> HRTIMER_SLOT_SHIFT) & HRTIMER_SLOT_MASK;
+	uint32_t steps  = (now - wheel_base) >> HRTIMER_SLOT_SHIFT;
+	uint32_t limit  = HRTIMER_WHEEL_SLOTS - cursor;
+	uint32_t occupied;
+
+	if (steps > limit) {
+		steps = limit;
+	}
+
+	occupied = wheel_find_slot(cursor + 1U, HRTIMER_WHEEL_SLOTS) - cursor;
+	if (steps > occupied) {
+		steps = occupied;
+	}
+
+	wheel_base += steps << HRTIMER_SLOT_SHIFT;
+
+	if ((cursor + steps) == HRTIMER_WHEEL_SLOTS) {
+		wheel_cascade(now);
+	}
+}
+
+/* A new revolution started, pull the timers of the overflow list that are
+now within the horizon into the wheel. */
+static void wheel_cascade(uint32_t now)
+{
+	hrtimer_t *timer = overflow_list;
+	hrtimer_t *next;
+
+	while (timer != NULL) {
+		next = timer->next;
+		if (((int32_t)(now - timer->expiry) >= 0) || ((timer->expiry - wheel_base) < HRTIMER_HORIZON)) {
+			timer_dequeue(timer);
+			timer_enqueue(timer, now);
+		}
+		timer = next;
+	}
+}
+
+/* Returns the first occupied slot in [ from, to ), or to if there is none. */
+static uint32_t wheel_find_slot(uint32_t from, uint32_t to)
+{
+	uint32_t word;
+	uint32_t bits;
+
+	while (from < to) {
+		word = from >> 5;
+		bits = wheel_bitmap[ word ] & (0xFFFFFFFFUL << (from & 31U));
+		if (bits != 0) {
+			from = (word << 5) + __CLZ(__RBIT(bits));
+			return (from < to) ? from : to;
+		}
+		from = (word + 1U) << 5;
+	}
+
+	return to;
+}
+
+/* Programs the compare event for the earliest pending deadline.  Must be
+called with interrupts masked. */
+static void compare_update(uint32_t now)
+{
+	hrtimer_t *timer;
+	uint32_t   cursor;
+	uint32_t   slot;
+	uint32_t   deadline = 0;
+	uint32_t   wrap;
+	bool       found = false;
+
+	if (due_list != NULL) {
+		compare_arm(now);
+		return;
+	}
+
+	/* Every slot holds exactly one slot width of the next revolution, so the
+	first occupied slot after the cursor holds the earliest deadline. */
+	cursor = (wheel_base >> HRTIMER_SLOT_SHIFT) & HRTIMER_SLOT_MASK;
+	slot = wheel_find_slot(cursor, HRTIMER_WHEEL_SLOTS);
+	if (slot == HRTIMER_WHEEL_SLOTS) {
+		slot = wheel_find_slot(0, cursor);
+	}
+
+	if (slot != cursor || wheel[ slot ] != NULL) {
+		for (timer = wheel[ slot ]; timer != NULL; timer = timer->next) {
+			if ((found == false) || ((timer->expiry - wheel_base) < (deadline - wheel_base))) {
+				deadline = timer->expiry;
+				found = true;
+			}
+		}
+	}
+
+	if (overflow_list != NULL) {
+		/* Wake up at the end of the revolution to cascade. */
+		wrap = wheel_base + ((HRTIMER_WHEEL_SLOTS - cursor) << HRTIMER_SLOT_SHIFT);
+		if ((found == false) || ((wrap - wheel_base) < (deadline - wheel_base))) {
+			deadline = wrap;
+			found = true;
+		}
+	}
+
+	if (found == true) {
+		compare_arm(deadline);
+	} else {
+		__HAL_TIM_DISABLE_IT(&htim2, TIM_IT_CC2);
+		compare_armed = false;
+	}
+}
+
+/* Must be called with interrupts masked. */
+static void compare_arm(uint32_t deadline)
+{
+	compare_value = deadline;
+	compare_armed = true;
+
+	htim2.Instance->CCR2 = deadline;
+	__HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_CC2);
+	__HAL_TIM_ENABLE_IT(&htim2, TIM_IT_CC2);
+
+	/* The counter may already be past the deadline, in which case the
+	compare match was missed.  Generate the event by software instead. */
+	if ((int32_t)(htim2.Instance->CNT - deadline) >= 0) {
+		htim2.Instance->EGR = TIM_EGR_CC2G;
+	}
+}
+
+static void list_insert(hrtimer_t **head, hrtimer_t *timer)
+{
+	timer->next = *head;
+	if (*head != NULL) {
+		(*head)->pprev = &timer->next;
+	}
+	*head = timer;
+	timer->pprev = head;
+}
+
+static void list_remove(hrtimer_t *timer)
+{
+	*timer->pprev = timer->next;
+	if (timer->next != NULL) {
+		timer->next->pprev = timer->pprev;
+	}
+	timer->next  = NULL;
+	timer->pprev = NULL;
+}
+
+static void pending_push(hrtimer_t *timer)
+{
+	timer->pending_next = NULL;
+	timer->pending_prev = pending_tail;
+	if (pending_tail != NULL) {
+		pending_tail->pending_next = timer;
+	} else {
+		pending_head = timer;
+	}
+	pending_tail = timer;
+	timer->pending = 1;
+}
+
+static void pending_remove(hrtimer_t *timer)
+{
+	if (timer->pending_prev != NULL) {
+		timer->pending_prev->pending_next = timer->pending_next;
+	} else {
+		pending_head = timer->pending_next;
+	}
+	if (timer->pending_next != NULL) {
+		timer->pending_next->pending_prev = timer->pending_prev;
+	} else {
+		pending_tail = timer->pending_prev;
+	}
+	timer->pending_next = NULL;
+	timer->pending_prev = NULL;
+	timer->pending = 0;
+}
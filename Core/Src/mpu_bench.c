@@ -0,0 +1,255 @@
+/**
+  ******************************************************************************
+  * @file    mpu_bench.c
+  * @brief   Measures what the isolation of the MPU build costs.
+  *
+  *          A pair of tasks is run first privileged, then unprivileged as
+  *          restricted tasks that can only reach their stack and a 32 byte
+  *          shared region.  For each pair the calling task measures the CPU
+  *          cycles of MPU_BENCH_ITERATIONS kernel calls, and of as many
+  *          notification round trips between the two tasks.  An unprivileged
+  *          kernel call raises the privilege through a system call, and
+  *          every task switch reprograms the MPU regions of the task.
+  *
+  *          The DWT cycle counter can not be read without privilege, the
+  *          measurements are taken by the calling task from the start
+  *          notification to the completion notification.
+  *
+  *          At last an unprivileged task reads the privileged data, the
+  *          access must be trapped by mpu_guard.c.  In the default build
+  *          there are no restricted tasks and only the privileged column is
+  *          measured.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "mpu_bench.h"
+#include "mpu_guard.h"
+#include "cycle_counter.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+#define MPU_BENCH_PRIORITY              ( tskIDLE_PRIORITY + 1 )
+
+/* Time the calling task waits for a job. */
+#define MPU_BENCH_TIMEOUT_MS            1000U
+
+typedef enum {
+	MPU_BENCH_JOB_CALLS = 0,
+	MPU_BENCH_JOB_SWITCHES,
+	MPU_BENCH_JOB_WILD_READ
+} mpu_bench_job_t;
+
+/* The only memory the restricted tasks can reach besides their stacks, the
+size and the alignment of an MPU region must match. */
+typedef struct {
+	TaskHandle_t    owner;
+	TaskHandle_t    ping;
+	TaskHandle_t    pong;
+	mpu_bench_job_t job;
+	uint32_t        iterations;
+	volatile uint32_t sink;
+} __attribute__((aligned(32))) mpu_bench_shared_t;
+
+static bool mpu_bench_measure(bool privileged, mpu_bench_job_t job, uint32_t *cycles);
+static void mpu_bench_ping_task(void *params);
+static void mpu_bench_pong_task(void *params);
+
+extern uint32_t __privileged_data_start__[];
+
+static mpu_bench_shared_t mpu_bench_shared;
+
+static StackType_t mpu_bench_stacks[ 2 ][ MPU_BENCH_TASK_STACK_SIZE ]
+	__attribute__((aligned(MPU_BENCH_TASK_STACK_SIZE * sizeof(StackType_t))));
+static StaticTask_t mpu_bench_tcbs[ 2 ];
+
+/**
+  * @brief  Runs the benchmark and prints the results.
+  * @param  buffer: Output buffer for the result table
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void mpu_bench_run(char *buffer, size_t length)
+{
+	static const char *const names[] = { "Kernel call", "Task switch" };
+	uint32_t cycles;
+	mpu_guard_stats_t before;
+	mpu_guard_stats_t after;
+	bool completed;
+	size_t written;
+	uint32_t job;
+	uint32_t mode;
+
+	configASSERT(buffer);
+
+	cycle_counter_init();
+
+	written = snprintf(buffer, length,
+		"\r\nProfile: %s\r\n"
+		"Operation       Privileged  Unprivileged  [CPU cycles]\r\n",
+		(portUSING_MPU_WRAPPERS == 1) ? "MPU" : "no MPU, tasks are not isolated");
+
+	for (job = MPU_BENCH_JOB_CALLS; (job <= MPU_BENCH_JOB_SWITCHES) && (written < length); job++) {
+		written += snprintf(buffer + written, length - written, "%-12s", names[job]);
+
+		for (mode = 0; (mode < 2) && (written < length); mode++) {
+			if ((mode != 0) && (portUSING_MPU_WRAPPERS != 1)) {
+				written += snprintf(buffer + written, length - written, "  %12s", "-");
+			} else if (true == mpu_bench_measure(mode == 0, ( mpu_bench_job_t ) job, &cycles)) {
+				/* A switch is half of a round trip. */
+				written += snprintf(buffer + written, length - written, "  %12lu",
+					( unsigned long ) (cycles / (MPU_BENCH_ITERATIONS * ((job == MPU_BENCH_JOB_SWITCHES) ? 2U : 1U))));
+			} else {
+				written += snprintf(buffer + written, length - written, "  %12s", "failed");
+			}
+		}
+
+		if (written < length) {
+			written += snprintf(buffer + written, length - written, "\r\n");
+		}
+	}
+
+	if ((portUSING_MPU_WRAPPERS == 1) && (written < length)) {
+		mpu_guard_get_stats(&before);
+		completed = mpu_bench_measure(false, MPU_BENCH_JOB_WILD_READ, &cycles);
+		mpu_guard_get_stats(&after);
+
+		snprintf(buffer + written, length - written, "Read of privileged data: %s\r\n",
+			((false == completed) && (after.faults != before.faults)) ? "trapped" : "NOT TRAPPED");
+	}
+}
+
+/**
+  * @brief  Runs a job on a pair of tasks and measures it.
+  * @param  privileged: Run the tasks privileged or restricted
+  * @param  job: Work of the tasks
+  * @param  cycles: Set to the CPU cycles of the job
+  * @retval true if the job completed, false if it did not or the tasks could
+  *         not be created
+  */
+static bool mpu_bench_measure(bool privileged, mpu_bench_job_t job, uint32_t *cycles)
+{
+	TaskFunction_t const functions[ 2 ] = { mpu_bench_ping_task, mpu_bench_pong_task };
+	const char *const names[ 2 ] = { "MPUPing", "MPUPong" };
+	TaskHandle_t handles[ 2 ] = { NULL, NULL };
+	uint32_t start;
+	uint32_t i;
+	bool completed;
+
+	mpu_bench_shared.owner = xTaskGetCurrentTaskHandle();
+	mpu_bench_shared.job = job;
+	mpu_bench_shared.iterations = MPU_BENCH_ITERATIONS;
+
+	/* Clear a stale notification, the start and completion of the job are
+	signalled with notifications. */
+	( void ) ulTaskNotifyTake(pdTRUE, 0);
+
+	for (i = 0; i < 2; i++) {
+		if (true == privileged) {
+			handles[i] = xTaskCreateStatic(functions[i],                              /* Function that implements the task. */
+										   names[i],                                  /* Text name for the task. */
+										   MPU_BENCH_TASK_STACK_SIZE,                 /* Stack size in words, not bytes. */
+										   &mpu_bench_shared,                         /* Parameter passed into the task. */
+										   MPU_BENCH_PRIORITY | portPRIVILEGE_BIT,    /* Priority at which the task is created, privileged for the first column. */
+										   mpu_bench_stacks[i],                       /* Array to use as the task's stack. */
+										   &mpu_bench_tcbs[i]);                       /* Variable to hold the task's data structure. */
+		} else {
+#if ( portUSING_MPU_WRAPPERS == 1 )
+			TaskParameters_t parameters = {
+				.pvTaskCode     = functions[i],
+				.pcName         = names[i],
+				.usStackDepth   = MPU_BENCH_TASK_STACK_SIZE,
+				.pvParameters   = &mpu_bench_shared,
+				.uxPriority     = MPU_BENCH_PRIORITY,
+				.puxStackBuffer = mpu_bench_stacks[i],
+				.xRegions       = {
+					{ &mpu_bench_shared, sizeof(mpu_bench_shared), portMPU_REGION_READ_WRITE | portMPU_REGION_EXECUTE_NEVER },
+					{ NULL, 0, 0 },
+					{ NULL, 0, 0 }
+				},
+				.pxTaskBuffer   = &mpu_bench_tcbs[i]
+			};
+
+			( void ) xTaskCreateRestrictedStatic(&parameters, &handles[i]);
+#endif
+		}
+
+		if (NULL == handles[i]) {
+			break;
+		}
+	}
+
+	mpu_bench_shared.ping = handles[0];
+	mpu_bench_shared.pong = handles[1];
+
+	completed = false;
+	if ((NULL != handles[0]) && (NULL != handles[1])) {
+		start = cycle_counter_get();
+		xTaskNotifyGive(handles[0]);
+
+		completed = (0 != ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(MPU_BENCH_TIMEOUT_MS)));
+		*cycles = cycle_counter_get() - start;
+	}
+
+	/* The tasks are blocked, suspended or done, their static buffers can be
+	reused as soon as they are deleted. */
+	for (i = 0; i < 2; i++) {
+		if (NULL != handles[i]) {
+			vTaskDelete(handles[i]);
+		}
+	}
+
+	return completed;
+}
+
+static void mpu_bench_ping_task(void *params)
+{
+	mpu_bench_shared_t *shared = ( mpu_bench_shared_t * ) params;
+	uint32_t i;
+
+	( void ) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+	switch (shared->job) {
+	case MPU_BENCH_JOB_CALLS:
+		for (i = 0; i < shared->iterations; i++) {
+			shared->sink = xTaskGetTickCount();
+		}
+		break;
+
+	case MPU_BENCH_JOB_SWITCHES:
+		for (i = 0; i < shared->iterations; i++) {
+			xTaskNotifyGive(shared->pong);
+			( void ) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		}
+		break;
+
+	case MPU_BENCH_JOB_WILD_READ:
+		/* Faults when the task is restricted, the task does not get past
+		this line. */
+		shared->sink = *( volatile uint32_t * ) __privileged_data_start__;
+		break;
+
+	default:
+		break;
+	}
+
+	xTaskNotifyGive(shared->owner);
+
+	for (;;) {
+		vTaskSuspend(NULL);
+	}
+}
+
+static void mpu_bench_pong_task(void *params)
+{
+	mpu_bench_shared_t *shared = ( mpu_bench_shared_t * ) params;
+
+	for (;;) {
+		( void ) ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+		xTaskNotifyGive(shared->ping);
+	}
+}
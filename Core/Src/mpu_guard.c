@@ -0,0 +1,229 @@
+/**
+  ******************************************************************************
+  * @file    mpu_guard.c
+  * @brief   Contains the memory management faults of unprivileged tasks.
+  *
+  *          In the MPU build (Debug_MPU configuration, ARM_CM4_MPU port) an
+  *          unprivileged task that touches memory outside of its regions
+  *          raises a memory management fault.  Instead of halting the whole
+  *          system the fault is recorded and the exception returns into a
+  *          trap that suspends the offending task, every other task keeps
+  *          running.  Faults of privileged code, and faults during stacking
+  *          or unstacking where the frame can not be trusted, are recorded
+  *          by crash_dump.c, which resets.
+  *
+  *          In the default build the MPU is not enabled, the handler is
+  *          only reached through a real fault and records it.
+  *
+  *          The tasks that need no privilege are created restricted with
+  *          mpu_guard_create_task(): they reach their stack, the regions
+  *          given to them, the flash and the peripherals, and enter the
+  *          kernel through the MPU_ wrappers.  Their stacks are declared
+  *          with MPU_GUARD_STACK() and their TCBs are privileged data.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "mpu_guard.h"
+#include "crash_dump.h"
+#include "stm32f4xx.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+
+/* Offsets of the stacked registers in the exception frame. */
+#define MPU_GUARD_FRAME_PC              6U
+#define MPU_GUARD_FRAME_XPSR            7U
+
+/* EXC_RETURN bits: return to thread mode, using the process stack. */
+#define MPU_GUARD_EXC_RETURN_THREAD     0x00000008UL
+#define MPU_GUARD_EXC_RETURN_PSP        0x00000004UL
+
+/* Access violations the task can be blamed for, and the ones where the
+exception frame itself is broken. */
+#define MPU_GUARD_ACCESS_FAULTS         ( SCB_CFSR_IACCVIOL_Msk | SCB_CFSR_DACCVIOL_Msk )
+#define MPU_GUARD_FRAME_FAULTS          ( SCB_CFSR_MSTKERR_Msk | SCB_CFSR_MUNSTKERR_Msk | SCB_CFSR_MLSPERR_Msk )
+
+/* Generated by the linker script. */
+extern uint32_t __privileged_functions_start__[];
+extern uint32_t __privileged_functions_end__[];
+extern uint32_t __syscalls_flash_start__[];
+extern uint32_t __syscalls_flash_end__[];
+extern uint32_t __privileged_data_start__[];
+extern uint32_t __privileged_data_end__[];
+extern uint32_t __demo_data_start__[];
+extern uint32_t __demo_data_end__[];
+
+static void mpu_guard_trap(void);
+
+/* Written by the fault handler only, unprivileged tasks can not clear
+their own traces. */
+static PRIVILEGED_DATA mpu_guard_stats_t mpu_guard_stats;
+
+/**
+  * @brief  Creates a task restricted to its stack and to the given regions.
+  * @note   Must be called by a privileged task or before the scheduler is
+  *         started.  The restricted task runs unprivileged unless priority
+  *         has portPRIVILEGE_BIT set.  Without the MPU the task is created
+  *         with xTaskCreateStatic() and the regions are not used.
+  * @param  code: Function that implements the task
+  * @param  name: Text name of the task
+  * @param  depth: Stack size in words
+  * @param  params: Parameter passed into the task
+  * @param  priority: Priority of the task
+  * @param  stack: Stack declared with MPU_GUARD_STACK()
+  * @param  tcb: Buffer of the task's data structure
+  * @param  regions: portNUM_CONFIGURABLE_REGIONS regions, NULL for none
+  * @retval Handle of the task, NULL if it could not be created
+  */
+TaskHandle_t mpu_guard_create_task(TaskFunction_t code, const char *name, uint32_t depth, void *params,
+	UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb, const MemoryRegion_t *regions)
+{
+#if ( portUSING_MPU_WRAPPERS == 1 )
+	TaskParameters_t parameters = {
+		.pvTaskCode     = code,
+		.pcName         = name,
+		.usStackDepth   = depth,
+		.pvParameters   = params,
+		.uxPriority     = priority,
+		.puxStackBuffer = stack,
+		.pxTaskBuffer   = tcb
+	};
+	TaskHandle_t handle = NULL;
+	uint32_t i;
+
+	for (i = 0; (regions != NULL) && (i < portNUM_CONFIGURABLE_REGIONS); i++) {
+		parameters.xRegions[i] = regions[i];
+	}
+
+	( void ) xTaskCreateRestrictedStatic(&parameters, &handle);
+
+	return handle;
+#else
+	( void ) regions;
+
+	return xTaskCreateStatic(code, name, depth, params, priority, stack, tcb);
+#endif
+}
+
+/**
+  * @brief  Creates one of the standard demo tasks, restricted to its stack
+  *         and to the data of the demo tasks.
+  * @note   The linker script gathers the data of Core/Src/demo_tasks_src in
+  *         one region.  The parameters are the ones of mpu_guard_create_task().
+  * @retval Handle of the task, NULL if it could not be created
+  */
+TaskHandle_t mpu_guard_create_demo_task(TaskFunction_t code, const char *name, uint32_t depth, void *params,
+	UBaseType_t priority, StackType_t *stack, StaticTask_t *tcb)
+{
+	const MemoryRegion_t regions[ portNUM_CONFIGURABLE_REGIONS ] = {
+		{ __demo_data_start__, ( uint32_t ) __demo_data_end__ - ( uint32_t ) __demo_data_start__, MPU_GUARD_READ_WRITE }
+	};
+
+	return mpu_guard_create_task(code, name, depth, params, priority, stack, tcb, regions);
+}
+
+/**
+  * @brief  Handles a memory management fault.
+  * @note   Called from MemManage_Handler with the exception frame of the
+  *         interrupted code.  Returning from here returns from the exception.
+  * @param  frame: Stacked R0-R3, R12, LR, PC and xPSR
+  * @param  exc_return: EXC_RETURN value of the exception
+  * @param  callee: R4-R11 of the interrupted code, for the crash record
+  * @retval None
+  */
+void mpu_guard_memmanage(uint32_t *frame, uint32_t exc_return, const uint32_t *callee)
+{
+	uint32_t cfsr = SCB->CFSR;
+	bool unprivileged;
+
+	unprivileged = ((exc_return & MPU_GUARD_EXC_RETURN_THREAD) != 0) &&
+		((exc_return & MPU_GUARD_EXC_RETURN_PSP) != 0) &&
+		((__get_CONTROL() & CONTROL_nPRIV_Msk) != 0);
+
+	if ((true != unprivileged) || ((cfsr & MPU_GUARD_ACCESS_FAULTS) == 0) || ((cfsr & MPU_GUARD_FRAME_FAULTS) != 0)) {
+		crash_dump_fault(frame, exc_return, callee, CRASH_DUMP_MEM_MANAGE);
+	}
+
+	mpu_guard_stats.faults++;
+	mpu_guard_stats.pc = frame[MPU_GUARD_FRAME_PC];
+	mpu_guard_stats.address = ((cfsr & SCB_CFSR_MMARVALID_Msk) != 0) ? SCB->MMFAR : MPU_GUARD_NO_ADDRESS;
+
+	/* Not pcTaskGetName(), its MPU wrapper would raise privilege with an SVC,
+	which faults in a handler when the interrupted task is unprivileged. */
+	crash_dump_task_name(mpu_guard_stats.task, sizeof(mpu_guard_stats.task));
+
+	/* Resume the task in the trap, in Thumb state. */
+	frame[MPU_GUARD_FRAME_PC] = ( uint32_t ) mpu_guard_trap;
+	frame[MPU_GUARD_FRAME_XPSR] = xPSR_T_Msk;
+
+	/* The fault status bits are cleared by writing ones. */
+	SCB->CFSR = cfsr & SCB_CFSR_MEMFAULTSR_Msk;
+}
+
+/**
+  * @brief  Returns a copy of the fault statistics.
+  * @param  stats: Destination of the copy
+  * @retval None
+  */
+void mpu_guard_get_stats(mpu_guard_stats_t *stats)
+{
+	configASSERT(stats);
+
+	taskENTER_CRITICAL();
+	{
+		*stats = mpu_guard_stats;
+	}
+	taskEXIT_CRITICAL();
+}
+
+/**
+  * @brief  Prints the state of the MPU, the size of the privileged sections
+  *         and the trapped faults.
+  * @param  buffer: Output buffer
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void mpu_guard_print(char *buffer, size_t length)
+{
+	mpu_guard_stats_t stats;
+	size_t written;
+
+	configASSERT(buffer);
+
+	mpu_guard_get_stats(&stats);
+
+	written = snprintf(buffer, length,
+		"\r\nMPU: %lu regions, %s\r\n"
+		"Privileged functions: %lu bytes\r\n"
+		"System calls: %lu bytes\r\n"
+		"Privileged data: %lu bytes\r\n"
+		"Trapped faults: %lu\r\n",
+		( unsigned long ) ((MPU->TYPE & MPU_TYPE_DREGION_Msk) >> MPU_TYPE_DREGION_Pos),
+		((MPU->CTRL & MPU_CTRL_ENABLE_Msk) != 0) ? "enabled" : "disabled",
+		( unsigned long ) (( uint32_t ) __privileged_functions_end__ - ( uint32_t ) __privileged_functions_start__),
+		( unsigned long ) (( uint32_t ) __syscalls_flash_end__ - ( uint32_t ) __syscalls_flash_start__),
+		( unsigned long ) (( uint32_t ) __privileged_data_end__ - ( uint32_t ) __privileged_data_start__),
+		( unsigned long ) stats.faults);
+
+	if ((stats.faults != 0) && (written < length)) {
+		written += snprintf(buffer + written, length - written, "Last: task %s, pc 0x%08lX", stats.task, ( unsigned long ) stats.pc);
+
+		if (written < length) {
+			if (stats.address != MPU_GUARD_NO_ADDRESS) {
+				snprintf(buffer + written, length - written, ", address 0x%08lX\r\n", ( unsigned long ) stats.address);
+			} else {
+				snprintf(buffer + written, length - written, "\r\n");
+			}
+		}
+	}
+}
+
+static void mpu_guard_trap(void)
+{
+	for (;;) {
+		vTaskSuspend(NULL);
+	}
+}
@@ -0,0 +1,247 @@
+/**
+  ******************************************************************************
+  * @file    newlib_heap.c
+  * @brief   malloc() on the FreeRTOS heap.
+  *
+  *          The newlib allocator took its memory from _sbrk(), which checked
+  *          for a collision with the stack pointer, the stack of the calling
+  *          task under FreeRTOS, and used the RAM after .bss besides heap_4.
+  *          malloc(), free(), realloc() and calloc(), and the reentrant
+  *          versions the library calls itself (stdio buffers, dtoa), are
+  *          defined here instead, on top of pvPortMalloc() and vPortFree().
+  *          So all the dynamic memory is in ucHeap, bounded by
+  *          configTOTAL_HEAP_SIZE, and newlib's allocator and _sbrk() are
+  *          not linked.
+  *
+  *          Every block has an 8 byte header with its requested size, which
+  *          keeps the 8 byte alignment of heap_4, and lets realloc() copy the
+  *          contents and the statistics count the bytes in use.  The header
+  *          and the statistics are updated with the scheduler suspended, as
+  *          heap_4 does, so malloc() must not be called from an interrupt.
+  *          In the MPU build the heap and the heap_4 state are privileged
+  *          data, only the privileged tasks may call malloc().
+  *
+  *          A failed allocation returns NULL with errno set to ENOMEM, the
+  *          malloc failed hook, which stops the system for the kernel
+  *          objects, returns for it.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "newlib_heap.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <errno.h>
+#include <reent.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define NEWLIB_HEAP_MAGIC               0x4D414C4CUL    /* "MALL" */
+
+typedef struct {
+	size_t   size;                  /* Requested size. */
+	uint32_t magic;
+} newlib_heap_header_t;
+
+typedef struct {
+	uint32_t blocks;                /* Blocks in use. */
+	size_t   bytes;                 /* Requested bytes in use. */
+	size_t   peak;                  /* Most bytes in use. */
+	uint32_t allocs;
+	uint32_t frees;
+	uint32_t failures;
+	bool     in_malloc;
+} newlib_heap_stats_t;
+
+static void *newlib_heap_alloc(size_t size);
+static void newlib_heap_free(void *ptr);
+
+PRIVILEGED_DATA static newlib_heap_stats_t newlib_heap_stats;
+
+void *_malloc_r(struct _reent *reent, size_t size)
+{
+	( void ) reent;
+
+	return newlib_heap_alloc(size);
+}
+
+void _free_r(struct _reent *reent, void *ptr)
+{
+	( void ) reent;
+
+	newlib_heap_free(ptr);
+}
+
+void *_calloc_r(struct _reent *reent, size_t count, size_t size)
+{
+	void *ptr;
+
+	( void ) reent;
+
+	if ((size != 0U) && (count > SIZE_MAX / size)) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	ptr = newlib_heap_alloc(count * size);
+	if (ptr != NULL) {
+		memset(ptr, 0, count * size);
+	}
+
+	return ptr;
+}
+
+void *_realloc_r(struct _reent *reent, void *ptr, size_t size)
+{
+	newlib_heap_header_t *header;
+	void *resized;
+
+	( void ) reent;
+
+	if (ptr == NULL) {
+		return newlib_heap_alloc(size);
+	}
+
+	if (size == 0U) {
+		newlib_heap_free(ptr);
+		return NULL;
+	}
+
+	header = (newlib_heap_header_t *)ptr - 1;
+	configASSERT(header->magic == NEWLIB_HEAP_MAGIC);
+
+	/* A block is not shrunk, heap_4 cannot split it in place. */
+	if (size <= header->size) {
+		return ptr;
+	}
+
+	resized = newlib_heap_alloc(size);
+	if (resized != NULL) {
+		memcpy(resized, ptr, header->size);
+		newlib_heap_free(ptr);
+	}
+
+	return resized;
+}
+
+void *malloc(size_t size)
+{
+	return _malloc_r(_REENT, size);
+}
+
+void free(void *ptr)
+{
+	_free_r(_REENT, ptr);
+}
+
+void *calloc(size_t count, size_t size)
+{
+	return _calloc_r(_REENT, count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+	return _realloc_r(_REENT, ptr, size);
+}
+
+/**
+  * @brief  Writes the malloc() statistics and the state of the FreeRTOS heap
+  *         into a buffer.
+  * @param  buffer: the output buffer
+  * @param  length: size of the buffer
+  * @retval None
+  */
+void newlib_heap_print(char *buffer, size_t length)
+{
+	newlib_heap_stats_t stats;
+
+	configASSERT(buffer);
+
+	vTaskSuspendAll();
+	stats = newlib_heap_stats;
+	(void)xTaskResumeAll();
+
+	snprintf(buffer, length,
+		"\r\nmalloc: %lu blocks, %lu bytes in use, most in use: %lu bytes\r\n"
+		"        %lu allocations, %lu frees, %lu failed\r\n"
+		"FreeRTOS heap: %lu of %lu bytes free, least free: %lu bytes\r\n",
+		( unsigned long ) stats.blocks, ( unsigned long ) stats.bytes, ( unsigned long ) stats.peak,
+		( unsigned long ) stats.allocs, ( unsigned long ) stats.frees, ( unsigned long ) stats.failures,
+		( unsigned long ) xPortGetFreeHeapSize(), ( unsigned long ) configTOTAL_HEAP_SIZE,
+		( unsigned long ) xPortGetMinimumEverFreeHeapSize());
+}
+
+/**
+  * @brief  Tells if pvPortMalloc() was called by malloc().
+  * @note   Called from vApplicationMallocFailedHook(), while the scheduler
+  *         is suspended by pvPortMalloc().
+  * @retval true in malloc()
+  */
+bool newlib_heap_in_malloc(void)
+{
+	return newlib_heap_stats.in_malloc;
+}
+
+static void *newlib_heap_alloc(size_t size)
+{
+	newlib_heap_header_t *header = NULL;
+
+	configASSERT(xPortIsInsideInterrupt() == pdFALSE);
+
+	vTaskSuspendAll();
+	if (size <= SIZE_MAX - sizeof(newlib_heap_header_t)) {
+		newlib_heap_stats.in_malloc = true;
+		header = pvPortMalloc(sizeof(newlib_heap_header_t) + size);
+		newlib_heap_stats.in_malloc = false;
+	}
+
+	if (header != NULL) {
+		header->size  = size;
+		header->magic = NEWLIB_HEAP_MAGIC;
+
+		newlib_heap_stats.blocks++;
+		newlib_heap_stats.allocs++;
+		newlib_heap_stats.bytes += size;
+		if (newlib_heap_stats.bytes > newlib_heap_stats.peak) {
+			newlib_heap_stats.peak = newlib_heap_stats.bytes;
+		}
+	} else {
+		newlib_heap_stats.failures++;
+	}
+	(void)xTaskResumeAll();
+
+	if (header == NULL) {
+		errno = ENOMEM;
+		return NULL;
+	}
+
+	return header + 1;
+}
+
+static void newlib_heap_free(void *ptr)
+{
+	newlib_heap_header_t *header;
+
+	if (ptr == NULL) {
+		return;
+	}
+
+	configASSERT(xPortIsInsideInterrupt() == pdFALSE);
+
+	header = (newlib_heap_header_t *)ptr - 1;
+	configASSERT(header->magic == NEWLIB_HEAP_MAGIC);
+
+	vTaskSuspendAll();
+	newlib_heap_stats.blocks--;
+	newlib_heap_stats.frees++;
+	newlib_heap_stats.bytes -= header->size;
+
+	/* A block freed twice is likely to trip the assertion above. */
+	header->magic = 0U;
+	vPortFree(header);
+	(void)xTaskResumeAll();
+}
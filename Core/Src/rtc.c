@@ -9,24 +9,29 @@
   ******************************************************************************
   */
 #include "rtc.h"
-#include <stdlib.h>
 #include <stdio.h>
+#include <string.h>
 #include "stm32f4xx_hal.h"
 #include "main.h"
+#include "timebase.h"
+#include "time_format.h"
 
 RTC_HandleTypeDef hrtc;
 
+/* RTC_BACKUP_CALENDAR once the calendar is set, "RTCC". */
+#define RTC_CALENDAR_MAGIC          0x52544343UL
+
+/* The RTC is initialized after the scheduler is started, see main(). */
+static volatile bool rtc_ready = false;
+
+/* The calendar was kept over the reset. */
+static bool rtc_restored = false;
+
+static void RTC_SetBuildTime(void);
+
 /* RTC init function */
 void RTC_Init(void)
 {
-	char *time     = __TIME__;
-	char hours[]   = { time[0], time[1] };
-	char minutes[] = { time[3], time[4] };
-	char seconds[] = { time[6], time[7] };
-
-	RTC_TimeTypeDef sTime    = {0};
-	RTC_DateTypeDef sDate    = {0};
-
 	/** Initialize RTC Only	*/
 	hrtc.Instance            = RTC;
 	hrtc.Init.HourFormat     = RTC_HOURFORMAT_24;
@@ -36,14 +41,62 @@ void RTC_Init(void)
 	hrtc.Init.OutPutPolarity = RTC_OUTPUT_POLARITY_HIGH;
 	hrtc.Init.OutPutType     = RTC_OUTPUT_TYPE_OPENDRAIN;
 
-	if (HAL_RTC_Init(&hrtc) != HAL_OK) {
-		Error_Handler();
+	/* A system reset does not reset the backup domain, the calendar kept
+	counting, except from the reset until SystemClock_Config() restarts the
+	LSI.  The initialization mode would restart the prescalers, it is only
+	entered to start the calendar after a power on. */
+	if ((RTC_CALENDAR_MAGIC == HAL_RTCEx_BKUPRead(&hrtc, RTC_BACKUP_CALENDAR)) &&
+		(0U != (hrtc.Instance->ISR & RTC_ISR_INITS))) {
+
+		HAL_RTC_MspInit(&hrtc);
+		hrtc.Lock  = HAL_UNLOCKED;
+		hrtc.State = HAL_RTC_STATE_READY;
+
+		/* The prescalers may have been calibrated, see rtc_calib.c. */
+		hrtc.Init.AsynchPrediv = (hrtc.Instance->PRER & RTC_PRER_PREDIV_A) >> RTC_PRER_PREDIV_A_Pos;
+		hrtc.Init.SynchPrediv  = hrtc.Instance->PRER & RTC_PRER_PREDIV_S;
+
+		/* The shadow registers are valid once they are synchronized after
+		the reset. */
+		__HAL_RTC_WRITEPROTECTION_DISABLE(&hrtc);
+		if (HAL_RTC_WaitForSynchro(&hrtc) != HAL_OK) {
+			Error_Handler();
+		}
+		__HAL_RTC_WRITEPROTECTION_ENABLE(&hrtc);
+
+		rtc_restored = true;
+	} else {
+		if (HAL_RTC_Init(&hrtc) != HAL_OK) {
+			Error_Handler();
+		}
+
+		RTC_SetBuildTime();
+		HAL_RTCEx_BKUPWrite(&hrtc, RTC_BACKUP_CALENDAR, RTC_CALENDAR_MAGIC);
+	}
+
+	rtc_ready = true;
+}
+
+static void RTC_SetBuildTime(void)
+{
+	static const char build_time[] = __DATE__ " " __TIME__;
+
+	/* Kept if the compiler's format is not recognized. */
+	timekeeping_calendar_t calendar = { .year = 2022, .month = 1, .day = 1, .weekday = 6 };
+	time_format_t format;
+
+	RTC_TimeTypeDef sTime    = {0};
+	RTC_DateTypeDef sDate    = {0};
+
+	/* "Oct  8 2026 12:34:56" */
+	if (true == time_format_compile(&format, "%b %e %Y %H:%M:%S", 0)) {
+		( void ) time_format_parse(&format, build_time, strlen(build_time), &calendar, NULL);
 	}
 
 	/** Initialize RTC and set the Time and Date */
-	sTime.Hours              = (uint8_t)strtoul(hours,   NULL, 10);
-	sTime.Minutes            = (uint8_t)strtoul(minutes, NULL, 10);
-	sTime.Seconds            = (uint8_t)strtoul(seconds, NULL, 10);
+	sTime.Hours              = calendar.hours;
+	sTime.Minutes            = calendar.minutes;
+	sTime.Seconds            = calendar.seconds;
 	sTime.DayLightSaving     = RTC_DAYLIGHTSAVING_NONE;
 	sTime.StoreOperation     = RTC_STOREOPERATION_RESET;
 
@@ -51,16 +104,21 @@ void RTC_Init(void)
 		Error_Handler();
 	}
 
-	sDate.WeekDay            = RTC_WEEKDAY_SATURDAY;
-	sDate.Month              = RTC_MONTH_JANUARY;
-	sDate.Date               = 1;
-	sDate.Year               = 22;
+	sDate.WeekDay            = calendar.weekday;
+	sDate.Month              = calendar.month;
+	sDate.Date               = calendar.day;
+	sDate.Year               = (uint8_t)(calendar.year % 100U);
 
 	if (HAL_RTC_SetDate(&hrtc, &sDate, RTC_FORMAT_BIN) != HAL_OK) {
 		Error_Handler();
 	}
 }
 
+bool RTC_IsReady(void)
+{
+	return rtc_ready;
+}
+
 void HAL_RTC_MspInit(RTC_HandleTypeDef* rtcHandle)
 {
 	RCC_PeriphCLKInitTypeDef PeriphClkInitStruct = {0};
@@ -88,69 +146,159 @@ void HAL_RTC_MspDeInit(RTC_HandleTypeDef* rtcHandle)
 	}
 }
 
-void RTC_GetTime(uint8_t *hours, uint8_t *minutes, uint8_t *seconds)
+/**
+  * @brief  Reads the calendar and the sub-second counter.
+  * @note   Reading RTC_SSR locks the shadow registers of the time and the
+  *         date until RTC_DR is read, the three are consistent.  The
+  *         sub-second counter counts down from SecondFraction within a
+  *         second.
+  * @param  sTime: the time, with SubSeconds and SecondFraction
+  * @param  sDate: the date
+  * @retval false if the RTC is not initialized
+  */
+bool RTC_GetCalendar(RTC_TimeTypeDef *sTime, RTC_DateTypeDef *sDate)
 {
-	RTC_TimeTypeDef stime = {0};
-	RTC_DateTypeDef sdate = {0};
+	uint32_t ssr;
+	uint32_t tr;
+	uint32_t dr;
 
-	HAL_RTC_GetTime(&hrtc, &stime, RTC_FORMAT_BIN);
-	HAL_RTC_GetDate(&hrtc, &sdate, RTC_FORMAT_BIN);
+	if (true != rtc_ready) {
+		return false;
+	}
 
-	*hours   = stime.Hours;
-	*minutes = stime.Minutes;
-	*seconds = stime.Seconds;
-}
+	ssr = hrtc.Instance->SSR;
+	tr  = hrtc.Instance->TR & RTC_TR_RESERVED_MASK;
+	dr  = hrtc.Instance->DR & RTC_DR_RESERVED_MASK;
 
-void RTC_GetDate(uint8_t *day, uint8_t *month, uint8_t *year)
-{
-	RTC_TimeTypeDef stime = {0};
-	RTC_DateTypeDef sdate = {0};
+	sTime->Hours          = RTC_Bcd2ToByte((uint8_t)((tr & (RTC_TR_HT | RTC_TR_HU)) >> RTC_TR_HU_Pos));
+	sTime->Minutes        = RTC_Bcd2ToByte((uint8_t)((tr & (RTC_TR_MNT | RTC_TR_MNU)) >> RTC_TR_MNU_Pos));
+	sTime->Seconds        = RTC_Bcd2ToByte((uint8_t)((tr & (RTC_TR_ST | RTC_TR_SU)) >> RTC_TR_SU_Pos));
+	sTime->TimeFormat     = (uint8_t)((tr & RTC_TR_PM) >> RTC_TR_PM_Pos);
+	sTime->SubSeconds     = ssr;
+	sTime->SecondFraction = hrtc.Instance->PRER & RTC_PRER_PREDIV_S;
 
-	HAL_RTC_GetTime(&hrtc, &stime, RTC_FORMAT_BIN);
-	HAL_RTC_GetDate(&hrtc, &sdate, RTC_FORMAT_BIN);
+	sDate->Year    = RTC_Bcd2ToByte((uint8_t)((dr & (RTC_DR_YT | RTC_DR_YU)) >> RTC_DR_YU_Pos));
+	sDate->Month   = RTC_Bcd2ToByte((uint8_t)((dr & (RTC_DR_MT | RTC_DR_MU)) >> RTC_DR_MU_Pos));
+	sDate->Date    = RTC_Bcd2ToByte((uint8_t)((dr & (RTC_DR_DT | RTC_DR_DU)) >> RTC_DR_DU_Pos));
+	sDate->WeekDay = (uint8_t)((dr & RTC_DR_WDU) >> RTC_DR_WDU_Pos);
 
-	*day   = sdate.Date;
-	*month = sdate.Month;
-	*year  = sdate.Year;
+	return true;
 }
 
-bool RTC_SetTime(uint8_t hours, uint8_t minutes, uint8_t seconds)
+/**
+  * @brief  Sets the time and the date in one initialization.
+  * @note   The prescalers restart with the new second, with the values of
+  *         RTC_SetPrescalers() if they were changed.  The calendar starts
+  *         RTC_START_DELAY_US after the initialization mode ends, which is
+  *         timed to start the second at start_us.  The caller must not be
+  *         preempted until then.
+  * @param  sTime: the time, the sub-seconds are not used
+  * @param  sDate: the date
+  * @param  start_us: timebase_get_us64() when the second starts, 0 for at
+  *         once
+  * @retval false if the RTC is not initialized or did not respond
+  */
+bool RTC_SetCalendar(const RTC_TimeTypeDef *sTime, const RTC_DateTypeDef *sDate, uint64_t start_us)
 {
-	RTC_TimeTypeDef stime = {0};
-	RTC_DateTypeDef sdate = {0};
-	bool retv = true;
+	HAL_StatusTypeDef status;
+
+	if (true != rtc_ready) {
+		return false;
+	}
+
+	__HAL_RTC_WRITEPROTECTION_DISABLE(&hrtc);
+
+	status = RTC_EnterInitMode(&hrtc);
+	if (HAL_OK == status) {
+		/* The two prescalers are written separately. */
+		hrtc.Instance->PRER  = hrtc.Init.SynchPrediv;
+		hrtc.Instance->PRER |= hrtc.Init.AsynchPrediv << RTC_PRER_PREDIV_A_Pos;
+
+		hrtc.Instance->TR = (((uint32_t)RTC_ByteToBcd2(sTime->Hours)   << RTC_TR_HU_Pos)  |
+		                     ((uint32_t)RTC_ByteToBcd2(sTime->Minutes) << RTC_TR_MNU_Pos) |
+		                     ((uint32_t)RTC_ByteToBcd2(sTime->Seconds) << RTC_TR_SU_Pos)) & RTC_TR_RESERVED_MASK;
+		hrtc.Instance->DR = (((uint32_t)RTC_ByteToBcd2(sDate->Year)  << RTC_DR_YU_Pos) |
+		                     ((uint32_t)RTC_ByteToBcd2(sDate->Month) << RTC_DR_MU_Pos) |
+		                     ((uint32_t)RTC_ByteToBcd2(sDate->Date)  << RTC_DR_DU_Pos) |
+		                     ((uint32_t)sDate->WeekDay               << RTC_DR_WDU_Pos)) & RTC_DR_RESERVED_MASK;
 
-	HAL_RTC_GetTime(&hrtc, &stime, RTC_FORMAT_BIN);
-	HAL_RTC_GetDate(&hrtc, &sdate, RTC_FORMAT_BIN);
+		while ((int64_t)(start_us - timebase_get_us64()) > (int64_t)RTC_START_DELAY_US) {
+			/* Wait for the start of the second. */
+		}
+
+		status = RTC_ExitInitMode(&hrtc);
+	}
 
-	stime.Hours    = hours;
-	stime.Minutes  = minutes;
-	stime.Seconds  = seconds;
+	__HAL_RTC_WRITEPROTECTION_ENABLE(&hrtc);
 
-	if (HAL_OK != HAL_RTC_SetTime(&hrtc, &stime, RTC_FORMAT_BIN)) {
-		retv = false;
+	if (HAL_OK == status) {
+		HAL_RTCEx_BKUPWrite(&hrtc, RTC_BACKUP_CALENDAR, RTC_CALENDAR_MAGIC);
 	}
 
-	return retv;
+	return (HAL_OK == status);
+}
+
+/**
+  * @brief  Returns the prescalers the calendar counts with.
+  * @param  asynch_prediv: the asynchronous prescaler, divides by the value + 1
+  * @param  synch_prediv: the synchronous prescaler, divides by the value + 1
+  * @retval None
+  */
+void RTC_GetPrescalers(uint32_t *asynch_prediv, uint32_t *synch_prediv)
+{
+	*asynch_prediv = hrtc.Init.AsynchPrediv;
+	*synch_prediv  = hrtc.Init.SynchPrediv;
 }
 
-bool RTC_SetDate(uint8_t day, uint8_t month, uint8_t year)
+/**
+  * @brief  Changes the prescalers.
+  * @note   They can only be changed in the initialization mode, which
+  *         restarts the second, they are taken over by the next
+  *         RTC_SetCalendar().  Must not be called while it runs.
+  * @param  asynch_prediv: the asynchronous prescaler, 2 - 127
+  * @param  synch_prediv: the synchronous prescaler, 0 - 32767
+  * @retval None
+  */
+void RTC_SetPrescalers(uint32_t asynch_prediv, uint32_t synch_prediv)
 {
-	RTC_TimeTypeDef stime = {0};
-	RTC_DateTypeDef sdate = {0};
-	bool retv = true;
+	assert_param(IS_RTC_ASYNCH_PREDIV(asynch_prediv));
+	assert_param(IS_RTC_SYNCH_PREDIV(synch_prediv));
 
-	HAL_RTC_GetTime(&hrtc, &stime, RTC_FORMAT_BIN);
-	HAL_RTC_GetDate(&hrtc, &sdate, RTC_FORMAT_BIN);
+	hrtc.Init.AsynchPrediv = asynch_prediv;
+	hrtc.Init.SynchPrediv  = synch_prediv;
+}
 
-	sdate.Date   = day;
-	sdate.Month  = month;
-	sdate.Year   = year;
+uint32_t RTC_GetSmoothCalib(void)
+{
+	return hrtc.Instance->CALR;
+}
 
-	if (HAL_OK != HAL_RTC_SetDate(&hrtc, &sdate, RTC_FORMAT_BIN)) {
-		retv = false;
+/**
+  * @brief  Sets the smooth calibration over the 32 s cycle.
+  * @param  plus_pulses: RTC_SMOOTHCALIB_PLUSPULSES_SET adds 512 pulses
+  * @param  minus_pulses: the pulses masked, 0 - 511
+  * @retval false if the RTC is not initialized or did not respond
+  */
+bool RTC_SetSmoothCalib(uint32_t plus_pulses, uint32_t minus_pulses)
+{
+	if (true != rtc_ready) {
+		return false;
 	}
 
-	return retv;
+	return (HAL_OK == HAL_RTCEx_SetSmoothCalib(&hrtc, RTC_SMOOTHCALIB_PERIOD_32SEC, plus_pulses, minus_pulses));
 }
 
+bool RTC_IsRestored(void)
+{
+	return rtc_restored;
+}
+
+uint32_t RTC_ReadBackup(uint32_t index)
+{
+	return HAL_RTCEx_BKUPRead(&hrtc, index);
+}
+
+void RTC_WriteBackup(uint32_t index, uint32_t value)
+{
+	HAL_RTCEx_BKUPWrite(&hrtc, index, value);
+}
@@ -0,0 +1,441 @@
+/**
+  ******************************************************************************
+  * @file    rtc_calib.c
+  * @brief   Calibration of the LSI clocked RTC against the HSE.
+  *
+  *          The LSI is specified from 17 to 47 kHz, and the prescalers set
+  *          by RTC_Init() divide by 32768, so the calendar may be off by
+  *          several percent.  TIM5 channel 4 captures the LSI, which is
+  *          remapped to its input, every 8 cycles while the timer counts
+  *          the APB1 timer clock derived from the HSE crystal.  A few
+  *          consecutive captures give the capture period to a few ppm, with
+  *          which the captures in a RTC_CALIB_WINDOW_MS long window are
+  *          counted without an interrupt for each.  A measurement during
+  *          which dfs.c changed the clocks is discarded.
+  *
+  *          The RTC then divides the LSI by the largest asynchronous
+  *          prescaler for which the smooth calibration can correct the
+  *          rest, at most +-488 ppm in steps of 0.95 ppm.  The smooth
+  *          calibration is written at once, new prescalers are taken over
+  *          when timekeeping.c sets the RTC next, which it is asked to do,
+  *          as they restart the second.  The measurement is repeated every
+  *          RTC_CALIB_PERIOD_S.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "rtc_calib.h"
+#include "rtc.h"
+#include "timekeeping.h"
+#include "timebase.h"
+#include "stm32f4xx_hal.h"
+
+#include <stdio.h>
+
+/* The LSI is captured every 8 cycles. */
+#define RTC_CALIB_CAPTURE_DIVIDER       8UL
+
+/* Consecutive captures that give the capture period. */
+#define RTC_CALIB_COARSE_CAPTURES       8UL
+
+/* Longer than 8 cycles of the slowest LSI. */
+#define RTC_CALIB_CAPTURE_TIMEOUT_US    2000UL
+
+/* Beyond the specified range of the LSI. */
+#define RTC_CALIB_MIN_MILLIHZ           15000000UL
+#define RTC_CALIB_MAX_MILLIHZ           50000000UL
+
+/* The smooth calibration can add 512 pulses or mask up to 511 in 2^20. */
+#define RTC_CALIB_CYCLE                 1048576LL
+#define RTC_CALIB_MAX_PULSES            511L
+#define RTC_CALIB_MIN_PULSES            -512L
+
+/* The prescalers of RTC_Init(), for 32768 Hz. */
+#define RTC_CALIB_DEFAULT_DIVIDER       32768ULL
+
+typedef struct {
+	uint32_t asynch_prediv;
+	uint32_t synch_prediv;
+	int32_t  pulses;            /* Masked pulses minus the added ones in 2^20 cycles. */
+	int32_t  residual_ppb;      /* Error of the RTC that remains. */
+} rtc_calib_setting_t;
+
+typedef struct {
+	uint32_t            lsi_millihz;    /* Last measurement in mHz, 0 before the first. */
+	uint32_t            previous_millihz;
+	uint32_t            min_millihz;
+	uint32_t            max_millihz;
+	uint32_t            measurements;
+	uint32_t            failures;
+	uint32_t            changes;        /* Settings written to the RTC. */
+	uint64_t            last_us;        /* timebase_get_us64() at the last measurement. */
+	rtc_calib_setting_t setting;
+} rtc_calib_state_t;
+
+static void rtc_calib_task(void *params);
+static void rtc_calib_calibrate(void);
+static bool rtc_calib_measure(uint32_t *lsi_millihz);
+static bool rtc_calib_capture(uint32_t *capture);
+static void rtc_calib_timer_start(void);
+static void rtc_calib_timer_stop(void);
+static uint32_t rtc_calib_timer_hz(void);
+static bool rtc_calib_setting(uint32_t lsi_millihz, rtc_calib_setting_t *setting);
+static int64_t rtc_calib_ppb(int64_t value, int64_t reference);
+static void rtc_calib_format_ppm(int64_t ppb, char *text, size_t length);
+
+PRIVILEGED_DATA static TaskHandle_t rtc_calib_task_handle;
+PRIVILEGED_DATA static volatile uint32_t rtc_calib_clock_generation;
+
+/* Written by the task in critical sections. */
+PRIVILEGED_DATA static rtc_calib_state_t rtc_calib_state;
+
+/**
+  * @brief  Creates the calibration task, which measures the LSI at once.
+  * @note   Called after timekeeping_init().
+  * @retval None
+  */
+void rtc_calib_init(void)
+{
+	BaseType_t retv;
+
+	retv = xTaskCreate(rtc_calib_task,				/* The calibration task. */
+					   "RtcCal",					/* Text name assigned to the task.  This is just to assist debugging. */
+					   RTC_CALIB_TASK_STACK_SIZE,	/* The size of the stack allocated to the task. */
+					   NULL,						/* The parameter is not used, so NULL is passed. */
+					   RTC_CALIB_TASK_PRIORITY | portPRIVILEGE_BIT,	/* The priority allocated to the task, privileged as the calibration state is privileged data. */
+					   &rtc_calib_task_handle );
+	configASSERT( retv == pdPASS );
+}
+
+/**
+  * @brief  Measures the LSI now, instead of at the end of the period.
+  * @retval None
+  */
+void rtc_calib_run(void)
+{
+	if (rtc_calib_task_handle != NULL) {
+		xTaskNotifyGive(rtc_calib_task_handle);
+	}
+}
+
+/**
+  * @brief  Discards the measurement in progress.
+  * @note   Called with the scheduler suspended.
+  * @retval None
+  */
+void rtc_calib_clock_changed(void)
+{
+	rtc_calib_clock_generation = rtc_calib_clock_generation + 1U;
+}
+
+/**
+  * @brief  Writes the last measurement and the calibration into a buffer.
+  * @param  buffer: the output buffer
+  * @param  length: size of the buffer
+  * @retval None
+  */
+void rtc_calib_print(char *buffer, size_t length)
+{
+	rtc_calib_state_t state;
+	char uncalibrated[ 16 ];
+	char change[ 16 ];
+	char residual[ 16 ];
+	size_t written;
+
+	configASSERT(buffer);
+
+	taskENTER_CRITICAL();
+	{
+		state = rtc_calib_state;
+	}
+	taskEXIT_CRITICAL();
+
+	if (state.lsi_millihz == 0U) {
+		snprintf(buffer, length, "\r\nNo measurement yet, %lu failed.\r\n", ( unsigned long ) state.failures);
+		return;
+	}
+
+	rtc_calib_format_ppm(rtc_calib_ppb(state.lsi_millihz, RTC_CALIB_DEFAULT_DIVIDER * 1000ULL), uncalibrated, sizeof(uncalibrated));
+	rtc_calib_format_ppm(rtc_calib_ppb(state.lsi_millihz, (state.previous_millihz != 0U) ? state.previous_millihz : state.lsi_millihz),
+		change, sizeof(change));
+	rtc_calib_format_ppm(state.setting.residual_ppb, residual, sizeof(residual));
+
+	written = snprintf(buffer, length,
+		"\r\nLSI: %lu.%03lu Hz, measured %lu s ago\r\n"
+		"RTC error with the prescalers for 32768 Hz: %s ppm\r\n"
+		"LSI change since the previous measurement: %s ppm, range %lu.%03lu - %lu.%03lu Hz\r\n",
+		( unsigned long ) (state.lsi_millihz / 1000U), ( unsigned long ) (state.lsi_millihz % 1000U),
+		( unsigned long ) ((timebase_get_us64() - state.last_us) / 1000000ULL),
+		uncalibrated, change,
+		( unsigned long ) (state.min_millihz / 1000U), ( unsigned long ) (state.min_millihz % 1000U),
+		( unsigned long ) (state.max_millihz / 1000U), ( unsigned long ) (state.max_millihz % 1000U));
+
+	if (written < length) {
+		snprintf(buffer + written, length - written,
+			"Prescalers: %lu x %lu, smooth calibration masks %ld of 2^20 pulses, remaining error %s ppm\r\n"
+			"Measurements: %lu, %lu failed, settings changed %lu times\r\n",
+			( unsigned long ) (state.setting.asynch_prediv + 1U), ( unsigned long ) (state.setting.synch_prediv + 1U),
+			( long ) state.setting.pulses, residual,
+			( unsigned long ) state.measurements, ( unsigned long ) state.failures, ( unsigned long ) state.changes);
+	}
+}
+
+static void rtc_calib_task(void *params)
+{
+	( void ) params;
+
+	for (;;) {
+		rtc_calib_calibrate();
+
+		( void ) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(RTC_CALIB_PERIOD_S * 1000UL));
+	}
+}
+
+/**
+  * @brief  Measures the LSI and updates the calibration of the RTC.
+  * @retval None
+  */
+static void rtc_calib_calibrate(void)
+{
+	rtc_calib_setting_t setting;
+	uint32_t asynch_prediv;
+	uint32_t synch_prediv;
+	uint32_t calr;
+	uint32_t lsi_millihz;
+	bool changed = false;
+
+	if ((true != rtc_calib_measure(&lsi_millihz)) || (true != rtc_calib_setting(lsi_millihz, &setting))) {
+		taskENTER_CRITICAL();
+		{
+			rtc_calib_state.failures++;
+		}
+		taskEXIT_CRITICAL();
+		return;
+	}
+
+	calr = (setting.pulses < 0) ? (RTC_SMOOTHCALIB_PLUSPULSES_SET | (uint32_t)(setting.pulses + 512)) : (uint32_t)setting.pulses;
+	if (calr != (RTC_GetSmoothCalib() & (RTC_CALR_CALP | RTC_CALR_CALM))) {
+		( void ) RTC_SetSmoothCalib(calr & RTC_CALR_CALP, calr & RTC_CALR_CALM);
+		changed = true;
+	}
+
+	/* The RTC update of timekeeping.c runs with the scheduler suspended. */
+	RTC_GetPrescalers(&asynch_prediv, &synch_prediv);
+	if ((asynch_prediv != setting.asynch_prediv) || (synch_prediv != setting.synch_prediv)) {
+		vTaskSuspendAll();
+		{
+			RTC_SetPrescalers(setting.asynch_prediv, setting.synch_prediv);
+		}
+		( void ) xTaskResumeAll();
+
+		timekeeping_request_rtc_update();
+		changed = true;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		rtc_calib_state.previous_millihz = rtc_calib_state.lsi_millihz;
+		rtc_calib_state.lsi_millihz      = lsi_millihz;
+		rtc_calib_state.last_us          = timebase_get_us64();
+		rtc_calib_state.setting          = setting;
+		rtc_calib_state.measurements++;
+
+		if ((rtc_calib_state.min_millihz == 0U) || (lsi_millihz < rtc_calib_state.min_millihz)) {
+			rtc_calib_state.min_millihz = lsi_millihz;
+		}
+		if (lsi_millihz > rtc_calib_state.max_millihz) {
+			rtc_calib_state.max_millihz = lsi_millihz;
+		}
+		if (true == changed) {
+			rtc_calib_state.changes++;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+
+/**
+  * @brief  Measures the frequency of the LSI.
+  * @param  lsi_millihz: the frequency in mHz
+  * @retval false if a capture was missed or the clocks changed
+  */
+static bool rtc_calib_measure(uint32_t *lsi_millihz)
+{
+	uint32_t generation = rtc_calib_clock_generation;
+	uint32_t timer_hz = rtc_calib_timer_hz();
+	uint32_t first = 0;
+	uint32_t start = 0;
+	uint32_t end = 0;
+	uint32_t coarse;
+	uint32_t window;
+	uint32_t captures;
+	uint64_t error;
+	uint32_t i;
+	bool retv;
+
+	rtc_calib_timer_start();
+
+	/* A capture is missed if the task is preempted for 8 LSI cycles. */
+	vTaskSuspendAll();
+	{
+		retv = rtc_calib_capture(&first);
+		for (i = 0; (true == retv) && (i < RTC_CALIB_COARSE_CAPTURES); i++) {
+			retv = rtc_calib_capture(&start);
+		}
+	}
+	( void ) xTaskResumeAll();
+
+	if (true == retv) {
+		vTaskDelay(pdMS_TO_TICKS(RTC_CALIB_WINDOW_MS));
+
+		/* Any capture after the window, the ones in between are counted
+		from the capture period. */
+		TIM5->SR = ~(uint32_t)(TIM_SR_CC4IF | TIM_SR_CC4OF);
+		retv = rtc_calib_capture(&end);
+	}
+
+	rtc_calib_timer_stop();
+
+	if ((true != retv) || (generation != rtc_calib_clock_generation)) {
+		return false;
+	}
+
+	coarse   = start - first;
+	window   = end - start;
+	captures = (uint32_t)(((uint64_t)window * RTC_CALIB_COARSE_CAPTURES + coarse / 2U) / coarse);
+
+	/* The window must be within a quarter capture of a whole number of
+	captures, or the capture period was not accurate enough. */
+	error = (uint64_t)window * RTC_CALIB_COARSE_CAPTURES;
+	error = (error > (uint64_t)captures * coarse) ? error - (uint64_t)captures * coarse : (uint64_t)captures * coarse - error;
+	if ((captures == 0U) || (error > coarse / 4U)) {
+		return false;
+	}
+
+	*lsi_millihz = (uint32_t)(((uint64_t)captures * RTC_CALIB_CAPTURE_DIVIDER * timer_hz * 1000ULL + window / 2U) / window);
+
+	return ((*lsi_millihz >= RTC_CALIB_MIN_MILLIHZ) && (*lsi_millihz <= RTC_CALIB_MAX_MILLIHZ));
+}
+
+/**
+  * @brief  Waits for the next capture.
+  * @param  capture: the timer value of the capture
+  * @retval false on a timeout, or if a capture was missed before it
+  */
+static bool rtc_calib_capture(uint32_t *capture)
+{
+	uint32_t start = timebase_get_us();
+
+	while ((TIM5->SR & TIM_SR_CC4IF) == 0U) {
+		if ((timebase_get_us() - start) > RTC_CALIB_CAPTURE_TIMEOUT_US) {
+			return false;
+		}
+	}
+
+	/* Reading the capture clears the flag, a capture since the flag was
+	set sets the overcapture flag. */
+	*capture = TIM5->CCR4;
+
+	return ((TIM5->SR & TIM_SR_CC4OF) == 0U);
+}
+
+static void rtc_calib_timer_start(void)
+{
+	__HAL_RCC_TIM5_CLK_ENABLE();
+
+	/* Free running at the timer clock, channel 4 captures every 8th rising
+	edge of the LSI. */
+	TIM5->CR1   = 0;
+	TIM5->PSC   = 0;
+	TIM5->ARR   = 0xFFFFFFFFUL;
+	TIM5->OR    = TIM_OR_TI4_RMP_0;
+	TIM5->CCMR2 = TIM_CCMR2_CC4S_0 | TIM_CCMR2_IC4PSC;
+	TIM5->CCER  = TIM_CCER_CC4E;
+	TIM5->EGR   = TIM_EGR_UG;
+	TIM5->SR    = 0;
+	TIM5->CR1   = TIM_CR1_CEN;
+}
+
+static void rtc_calib_timer_stop(void)
+{
+	TIM5->CR1  = 0;
+	TIM5->CCER = 0;
+
+	__HAL_RCC_TIM5_CLK_DISABLE();
+}
+
+/**
+  * @brief  Returns the clock of the APB1 timers.
+  * @retval Frequency in Hz
+  */
+static uint32_t rtc_calib_timer_hz(void)
+{
+	uint32_t pclk1 = HAL_RCC_GetPCLK1Freq();
+
+	/* The timers run at twice PCLK1 when APB1 is divided. */
+	if ((RCC->CFGR & RCC_CFGR_PPRE1) != RCC_CFGR_PPRE1_DIV1) {
+		return 2U * pclk1;
+	}
+
+	return pclk1;
+}
+
+/**
+  * @brief  Finds the prescalers and the smooth calibration for an LSI.
+  * @param  lsi_millihz: the frequency of the LSI in mHz
+  * @param  setting: the calibration
+  * @retval false if the LSI can not be corrected
+  */
+static bool rtc_calib_setting(uint32_t lsi_millihz, rtc_calib_setting_t *setting)
+{
+	uint64_t divider_millihz;
+	uint64_t corrected;
+	int64_t difference;
+	int64_t pulses;
+	uint32_t asynch;
+	uint32_t synch;
+
+	/* The largest asynchronous prescaler draws the least current.  The
+	smooth calibration needs it to divide by at least 4. */
+	for (asynch = 128U; asynch >= 4U; asynch--) {
+		synch = (lsi_millihz + asynch * 500U) / (asynch * 1000U);
+		if ((synch < 1U) || (synch > 32768U)) {
+			continue;
+		}
+
+		divider_millihz = (uint64_t)asynch * synch * 1000U;
+		difference  = (int64_t)lsi_millihz - (int64_t)divider_millihz;
+
+		/* LSI / (1 + pulses / 2^20) = divider */
+		pulses = (difference * RTC_CALIB_CYCLE + ((difference < 0) ? -(int64_t)(divider_millihz / 2U) : (int64_t)(divider_millihz / 2U))) /
+				 (int64_t)divider_millihz;
+		if ((pulses < RTC_CALIB_MIN_PULSES) || (pulses > RTC_CALIB_MAX_PULSES)) {
+			continue;
+		}
+
+		corrected = (uint64_t)(RTC_CALIB_CYCLE + pulses) * divider_millihz;
+
+		setting->asynch_prediv = asynch - 1U;
+		setting->synch_prediv  = synch - 1U;
+		setting->pulses        = (int32_t)pulses;
+		setting->residual_ppb  = (int32_t)rtc_calib_ppb((int64_t)lsi_millihz * RTC_CALIB_CYCLE, (int64_t)corrected);
+
+		return true;
+	}
+
+	return false;
+}
+
+/* value / reference - 1 in ppb, the two must be within a few percent. */
+static int64_t rtc_calib_ppb(int64_t value, int64_t reference)
+{
+	return ((value - reference) * 1000000000LL) / reference;
+}
+
+static void rtc_calib_format_ppm(int64_t ppb, char *text, size_t length)
+{
+	uint64_t magnitude = (ppb < 0) ? (uint64_t)-ppb : (uint64_t)ppb;
+
+	snprintf(text, length, "%s%lu.%03lu", (ppb < 0) ? "-" : "+",
+		( unsigned long ) (magnitude / 1000U), ( unsigned long ) (magnitude % 1000U));
+}
@@ -0,0 +1,281 @@
+/**
+  ******************************************************************************
+  * @file    spsc_ring.c
+  * @brief   Lock free single producer, single consumer byte ring buffer.
+  *
+  *          Made for passing data from an interrupt to a task without a
+  *          queue transaction per byte.  The producer only writes the head
+  *          index and the consumer only writes the tail index, so neither
+  *          side needs a critical section or LDREX/STREX, an aligned 32-bit
+  *          store is atomic on the Cortex-M4.  The indices run freely and
+  *          are reduced modulo the power of two size when the storage is
+  *          accessed.
+  *
+  *          A data memory barrier orders the payload against the index that
+  *          publishes it.  The consumer task is notified only when the
+  *          producer finds that the consumer had already taken everything
+  *          before the new data was published, which is the only case in
+  *          which it may be waiting.  Each side stores its own index before
+  *          it loads the other one (with a barrier in between), so the
+  *          consumer either sees the new head or the producer sees the old
+  *          tail and a wakeup can not be lost.  A spurious wakeup on an empty
+  *          ring is possible and harmless.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "spsc_ring.h"
+#include "stm32f4xx.h"
+
+#include <stdbool.h>
+#include <string.h>
+
+static uint32_t spsc_ring_put(spsc_ring_t *ring, const uint8_t *data, uint32_t length, bool *was_empty);
+
+/**
+  * @brief  Initializes an empty ring buffer.
+  * @param  ring: The ring buffer to initialize
+  * @param  storage: Memory used to hold the data
+  * @param  size: Size of the storage in bytes, must be a power of two
+  * @retval None
+  */
+void spsc_ring_init(spsc_ring_t *ring, uint8_t *storage, uint32_t size)
+{
+	configASSERT(ring);
+	configASSERT(storage);
+	configASSERT((size != 0) && ((size & (size - 1U)) == 0));
+
+	ring->storage  = storage;
+	ring->size     = size;
+	ring->head     = 0;
+	ring->tail     = 0;
+	ring->consumer = NULL;
+	ring->dropped  = 0;
+}
+
+/**
+  * @brief  Sets the task that is notified when data becomes available.
+  * @note   Must be called before the producer starts writing.
+  * @param  ring: The ring buffer
+  * @param  consumer: The task that reads the ring buffer, NULL if it does
+  *         not wait with spsc_ring_receive()
+  * @retval None
+  */
+void spsc_ring_set_consumer(spsc_ring_t *ring, TaskHandle_t consumer)
+{
+	configASSERT(ring);
+
+	ring->consumer = consumer;
+}
+
+/**
+  * @brief  Writes data to the ring buffer from a task.
+  * @note   Data that does not fit is dropped and counted.
+  * @param  ring: The ring buffer to write
+  * @param  data: The data to write
+  * @param  length: Number of bytes to write
+  * @retval Number of bytes written
+  */
+uint32_t spsc_ring_write(spsc_ring_t *ring, const void *data, uint32_t length)
+{
+	bool was_empty;
+	TaskHandle_t consumer;
+
+	length = spsc_ring_put(ring, data, length, &was_empty);
+
+	consumer = ring->consumer;
+	if ((true == was_empty) && (consumer != NULL)) {
+		xTaskNotifyGiveIndexed(consumer, SPSC_RING_NOTIFY_INDEX);
+	}
+
+	return length;
+}
+
+/**
+  * @brief  Writes data to the ring buffer from an interrupt.
+  * @note   Data that does not fit is dropped and counted.
+  * @param  ring: The ring buffer to write
+  * @param  data: The data to write
+  * @param  length: Number of bytes to write
+  * @param  higher_priority_task_woken: Set to pdTRUE if a context switch
+  *         should be requested before the interrupt exits
+  * @retval Number of bytes written
+  */
+uint32_t spsc_ring_write_from_isr(spsc_ring_t *ring, const void *data, uint32_t length, BaseType_t *higher_priority_task_woken)
+{
+	bool was_empty;
+	TaskHandle_t consumer;
+
+	length = spsc_ring_put(ring, data, length, &was_empty);
+
+	consumer = ring->consumer;
+	if ((true == was_empty) && (consumer != NULL)) {
+		vTaskNotifyGiveIndexedFromISR(consumer, SPSC_RING_NOTIFY_INDEX, higher_priority_task_woken);
+	}
+
+	return length;
+}
+
+/**
+  * @brief  Reads the available data without blocking.
+  * @param  ring: The ring buffer to read
+  * @param  data: Buffer for the data
+  * @param  length: Size of the buffer in bytes
+  * @retval Number of bytes read, 0 if the ring buffer is empty
+  */
+uint32_t spsc_ring_read(spsc_ring_t *ring, void *data, uint32_t length)
+{
+	uint32_t head;
+	uint32_t tail;
+	uint32_t offset;
+	uint32_t first;
+
+	configASSERT(ring);
+	configASSERT(data);
+
+	head = ring->head;
+
+	/* The data behind the head must not be read before the head itself. */
+	__DMB();
+
+	tail = ring->tail;
+	if (length > head - tail) {
+		length = head - tail;
+	}
+
+	offset = tail & (ring->size - 1U);
+	first  = ring->size - offset;
+	if (first > length) {
+		first = length;
+	}
+
+	memcpy(data, &ring->storage[offset], first);
+	memcpy((uint8_t *)data + first, ring->storage, length - first);
+
+	/* The data must have been copied before the space is handed back to the
+	producer. */
+	__DMB();
+
+	ring->tail = tail + length;
+
+	return length;
+}
+
+/**
+  * @brief  Reads data, waiting for it if the ring buffer is empty.
+  * @note   Only the consumer set with spsc_ring_set_consumer() may wait.
+  * @param  ring: The ring buffer to read
+  * @param  data: Buffer for the data
+  * @param  length: Size of the buffer in bytes
+  * @param  ticks_to_wait: Maximum time to wait for the first byte
+  * @retval Number of bytes read, 0 if nothing arrived in time
+  */
+uint32_t spsc_ring_receive(spsc_ring_t *ring, void *data, uint32_t length, TickType_t ticks_to_wait)
+{
+	TimeOut_t timeout;
+	uint32_t read;
+
+	configASSERT(ring);
+	configASSERT((ticks_to_wait == 0) || (ring->consumer == xTaskGetCurrentTaskHandle()));
+
+	vTaskSetTimeOutState(&timeout);
+
+	for (;;) {
+		/* Orders the last tail store against the head load in
+		spsc_ring_read(), the producer does the same the other way round. */
+		__DMB();
+
+		read = spsc_ring_read(ring, data, length);
+		if ((read > 0) || (length == 0)) {
+			break;
+		}
+
+		if (xTaskCheckForTimeOut(&timeout, &ticks_to_wait) != pdFALSE) {
+			break;
+		}
+
+		/* A notification given after the ring buffer was found empty is
+		still pending, so this returns at once in that case. */
+		ulTaskNotifyTakeIndexed(SPSC_RING_NOTIFY_INDEX, pdTRUE, ticks_to_wait);
+	}
+
+	return read;
+}
+
+/**
+  * @brief  Returns the number of bytes waiting to be read.
+  * @param  ring: The ring buffer to query
+  * @retval Number of bytes in the ring buffer
+  */
+uint32_t spsc_ring_get_used(const spsc_ring_t *ring)
+{
+	configASSERT(ring);
+
+	return ring->head - ring->tail;
+}
+
+/**
+  * @brief  Returns the number of bytes that can be written.
+  * @param  ring: The ring buffer to query
+  * @retval Number of free bytes in the ring buffer
+  */
+uint32_t spsc_ring_get_free(const spsc_ring_t *ring)
+{
+	configASSERT(ring);
+
+	return ring->size - (ring->head - ring->tail);
+}
+
+/**
+  * @brief  Returns the number of bytes dropped because the ring buffer was
+  *         full.
+  * @param  ring: The ring buffer to query
+  * @retval Number of dropped bytes since the ring buffer was initialized
+  */
+uint32_t spsc_ring_get_dropped(const spsc_ring_t *ring)
+{
+	configASSERT(ring);
+
+	return ring->dropped;
+}
+
+static uint32_t spsc_ring_put(spsc_ring_t *ring, const uint8_t *data, uint32_t length, bool *was_empty)
+{
+	uint32_t head;
+	uint32_t space;
+	uint32_t offset;
+	uint32_t first;
+
+	configASSERT(ring);
+	configASSERT(data);
+
+	head  = ring->head;
+	space = ring->size - (head - ring->tail);
+	if (length > space) {
+		ring->dropped += length - space;
+		length = space;
+	}
+
+	offset = head & (ring->size - 1U);
+	first  = ring->size - offset;
+	if (first > length) {
+		first = length;
+	}
+
+	memcpy(&ring->storage[offset], data, first);
+	memcpy(ring->storage, data + first, length - first);
+
+	/* The data must be visible before the head that publishes it. */
+	__DMB();
+
+	ring->head = head + length;
+
+	/* Loading the tail after the head was stored, if the consumer had taken
+	everything up to the old head it may be waiting for this data. */
+	__DMB();
+
+	*was_empty = (length > 0) && (ring->tail == head);
+
+	return length;
+}
@@ -0,0 +1,299 @@
+/**
+  ******************************************************************************
+  * @file    stdio_uart.c
+  * @brief   newlib stdio on the console UART.
+  *
+  *          _write() puts the output of stdout and stderr into a line
+  *          buffer of the calling task, and a complete line, or a full
+  *          buffer, is sent with cli_io_print(): as one DMA transfer under
+  *          the mutex of the console UART, so the lines of different tasks
+  *          and the console output are not mixed.  '\n' is sent as "\r\n".
+  *
+  *          With configUSE_NEWLIB_REENTRANT every task has its own newlib
+  *          reentrancy structure, and with it its own errno and stdio
+  *          streams, so the FILE objects need no locking either.  Whatever
+  *          buffering newlib does on top, a line is complete in the line
+  *          buffer before it is sent.
+  *
+  *          The line buffers come from a fixed pool, a task takes one with
+  *          its first output and keeps it in a thread local storage pointer
+  *          until it is deleted.  A partial line stays in the buffer until
+  *          the line is completed or stdio_uart_flush() is called.
+  *
+  *          Output written from an interrupt, with the scheduler suspended
+  *          or, in the MPU build, from an unprivileged task is dropped and
+  *          counted, none of them may wait for the UART.  stdin is always at
+  *          its end, the console input belongs to the CLI task.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "stdio_uart.h"
+#include "cli_io.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stm32f4xx_hal.h"
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+typedef struct {
+	bool     in_use;
+	uint32_t used;
+	char     data[ STDIO_UART_LINE_SIZE ];
+} stdio_uart_line_t;
+
+typedef struct {
+	uint32_t          lines;        /* Blocks sent from the line buffers. */
+	uint32_t          bytes;
+	uint32_t          unbuffered;   /* Writes of tasks without a line buffer. */
+	volatile uint32_t dropped;      /* Bytes that could not be sent. */
+} stdio_uart_stats_t;
+
+int _write(int file, char *ptr, int len);
+int _read(int file, char *ptr, int len);
+
+static void stdio_uart_write(const char *data, size_t length);
+static void stdio_uart_write_unbuffered(const char *data, size_t length);
+static void stdio_uart_send(stdio_uart_line_t *line);
+static bool stdio_uart_can_wait(void);
+static void stdio_uart_count_dropped(size_t length);
+static stdio_uart_line_t *stdio_uart_line(void);
+
+/* Ordinary data, in the MPU build an unprivileged task counts its dropped
+output. */
+static stdio_uart_line_t stdio_uart_lines[ STDIO_UART_BUFFERS ];
+static stdio_uart_stats_t stdio_uart_stats;
+
+/**
+  * @brief  newlib output system call.
+  * @param  file: STDOUT_FILENO or STDERR_FILENO, there are no other files
+  * @param  ptr: the data
+  * @param  len: number of bytes
+  * @retval len, or -1 with errno set
+  */
+int _write(int file, char *ptr, int len)
+{
+	if ((file != STDOUT_FILENO) && (file != STDERR_FILENO)) {
+		errno = EBADF;
+		return -1;
+	}
+
+	if (len > 0) {
+		stdio_uart_write(ptr, (size_t)len);
+	}
+
+	return len;
+}
+
+/**
+  * @brief  newlib input system call.
+  * @param  file: STDIN_FILENO, there are no other files
+  * @param  ptr: not used
+  * @param  len: not used
+  * @retval 0, the end of the file, or -1 with errno set
+  */
+int _read(int file, char *ptr, int len)
+{
+	( void ) ptr;
+	( void ) len;
+
+	if (file != STDIN_FILENO) {
+		errno = EBADF;
+		return -1;
+	}
+
+	return 0;
+}
+
+/**
+  * @brief  Sends the partial line in the buffer of the calling task.
+  * @retval None
+  */
+void stdio_uart_flush(void)
+{
+	stdio_uart_line_t *line;
+
+	if (true == stdio_uart_can_wait()) {
+		line = pvTaskGetThreadLocalStoragePointer(NULL, configSTDIO_UART_TLS_INDEX);
+		if ((line != NULL) && (line->used > 0U)) {
+			stdio_uart_send(line);
+		}
+	}
+}
+
+/**
+  * @brief  Writes the output statistics into a buffer.
+  * @param  buffer: the output buffer
+  * @param  length: size of the buffer
+  * @retval None
+  */
+void stdio_uart_print(char *buffer, size_t length)
+{
+	uint32_t in_use = 0;
+	uint32_t i;
+
+	configASSERT(buffer);
+
+	for (i = 0; i < STDIO_UART_BUFFERS; i++) {
+		if (true == stdio_uart_lines[i].in_use) {
+			in_use++;
+		}
+	}
+
+	snprintf(buffer, length,
+		"\r\nLines: %lu, bytes: %lu, unbuffered writes: %lu, dropped: %lu bytes\r\n"
+		"Line buffers in use: %lu of %lu, %lu bytes each\r\n",
+		( unsigned long ) stdio_uart_stats.lines, ( unsigned long ) stdio_uart_stats.bytes,
+		( unsigned long ) stdio_uart_stats.unbuffered, ( unsigned long ) stdio_uart_stats.dropped,
+		( unsigned long ) in_use, ( unsigned long ) STDIO_UART_BUFFERS,
+		( unsigned long ) STDIO_UART_LINE_SIZE);
+}
+
+/**
+  * @brief  Returns the line buffer of a deleted task to the pool.
+  * @note   Called by the kernel in a critical section, a partial line is lost.
+  * @param  line: thread local storage pointer of the task
+  * @retval None
+  */
+void stdio_uart_task_deleted(void *line)
+{
+	if (line != NULL) {
+		((stdio_uart_line_t *)line)->in_use = false;
+	}
+}
+
+static void stdio_uart_write(const char *data, size_t length)
+{
+	stdio_uart_line_t *line;
+	size_t i;
+
+	if (false == stdio_uart_can_wait()) {
+		stdio_uart_count_dropped(length);
+		return;
+	}
+
+	/* Before the scheduler is started there is no task to buffer for, the
+	UART is written directly. */
+	line = NULL;
+	if (xTaskGetSchedulerState() == taskSCHEDULER_RUNNING) {
+		line = stdio_uart_line();
+	}
+
+	if (line == NULL) {
+		stdio_uart_write_unbuffered(data, length);
+		return;
+	}
+
+	/* After every character there is room for a "\r\n". */
+	for (i = 0; i < length; i++) {
+		if (data[i] == '\n') {
+			line->data[line->used++] = '\r';
+		}
+		line->data[line->used++] = data[i];
+
+		if ((data[i] == '\n') || (line->used >= STDIO_UART_LINE_SIZE - 1U)) {
+			stdio_uart_send(line);
+		}
+	}
+}
+
+static void stdio_uart_write_unbuffered(const char *data, size_t length)
+{
+	const char *newline;
+	size_t count;
+
+	stdio_uart_stats.unbuffered++;
+
+	while (length > 0U) {
+		newline = memchr(data, '\n', length);
+		count = (newline != NULL) ? (size_t)(newline - data) : length;
+
+		cli_io_print(data, count);
+		if (newline != NULL) {
+			cli_io_print("\r\n", 2U);
+			count++;
+		}
+
+		data += count;
+		length -= count;
+	}
+}
+
+static void stdio_uart_send(stdio_uart_line_t *line)
+{
+	cli_io_print(line->data, line->used);
+
+	stdio_uart_stats.lines++;
+	stdio_uart_stats.bytes += line->used;
+	line->used = 0U;
+}
+
+/**
+  * @brief  Tells if the caller may block on the console UART.
+  * @retval true from a task that may
+  */
+static bool stdio_uart_can_wait(void)
+{
+	if (xPortIsInsideInterrupt() == pdTRUE) {
+		return false;
+	}
+
+	/* In the MPU build the UART and the console state are privileged. */
+	if ((__get_CONTROL() & CONTROL_nPRIV_Msk) != 0U) {
+		return false;
+	}
+
+	return (xTaskGetSchedulerState() != taskSCHEDULER_SUSPENDED);
+}
+
+/**
+  * @brief  Adds to the dropped bytes from any context, an unprivileged task
+  *         cannot mask the interrupts.
+  * @param  length: number of bytes dropped
+  * @retval None
+  */
+static void stdio_uart_count_dropped(size_t length)
+{
+	uint32_t dropped;
+
+	do {
+		dropped = __LDREXW(&stdio_uart_stats.dropped);
+	} while (__STREXW(dropped + length, &stdio_uart_stats.dropped) != 0U);
+}
+
+/**
+  * @brief  Returns the line buffer of the calling task, takes one from the
+  *         pool with the first output of the task.
+  * @retval The line buffer, NULL if the pool is empty
+  */
+static stdio_uart_line_t *stdio_uart_line(void)
+{
+	stdio_uart_line_t *line;
+	uint32_t i;
+
+	line = pvTaskGetThreadLocalStoragePointer(NULL, configSTDIO_UART_TLS_INDEX);
+	if (line != NULL) {
+		return line;
+	}
+
+	taskENTER_CRITICAL();
+	for (i = 0; (i < STDIO_UART_BUFFERS) && (line == NULL); i++) {
+		if (false == stdio_uart_lines[i].in_use) {
+			line = &stdio_uart_lines[i];
+			line->in_use = true;
+			line->used = 0U;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	if (line != NULL) {
+		vTaskSetThreadLocalStoragePointer(NULL, configSTDIO_UART_TLS_INDEX, line);
+	}
+
+	return line;
+}
@@ -9,10 +9,29 @@
   */
 #include "main.h"
 #include "stm32f4xx_it.h"
-
-extern TIM_HandleTypeDef htim7;
-extern TIM_HandleTypeDef htim2;
-extern UART_HandleTypeDef h_uart_cli;
+#include "timebase.h"
+#include "hrtimer.h"
+#include "cli_io.h"
+#include "mpu_guard.h"
+#include "binlog.h"
+#include "crash_dump.h"
+
+/* Body of a naked fault handler: passes the exception frame of the faulting
+code, EXC_RETURN and R4-R11 to crash_dump_fault(), which does not return. */
+#define FAULT_TO_CRASH_DUMP(reason)       \
+	__asm volatile                        \
+	(                                     \
+		"	tst lr, #4				\n"    \
+		"	ite eq					\n"    \
+		"	mrseq r0, msp			\n"    \
+		"	mrsne r0, psp			\n"    \
+		"	mov r1, lr				\n"    \
+		"	push {r4-r11}			\n"    \
+		"	mov r2, sp				\n"    \
+		"	movs r3, %0				\n"    \
+		"	b crash_dump_fault		\n"    \
+		:: "i" ( reason )                 \
+	)
 
 /******************************************************************************/
 /*           Cortex-M4 Processor Interruption and Exception Handlers          */
@@ -30,42 +49,50 @@ void NMI_Handler(void)
 
 /**
   * @brief This function handles Hard fault interrupt.
+  * @note  Also reached by the UDF traps of configASSERT() and the stack
+  *        overflow hook, see crash_dump.c.
   */
-void HardFault_Handler(void)
+__attribute__((naked)) void HardFault_Handler(void)
 {
-	while (1)
-	{
-	}
+	FAULT_TO_CRASH_DUMP(CRASH_DUMP_HARD_FAULT);
 }
 
 /**
   * @brief This function handles Memory management fault.
+  * @note  Passes the exception frame of the faulting code, EXC_RETURN and
+  *        R4-R11 to mpu_guard_memmanage, which returns from the exception
+  *        or writes the crash record.  R3 keeps the stack 8 byte aligned.
   */
-void MemManage_Handler(void)
+__attribute__((naked)) void MemManage_Handler(void)
 {
-	while (1)
-	{
-	}
+	__asm volatile
+	(
+		"	tst lr, #4					\n"
+		"	ite eq						\n"
+		"	mrseq r0, msp				\n"
+		"	mrsne r0, psp				\n"
+		"	mov r1, lr					\n"
+		"	push {r3-r11, lr}			\n"
+		"	add r2, sp, #4				\n"
+		"	bl mpu_guard_memmanage		\n"
+		"	pop {r3-r11, pc}			\n"
+	);
 }
 
 /**
   * @brief This function handles Pre-fetch fault, memory access fault.
   */
-void BusFault_Handler(void)
+__attribute__((naked)) void BusFault_Handler(void)
 {
-	while (1)
-	{
-	}
+	FAULT_TO_CRASH_DUMP(CRASH_DUMP_BUS_FAULT);
 }
 
 /**
   * @brief This function handles Undefined instruction or illegal state.
   */
-void UsageFault_Handler(void)
+__attribute__((naked)) void UsageFault_Handler(void)
 {
-	while (1)
-	{
-	}
+	FAULT_TO_CRASH_DUMP(CRASH_DUMP_USAGE_FAULT);
 }
 
 /**
@@ -96,23 +123,33 @@ void EXTI0_IRQHandler(void)
   */
 void USART2_IRQHandler(void)
 {
-	HAL_UART_IRQHandler(&h_uart_cli);
+	cli_io_uart_irq_handler();
+}
+
+/**
+  * @brief This function handles DMA1 stream6 global interrupt (USART2 TX).
+  */
+void DMA1_Stream6_IRQHandler(void)
+{
+	cli_io_dma_irq_handler();
 }
 
 /**
-  * @brief This function handles TIM7 global interrupt.
+  * @brief This function handles USART6 global interrupt.
   */
-void TIM7_IRQHandler(void)
+void USART6_IRQHandler(void)
 {
-	HAL_TIM_IRQHandler(&htim7);
+	binlog_uart_irq_handler();
 }
 
 /**
-  * @brief This function handles TIM2 global interrupt.
+  * @brief This function handles TIM2 global interrupt (system timebase on
+  *        channel 1, high resolution timers on channel 2).
   */
 void TIM2_IRQHandler(void)
 {
-	HAL_TIM_IRQHandler(&htim2);
+	timebase_irq_handler();
+	hrtimer_irq_handler();
 }
 
 
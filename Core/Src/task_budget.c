@@ -0,0 +1,469 @@
+/**
+  ******************************************************************************
+  * @file    task_budget.c
+  * @brief   Per task CPU cycle budgets.
+  *
+  *          A task with a budget may use at most budget_us of CPU time in
+  *          every period_ms long window.  The time is measured with the DWT
+  *          cycle counter: traceTASK_SWITCHED_OUT charges the cycles since
+  *          the task was switched in, and the tick hook charges the running
+  *          task as well, so a task that is never switched out (the only
+  *          ready task at the highest priority) is still caught within one
+  *          tick.  Interrupts are charged to the task they interrupted, the
+  *          same way the run time stats do.
+  *
+  *          The budget of a task is found through a thread local storage
+  *          pointer, so the context switch costs two cycle counter reads and
+  *          no search.  The hooks only account and flag an overrun, the
+  *          policy is applied by the supervisor task, because the kernel
+  *          API can not be used from inside the context switch:
+  *          - log:     the overrun is counted and shown by the CLI
+  *          - demote:  the task drops to TASK_BUDGET_DEMOTED_PRIORITY
+  *          - suspend: the task is suspended
+  *          A demoted or suspended task gets its priority back, or is
+  *          resumed, when the period in which it overran ends.  The policies
+  *          assume nothing else changes the priority of the task or suspends
+  *          it at the same time.  In the MPU build the supervisor task is
+  *          restricted to its stack and to the budget records.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "task_budget.h"
+#include "cycle_counter.h"
+#include "mpu_guard.h"
+
+#include <stdio.h>
+#include <string.h>
+
+typedef enum {
+	TASK_BUDGET_STATE_OK = 0,
+	TASK_BUDGET_STATE_DEMOTED,
+	TASK_BUDGET_STATE_SUSPENDED
+} task_budget_state_t;
+
+typedef struct {
+	TaskHandle_t          task;         /* NULL if the record is free. */
+	uint32_t              budget_us;
+	uint32_t              budget_cycles;
+	TickType_t            period;
+	task_budget_policy_t  policy;
+
+	/* Accounting, updated by the context switch and tick hooks. */
+	TickType_t            window_start;
+	uint32_t              used;
+	uint32_t              peak;
+	uint32_t              overruns;
+	bool                  overrun_in_window;
+	bool                  action_pending;
+	TickType_t            overrun_window;
+
+	/* Enforcement, owned by the supervisor task. */
+	task_budget_state_t   state;
+	UBaseType_t           saved_priority;
+} task_budget_t;
+
+typedef task_budget_t task_budget_records_t[ TASK_BUDGET_MAX_TASKS ];
+
+static MPU_GUARD_REGION(task_budget_records_t) task_budgets;
+static TaskHandle_t task_budget_task_handle = NULL;
+static MPU_GUARD_STACK(task_budget_stack, TASK_BUDGET_TASK_STACK_SIZE);
+static StaticTask_t task_budget_tcb;
+
+/* Cycle counter value when the running task was switched in or last charged
+by the tick hook. */
+static uint32_t task_budget_switch_time;
+static volatile bool task_budget_action_pending;
+
+static void task_budget_task(void *params);
+static void task_budget_charge(task_budget_t *budget, uint32_t cycles);
+static void task_budget_enforce(task_budget_t *budget);
+static void task_budget_restore(task_budget_t *budget);
+
+static const char * const task_budget_policy_names[] = { "log", "demote", "suspend" };
+static const char * const task_budget_state_names[]  = { "ok", "demoted", "suspended" };
+
+/**
+  * @brief  Starts the cycle counter and creates the supervisor task.
+  * @note   Must be called before the scheduler is started.
+  * @param  None
+  * @retval None
+  */
+void task_budget_init(void)
+{
+	const MemoryRegion_t regions[ portNUM_CONFIGURABLE_REGIONS ] = {
+		{ &task_budgets, sizeof(task_budgets), MPU_GUARD_READ_WRITE }
+	};
+
+	cycle_counter_init();
+	task_budget_switch_time = cycle_counter_get();
+
+	task_budget_task_handle = mpu_guard_create_task(task_budget_task,	/* The task that applies the overrun policies. */
+					   "Budget",					/* Text name assigned to the task.  This is just to assist debugging. */
+					   TASK_BUDGET_TASK_STACK_SIZE,	/* The size of the stack allocated to the task. */
+					   NULL,						/* The parameter is not used, so NULL is passed. */
+					   TASK_BUDGET_TASK_PRIORITY,	/* The priority allocated to the task. */
+					   task_budget_stack,			/* Array to use as the task's stack. */
+					   &task_budget_tcb,			/* Variable to hold the task's data structure. */
+					   regions);					/* The budget records. */
+	configASSERT( task_budget_task_handle != NULL );
+}
+
+/**
+  * @brief  Sets or changes the CPU budget of a task.
+  * @note   Changing the budget starts a new window.  A task that is demoted
+  *         or suspended stays so until the end of the window it overran.
+  *         The supervisor task itself can not have a budget.
+  * @param  task: The task, NULL for the calling task
+  * @param  budget_us: CPU time the task may use in a period
+  * @param  period_ms: Length of the period, at most TASK_BUDGET_MAX_PERIOD_MS
+  * @param  policy: What to do when the task uses more than its budget
+  * @retval true if the budget was set, false if the parameters are invalid
+  *         or there are already TASK_BUDGET_MAX_TASKS budgets
+  */
+bool task_budget_attach(TaskHandle_t task, uint32_t budget_us, uint32_t period_ms, task_budget_policy_t policy)
+{
+	task_budget_t *budget;
+	uint32_t i;
+	bool retv = false;
+
+	if (task == NULL) {
+		task = xTaskGetCurrentTaskHandle();
+	}
+
+	if ((period_ms == 0) || (period_ms > TASK_BUDGET_MAX_PERIOD_MS) ||
+		(budget_us == 0) || (budget_us > period_ms * 1000UL) ||
+		(policy > TASK_BUDGET_POLICY_SUSPEND) || (task == task_budget_task_handle)) {
+		return false;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		budget = pvTaskGetThreadLocalStoragePointer(task, configTASK_BUDGET_TLS_INDEX);
+
+		for (i = 0; (budget == NULL) && (i < TASK_BUDGET_MAX_TASKS); i++) {
+			if (task_budgets.data[i].task == NULL) {
+				budget = &task_budgets.data[i];
+				budget->state = TASK_BUDGET_STATE_OK;
+			}
+		}
+
+		if (budget != NULL) {
+			budget->task              = task;
+			budget->budget_us         = budget_us;
+			budget->budget_cycles     = budget_us * (SystemCoreClock / 1000000UL);
+			budget->period            = pdMS_TO_TICKS(period_ms) > 0 ? pdMS_TO_TICKS(period_ms) : 1;
+			budget->policy            = policy;
+			budget->window_start      = xTaskGetTickCount();
+			budget->used              = 0;
+			budget->peak              = 0;
+			budget->overruns          = 0;
+			budget->overrun_in_window = false;
+			budget->action_pending    = false;
+
+			vTaskSetThreadLocalStoragePointer(task, configTASK_BUDGET_TLS_INDEX, budget);
+			retv = true;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return retv;
+}
+
+/**
+  * @brief  Removes the CPU budget of a task.
+  * @note   A demoted or suspended task is restored at once.
+  * @param  task: The task, NULL for the calling task
+  * @retval None
+  */
+void task_budget_detach(TaskHandle_t task)
+{
+	task_budget_t *budget;
+
+	if (task == NULL) {
+		task = xTaskGetCurrentTaskHandle();
+	}
+
+	vTaskSuspendAll();
+	{
+		budget = pvTaskGetThreadLocalStoragePointer(task, configTASK_BUDGET_TLS_INDEX);
+		if (budget != NULL) {
+			task_budget_restore(budget);
+
+			taskENTER_CRITICAL();
+			{
+				vTaskSetThreadLocalStoragePointer(task, configTASK_BUDGET_TLS_INDEX, NULL);
+				budget->task = NULL;
+			}
+			taskEXIT_CRITICAL();
+		}
+	}
+	( void ) xTaskResumeAll();
+}
+
+/**
+  * @brief  Converts the budgets to CPU cycles of the new system clock.
+  * @note   Called after SystemCoreClock has changed.  The cycles already used
+  *         in the current window are kept, so the window of the change is
+  *         checked against a mix of the two clocks.
+  * @retval None
+  */
+void task_budget_clock_changed(void)
+{
+	uint32_t i;
+
+	taskENTER_CRITICAL();
+	{
+		for (i = 0; i < TASK_BUDGET_MAX_TASKS; i++) {
+			if (task_budgets.data[i].task != NULL) {
+				task_budgets.data[i].budget_cycles = task_budgets.data[i].budget_us * (SystemCoreClock / 1000000UL);
+			}
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+
+/**
+  * @brief  Prints the budget consumption of the tasks that have a budget.
+  * @param  buffer: Output buffer for the table
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void task_budget_print(char *buffer, size_t length)
+{
+	task_budget_t budget;
+	char name[ configMAX_TASK_NAME_LEN ];
+	TickType_t now;
+	uint32_t cycles_per_us;
+	size_t written;
+	uint32_t i;
+
+	configASSERT(buffer);
+
+	cycles_per_us = SystemCoreClock / 1000000UL;
+
+	written = snprintf(buffer, length,
+		"\r\nTask            Budget[us]  Period[ms]  Policy   Used[us]  Peak[us]  Overruns  State\r\n");
+
+	for (i = 0; (i < TASK_BUDGET_MAX_TASKS) && (written < length); i++) {
+		taskENTER_CRITICAL();
+		{
+			budget = task_budgets.data[i];
+			now = xTaskGetTickCount();
+
+			/* The task can not be deleted while its name is copied. */
+			if (budget.task != NULL) {
+				strncpy(name, pcTaskGetName(budget.task), sizeof(name) - 1);
+				name[sizeof(name) - 1] = '\0';
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if (budget.task == NULL) {
+			continue;
+		}
+
+		/* The window is only moved on when the task runs. */
+		if ((TickType_t)(now - budget.window_start) >= budget.period) {
+			budget.used = 0;
+		}
+
+		written += snprintf(buffer + written, length - written, "%-16s%10lu  %10lu  %-7s  %8lu  %8lu  %8lu  %s\r\n",
+			name,
+			( unsigned long ) budget.budget_us,
+			( unsigned long ) (budget.period * portTICK_PERIOD_MS),
+			task_budget_policy_names[budget.policy],
+			( unsigned long ) (budget.used / cycles_per_us),
+			( unsigned long ) (budget.peak / cycles_per_us),
+			( unsigned long ) budget.overruns,
+			task_budget_state_names[budget.state]);
+	}
+}
+
+/**
+  * @brief  Starts timing the task that is switched in.
+  * @note   Called from traceTASK_SWITCHED_IN.
+  * @param  None
+  * @retval None
+  */
+void task_budget_switched_in(void)
+{
+	task_budget_switch_time = cycle_counter_get();
+}
+
+/**
+  * @brief  Charges the task that is switched out.
+  * @note   Called from traceTASK_SWITCHED_OUT.
+  * @param  budget: Thread local storage pointer of the task
+  * @retval None
+  */
+void task_budget_switched_out(void *budget)
+{
+	if (budget != NULL) {
+		task_budget_charge(budget, cycle_counter_get() - task_budget_switch_time);
+	}
+}
+
+/**
+  * @brief  Frees the budget of a task that is deleted.
+  * @note   Called from traceTASK_DELETE, inside a critical section.
+  * @param  budget: Thread local storage pointer of the task
+  * @retval None
+  */
+void task_budget_task_deleted(void *budget)
+{
+	if (budget != NULL) {
+		((task_budget_t *)budget)->task = NULL;
+	}
+}
+
+/**
+  * @brief  Charges the running task and wakes the supervisor task if an
+  *         overrun has to be handled.
+  * @note   Called from the tick hook.
+  * @param  None
+  * @retval None
+  */
+void task_budget_tick_hook(void)
+{
+	task_budget_t *budget;
+	uint32_t now;
+
+	now = cycle_counter_get();
+
+	budget = pvTaskGetThreadLocalStoragePointer(NULL, configTASK_BUDGET_TLS_INDEX);
+	if (budget != NULL) {
+		task_budget_charge(budget, now - task_budget_switch_time);
+	}
+	task_budget_switch_time = now;
+
+	if ((true == task_budget_action_pending) && (task_budget_task_handle != NULL)) {
+		task_budget_action_pending = false;
+
+		/* Without a pxHigherPriorityTaskWoken the kernel requests the
+		context switch at the end of the tick itself. */
+		vTaskNotifyGiveFromISR(task_budget_task_handle, NULL);
+	}
+}
+
+static void task_budget_task(void *params)
+{
+	TickType_t wait = portMAX_DELAY;
+	TickType_t elapsed;
+	TickType_t now;
+	task_budget_t *budget;
+	uint32_t i;
+
+	( void ) params;
+
+	for (;;) {
+		ulTaskNotifyTake(pdTRUE, wait);
+
+		wait = portMAX_DELAY;
+
+		for (i = 0; i < TASK_BUDGET_MAX_TASKS; i++) {
+			budget = &task_budgets.data[i];
+
+			/* No other task runs, so the supervised task can not be
+			deleted in the meantime. */
+			vTaskSuspendAll();
+			{
+				if (budget->task != NULL) {
+					now = xTaskGetTickCount();
+
+					/* The window in which the task overran has ended. */
+					if ((budget->state != TASK_BUDGET_STATE_OK) &&
+						((TickType_t)(now - budget->overrun_window) >= budget->period)) {
+						task_budget_restore(budget);
+					}
+
+					task_budget_enforce(budget);
+
+					if (budget->state != TASK_BUDGET_STATE_OK) {
+						elapsed = now - budget->overrun_window;
+						if (elapsed >= budget->period) {
+							wait = 0;
+						} else if (budget->period - elapsed < wait) {
+							wait = budget->period - elapsed;
+						}
+					}
+				}
+			}
+			( void ) xTaskResumeAll();
+		}
+	}
+}
+
+static void task_budget_charge(task_budget_t *budget, uint32_t cycles)
+{
+	TickType_t now = xTaskGetTickCountFromISR();
+	TickType_t elapsed = now - budget->window_start;
+
+	if (elapsed >= budget->period) {
+		budget->window_start      = now - (elapsed % budget->period);
+		budget->used              = 0;
+		budget->overrun_in_window = false;
+	}
+
+	budget->used += cycles;
+	if (budget->used > budget->peak) {
+		budget->peak = budget->used;
+	}
+
+	if ((budget->used > budget->budget_cycles) && (true != budget->overrun_in_window)) {
+		budget->overrun_in_window = true;
+		budget->overruns++;
+
+		if (budget->policy != TASK_BUDGET_POLICY_LOG) {
+			budget->overrun_window     = budget->window_start;
+			budget->action_pending     = true;
+			task_budget_action_pending = true;
+		}
+	}
+}
+
+static void task_budget_enforce(task_budget_t *budget)
+{
+	bool pending;
+
+	taskENTER_CRITICAL();
+	{
+		pending = budget->action_pending;
+		budget->action_pending = false;
+	}
+	taskEXIT_CRITICAL();
+
+	if ((true != pending) || (budget->state != TASK_BUDGET_STATE_OK)) {
+		return;
+	}
+
+	switch (budget->policy) {
+	case TASK_BUDGET_POLICY_DEMOTE:
+		budget->saved_priority = uxTaskPriorityGet(budget->task);
+		if (budget->saved_priority > TASK_BUDGET_DEMOTED_PRIORITY) {
+			vTaskPrioritySet(budget->task, TASK_BUDGET_DEMOTED_PRIORITY);
+			budget->state = TASK_BUDGET_STATE_DEMOTED;
+		}
+		break;
+
+	case TASK_BUDGET_POLICY_SUSPEND:
+		vTaskSuspend(budget->task);
+		budget->state = TASK_BUDGET_STATE_SUSPENDED;
+		break;
+
+	default:
+		break;
+	}
+}
+
+static void task_budget_restore(task_budget_t *budget)
+{
+	if (budget->state == TASK_BUDGET_STATE_SUSPENDED) {
+		vTaskResume(budget->task);
+	} else if (budget->state == TASK_BUDGET_STATE_DEMOTED) {
+		vTaskPrioritySet(budget->task, budget->saved_priority);
+	}
+
+	budget->state = TASK_BUDGET_STATE_OK;
+}
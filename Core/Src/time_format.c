@@ -0,0 +1,572 @@
+/**
+  ******************************************************************************
+  * @file    time_format.c
+  * @brief   Time formatting and parsing without snprintf() or allocation.
+  *
+  *          A pattern with strftime() like conversions (see time_format.h)
+  *          is compiled once into a table of items, each a literal
+  *          character or a conversion, which time_format_us() and
+  *          time_format_parse() walk.  The properties of a conversion, its
+  *          length and the digits it reads, come from time_format_fields,
+  *          indexed by the item.
+  *
+  *          Formatting writes two digits at a time from a table and checks
+  *          the buffer once against the longest text of the format.  The
+  *          date is only converted when the day changed since the previous
+  *          call, a stream of log timestamps needs one 64 bit division each
+  *          and 32 bit arithmetic for the rest.  Times are formatted up to
+  *          2106, when the seconds since 1970 overflow 32 bits.
+  *
+  *          Parsing overwrites the fields that the text gives and keeps the
+  *          others, then validates the result.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "time_format.h"
+#include "FreeRTOS.h"
+
+#include <string.h>
+
+/* The items, the field is the index into time_format_fields plus 1. */
+typedef enum {
+	TIME_FORMAT_FIELD_LITERAL = 0,
+	TIME_FORMAT_FIELD_YEAR,
+	TIME_FORMAT_FIELD_YEAR_2,
+	TIME_FORMAT_FIELD_MONTH,
+	TIME_FORMAT_FIELD_MONTH_NAME,
+	TIME_FORMAT_FIELD_DAY,
+	TIME_FORMAT_FIELD_DAY_SPACE,
+	TIME_FORMAT_FIELD_WEEKDAY_NAME,
+	TIME_FORMAT_FIELD_HOURS,
+	TIME_FORMAT_FIELD_MINUTES,
+	TIME_FORMAT_FIELD_SECONDS,
+	TIME_FORMAT_FIELD_MILLISECONDS,
+	TIME_FORMAT_FIELD_MICROSECONDS,
+	TIME_FORMAT_FIELD_EPOCH,
+	TIME_FORMAT_FIELD_TZ_OFFSET
+} time_format_field_t;
+
+static const struct {
+	char    specifier;
+	uint8_t length;         /* The most characters written or read. */
+	uint8_t min_digits;     /* The least digits read, 0 if not a number. */
+} time_format_fields[] = {
+	{ 'Y', 4,  4 },
+	{ 'y', 2,  2 },
+	{ 'm', 2,  2 },
+	{ 'b', 3,  0 },
+	{ 'd', 2,  2 },
+	{ 'e', 2,  1 },
+	{ 'a', 3,  0 },
+	{ 'H', 2,  2 },
+	{ 'M', 2,  2 },
+	{ 'S', 2,  2 },
+	{ 'L', 3,  1 },
+	{ 'f', 6,  1 },
+	{ 's', 10, 1 },
+	{ 'z', 6,  0 },
+};
+
+#define TIME_FORMAT_FIELDS              ( sizeof(time_format_fields) / sizeof(time_format_fields[0]) )
+
+/* Limit of the offset from UTC, in minutes. */
+#define TIME_FORMAT_MAX_TZ_OFFSET       ( 23 * 60 + 59 )
+
+#define TIME_FORMAT_SECONDS_PER_DAY     86400UL
+
+static const char time_format_pairs[] =
+	"00010203040506070809" "10111213141516171819" "20212223242526272829" "30313233343536373839"
+	"40414243444546474849" "50515253545556575859" "60616263646566676869" "70717273747576777879"
+	"80818283848586878889" "90919293949596979899";
+
+static const char time_format_months[] = "JanFebMarAprMayJunJulAugSepOctNovDec";
+static const char time_format_weekdays[] = "MonTueWedThuFriSatSun";
+
+static const uint32_t time_format_powers[] = {
+	1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL
+};
+
+static uint64_t time_format_local_us(uint64_t epoch_us, int32_t tz_offset_min);
+static char *time_format_digits(char *out, uint32_t value, uint32_t count);
+static char *time_format_number(char *out, uint32_t value);
+static char *time_format_offset(char *out, int32_t tz_offset_min);
+static size_t time_format_read_digits(const char *text, size_t length, uint32_t max_digits, uint32_t *value);
+static size_t time_format_read_offset(const char *text, size_t length, int32_t *tz_offset_min);
+static int32_t time_format_read_name(const char *text, size_t length, const char *names, uint32_t count);
+
+/**
+  * @brief  Compiles a pattern.
+  * @param  format: the compiled format
+  * @param  pattern: the pattern, see time_format.h
+  * @param  tz_offset_min: offset of the local time from UTC in minutes,
+  *         the fields are formatted in the local time
+  * @retval false if the pattern has an unknown conversion or too many
+  *         items, or the offset is out of range
+  */
+bool time_format_compile(time_format_t *format, const char *pattern, int32_t tz_offset_min)
+{
+	time_format_item_t *item;
+	uint32_t field;
+
+	configASSERT(format);
+	configASSERT(pattern);
+
+	if ((tz_offset_min > TIME_FORMAT_MAX_TZ_OFFSET) || (tz_offset_min < -TIME_FORMAT_MAX_TZ_OFFSET)) {
+		return false;
+	}
+
+	format->count         = 0;
+	format->max_length    = 0;
+	format->tz_offset_min = (int16_t)tz_offset_min;
+	format->cached_day    = 0;
+
+	while (*pattern != '\0') {
+		if (format->count >= TIME_FORMAT_MAX_ITEMS) {
+			return false;
+		}
+
+		item = &format->items[format->count];
+		item->field   = TIME_FORMAT_FIELD_LITERAL;
+		item->literal = *pattern;
+
+		if ((pattern[0] == '%') && (pattern[1] == '%')) {
+			pattern++;
+		} else if (pattern[0] == '%') {
+			pattern++;
+			for (field = 0; (field < TIME_FORMAT_FIELDS) && (time_format_fields[field].specifier != *pattern); field++) {
+			}
+
+			if ((field == TIME_FORMAT_FIELDS) || (*pattern == '\0')) {
+				return false;
+			}
+
+			item->field = (uint8_t)(field + 1U);
+			format->max_length += (uint16_t)(time_format_fields[field].length - 1U);
+		}
+
+		format->max_length++;
+		format->count++;
+		pattern++;
+	}
+
+	return true;
+}
+
+/**
+  * @brief  Formats a time.
+  * @param  format: the compiled format, which caches the date
+  * @param  epoch_us: Microseconds since 1970-01-01 00:00:00 UTC
+  * @param  buffer: the output buffer, the text is terminated
+  * @param  length: size of the buffer, which must hold the longest text of
+  *         the format
+  * @retval Length of the text, 0 if the buffer is too small
+  */
+size_t time_format_us(time_format_t *format, uint64_t epoch_us, char *buffer, size_t length)
+{
+	const time_format_item_t *item;
+	const time_format_item_t *end;
+	uint64_t local_us;
+	uint32_t seconds;
+	uint32_t microseconds;
+	uint32_t day;
+	uint32_t of_day;
+	char *out = buffer;
+
+	configASSERT(format);
+	configASSERT(buffer);
+
+	if (length <= format->max_length) {
+		if (length > 0U) {
+			buffer[0] = '\0';
+		}
+		return 0;
+	}
+
+	local_us     = time_format_local_us(epoch_us, format->tz_offset_min);
+	seconds      = (uint32_t)(local_us / TIMEKEEPING_US_PER_SECOND);
+	microseconds = (uint32_t)(local_us - (uint64_t)seconds * TIMEKEEPING_US_PER_SECOND);
+	day          = seconds / TIME_FORMAT_SECONDS_PER_DAY;
+	of_day       = seconds - day * TIME_FORMAT_SECONDS_PER_DAY;
+
+	if (format->cached_day != day + 1U) {
+		timekeeping_to_calendar((uint64_t)day * TIME_FORMAT_SECONDS_PER_DAY * TIMEKEEPING_US_PER_SECOND, &format->cached);
+		format->cached_day = day + 1U;
+	}
+
+	end = &format->items[format->count];
+	for (item = format->items; item < end; item++) {
+		switch (item->field) {
+		case TIME_FORMAT_FIELD_LITERAL:
+			*out++ = item->literal;
+			break;
+		case TIME_FORMAT_FIELD_YEAR:
+			out = time_format_digits(out, format->cached.year, 4U);
+			break;
+		case TIME_FORMAT_FIELD_YEAR_2:
+			out = time_format_digits(out, format->cached.year % 100U, 2U);
+			break;
+		case TIME_FORMAT_FIELD_MONTH:
+			out = time_format_digits(out, format->cached.month, 2U);
+			break;
+		case TIME_FORMAT_FIELD_MONTH_NAME:
+			memcpy(out, &time_format_months[(format->cached.month - 1U) * 3U], 3U);
+			out += 3;
+			break;
+		case TIME_FORMAT_FIELD_DAY:
+			out = time_format_digits(out, format->cached.day, 2U);
+			break;
+		case TIME_FORMAT_FIELD_DAY_SPACE:
+			out = time_format_digits(out, format->cached.day, 2U);
+			if (out[-2] == '0') {
+				out[-2] = ' ';
+			}
+			break;
+		case TIME_FORMAT_FIELD_WEEKDAY_NAME:
+			memcpy(out, &time_format_weekdays[(format->cached.weekday - 1U) * 3U], 3U);
+			out += 3;
+			break;
+		case TIME_FORMAT_FIELD_HOURS:
+			out = time_format_digits(out, of_day / 3600U, 2U);
+			break;
+		case TIME_FORMAT_FIELD_MINUTES:
+			out = time_format_digits(out, (of_day / 60U) % 60U, 2U);
+			break;
+		case TIME_FORMAT_FIELD_SECONDS:
+			out = time_format_digits(out, of_day % 60U, 2U);
+			break;
+		case TIME_FORMAT_FIELD_MILLISECONDS:
+			out = time_format_digits(out, microseconds / 1000U, 3U);
+			break;
+		case TIME_FORMAT_FIELD_MICROSECONDS:
+			out = time_format_digits(out, microseconds, 6U);
+			break;
+		case TIME_FORMAT_FIELD_EPOCH:
+			out = time_format_number(out, (uint32_t)(epoch_us / TIMEKEEPING_US_PER_SECOND));
+			break;
+		case TIME_FORMAT_FIELD_TZ_OFFSET:
+			out = time_format_offset(out, format->tz_offset_min);
+			break;
+		default:
+			break;
+		}
+	}
+
+	*out = '\0';
+
+	return (size_t)(out - buffer);
+}
+
+/**
+  * @brief  Parses a time.
+  * @param  format: the compiled format
+  * @param  text: the text, which need not be terminated
+  * @param  length: length of the text, which must match the whole format
+  * @param  calendar: the fields not in the format are kept, the weekday is
+  *         set from the date, the calendar is only changed on success
+  * @param  tz_offset_min: the offset of %z, or the one of the format, may
+  *         be NULL.  %s sets the whole calendar in UTC and the offset to 0.
+  * @retval false if the text does not match or a field is out of range
+  */
+bool time_format_parse(const time_format_t *format, const char *text, size_t length,
+					   timekeeping_calendar_t *calendar, int32_t *tz_offset_min)
+{
+	const time_format_item_t *item;
+	timekeeping_calendar_t parsed;
+	uint64_t epoch_us;
+	int32_t offset = format->tz_offset_min;
+	int32_t name;
+	uint32_t value = 0;
+	size_t read;
+	size_t pos = 0;
+	uint32_t i;
+	bool fraction;
+
+	configASSERT(format);
+	configASSERT(text);
+	configASSERT(calendar);
+
+	parsed = *calendar;
+
+	for (i = 0; i < format->count; i++) {
+		item = &format->items[i];
+
+		if (item->field == TIME_FORMAT_FIELD_LITERAL) {
+			fraction = ((item->literal == '.') || (item->literal == ',')) && ((i + 1U) < format->count) &&
+					   ((format->items[i + 1U].field == TIME_FORMAT_FIELD_MILLISECONDS) ||
+						(format->items[i + 1U].field == TIME_FORMAT_FIELD_MICROSECONDS));
+
+			/* ISO 8601 allows both decimal signs. */
+			if ((pos < length) && ((text[pos] == item->literal) ||
+				((true == fraction) && ((text[pos] == '.') || (text[pos] == ','))))) {
+				pos++;
+				continue;
+			}
+
+			/* A missing fraction is 0. */
+			if (true == fraction) {
+				parsed.microseconds = 0;
+				i++;
+				continue;
+			}
+
+			return false;
+		}
+
+		switch (item->field) {
+		case TIME_FORMAT_FIELD_MONTH_NAME:
+		case TIME_FORMAT_FIELD_WEEKDAY_NAME:
+			read = 3;
+			if (item->field == TIME_FORMAT_FIELD_MONTH_NAME) {
+				name = time_format_read_name(&text[pos], length - pos, time_format_months, 12U);
+				parsed.month = (uint8_t)(name + 1);
+			} else {
+				/* The weekday follows from the date. */
+				name = time_format_read_name(&text[pos], length - pos, time_format_weekdays, 7U);
+			}
+			if (name < 0) {
+				return false;
+			}
+			break;
+		case TIME_FORMAT_FIELD_TZ_OFFSET:
+			read = time_format_read_offset(&text[pos], length - pos, &offset);
+			break;
+		default:
+			if ((item->field == TIME_FORMAT_FIELD_DAY_SPACE) && (pos < length) && (text[pos] == ' ')) {
+				pos++;
+			}
+			read = time_format_read_digits(&text[pos], length - pos,
+				time_format_fields[item->field - 1U].length, &value);
+			if (read < time_format_fields[item->field - 1U].min_digits) {
+				read = 0;
+			}
+			break;
+		}
+
+		if (read == 0U) {
+			return false;
+		}
+		pos += read;
+
+		switch (item->field) {
+		case TIME_FORMAT_FIELD_YEAR:
+			parsed.year = (uint16_t)value;
+			break;
+		case TIME_FORMAT_FIELD_YEAR_2:
+			parsed.year = (uint16_t)(2000U + value);
+			break;
+		case TIME_FORMAT_FIELD_MONTH:
+			parsed.month = (uint8_t)((value <= 12U) ? value : 0U);
+			break;
+		case TIME_FORMAT_FIELD_DAY:
+		case TIME_FORMAT_FIELD_DAY_SPACE:
+			parsed.day = (uint8_t)((value <= 31U) ? value : 0U);
+			break;
+		case TIME_FORMAT_FIELD_HOURS:
+			parsed.hours = (uint8_t)((value <= 23U) ? value : 24U);
+			break;
+		case TIME_FORMAT_FIELD_MINUTES:
+			parsed.minutes = (uint8_t)((value <= 59U) ? value : 60U);
+			break;
+		case TIME_FORMAT_FIELD_SECONDS:
+			parsed.seconds = (uint8_t)((value <= 59U) ? value : 60U);
+			break;
+		case TIME_FORMAT_FIELD_MILLISECONDS:
+			parsed.microseconds = value * time_format_powers[3U - read] * 1000U;
+			break;
+		case TIME_FORMAT_FIELD_MICROSECONDS:
+			parsed.microseconds = value * time_format_powers[6U - read];
+
+			/* The decimals after the sixth are dropped. */
+			while ((pos < length) && (text[pos] >= '0') && (text[pos] <= '9')) {
+				pos++;
+			}
+			break;
+		case TIME_FORMAT_FIELD_EPOCH:
+			timekeeping_to_calendar((uint64_t)value * TIMEKEEPING_US_PER_SECOND, &parsed);
+			offset = 0;
+			break;
+		default:
+			break;
+		}
+	}
+
+	if ((pos != length) || (true != timekeeping_from_calendar(&parsed, &epoch_us))) {
+		return false;
+	}
+
+	timekeeping_to_calendar(epoch_us, calendar);
+	if (tz_offset_min != NULL) {
+		*tz_offset_min = offset;
+	}
+
+	return true;
+}
+
+/**
+  * @brief  Parses a time into microseconds since 1970.
+  * @param  format: the compiled format
+  * @param  text: the text, which need not be terminated
+  * @param  length: length of the text
+  * @param  base_us: the time the fields not in the format are taken from,
+  *         in the offset of the format
+  * @param  epoch_us: Microseconds since 1970-01-01 00:00:00 UTC
+  * @retval false if the text does not match or the time is before 1970
+  */
+bool time_format_parse_us(const time_format_t *format, const char *text, size_t length,
+						  uint64_t base_us, uint64_t *epoch_us)
+{
+	timekeeping_calendar_t calendar;
+	uint64_t local_us;
+	int64_t offset_us;
+	int32_t offset;
+
+	configASSERT(format);
+	configASSERT(epoch_us);
+
+	timekeeping_to_calendar(time_format_local_us(base_us, format->tz_offset_min), &calendar);
+
+	if (true != time_format_parse(format, text, length, &calendar, &offset)) {
+		return false;
+	}
+
+	( void ) timekeeping_from_calendar(&calendar, &local_us);
+
+	offset_us = (int64_t)offset * 60LL * (int64_t)TIMEKEEPING_US_PER_SECOND;
+	if ((offset_us > 0) && (local_us < (uint64_t)offset_us)) {
+		return false;
+	}
+
+	*epoch_us = (uint64_t)((int64_t)local_us - offset_us);
+
+	return true;
+}
+
+/* The local time, not before 1970. */
+static uint64_t time_format_local_us(uint64_t epoch_us, int32_t tz_offset_min)
+{
+	int64_t offset_us = (int64_t)tz_offset_min * 60LL * (int64_t)TIMEKEEPING_US_PER_SECOND;
+
+	if ((offset_us < 0) && (epoch_us < (uint64_t)-offset_us)) {
+		return 0;
+	}
+
+	return (uint64_t)((int64_t)epoch_us + offset_us);
+}
+
+/* Writes count digits, with leading zeros. */
+static char *time_format_digits(char *out, uint32_t value, uint32_t count)
+{
+	char *end = out + count;
+	char *digit = end;
+
+	while (count >= 2U) {
+		digit -= 2;
+		memcpy(digit, &time_format_pairs[(value % 100U) * 2U], 2U);
+		value /= 100U;
+		count -= 2U;
+	}
+
+	if (count != 0U) {
+		digit[-1] = (char)('0' + (value % 10U));
+	}
+
+	return end;
+}
+
+/* Writes a number without leading zeros. */
+static char *time_format_number(char *out, uint32_t value)
+{
+	uint32_t count = 1;
+
+	while ((count < 10U) && (value >= time_format_powers[count])) {
+		count++;
+	}
+
+	return time_format_digits(out, value, count);
+}
+
+static char *time_format_offset(char *out, int32_t tz_offset_min)
+{
+	uint32_t minutes;
+
+	if (tz_offset_min == 0) {
+		*out++ = 'Z';
+		return out;
+	}
+
+	*out++  = (tz_offset_min < 0) ? '-' : '+';
+	minutes = (uint32_t)((tz_offset_min < 0) ? -tz_offset_min : tz_offset_min);
+	out     = time_format_digits(out, minutes / 60U, 2U);
+	*out++  = ':';
+
+	return time_format_digits(out, minutes % 60U, 2U);
+}
+
+/* Reads up to max_digits digits, returns the number read. */
+static size_t time_format_read_digits(const char *text, size_t length, uint32_t max_digits, uint32_t *value)
+{
+	size_t read = 0;
+
+	*value = 0;
+	while ((read < length) && (read < max_digits) && (text[read] >= '0') && (text[read] <= '9')) {
+		/* Only 10 digits of %s can overflow. */
+		if ((read == 9U) && ((*value > 429496729UL) || ((*value == 429496729UL) && (text[read] > '5')))) {
+			return 0;
+		}
+		*value = (*value * 10U) + (uint32_t)(text[read] - '0');
+		read++;
+	}
+
+	return read;
+}
+
+/* Z, +hh:mm or +hhmm, returns the characters read, 0 if none match. */
+static size_t time_format_read_offset(const char *text, size_t length, int32_t *tz_offset_min)
+{
+	uint32_t hours;
+	uint32_t minutes;
+	size_t read;
+
+	if ((length >= 1U) && (text[0] == 'Z')) {
+		*tz_offset_min = 0;
+		return 1;
+	}
+
+	if ((length < 5U) || ((text[0] != '+') && (text[0] != '-')) ||
+		(time_format_read_digits(&text[1], 2U, 2U, &hours) != 2U)) {
+		return 0;
+	}
+
+	read = (text[3] == ':') ? 4U : 3U;
+	if ((time_format_read_digits(&text[read], length - read, 2U, &minutes) != 2U) ||
+		(hours > 23U) || (minutes > 59U)) {
+		return 0;
+	}
+
+	*tz_offset_min = (int32_t)(hours * 60U + minutes);
+	if (text[0] == '-') {
+		*tz_offset_min = -*tz_offset_min;
+	}
+
+	return read + 2U;
+}
+
+/* Returns the index of the 3 letter name, -1 if none matches. */
+static int32_t time_format_read_name(const char *text, size_t length, const char *names, uint32_t count)
+{
+	uint32_t i;
+
+	if (length < 3U) {
+		return -1;
+	}
+
+	for (i = 0; i < count; i++) {
+		if (strncmp(text, &names[i * 3U], 3U) == 0) {
+			return (int32_t)i;
+		}
+	}
+
+	return -1;
+}
@@ -0,0 +1,172 @@
+/**
+  ******************************************************************************
+  * @file    time_format_bench.c
+  * @brief   Measures the throughput of time_format.c against snprintf().
+  *
+  *          Every call converts TIME_FORMAT_BENCH_BATCH consecutive ISO 8601
+  *          timestamps, 1 ms apart as in a log or a day apart so that the
+  *          date is converted each time, and is timed with the CPU cycle
+  *          counter while the scheduler is suspended.  The fastest of
+  *          TIME_FORMAT_BENCH_RUNS calls is kept to leave out the
+  *          interrupts.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "time_format_bench.h"
+#include "time_format.h"
+#include "timekeeping.h"
+#include "cycle_counter.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+/* 2026-10-18T12:34:56.123456Z */
+#define TIME_FORMAT_BENCH_START_US      1760790896123456ULL
+
+#define TIME_FORMAT_BENCH_MS_STEP_US    1000ULL
+#define TIME_FORMAT_BENCH_DAY_STEP_US   ( 86400ULL * TIMEKEEPING_US_PER_SECOND + 1000ULL )
+
+typedef uint32_t ( *time_format_bench_call_t )( uint64_t start_us );
+
+static uint32_t time_format_bench_format_ms(uint64_t start_us);
+static uint32_t time_format_bench_format_day(uint64_t start_us);
+static uint32_t time_format_bench_snprintf(uint64_t start_us);
+static uint32_t time_format_bench_parse(uint64_t start_us);
+
+static const struct {
+	const char               *name;
+	time_format_bench_call_t  call;
+} time_format_bench_calls[] = {
+	{ "time_format_us, 1 ms apart",  time_format_bench_format_ms },
+	{ "time_format_us, 1 day apart", time_format_bench_format_day },
+	{ "snprintf, 1 ms apart",        time_format_bench_snprintf },
+	{ "time_format_parse_us",        time_format_bench_parse },
+};
+
+#define TIME_FORMAT_BENCH_CALLS         ( sizeof(time_format_bench_calls) / sizeof(time_format_bench_calls[0]) )
+
+static time_format_t time_format_bench_format;
+static char time_format_bench_text[ TIME_FORMAT_BENCH_BATCH ][ 40 ];
+
+/**
+  * @brief  Runs the benchmark and prints the results.
+  * @param  buffer: Output buffer for the result table
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void time_format_bench_run(char *buffer, size_t length)
+{
+	uint32_t cycles[ TIME_FORMAT_BENCH_CALLS ];
+	uint32_t per_call;
+	uint32_t elapsed;
+	uint32_t i;
+	uint32_t run;
+	size_t written;
+	bool compiled;
+
+	configASSERT(buffer);
+
+	cycle_counter_init();
+	compiled = time_format_compile(&time_format_bench_format, TIME_FORMAT_ISO8601, 0);
+	configASSERT(true == compiled);
+	( void ) compiled;
+
+	for (i = 0; i < TIME_FORMAT_BENCH_CALLS; i++) {
+		cycles[i] = UINT32_MAX;
+
+		for (run = 0; run < TIME_FORMAT_BENCH_RUNS; run++) {
+			vTaskSuspendAll();
+			{
+				elapsed = time_format_bench_calls[i].call(TIME_FORMAT_BENCH_START_US + run * TIME_FORMAT_BENCH_MS_STEP_US);
+			}
+			( void ) xTaskResumeAll();
+
+			if (elapsed < cycles[i]) {
+				cycles[i] = elapsed;
+			}
+		}
+	}
+
+	written = snprintf(buffer, length, "\r\n%s, %lu timestamps a call\r\n"
+		"Call                         CPU cycles each  Timestamps/s\r\n",
+		time_format_bench_text[0], ( unsigned long ) TIME_FORMAT_BENCH_BATCH);
+
+	for (i = 0; (i < TIME_FORMAT_BENCH_CALLS) && (written < length); i++) {
+		per_call = cycles[i] / TIME_FORMAT_BENCH_BATCH;
+		written += snprintf(buffer + written, length - written, "%-27s  %15lu  %12lu\r\n",
+			time_format_bench_calls[i].name, ( unsigned long ) per_call,
+			( unsigned long ) ((per_call != 0U) ? SystemCoreClock / per_call : 0U));
+	}
+
+	if ((written < length) && (cycles[0] != 0U)) {
+		snprintf(buffer + written, length - written, "snprintf / time_format_us: %lu.%02lu\r\n",
+			( unsigned long ) (cycles[2] / cycles[0]), ( unsigned long ) ((cycles[2] * 100U / cycles[0]) % 100U));
+	}
+}
+
+static uint32_t time_format_bench_format_ms(uint64_t start_us)
+{
+	uint32_t start;
+	uint32_t i;
+
+	start = cycle_counter_get();
+	for (i = 0; i < TIME_FORMAT_BENCH_BATCH; i++) {
+		( void ) time_format_us(&time_format_bench_format, start_us + i * TIME_FORMAT_BENCH_MS_STEP_US,
+			time_format_bench_text[i], sizeof(time_format_bench_text[i]));
+	}
+
+	return cycle_counter_get() - start;
+}
+
+static uint32_t time_format_bench_format_day(uint64_t start_us)
+{
+	uint32_t start;
+	uint32_t i;
+
+	start = cycle_counter_get();
+	for (i = 0; i < TIME_FORMAT_BENCH_BATCH; i++) {
+		( void ) time_format_us(&time_format_bench_format, start_us + i * TIME_FORMAT_BENCH_DAY_STEP_US,
+			time_format_bench_text[i], sizeof(time_format_bench_text[i]));
+	}
+
+	return cycle_counter_get() - start;
+}
+
+/* The same text as TIME_FORMAT_ISO8601 in UTC. */
+static uint32_t time_format_bench_snprintf(uint64_t start_us)
+{
+	timekeeping_calendar_t calendar;
+	uint32_t start;
+	uint32_t i;
+
+	start = cycle_counter_get();
+	for (i = 0; i < TIME_FORMAT_BENCH_BATCH; i++) {
+		timekeeping_to_calendar(start_us + i * TIME_FORMAT_BENCH_MS_STEP_US, &calendar);
+		snprintf(time_format_bench_text[i], sizeof(time_format_bench_text[i]), "%04u-%02u-%02uT%02u:%02u:%02u.%06luZ",
+			calendar.year, calendar.month, calendar.day, calendar.hours, calendar.minutes, calendar.seconds,
+			( unsigned long ) calendar.microseconds);
+	}
+
+	return cycle_counter_get() - start;
+}
+
+/* Parses the texts of the previous call. */
+static uint32_t time_format_bench_parse(uint64_t start_us)
+{
+	uint64_t epoch_us;
+	uint32_t start;
+	uint32_t i;
+
+	start = cycle_counter_get();
+	for (i = 0; i < TIME_FORMAT_BENCH_BATCH; i++) {
+		( void ) time_format_parse_us(&time_format_bench_format, time_format_bench_text[i],
+			strlen(time_format_bench_text[i]), start_us, &epoch_us);
+	}
+
+	return cycle_counter_get() - start;
+}
@@ -0,0 +1,260 @@
+/**
+  ******************************************************************************
+  * @file    timebase.c
+  * @brief   Unified system timebase built on TIM2.
+  *
+  *          TIM2 is a free running 32 bit counter clocked at 1 MHz.  Its
+  *          channel 1 compare event fires every millisecond and drives both
+  *          HAL_IncTick() and the FreeRTOS tick, so SysTick and TIM7 are no
+  *          longer used.  The counter itself is the high resolution timestamp
+  *          and the run time stats clock, extended to 64 bits by counting the
+  *          update (overflow) events.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "timebase.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "stm32f4xx_hal.h"
+
+TIM_HandleTypeDef htim2;
+
+/* Number of times the 32 bit counter wrapped, the upper word of the 64 bit
+timestamp. */
+static volatile uint32_t timebase_overflows = 0;
+
+/* Set once the scheduler is started, until then the compare event only
+increments the HAL tick. */
+static volatile uint32_t kernel_tick_enabled = 0;
+
+/* Provided by port.c, it increments the RTOS tick and pends PendSV if a
+context switch is required. */
+extern void xPortSysTickHandler(void);
+
+static uint32_t timebase_get_prescaler(void);
+
+/**
+  * @brief  This function configures TIM2 as the time base source.
+  *         The counter runs at 1 MHz and the channel 1 compare event
+  *         generates the 1 ms tick with a dedicated interrupt priority.
+  * @note   This function is called automatically at the beginning of program
+  *         after reset by HAL_Init() and every time the clock is configured
+  *         by HAL_RCC_ClockConfig().  On reconfiguration only the prescaler
+  *         is reloaded, the counter keeps its value so timestamps taken
+  *         before and after a clock change stay on the same timeline.
+  * @param  TickPriority: Tick interrupt priority.
+  * @retval HAL status
+  */
+HAL_StatusTypeDef HAL_InitTick(uint32_t TickPriority)
+{
+	uint32_t prescaler;
+	uint32_t counter;
+	uint32_t primask;
+
+	if (TickPriority >= (1UL << __NVIC_PRIO_BITS)) {
+		return HAL_ERROR;
+	}
+
+	prescaler = timebase_get_prescaler();
+
+	if (htim2.Instance == NULL) {
+
+		/* Enable TIM2 clock */
+		__HAL_RCC_TIM2_CLK_ENABLE();
+
+		/* Initialize TIMx peripheral as follow:
+		+ Period = 0xFFFFFFFF to have a free running 32 bit counter.
+		+ Prescaler = (uwTimclock/1000000 - 1) to have a 1MHz counter clock.
+		+ ClockDivision = 0
+		+ Counter direction = Up
+		*/
+		htim2.Instance               = TIM2;
+		htim2.Init.Period            = 0xFFFFFFFFUL;
+		htim2.Init.Prescaler         = prescaler;
+		htim2.Init.ClockDivision     = 0;
+		htim2.Init.CounterMode       = TIM_COUNTERMODE_UP;
+		htim2.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_DISABLE;
+
+		if (HAL_TIM_Base_Init(&htim2) != HAL_OK) {
+			return HAL_ERROR;
+		}
+
+		/* Only a real overflow may raise the update interrupt, so the
+		software UG used on reconfiguration does not count as a wrap. */
+		htim2.Instance->CR1 |= TIM_CR1_URS;
+
+		/* Channel 1 in frozen output compare mode (reset value of CCMR1)
+		generates the tick. */
+		htim2.Instance->CCR1 = htim2.Instance->CNT + TIMEBASE_TICK_PERIOD_US;
+
+		__HAL_TIM_CLEAR_FLAG(&htim2, TIM_FLAG_UPDATE | TIM_FLAG_CC1);
+		__HAL_TIM_ENABLE_IT(&htim2, TIM_IT_UPDATE | TIM_IT_CC1);
+
+		HAL_NVIC_SetPriority(TIM2_IRQn, TickPriority, 0);
+		HAL_NVIC_EnableIRQ(TIM2_IRQn);
+
+		__HAL_TIM_ENABLE(&htim2);
+
+	} else {
+
+		/* The bus clock has changed.  The new prescaler is only loaded on an
+		update event, which resets the counter, so put the counter value
+		back straight after it. */
+		primask = __get_PRIMASK();
+		__disable_irq();
+
+		counter = htim2.Instance->CNT;
+		htim2.Instance->PSC = prescaler;
+		htim2.Instance->EGR = TIM_EGR_UG;
+		htim2.Instance->CNT = counter;
+		htim2.Init.Prescaler = prescaler;
+
+		__set_PRIMASK(primask);
+
+		HAL_NVIC_SetPriority(TIM2_IRQn, TickPriority, 0);
+	}
+
+	uwTickPrio = TickPriority;
+
+	return HAL_OK;
+}
+
+/**
+  * @brief  Suspend Tick increment.
+  * @note   Disable the tick increment by disabling the TIM2 channel 1
+  *         compare interrupt.  This also stops the RTOS tick.
+  * @param  None
+  * @retval None
+  */
+void HAL_SuspendTick(void)
+{
+	__HAL_TIM_DISABLE_IT(&htim2, TIM_IT_CC1);
+}
+
+/**
+  * @brief  Resume Tick increment.
+  * @note   Enable the tick increment by enabling the TIM2 channel 1
+  *         compare interrupt.
+  * @param  None
+  * @retval None
+  */
+void HAL_ResumeTick(void)
+{
+	__HAL_TIM_ENABLE_IT(&htim2, TIM_IT_CC1);
+}
+
+/**
+  * @brief  Replaces the SysTick setup of the port layer.
+  * @note   Called by xPortStartScheduler() with interrupts disabled.  TIM2 is
+  *         already running, from now on its tick also increments the kernel
+  *         tick.
+  * @param  None
+  * @retval None
+  */
+void vPortSetupTimerInterrupt(void)
+{
+	kernel_tick_enabled = 1;
+}
+
+/**
+  * @brief  Returns the free running microsecond counter.
+  * @note   Wraps around every ~71.6 minutes, differences of two readings
+  *         are valid as long as they are computed in uint32_t.
+  * @retval Microseconds since the timebase was started (mod 2^32)
+  */
+uint32_t timebase_get_us(void)
+{
+	return htim2.Instance->CNT;
+}
+
+/**
+  * @brief  Returns the 64 bit microsecond timestamp.
+  * @note   Safe to call from tasks and interrupts, including code that runs
+  *         with interrupts masked while an overflow is pending.
+  * @retval Microseconds since the timebase was started
+  */
+uint64_t timebase_get_us64(void)
+{
+	uint32_t high;
+	uint32_t low;
+	uint32_t overflow_pending;
+
+	do {
+		high             = timebase_overflows;
+		low              = htim2.Instance->CNT;
+		overflow_pending = htim2.Instance->SR & TIM_SR_UIF;
+	} while (high != timebase_overflows);
+
+	/* The counter wrapped but the interrupt has not been serviced yet. */
+	if ((overflow_pending != 0) && (low < 0x80000000UL)) {
+		high = high + 1;
+	}
+
+	return ((uint64_t)high << 32) | low;
+}
+
+/**
+  * @brief  Returns the clock used by the FreeRTOS run time statistics.
+  * @retval The timestamp in (1 << TIMEBASE_RUNTIME_SHIFT) us units
+  */
+uint32_t timebase_get_runtime_counter(void)
+{
+	return (uint32_t)(timebase_get_us64() >> TIMEBASE_RUNTIME_SHIFT);
+}
+
+/**
+  * @brief  TIM2 interrupt handler body, called from TIM2_IRQHandler().
+  * @note   The compare register is advanced by a whole tick period each time
+  *         so the tick does not drift.  If the interrupt was held off for
+  *         more than one period the missed ticks are processed here instead
+  *         of waiting for the counter to wrap around to the stale compare
+  *         value.
+  * @param  None
+  * @retval None
+  */
+void timebase_irq_handler(void)
+{
+	uint32_t status = htim2.Instance->SR & htim2.Instance->DIER;
+
+	if ((status & TIM_SR_UIF) != 0) {
+		htim2.Instance->SR = ~TIM_SR_UIF;
+		timebase_overflows = timebase_overflows + 1;
+	}
+
+	if ((status & TIM_SR_CC1IF) != 0) {
+		htim2.Instance->SR = ~TIM_SR_CC1IF;
+
+		while ((int32_t)(htim2.Instance->CNT - htim2.Instance->CCR1) >= 0) {
+			htim2.Instance->CCR1 += TIMEBASE_TICK_PERIOD_US;
+
+			HAL_IncTick();
+
+			if (kernel_tick_enabled != 0) {
+				xPortSysTickHandler();
+			}
+		}
+	}
+}
+
+static uint32_t timebase_get_prescaler(void)
+{
+	RCC_ClkInitTypeDef clkconfig;
+	uint32_t           uwTimclock;
+	uint32_t           pFLatency;
+
+	/* Get clock configuration */
+	HAL_RCC_GetClockConfig(&clkconfig, &pFLatency);
+
+	/* Compute TIM2 clock.  The APB1 timers run at twice PCLK1 unless the APB1
+	prescaler is 1. */
+	if (clkconfig.APB1CLKDivider == RCC_HCLK_DIV1) {
+		uwTimclock = HAL_RCC_GetPCLK1Freq();
+	} else {
+		uwTimclock = 2 * HAL_RCC_GetPCLK1Freq();
+	}
+
+	/* Compute the prescaler value to have TIM2 counter clock equal to 1MHz */
+	return (uint32_t)((uwTimclock / TIMEBASE_COUNTER_HZ) - 1U);
+}
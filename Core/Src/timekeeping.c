@@ -0,0 +1,700 @@
+/**
+  ******************************************************************************
+  * @file    timekeeping.c
+  * @brief   Microsecond UTC clock from the RTC and the timebase.
+  *
+  *          The RTC is read once, at the start, and gives the time of a
+  *          point of the 1 MHz timebase that also drives the kernel tick.
+  *          From then on the clock is that time plus the timebase
+  *          microseconds elapsed since, corrected by a rate and, while an
+  *          offset is slewed in, a slew rate.  A read does not access the
+  *          RTC, it takes one of two copies of the base, the one the
+  *          generation counter points to, and retries if the counter
+  *          changed meanwhile.  An update writes the other copy and then
+  *          moves the counter, so a read is never blocked and may be done
+  *          from any task or interrupt.
+  *
+  *          The RTC is read when its sub-second counter changes, which
+  *          puts the start within the shadow register update of 2 RTCCLK
+  *          cycles instead of the 3.9 ms sub-second step.  It is set from
+  *          the clock every TIMEKEEPING_RTC_UPDATE_MS, the new second timed
+  *          to start with the second of the clock, which also rebases the
+  *          clock so the corrections stay within their range.  The RTC
+  *          keeps the time over a reset in the backup domain (see
+  *          RTC_Init()), with the source of the time and the rate
+  *          correction in its backup registers.
+  *
+  *          The rate corrects the HSE crystal the timebase runs from.  A
+  *          host reference passed to timekeeping_sync_us() gives the offset
+  *          of the clock, which is slewed in at TIMEKEEPING_SLEW_PPM, or
+  *          stepped if it is above TIMEKEEPING_STEP_THRESHOLD_US.  With two
+  *          references at least TIMEKEEPING_DRIFT_MIN_INTERVAL_S apart the
+  *          part of the offset that the previous one did not explain is the
+  *          drift, added to the rate.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "timekeeping.h"
+#include "rtc.h"
+#include "timebase.h"
+#include "work_queue.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include <stdio.h>
+
+/* The RTC counts from 2000 to 2099. */
+#define TIMEKEEPING_MIN_YEAR            2000U
+#define TIMEKEEPING_MAX_YEAR            2099U
+
+/* Backup register values, the source in the low byte. */
+#define TIMEKEEPING_SOURCE_MAGIC        0x434C4B00UL    /* "CLK" */
+#define TIMEKEEPING_SOURCE_MASK         0x000000FFUL
+
+/* Longest sub-second step of the RTC, at the slowest LSI. */
+#define TIMEKEEPING_SSR_WAIT_US         10000ULL
+
+/* The RTC update wakes up this long before the second it sets. */
+#define TIMEKEEPING_RTC_MARGIN_US       3000ULL
+
+/* ppb to 2^-32 units. */
+#define TIMEKEEPING_PPB_TO_RATE(ppb)    ( (int32_t)(((int64_t)(ppb) * 4294967296LL) / 1000000000LL) )
+
+typedef struct {
+	uint64_t epoch_us;          /* The clock at base_us. */
+	uint64_t base_us;           /* timebase_get_us64() at the base. */
+	int32_t  rate;              /* Rate correction, 2^-32 units. */
+	int32_t  slew;              /* Slew rate, 2^-32 units. */
+	uint32_t slew_us;           /* Timebase microseconds of slew after the base. */
+} timekeeping_base_t;
+
+typedef struct {
+	timekeeping_source_t source;
+	int32_t              drift_ppb;
+	uint32_t             syncs;
+	int64_t              last_offset_us;
+	uint64_t             last_sync_us;     /* timebase_get_us64() at the last reference. */
+	bool                 last_sync_valid;  /* The clock was not set since. */
+} timekeeping_state_t;
+
+static void timekeeping_timer_callback(TimerHandle_t timer);
+static void timekeeping_rtc_work(work_queue_item_t *item, void *arg);
+static bool timekeeping_read_rtc(uint64_t *epoch_us, uint64_t *base_us);
+static void timekeeping_get_base(timekeeping_base_t *base);
+static void timekeeping_publish(const timekeeping_base_t *base);
+static uint64_t timekeeping_at(const timekeeping_base_t *base, uint64_t now_us);
+static int64_t timekeeping_slew_left(const timekeeping_base_t *base, uint64_t now_us);
+static void timekeeping_rebase(timekeeping_base_t *base, uint64_t now_us);
+static void timekeeping_save(void);
+
+PRIVILEGED_DATA static timekeeping_base_t timekeeping_bases[2];
+PRIVILEGED_DATA static volatile uint32_t timekeeping_generation;
+PRIVILEGED_DATA static volatile bool timekeeping_ready = false;
+
+/* Written in critical sections. */
+PRIVILEGED_DATA static timekeeping_state_t timekeeping_state;
+
+PRIVILEGED_DATA static work_queue_item_t timekeeping_work;
+
+/**
+  * @brief  Starts the clock from the RTC.
+  * @note   Called after RTC_Init(), from a task.
+  * @retval None
+  */
+void timekeeping_init(void)
+{
+	timekeeping_base_t base = {0};
+	TimerHandle_t timer;
+	uint32_t source;
+	uint32_t drift;
+
+	configASSERT(true == RTC_IsReady());
+
+	source = RTC_ReadBackup(RTC_BACKUP_CLOCK_SOURCE);
+	drift  = RTC_ReadBackup(RTC_BACKUP_CLOCK_DRIFT);
+
+	/* The backup registers are reset with the calendar after a power on. */
+	timekeeping_state.source = TIMEKEEPING_SOURCE_BUILD_TIME;
+	if ((true == RTC_IsRestored()) && ((source & ~TIMEKEEPING_SOURCE_MASK) == TIMEKEEPING_SOURCE_MAGIC) &&
+		((source & TIMEKEEPING_SOURCE_MASK) <= TIMEKEEPING_SOURCE_HOST)) {
+		timekeeping_state.source = (timekeeping_source_t)(source & TIMEKEEPING_SOURCE_MASK);
+	}
+
+	if ((drift ^ RTC_ReadBackup(RTC_BACKUP_CLOCK_CHECK)) == 0xFFFFFFFFUL) {
+		timekeeping_state.drift_ppb = (int32_t)drift;
+	}
+
+	if ((timekeeping_state.drift_ppb > TIMEKEEPING_MAX_DRIFT_PPM * 1000L) ||
+		(timekeeping_state.drift_ppb < -TIMEKEEPING_MAX_DRIFT_PPM * 1000L)) {
+		timekeeping_state.drift_ppb = 0;
+	}
+
+	/* The wait for the sub-second counter must not be preempted. */
+	vTaskSuspendAll();
+	{
+		( void ) timekeeping_read_rtc(&base.epoch_us, &base.base_us);
+	}
+	( void ) xTaskResumeAll();
+
+	base.rate = TIMEKEEPING_PPB_TO_RATE(timekeeping_state.drift_ppb);
+	timekeeping_publish(&base);
+
+	work_queue_item_init(&timekeeping_work, timekeeping_rtc_work, NULL, WORK_QUEUE_LOW);
+
+	timer = xTimerCreate("Clock", pdMS_TO_TICKS(TIMEKEEPING_RTC_UPDATE_MS), pdTRUE, NULL, timekeeping_timer_callback);
+	configASSERT(timer);
+	( void ) xTimerStart(timer, portMAX_DELAY);
+
+	timekeeping_ready = true;
+}
+
+bool timekeeping_is_ready(void)
+{
+	return timekeeping_ready;
+}
+
+/**
+  * @brief  Returns the time.
+  * @note   Safe to call from tasks and interrupts.
+  * @retval Microseconds since 1970-01-01 00:00:00 UTC
+  */
+uint64_t timekeeping_get_us(void)
+{
+	timekeeping_base_t base;
+
+	if (true != timekeeping_ready) {
+		return 0;
+	}
+
+	timekeeping_get_base(&base);
+
+	return timekeeping_at(&base, timebase_get_us64());
+}
+
+void timekeeping_get_calendar(timekeeping_calendar_t *calendar)
+{
+	configASSERT(calendar);
+
+	timekeeping_to_calendar(timekeeping_get_us(), calendar);
+}
+
+/**
+  * @brief  Steps the clock to a time.
+  * @note   The RTC is set shortly after, by the low priority worker.
+  * @param  epoch_us: Microseconds since 1970-01-01 00:00:00 UTC
+  * @retval false if the clock is not started or the RTC can not hold the time
+  */
+bool timekeeping_set_us(uint64_t epoch_us)
+{
+	timekeeping_calendar_t calendar;
+	timekeeping_base_t base;
+
+	timekeeping_to_calendar(epoch_us, &calendar);
+	if ((true != timekeeping_ready) || (calendar.year < TIMEKEEPING_MIN_YEAR) || (calendar.year > TIMEKEEPING_MAX_YEAR)) {
+		return false;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		timekeeping_get_base(&base);
+		base.epoch_us = epoch_us;
+		base.base_us  = timebase_get_us64();
+		base.slew     = 0;
+		base.slew_us  = 0;
+		timekeeping_publish(&base);
+
+		timekeeping_state.source          = TIMEKEEPING_SOURCE_SET;
+		timekeeping_state.last_sync_valid = false;
+	}
+	taskEXIT_CRITICAL();
+
+	timekeeping_save();
+	( void ) work_queue_submit(&timekeeping_work);
+
+	return true;
+}
+
+/**
+  * @brief  Corrects the clock with a host reference.
+  * @param  reference_us: The time, in microseconds since 1970-01-01 00:00:00 UTC
+  * @param  offset_us: Set to the reference minus the clock, may be NULL
+  * @retval false if the clock is not started or the RTC can not hold the time
+  */
+bool timekeeping_sync_us(uint64_t reference_us, int64_t *offset_us)
+{
+	const int64_t max_drift_ppb = TIMEKEEPING_MAX_DRIFT_PPM * 1000LL;
+	timekeeping_calendar_t calendar;
+	timekeeping_base_t base;
+	uint64_t now;
+	uint64_t interval;
+	int64_t offset;
+	int64_t error;
+	int64_t drift;
+	int64_t magnitude;
+
+	timekeeping_to_calendar(reference_us, &calendar);
+	if ((true != timekeeping_ready) || (calendar.year < TIMEKEEPING_MIN_YEAR) || (calendar.year > TIMEKEEPING_MAX_YEAR)) {
+		return false;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		now = timebase_get_us64();
+		timekeeping_get_base(&base);
+		offset = (int64_t)(reference_us - timekeeping_at(&base, now));
+
+		/* What the slew of the previous offset does not cover is drift. */
+		interval = now - timekeeping_state.last_sync_us;
+		if ((true == timekeeping_state.last_sync_valid) &&
+			(interval >= TIMEKEEPING_DRIFT_MIN_INTERVAL_S * TIMEKEEPING_US_PER_SECOND)) {
+
+			error = offset - timekeeping_slew_left(&base, now);
+
+			/* Larger than twice the limit is not drift, the reference or
+			the clock was wrong. */
+			magnitude = (error < 0) ? -error : error;
+			if (magnitude <= (int64_t)((interval * 2U * (uint64_t)TIMEKEEPING_MAX_DRIFT_PPM) / TIMEKEEPING_US_PER_SECOND)) {
+				drift = timekeeping_state.drift_ppb + (error * 1000000LL) / (int64_t)(interval / 1000U);
+
+				if (drift > max_drift_ppb) {
+					drift = max_drift_ppb;
+				} else if (drift < -max_drift_ppb) {
+					drift = -max_drift_ppb;
+				}
+
+				timekeeping_state.drift_ppb = (int32_t)drift;
+			}
+		}
+
+		timekeeping_rebase(&base, now);
+		base.rate = TIMEKEEPING_PPB_TO_RATE(timekeeping_state.drift_ppb);
+
+		magnitude = (offset < 0) ? -offset : offset;
+		if (magnitude > TIMEKEEPING_STEP_THRESHOLD_US) {
+			base.epoch_us = reference_us;
+			base.slew     = 0;
+			base.slew_us  = 0;
+		} else {
+			base.slew     = TIMEKEEPING_PPB_TO_RATE((offset < 0) ? -TIMEKEEPING_SLEW_PPM * 1000L : TIMEKEEPING_SLEW_PPM * 1000L);
+			base.slew_us  = (uint32_t)((magnitude * 1000000LL) / TIMEKEEPING_SLEW_PPM);
+		}
+
+		timekeeping_publish(&base);
+
+		timekeeping_state.source          = TIMEKEEPING_SOURCE_HOST;
+		timekeeping_state.syncs           = timekeeping_state.syncs + 1U;
+		timekeeping_state.last_offset_us  = offset;
+		timekeeping_state.last_sync_us    = now;
+		timekeeping_state.last_sync_valid = true;
+	}
+	taskEXIT_CRITICAL();
+
+	if (offset_us != NULL) {
+		*offset_us = offset;
+	}
+
+	timekeeping_save();
+	( void ) work_queue_submit(&timekeeping_work);
+
+	return true;
+}
+
+/**
+  * @brief  Sets the RTC from the clock soon, by the low priority worker.
+  * @retval None
+  */
+void timekeeping_request_rtc_update(void)
+{
+	if (true == timekeeping_ready) {
+		( void ) work_queue_submit(&timekeeping_work);
+	}
+}
+
+/**
+  * @brief  Removes the rate correction.
+  * @retval None
+  */
+void timekeeping_clear_drift(void)
+{
+	timekeeping_base_t base;
+
+	if (true != timekeeping_ready) {
+		return;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		timekeeping_get_base(&base);
+		timekeeping_rebase(&base, timebase_get_us64());
+		base.rate = 0;
+		timekeeping_publish(&base);
+
+		timekeeping_state.drift_ppb       = 0;
+		timekeeping_state.last_sync_valid = false;
+	}
+	taskEXIT_CRITICAL();
+
+	timekeeping_save();
+}
+
+/**
+  * @brief  Breaks down a time.
+  * @param  epoch_us: Microseconds since 1970-01-01 00:00:00 UTC
+  * @param  calendar: the broken down time
+  * @retval None
+  */
+void timekeeping_to_calendar(uint64_t epoch_us, timekeeping_calendar_t *calendar)
+{
+	uint64_t seconds = epoch_us / TIMEKEEPING_US_PER_SECOND;
+	uint32_t days = (uint32_t)(seconds / 86400ULL);
+	uint32_t of_day = (uint32_t)(seconds % 86400ULL);
+	uint32_t era;
+	uint32_t of_era;
+	uint32_t year_of_era;
+	uint32_t day_of_year;
+	uint32_t month;
+
+	configASSERT(calendar);
+
+	calendar->microseconds = (uint32_t)(epoch_us % TIMEKEEPING_US_PER_SECOND);
+	calendar->hours        = (uint8_t)(of_day / 3600U);
+	calendar->minutes      = (uint8_t)((of_day / 60U) % 60U);
+	calendar->seconds      = (uint8_t)(of_day % 60U);
+
+	/* 1970-01-01 was a Thursday. */
+	calendar->weekday      = (uint8_t)(((days + 3U) % 7U) + 1U);
+
+	/* Days to civil date, with years starting in March, so the leap day is
+	the last of the year. */
+	days        = days + 719468U;
+	era         = days / 146097U;
+	of_era      = days - era * 146097U;
+	year_of_era = (of_era - of_era / 1460U + of_era / 36524U - of_era / 146096U) / 365U;
+	day_of_year = of_era - (365U * year_of_era + year_of_era / 4U - year_of_era / 100U);
+	month       = (5U * day_of_year + 2U) / 153U;
+
+	calendar->day   = (uint8_t)(day_of_year - (153U * month + 2U) / 5U + 1U);
+	calendar->month = (uint8_t)((month < 10U) ? month + 3U : month - 9U);
+	calendar->year  = (uint16_t)(year_of_era + era * 400U + ((calendar->month <= 2U) ? 1U : 0U));
+}
+
+/**
+  * @brief  Converts a broken down time, the weekday is not used.
+  * @param  calendar: the broken down time
+  * @param  epoch_us: Microseconds since 1970-01-01 00:00:00 UTC
+  * @retval false if a field is out of range
+  */
+bool timekeeping_from_calendar(const timekeeping_calendar_t *calendar, uint64_t *epoch_us)
+{
+	static const uint8_t month_days[] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+	uint32_t year;
+	uint32_t era;
+	uint32_t year_of_era;
+	uint32_t day_of_year;
+	uint32_t days;
+	bool leap;
+
+	configASSERT(calendar);
+	configASSERT(epoch_us);
+
+	leap = ((calendar->year % 4U) == 0U) && (((calendar->year % 100U) != 0U) || ((calendar->year % 400U) == 0U));
+
+	if ((calendar->year < 1970U) || (calendar->month < 1U) || (calendar->month > 12U) || (calendar->day < 1U) ||
+		(calendar->day > month_days[calendar->month - 1U] + (((calendar->month == 2U) && (true == leap)) ? 1U : 0U)) ||
+		(calendar->hours > 23U) || (calendar->minutes > 59U) || (calendar->seconds > 59U) ||
+		(calendar->microseconds >= TIMEKEEPING_US_PER_SECOND)) {
+		return false;
+	}
+
+	year        = calendar->year - ((calendar->month <= 2U) ? 1U : 0U);
+	era         = year / 400U;
+	year_of_era = year - era * 400U;
+	day_of_year = (153U * ((calendar->month > 2U) ? calendar->month - 3U : calendar->month + 9U) + 2U) / 5U + calendar->day - 1U;
+	days        = era * 146097U + year_of_era * 365U + year_of_era / 4U - year_of_era / 100U + day_of_year - 719468U;
+
+	*epoch_us = ((uint64_t)days * 86400ULL + (uint64_t)calendar->hours * 3600ULL +
+				 (uint64_t)calendar->minutes * 60ULL + calendar->seconds) * TIMEKEEPING_US_PER_SECOND + calendar->microseconds;
+
+	return true;
+}
+
+/**
+  * @brief  Writes the time and the corrections into a buffer.
+  * @param  buffer: the output buffer
+  * @param  length: size of the buffer
+  * @retval None
+  */
+void timekeeping_print(char *buffer, size_t length)
+{
+	static const char * const source_names[] = { "build time", "set", "host reference" };
+	timekeeping_calendar_t calendar;
+	timekeeping_state_t state;
+	timekeeping_base_t base;
+	uint64_t epoch_us;
+	uint64_t now;
+	int64_t slew_left;
+	int32_t drift;
+	size_t written;
+	bool stepped;
+
+	configASSERT(buffer);
+
+	if (true != timekeeping_ready) {
+		snprintf(buffer, length, "Clock not ready.\r\n");
+		return;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		state = timekeeping_state;
+	}
+	taskEXIT_CRITICAL();
+
+	timekeeping_get_base(&base);
+	now       = timebase_get_us64();
+	epoch_us  = timekeeping_at(&base, now);
+	slew_left = timekeeping_slew_left(&base, now);
+	timekeeping_to_calendar(epoch_us, &calendar);
+
+	drift = (state.drift_ppb < 0) ? -state.drift_ppb : state.drift_ppb;
+
+	/* A stepped offset may not fit in microseconds. */
+	stepped = (state.last_offset_us > TIMEKEEPING_STEP_THRESHOLD_US) || (state.last_offset_us < -TIMEKEEPING_STEP_THRESHOLD_US);
+
+	written = snprintf(buffer, length,
+		"\r\n%04u-%02u-%02u %02u:%02u:%02u.%06lu UTC, %lu.%06lu s since the epoch\r\n"
+		"Source: %s%s\r\n"
+		"Drift correction: %s%lu.%03lu ppm\r\n",
+		( unsigned ) calendar.year, ( unsigned ) calendar.month, ( unsigned ) calendar.day,
+		( unsigned ) calendar.hours, ( unsigned ) calendar.minutes, ( unsigned ) calendar.seconds,
+		( unsigned long ) calendar.microseconds,
+		( unsigned long ) (epoch_us / TIMEKEEPING_US_PER_SECOND), ( unsigned long ) (epoch_us % TIMEKEEPING_US_PER_SECOND),
+		source_names[state.source], (true == RTC_IsRestored()) ? ", kept over the reset" : "",
+		(state.drift_ppb < 0) ? "-" : "", ( unsigned long ) (drift / 1000), ( unsigned long ) (drift % 1000));
+
+	if ((written < length) && (state.syncs > 0U)) {
+		written += snprintf(buffer + written, length - written,
+			"Host references: %lu, the last %lu s ago with an offset of %ld %s\r\n",
+			( unsigned long ) state.syncs, ( unsigned long ) ((now - state.last_sync_us) / TIMEKEEPING_US_PER_SECOND),
+			( long ) ((true == stepped) ? state.last_offset_us / 1000000LL : state.last_offset_us), (true == stepped) ? "s" : "us");
+	}
+
+	if ((written < length) && (slew_left != 0)) {
+		snprintf(buffer + written, length - written, "Slewing, %ld us left\r\n", ( long ) slew_left);
+	}
+}
+
+static void timekeeping_timer_callback(TimerHandle_t timer)
+{
+	( void ) timer;
+
+	( void ) work_queue_submit(&timekeeping_work);
+}
+
+/**
+  * @brief  Sets the RTC from the clock, and rebases the clock.
+  * @note   Blocks the worker until shortly before the next second.
+  * @retval None
+  */
+static void timekeeping_rtc_work(work_queue_item_t *item, void *arg)
+{
+	timekeeping_calendar_t calendar;
+	timekeeping_base_t base;
+	RTC_TimeTypeDef time = {0};
+	RTC_DateTypeDef date = {0};
+	uint64_t now;
+	uint64_t epoch;
+	uint64_t next;
+	bool set;
+
+	( void ) item;
+	( void ) arg;
+
+	/* Sleep until just before the next second. */
+	epoch = timekeeping_get_us();
+	next  = (epoch / TIMEKEEPING_US_PER_SECOND + 1U) * TIMEKEEPING_US_PER_SECOND;
+	if (next - epoch > TIMEKEEPING_RTC_MARGIN_US + (1000000UL / configTICK_RATE_HZ)) {
+		vTaskDelay(pdMS_TO_TICKS((uint32_t)((next - epoch - TIMEKEEPING_RTC_MARGIN_US) / 1000U)));
+	}
+
+	vTaskSuspendAll();
+	{
+		now   = timebase_get_us64();
+		epoch = timekeeping_get_us();
+		next  = (epoch / TIMEKEEPING_US_PER_SECOND + 1U) * TIMEKEEPING_US_PER_SECOND;
+
+		timekeeping_to_calendar(next, &calendar);
+		time.Hours    = calendar.hours;
+		time.Minutes  = calendar.minutes;
+		time.Seconds  = calendar.seconds;
+		date.Year     = (uint8_t)(calendar.year % 100U);
+		date.Month    = calendar.month;
+		date.Date     = calendar.day;
+		date.WeekDay  = calendar.weekday;
+
+		/* The corrections change the rate by less than a microsecond
+		within the wait. */
+		set = ((calendar.year >= TIMEKEEPING_MIN_YEAR) && (calendar.year <= TIMEKEEPING_MAX_YEAR) &&
+			   (true == RTC_SetCalendar(&time, &date, now + (next - epoch))));
+	}
+	( void ) xTaskResumeAll();
+
+	configASSERT(true == set);
+
+	taskENTER_CRITICAL();
+	{
+		timekeeping_get_base(&base);
+		timekeeping_rebase(&base, timebase_get_us64());
+		timekeeping_publish(&base);
+	}
+	taskEXIT_CRITICAL();
+}
+
+/**
+  * @brief  Reads the RTC when its sub-second counter changes.
+  * @param  epoch_us: the time of the RTC
+  * @param  base_us: timebase_get_us64() at the time
+  * @retval false if the counter did not change, the time is less accurate
+  */
+static bool timekeeping_read_rtc(uint64_t *epoch_us, uint64_t *base_us)
+{
+	timekeeping_calendar_t calendar;
+	RTC_TimeTypeDef first;
+	RTC_TimeTypeDef time;
+	RTC_DateTypeDef date;
+	uint64_t start;
+	uint64_t now;
+	uint32_t fraction;
+	bool changed;
+
+	( void ) RTC_GetCalendar(&first, &date);
+	start = timebase_get_us64();
+
+	do {
+		now = timebase_get_us64();
+		( void ) RTC_GetCalendar(&time, &date);
+		changed = (time.SubSeconds != first.SubSeconds);
+	} while ((true != changed) && ((now - start) < TIMEKEEPING_SSR_WAIT_US));
+
+	calendar.year         = (uint16_t)(TIMEKEEPING_MIN_YEAR + date.Year);
+	calendar.month        = date.Month;
+	calendar.day          = date.Date;
+	calendar.hours        = time.Hours;
+	calendar.minutes      = time.Minutes;
+	calendar.seconds      = time.Seconds;
+	calendar.microseconds = 0;
+
+	/* The sub-second counter counts down, a shift may have set it above
+	the prescaler. */
+	fraction = 0;
+	if (time.SubSeconds <= time.SecondFraction) {
+		fraction = (uint32_t)(((uint64_t)(time.SecondFraction - time.SubSeconds) * TIMEKEEPING_US_PER_SECOND) /
+							  (time.SecondFraction + 1U));
+	}
+
+	if (true != timekeeping_from_calendar(&calendar, epoch_us)) {
+		*epoch_us = 0;
+	}
+
+	*epoch_us = *epoch_us + fraction;
+	*base_us  = now;
+
+	return changed;
+}
+
+/**
+  * @brief  Copies the current base, without a lock.
+  * @param  base: the copy
+  * @retval None
+  */
+static void timekeeping_get_base(timekeeping_base_t *base)
+{
+	uint32_t generation;
+
+	do {
+		generation = timekeeping_generation;
+		__DMB();
+		*base = timekeeping_bases[generation & 1U];
+		__DMB();
+	} while (generation != timekeeping_generation);
+}
+
+/**
+  * @brief  Makes a base the current one.
+  * @note   Called in a critical section, one update at a time.
+  * @param  base: the new base
+  * @retval None
+  */
+static void timekeeping_publish(const timekeeping_base_t *base)
+{
+	uint32_t generation = timekeeping_generation + 1U;
+
+	/* The copy the readers do not use. */
+	timekeeping_bases[generation & 1U] = *base;
+	__DMB();
+	timekeeping_generation = generation;
+}
+
+static uint64_t timekeeping_at(const timekeeping_base_t *base, uint64_t now_us)
+{
+	int64_t elapsed = (now_us > base->base_us) ? (int64_t)(now_us - base->base_us) : 0;
+	int64_t slewed = (elapsed < (int64_t)base->slew_us) ? elapsed : (int64_t)base->slew_us;
+
+	return base->epoch_us + (uint64_t)(elapsed + ((elapsed * base->rate) >> 32) + ((slewed * base->slew) >> 32));
+}
+
+static int64_t timekeeping_slew_left(const timekeeping_base_t *base, uint64_t now_us)
+{
+	int64_t elapsed = (now_us > base->base_us) ? (int64_t)(now_us - base->base_us) : 0;
+
+	if (elapsed >= (int64_t)base->slew_us) {
+		return 0;
+	}
+
+	return (((int64_t)base->slew_us - elapsed) * base->slew) >> 32;
+}
+
+/**
+  * @brief  Moves a base to a later point, the clock does not change.
+  * @param  base: the base
+  * @param  now_us: timebase_get_us64() of the new base
+  * @retval None
+  */
+static void timekeeping_rebase(timekeeping_base_t *base, uint64_t now_us)
+{
+	uint64_t elapsed = (now_us > base->base_us) ? now_us - base->base_us : 0U;
+
+	base->epoch_us = timekeeping_at(base, now_us);
+	base->base_us  = now_us;
+
+	if (elapsed >= base->slew_us) {
+		base->slew    = 0;
+		base->slew_us = 0;
+	} else {
+		base->slew_us = base->slew_us - (uint32_t)elapsed;
+	}
+}
+
+/**
+  * @brief  Keeps the source and the rate correction with the RTC.
+  * @retval None
+  */
+static void timekeeping_save(void)
+{
+	timekeeping_source_t source;
+	int32_t drift;
+
+	taskENTER_CRITICAL();
+	{
+		source = timekeeping_state.source;
+		drift  = timekeeping_state.drift_ppb;
+	}
+	taskEXIT_CRITICAL();
+
+	RTC_WriteBackup(RTC_BACKUP_CLOCK_SOURCE, TIMEKEEPING_SOURCE_MAGIC | (uint32_t)source);
+	RTC_WriteBackup(RTC_BACKUP_CLOCK_DRIFT, (uint32_t)drift);
+	RTC_WriteBackup(RTC_BACKUP_CLOCK_CHECK, ~(uint32_t)drift);
+}
@@ -0,0 +1,176 @@
+/**
+  ******************************************************************************
+  * @file    timer_bench.c
+  * @brief   Measures the cost of the software timer API.
+  *
+  *          10, 100 and 1000 timers are started, reset and stopped while the
+  *          CPU cycles spent in each xTimerStart(), xTimerReset() and
+  *          xTimerStop() call are counted.  The caller must run below the
+  *          timer service task priority, so the daemon preempts it as soon as
+  *          a command is queued and the measured time includes inserting the
+  *          timer into (or removing it from) the active timer structure.
+  *          Build with configUSE_TIMER_WHEEL set to 0 and to 1 to compare the
+  *          sorted lists with the timing wheel.  Resetting every timer through
+  *          xTimerSendCommandBatch() is measured as well, to show the saving
+  *          of one queue transaction per batch instead of one per timer.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "timer_bench.h"
+#include "cycle_counter.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include <stdio.h>
+
+typedef struct {
+	uint32_t start_avg;
+	uint32_t reset_avg;
+	uint32_t reset_max;
+	uint32_t batch_avg;
+	uint32_t stop_avg;
+} timer_bench_result_t;
+
+static const uint32_t timer_bench_counts[] = { 10U, 100U, TIMER_BENCH_MAX_TIMERS };
+
+/* The control blocks are only touched while a benchmark runs and are
+initialized by xTimerCreateStatic(), so they are kept out of the main RAM. */
+static StaticTimer_t timer_bench_buffers[ TIMER_BENCH_MAX_TIMERS ] __attribute__((section(".ccmbss")));
+static TimerHandle_t timer_bench_timers[ TIMER_BENCH_MAX_TIMERS ] __attribute__((section(".ccmbss")));
+
+static TimerBatchCommand_t timer_bench_batch_commands[ TIMER_BENCH_BATCH_SIZE ];
+static TimerCommandBatch_t timer_bench_batch;
+
+static void timer_bench_callback(TimerHandle_t timer);
+static void timer_bench_measure(uint32_t count, timer_bench_result_t *result);
+
+/**
+  * @brief  Runs the benchmark and prints the results.
+  * @param  buffer: Output buffer for the result table
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void timer_bench_run(char *buffer, size_t length)
+{
+	timer_bench_result_t result;
+	size_t written;
+	uint32_t i;
+
+	configASSERT(buffer);
+
+	cycle_counter_init();
+
+#if ( configUSE_TIMER_WHEEL == 1 )
+	written = snprintf(buffer, length, "\r\nTimer backend: timing wheel, %u levels\r\n", ( unsigned ) configTIMER_WHEEL_LEVELS);
+#else
+	written = snprintf(buffer, length, "\r\nTimer backend: sorted lists\r\n");
+#endif
+
+	if (uxTaskPriorityGet(NULL) >= configTIMER_TASK_PRIORITY) {
+		snprintf(buffer + written, length - written, "Must run below the timer task priority.\r\n");
+		return;
+	}
+
+	written += snprintf(buffer + written, length - written,
+		"Timers   Start   Reset  Reset max  Batch reset    Stop  [CPU cycles per timer]\r\n");
+
+	for (i = 0; i < sizeof(timer_bench_counts) / sizeof(timer_bench_counts[0]); i++) {
+		if (written >= length) {
+			break;
+		}
+
+		timer_bench_measure(timer_bench_counts[i], &result);
+
+		written += snprintf(buffer + written, length - written, "%6lu  %6lu  %6lu  %9lu  %11lu  %6lu\r\n",
+			( unsigned long ) timer_bench_counts[i],
+			( unsigned long ) result.start_avg,
+			( unsigned long ) result.reset_avg,
+			( unsigned long ) result.reset_max,
+			( unsigned long ) result.batch_avg,
+			( unsigned long ) result.stop_avg);
+	}
+}
+
+static void timer_bench_callback(TimerHandle_t timer)
+{
+	/* The periods are far longer than a benchmark run. */
+	( void ) timer;
+}
+
+static void timer_bench_measure(uint32_t count, timer_bench_result_t *result)
+{
+	uint32_t total;
+	uint32_t elapsed;
+	uint32_t start;
+	uint32_t seed;
+	uint32_t i;
+
+	/* Periods between 10 and 60 seconds spread the expiry times over the
+	whole structure, and no timer expires while it is being measured. */
+	for (i = 0; i < count; i++) {
+		timer_bench_timers[i] = xTimerCreateStatic("Bench",
+			pdMS_TO_TICKS(10000UL) + ((i * 7919UL) % pdMS_TO_TICKS(50000UL)),
+			pdFALSE, NULL, timer_bench_callback, &timer_bench_buffers[i]);
+		configASSERT(timer_bench_timers[i]);
+	}
+
+	total = 0;
+	for (i = 0; i < count; i++) {
+		start = cycle_counter_get();
+		xTimerStart(timer_bench_timers[i], portMAX_DELAY);
+		total += cycle_counter_get() - start;
+	}
+	result->start_avg = total / count;
+
+	/* Reset the timers in a pseudo random order, a reset moves the timer to
+	the far end of its period. */
+	total = 0;
+	result->reset_max = 0;
+	seed = 1;
+	for (i = 0; i < TIMER_BENCH_RESETS; i++) {
+		seed = seed * 1103515245UL + 12345UL;
+
+		start = cycle_counter_get();
+		xTimerReset(timer_bench_timers[(seed >> 16) % count], portMAX_DELAY);
+		elapsed = cycle_counter_get() - start;
+
+		total += elapsed;
+		if (elapsed > result->reset_max) {
+			result->reset_max = elapsed;
+		}
+	}
+	result->reset_avg = total / TIMER_BENCH_RESETS;
+
+	/* Reset every timer again, TIMER_BENCH_BATCH_SIZE of them per queue
+	message.  Running below the timer task priority, each batch has been
+	applied when xTimerSendCommandBatch() returns. */
+	vTimerCommandBatchInit(&timer_bench_batch, timer_bench_batch_commands, TIMER_BENCH_BATCH_SIZE);
+
+	start = cycle_counter_get();
+	for (i = 0; i < count; i++) {
+		xTimerBatchReset(&timer_bench_batch, timer_bench_timers[i]);
+
+		if ((((i + 1) % TIMER_BENCH_BATCH_SIZE) == 0) || (i == count - 1)) {
+			xTimerSendCommandBatch(&timer_bench_batch, portMAX_DELAY);
+			configASSERT(xTimerCommandBatchIsPending(&timer_bench_batch) == pdFALSE);
+		}
+	}
+	result->batch_avg = (cycle_counter_get() - start) / count;
+
+	total = 0;
+	for (i = 0; i < count; i++) {
+		start = cycle_counter_get();
+		xTimerStop(timer_bench_timers[i], portMAX_DELAY);
+		total += cycle_counter_get() - start;
+	}
+	result->stop_avg = total / count;
+
+	/* The daemon processes the delete commands before this task runs again,
+	after that the buffers can be reused. */
+	for (i = 0; i < count; i++) {
+		xTimerDelete(timer_bench_timers[i], portMAX_DELAY);
+	}
+}
@@ -0,0 +1,437 @@
+/**
+  ******************************************************************************
+  * @file    watchdog.c
+  * @brief   Independent watchdog fed by a supervisor of task heartbeats.
+  *
+  *          A supervised task calls watchdog_heartbeat() at least once in
+  *          every period it was attached with.  The supervisor task checks
+  *          the heartbeats every WATCHDOG_CHECK_PERIOD_MS and feeds the IWDG
+  *          only while none of them is late.  The first time one is late it
+  *          writes the name of the task and how late it is into RAM the
+  *          startup code does not initialize, and stops feeding for good, so
+  *          the IWDG resets the system within WATCHDOG_TIMEOUT_MS even if
+  *          the task recovers.  A system that hangs as a whole, the
+  *          supervisor included, is reset as well, without a culprit.
+  *
+  *          The heartbeat of a task is found through a thread local storage
+  *          pointer, as its CPU budget is (see task_budget.c), a task that
+  *          is not supervised may call watchdog_heartbeat() as well.
+  *
+  *          The reset cause is read from RCC_CSR at startup and the flags
+  *          are cleared.  After an IWDG reset the culprit becomes the last
+  *          one, kept until a power on reset.  The IWDG is only started by
+  *          the supervisor task, the initialization before the scheduler
+  *          starts is not supervised, and is stopped while a debugger
+  *          halts the core.  Once started the IWDG can not be stopped.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "watchdog.h"
+#include "mem_placement.h"
+#include "stm32f4xx_hal.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define WATCHDOG_MAGIC                  0x57444F47UL    /* "WDOG" */
+
+/* IWDG key register values. */
+#define WATCHDOG_KEY_RELOAD             0xAAAAU
+#define WATCHDOG_KEY_ACCESS             0x5555U
+#define WATCHDOG_KEY_START              0xCCCCU
+
+/* The LSI divided by 64 counts in 2 ms steps at 32 kHz. */
+#define WATCHDOG_LSI_HZ                 32000UL
+#define WATCHDOG_PRESCALER              IWDG_PR_PR_2
+#define WATCHDOG_DIVIDER                64UL
+#define WATCHDOG_RELOAD                 ( (WATCHDOG_TIMEOUT_MS * (WATCHDOG_LSI_HZ / 1000UL)) / WATCHDOG_DIVIDER - 1UL )
+
+#if ( WATCHDOG_RELOAD > 0xFFFUL )
+	#error "WATCHDOG_TIMEOUT_MS is longer than the IWDG can count with the prescaler"
+#endif
+
+#if ( WATCHDOG_CHECK_PERIOD_MS * 2U > WATCHDOG_TIMEOUT_MS )
+	#error "The IWDG must be fed at least twice within its timeout"
+#endif
+
+typedef struct {
+	TaskHandle_t          task;         /* NULL if the record is free. */
+	TickType_t            period;
+
+	/* Written by the task, read by the supervisor. */
+	volatile TickType_t   last;
+	uint32_t              beats;
+	TickType_t            longest;      /* Longest time between two heartbeats. */
+} watchdog_client_t;
+
+typedef struct {
+	char                  task[ configMAX_TASK_NAME_LEN ];  /* Empty if the supervisor did not run. */
+	uint32_t              late_ms;
+	uint32_t              period_ms;
+	uint32_t              uptime_ms;
+} watchdog_culprit_t;
+
+/* Kept over a reset, the contents are random after a power on. */
+typedef struct {
+	uint32_t              magic;
+	uint32_t              resets;       /* IWDG resets since the power on. */
+	uint32_t              pending;      /* culprit is set, the IWDG is no longer fed. */
+	watchdog_culprit_t    culprit;
+	uint32_t              has_last;
+	watchdog_culprit_t    last;
+} watchdog_retained_t;
+
+static watchdog_client_t watchdog_clients[ WATCHDOG_MAX_TASKS ];
+static TaskHandle_t watchdog_task_handle = NULL;
+PRIVILEGED_DATA static watchdog_reset_t watchdog_reset;
+PRIVILEGED_DATA static uint32_t watchdog_feeds;
+PRIVILEGED_DATA static bool watchdog_tripped;
+static watchdog_retained_t watchdog_retained NOINIT;
+
+static void watchdog_task(void *params);
+static void watchdog_start(void);
+static watchdog_reset_t watchdog_read_reset_cause(void);
+
+static const char * const watchdog_reset_names[] = {
+	"unknown", "power on", "brown out", "reset pin", "software", "independent watchdog",
+	"window watchdog", "low power"
+};
+
+/**
+  * @brief  Reads the reset cause, takes over the culprit of an IWDG reset and
+  *         creates the supervisor task.
+  * @note   Must be called before the scheduler is started.
+  * @param  None
+  * @retval None
+  */
+void watchdog_init(void)
+{
+	BaseType_t retv;
+
+	watchdog_reset = watchdog_read_reset_cause();
+
+	if ((watchdog_retained.magic != WATCHDOG_MAGIC) ||
+		(watchdog_reset == WATCHDOG_RESET_POWER_ON) || (watchdog_reset == WATCHDOG_RESET_BROWN_OUT)) {
+		memset(&watchdog_retained, 0, sizeof(watchdog_retained));
+		watchdog_retained.magic = WATCHDOG_MAGIC;
+	}
+
+	if (watchdog_reset == WATCHDOG_RESET_IWDG) {
+		watchdog_retained.resets++;
+		watchdog_retained.has_last = 1U;
+		if (watchdog_retained.pending != 0U) {
+			watchdog_retained.last = watchdog_retained.culprit;
+		} else {
+			memset(&watchdog_retained.last, 0, sizeof(watchdog_retained.last));
+		}
+	}
+	watchdog_retained.pending = 0U;
+
+	retv = xTaskCreate(watchdog_task,				/* The supervisor. */
+					   "Watchdog",					/* Text name assigned to the task.  This is just to assist debugging. */
+					   WATCHDOG_TASK_STACK_SIZE,	/* The size of the stack allocated to the task. */
+					   NULL,						/* The parameter is not used, so NULL is passed. */
+					   WATCHDOG_TASK_PRIORITY | portPRIVILEGE_BIT,	/* The priority allocated to the task, privileged as the heartbeats and the trip record are privileged data. */
+					   &watchdog_task_handle );
+	configASSERT( retv == pdPASS );
+}
+
+/**
+  * @brief  Supervises the heartbeats of a task.
+  * @note   The first period starts now.  Attaching a task again changes its
+  *         period.
+  * @param  task: The task, NULL for the calling task
+  * @param  period_ms: Longest time between two heartbeats
+  * @retval true if the task is supervised, false if the period is shorter
+  *         than a check or there are already WATCHDOG_MAX_TASKS tasks
+  */
+bool watchdog_attach(TaskHandle_t task, uint32_t period_ms)
+{
+	watchdog_client_t *client;
+	uint32_t i;
+	bool retv = false;
+
+	if (task == NULL) {
+		task = xTaskGetCurrentTaskHandle();
+	}
+
+	if ((period_ms < WATCHDOG_CHECK_PERIOD_MS) || (task == watchdog_task_handle)) {
+		return false;
+	}
+
+	taskENTER_CRITICAL();
+	{
+		client = pvTaskGetThreadLocalStoragePointer(task, configWATCHDOG_TLS_INDEX);
+
+		for (i = 0; (client == NULL) && (i < WATCHDOG_MAX_TASKS); i++) {
+			if (watchdog_clients[i].task == NULL) {
+				client = &watchdog_clients[i];
+				client->beats   = 0;
+				client->longest = 0;
+			}
+		}
+
+		if (client != NULL) {
+			client->task   = task;
+			client->period = pdMS_TO_TICKS(period_ms);
+			client->last   = xTaskGetTickCount();
+
+			vTaskSetThreadLocalStoragePointer(task, configWATCHDOG_TLS_INDEX, client);
+			retv = true;
+		}
+	}
+	taskEXIT_CRITICAL();
+
+	return retv;
+}
+
+/**
+  * @brief  Stops supervising a task.
+  * @param  task: The task, NULL for the calling task
+  * @retval None
+  */
+void watchdog_detach(TaskHandle_t task)
+{
+	watchdog_client_t *client;
+
+	if (task == NULL) {
+		task = xTaskGetCurrentTaskHandle();
+	}
+
+	taskENTER_CRITICAL();
+	{
+		client = pvTaskGetThreadLocalStoragePointer(task, configWATCHDOG_TLS_INDEX);
+		if (client != NULL) {
+			vTaskSetThreadLocalStoragePointer(task, configWATCHDOG_TLS_INDEX, NULL);
+			client->task = NULL;
+		}
+	}
+	taskEXIT_CRITICAL();
+}
+
+/**
+  * @brief  Tells the supervisor the calling task is alive.
+  * @note   Only the task itself writes its record, the tick count is read
+  *         and stored as one word, so no locking is needed.
+  * @param  None
+  * @retval None
+  */
+void watchdog_heartbeat(void)
+{
+	watchdog_client_t *client;
+	TickType_t now;
+
+	client = pvTaskGetThreadLocalStoragePointer(NULL, configWATCHDOG_TLS_INDEX);
+	if (client == NULL) {
+		return;
+	}
+
+	now = xTaskGetTickCount();
+	if ((TickType_t)(now - client->last) > client->longest) {
+		client->longest = now - client->last;
+	}
+	client->last = now;
+	client->beats++;
+}
+
+watchdog_reset_t watchdog_reset_cause(void)
+{
+	return watchdog_reset;
+}
+
+/**
+  * @brief  Writes the reset cause, the last watchdog culprit and the state of
+  *         the supervised tasks into a buffer.
+  * @param  buffer: the output buffer
+  * @param  length: size of the buffer
+  * @retval None
+  */
+void watchdog_print(char *buffer, size_t length)
+{
+	watchdog_client_t client;
+	char name[ configMAX_TASK_NAME_LEN ];
+	TickType_t now;
+	size_t written;
+	uint32_t i;
+
+	configASSERT(buffer);
+
+	written = snprintf(buffer, length, "\r\nLast reset: %s, watchdog resets since power on: %lu\r\n",
+		watchdog_reset_names[watchdog_reset], ( unsigned long ) watchdog_retained.resets);
+
+	if ((written < length) && (watchdog_retained.has_last != 0U)) {
+		if (watchdog_retained.last.task[0] != '\0') {
+			written += snprintf(buffer + written, length - written,
+				"Last watchdog reset: task %s, heartbeat %lu ms late (period %lu ms), %lu ms after the start\r\n",
+				watchdog_retained.last.task, ( unsigned long ) watchdog_retained.last.late_ms,
+				( unsigned long ) watchdog_retained.last.period_ms, ( unsigned long ) watchdog_retained.last.uptime_ms);
+		} else {
+			written += snprintf(buffer + written, length - written,
+				"Last watchdog reset: the supervisor did not run\r\n");
+		}
+	}
+
+	if (written < length) {
+		written += snprintf(buffer + written, length - written,
+			"IWDG %s, timeout: %lu ms, feeds: %lu\r\n"
+			"Task            Period[ms]  Since[ms]  Longest[ms]  Heartbeats\r\n",
+			(true == watchdog_tripped) ? "no longer fed" : "fed",
+			( unsigned long ) WATCHDOG_TIMEOUT_MS, ( unsigned long ) watchdog_feeds);
+	}
+
+	for (i = 0; (i < WATCHDOG_MAX_TASKS) && (written < length); i++) {
+		taskENTER_CRITICAL();
+		{
+			client = watchdog_clients[i];
+			now = xTaskGetTickCount();
+
+			/* The task can not be deleted while its name is copied. */
+			if (client.task != NULL) {
+				strncpy(name, pcTaskGetName(client.task), sizeof(name) - 1);
+				name[sizeof(name) - 1] = '\0';
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if (client.task == NULL) {
+			continue;
+		}
+
+		written += snprintf(buffer + written, length - written, "%-16s%10lu  %9lu  %11lu  %10lu\r\n",
+			name,
+			( unsigned long ) (client.period * portTICK_PERIOD_MS),
+			( unsigned long ) ((TickType_t)(now - client.last) * portTICK_PERIOD_MS),
+			( unsigned long ) (client.longest * portTICK_PERIOD_MS),
+			( unsigned long ) client.beats);
+	}
+}
+
+/**
+  * @brief  Frees the record of a deleted task.
+  * @note   Called by the kernel in a critical section.
+  * @param  client: thread local storage pointer of the task
+  * @retval None
+  */
+void watchdog_task_deleted(void *client)
+{
+	if (client != NULL) {
+		((watchdog_client_t *)client)->task = NULL;
+	}
+}
+
+static void watchdog_task(void *params)
+{
+	TickType_t wake;
+	TickType_t now;
+	TickType_t late;
+	const watchdog_client_t *culprit;
+	uint32_t i;
+
+	( void ) params;
+
+	watchdog_start();
+	wake = xTaskGetTickCount();
+
+	for (;;) {
+		vTaskDelayUntil(&wake, pdMS_TO_TICKS(WATCHDOG_CHECK_PERIOD_MS));
+
+		if (true == watchdog_tripped) {
+			continue;
+		}
+
+		culprit = NULL;
+		late = 0;
+
+		taskENTER_CRITICAL();
+		{
+			now = xTaskGetTickCount();
+
+			/* The latest task is the culprit. */
+			for (i = 0; i < WATCHDOG_MAX_TASKS; i++) {
+				if ((watchdog_clients[i].task != NULL) &&
+					((TickType_t)(now - watchdog_clients[i].last) > watchdog_clients[i].period) &&
+					((TickType_t)(now - watchdog_clients[i].last - watchdog_clients[i].period) >= late)) {
+					culprit = &watchdog_clients[i];
+					late = now - culprit->last - culprit->period;
+				}
+			}
+
+			if (culprit != NULL) {
+				strncpy(watchdog_retained.culprit.task, pcTaskGetName(culprit->task), configMAX_TASK_NAME_LEN - 1);
+				watchdog_retained.culprit.task[configMAX_TASK_NAME_LEN - 1] = '\0';
+				watchdog_retained.culprit.late_ms   = late * portTICK_PERIOD_MS;
+				watchdog_retained.culprit.period_ms = culprit->period * portTICK_PERIOD_MS;
+				watchdog_retained.culprit.uptime_ms = now * portTICK_PERIOD_MS;
+				watchdog_retained.pending = 1U;
+			}
+		}
+		taskEXIT_CRITICAL();
+
+		if (culprit != NULL) {
+			watchdog_tripped = true;
+		} else {
+			IWDG->KR = WATCHDOG_KEY_RELOAD;
+			watchdog_feeds++;
+		}
+	}
+}
+
+/**
+  * @brief  Starts the IWDG, which also starts the LSI.
+  * @param  None
+  * @retval None
+  */
+static void watchdog_start(void)
+{
+	__HAL_DBGMCU_FREEZE_IWDG();
+
+	IWDG->KR  = WATCHDOG_KEY_START;
+	IWDG->KR  = WATCHDOG_KEY_ACCESS;
+	IWDG->PR  = WATCHDOG_PRESCALER;
+	IWDG->RLR = WATCHDOG_RELOAD;
+
+	/* The new values are taken over in the LSI clock domain. */
+	while ((IWDG->SR & (IWDG_SR_PVU | IWDG_SR_RVU)) != 0U)
+	{
+		vTaskDelay(1);
+	}
+
+	IWDG->KR = WATCHDOG_KEY_RELOAD;
+}
+
+/**
+  * @brief  Reads and clears the reset flags.
+  * @note   A power on reset sets the brown out and pin flags too, and every
+  *         internal reset drives the reset pin, the most specific flag wins.
+  * @param  None
+  * @retval The cause of the last reset
+  */
+static watchdog_reset_t watchdog_read_reset_cause(void)
+{
+	uint32_t csr = RCC->CSR;
+	watchdog_reset_t cause;
+
+	if ((csr & RCC_CSR_LPWRRSTF) != 0U) {
+		cause = WATCHDOG_RESET_LOW_POWER;
+	} else if ((csr & RCC_CSR_WWDGRSTF) != 0U) {
+		cause = WATCHDOG_RESET_WWDG;
+	} else if ((csr & RCC_CSR_IWDGRSTF) != 0U) {
+		cause = WATCHDOG_RESET_IWDG;
+	} else if ((csr & RCC_CSR_SFTRSTF) != 0U) {
+		cause = WATCHDOG_RESET_SOFTWARE;
+	} else if ((csr & RCC_CSR_PORRSTF) != 0U) {
+		cause = WATCHDOG_RESET_POWER_ON;
+	} else if ((csr & RCC_CSR_BORRSTF) != 0U) {
+		cause = WATCHDOG_RESET_BROWN_OUT;
+	} else if ((csr & RCC_CSR_PINRSTF) != 0U) {
+		cause = WATCHDOG_RESET_PIN;
+	} else {
+		cause = WATCHDOG_RESET_UNKNOWN;
+	}
+
+	RCC->CSR |= RCC_CSR_RMVF;
+
+	return cause;
+}
@@ -0,0 +1,153 @@
+/**
+  ******************************************************************************
+  * @file    work_bench.c
+  * @brief   Measures the delay from an interrupt to its deferred work.
+  *
+  *          An hrtimer interrupt callback defers a function call to each
+  *          level of the work queue and to the timer service task with
+  *          xTimerPendFunctionCallFromISR(), WORK_BENCH_SAMPLES times each,
+  *          and the CPU cycles from the submission in the interrupt to the
+  *          start of the function are recorded.  The caller must run below
+  *          all the workers, so it is blocked while a sample is taken and
+  *          only the other tasks of the system compete with the workers.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "work_bench.h"
+#include "work_queue.h"
+#include "hrtimer.h"
+#include "cycle_counter.h"
+#include "FreeRTOS.h"
+#include "task.h"
+#include "timers.h"
+
+#include <stdbool.h>
+#include <stdio.h>
+
+/* The timer service task is measured after the work queue levels. */
+#define WORK_BENCH_DAEMON               WORK_QUEUE_LEVELS
+
+/* Delay of the interrupt after a sample was started. */
+#define WORK_BENCH_DELAY_US             200UL
+
+static const char * const work_bench_names[ WORK_QUEUE_LEVELS + 1 ] = {
+	"Work queue high", "Work queue medium", "Work queue low", "Timer daemon"
+};
+
+static const UBaseType_t work_bench_priorities[ WORK_QUEUE_LEVELS + 1 ] = {
+	WORK_QUEUE_HIGH_PRIORITY, WORK_QUEUE_MEDIUM_PRIORITY, WORK_QUEUE_LOW_PRIORITY, configTIMER_TASK_PRIORITY
+};
+
+static hrtimer_t work_bench_timer;
+static work_queue_item_t work_bench_items[ WORK_QUEUE_LEVELS ];
+static volatile uint32_t work_bench_path;
+static volatile uint32_t work_bench_submitted;
+static volatile uint32_t work_bench_latency;
+static volatile bool work_bench_done;
+
+static void work_bench_interrupt(hrtimer_t *timer, void *arg);
+static void work_bench_work(work_queue_item_t *item, void *arg);
+static void work_bench_pended(void *parameter1, uint32_t parameter2);
+static void work_bench_record(void);
+
+/**
+  * @brief  Runs the benchmark and prints the results.
+  * @param  buffer: Output buffer for the result table
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void work_bench_run(char *buffer, size_t length)
+{
+	uint32_t cycles_per_us;
+	uint32_t total;
+	uint32_t max;
+	uint32_t path;
+	uint32_t i;
+	size_t written;
+
+	configASSERT(buffer);
+
+	if (uxTaskPriorityGet(NULL) >= WORK_QUEUE_LOW_PRIORITY) {
+		snprintf(buffer, length, "\r\nMust run below priority %u.\r\n", ( unsigned ) WORK_QUEUE_LOW_PRIORITY);
+		return;
+	}
+
+	cycles_per_us = SystemCoreClock / 1000000UL;
+
+	hrtimer_create(&work_bench_timer, work_bench_interrupt, NULL, HRTIMER_CONTEXT_ISR);
+	for (i = 0; i < WORK_QUEUE_LEVELS; i++) {
+		work_queue_item_init(&work_bench_items[i], work_bench_work, NULL, (work_queue_level_t)i);
+	}
+
+	written = snprintf(buffer, length,
+		"\r\nPath               Priority  Avg[cycles]  Max[cycles]  Max[us]\r\n");
+
+	for (path = 0; (path <= WORK_BENCH_DAEMON) && (written < length); path++) {
+		work_bench_path = path;
+		total = 0;
+		max = 0;
+
+		for (i = 0; i < WORK_BENCH_SAMPLES; i++) {
+			work_bench_done = false;
+			hrtimer_start(&work_bench_timer, WORK_BENCH_DELAY_US, 0);
+
+			while (true != work_bench_done) {
+				vTaskDelay(1);
+			}
+
+			total += work_bench_latency;
+			if (work_bench_latency > max) {
+				max = work_bench_latency;
+			}
+		}
+
+		written += snprintf(buffer + written, length - written, "%-17s  %8u  %11lu  %11lu  %7lu\r\n",
+			work_bench_names[path],
+			( unsigned ) work_bench_priorities[path],
+			( unsigned long ) (total / WORK_BENCH_SAMPLES),
+			( unsigned long ) max,
+			( unsigned long ) (max / cycles_per_us));
+	}
+}
+
+static void work_bench_interrupt(hrtimer_t *timer, void *arg)
+{
+	BaseType_t xHigherPriorityTaskWoken = pdFALSE;
+
+	( void ) timer;
+	( void ) arg;
+
+	work_bench_submitted = cycle_counter_get();
+
+	if (work_bench_path == WORK_BENCH_DAEMON) {
+		xTimerPendFunctionCallFromISR(work_bench_pended, NULL, 0, &xHigherPriorityTaskWoken);
+	} else {
+		work_queue_submit_from_isr(&work_bench_items[work_bench_path], &xHigherPriorityTaskWoken);
+	}
+
+	portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
+}
+
+static void work_bench_work(work_queue_item_t *item, void *arg)
+{
+	( void ) item;
+	( void ) arg;
+
+	work_bench_record();
+}
+
+static void work_bench_pended(void *parameter1, uint32_t parameter2)
+{
+	( void ) parameter1;
+	( void ) parameter2;
+
+	work_bench_record();
+}
+
+static void work_bench_record(void)
+{
+	work_bench_latency = cycle_counter_get() - work_bench_submitted;
+	work_bench_done = true;
+}
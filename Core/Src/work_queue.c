@@ -0,0 +1,320 @@
+/**
+  ******************************************************************************
+  * @file    work_queue.c
+  * @brief   Deferred work, runs functions submitted by interrupts in one of
+  *          several worker tasks of different priority.
+  *
+  *          An interrupt that has more to do than it should do in interrupt
+  *          context submits a work item at the level that matches the
+  *          urgency of the work, and the worker task of that level runs the
+  *          function of the item.  Unlike xTimerPendFunctionCallFromISR(),
+  *          which queues every request to the single timer service task, the
+  *          levels are independent, so urgent work is not held up behind
+  *          timer commands or slow low priority work.
+  *
+  *          Each level has a lock free LIFO list of submitted items.  An item
+  *          is claimed through its pending flag and pushed onto the list
+  *          with LDREX/STREX, so submitting never masks interrupts, does not
+  *          depend on the number of queued items and can not fail for lack
+  *          of space.  The worker detaches the whole list at once, reverses
+  *          it to restore the submission order and runs the items.  An item
+  *          that is submitted again before it started running is coalesced
+  *          with the pending submission, as the function has not yet seen
+  *          the state that triggered either of them.  The pending flag is
+  *          cleared just before the function is called, so the function may
+  *          submit its own item again.
+  *
+  *          The worker is notified only when an item is pushed onto an
+  *          empty list, the list can only be empty while the worker has run
+  *          everything it detached or is waiting for a notification.
+  *
+  *          The exception entry clears the exclusive monitor, so a sequence
+  *          interrupted by a nested submission is retried.  Interrupts above
+  *          configMAX_SYSCALL_INTERRUPT_PRIORITY must not submit, the worker
+  *          is notified through the FreeRTOS API.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "work_queue.h"
+#include "cycle_counter.h"
+
+#include <stdio.h>
+
+typedef struct {
+	work_queue_item_t * volatile head;
+	TaskHandle_t                 worker;
+	volatile uint32_t            coalesced;
+	uint32_t                     executed;
+	uint32_t                     max_latency;
+	uint32_t                     max_run;
+} work_queue_t;
+
+static work_queue_t work_queues[ WORK_QUEUE_LEVELS ];
+
+static const UBaseType_t work_queue_priorities[ WORK_QUEUE_LEVELS ] = {
+	WORK_QUEUE_HIGH_PRIORITY,
+	WORK_QUEUE_MEDIUM_PRIORITY,
+	WORK_QUEUE_LOW_PRIORITY
+};
+
+static const char * const work_queue_names[ WORK_QUEUE_LEVELS ] = { "WorkHigh", "WorkMedium", "WorkLow" };
+
+static void work_queue_task(void *params);
+static bool work_queue_push(work_queue_item_t *item, bool *was_empty);
+
+/**
+  * @brief  Creates the worker tasks.
+  * @note   Must be called before the scheduler is started.
+  * @param  None
+  * @retval None
+  */
+void work_queue_init(void)
+{
+	BaseType_t retv;
+	uint32_t i;
+
+	cycle_counter_init();
+
+	for (i = 0; i < WORK_QUEUE_LEVELS; i++) {
+		retv = xTaskCreate(work_queue_task,				/* The task that runs the items of one level. */
+						   work_queue_names[i],			/* Text name assigned to the task.  This is just to assist debugging. */
+						   WORK_QUEUE_TASK_STACK_SIZE,	/* The size of the stack allocated to the task. */
+						   &work_queues[i],				/* The parameter is the level the task serves. */
+						   work_queue_priorities[i] | portPRIVILEGE_BIT,	/* The priority allocated to the task, privileged as it runs the items of every module, the config store writes included. */
+						   &work_queues[i].worker );
+		configASSERT( retv == pdPASS );
+	}
+}
+
+/**
+  * @brief  Initializes a work item.
+  * @note   The item must not be pending.
+  * @param  item: The item to initialize
+  * @param  function: The function to run in the worker task
+  * @param  arg: Passed to the function
+  * @param  level: Selects the worker task that runs the function
+  * @retval None
+  */
+void work_queue_item_init(work_queue_item_t *item, work_queue_function_t function, void *arg, work_queue_level_t level)
+{
+	configASSERT(item);
+	configASSERT(function);
+	configASSERT(level < WORK_QUEUE_LEVELS);
+
+	item->next      = NULL;
+	item->function  = function;
+	item->arg       = arg;
+	item->pending   = 0;
+	item->submitted = 0;
+	item->level     = (uint8_t)level;
+}
+
+/**
+  * @brief  Submits a work item from a task.
+  * @param  item: The item to run
+  * @retval true if the item was queued, false if it was still pending from
+  *         an earlier submission
+  */
+bool work_queue_submit(work_queue_item_t *item)
+{
+	bool was_empty;
+
+	if (true != work_queue_push(item, &was_empty)) {
+		return false;
+	}
+
+	if (true == was_empty) {
+		xTaskNotifyGive(work_queues[item->level].worker);
+	}
+
+	return true;
+}
+
+/**
+  * @brief  Submits a work item from an interrupt.
+  * @param  item: The item to run
+  * @param  higher_priority_task_woken: Set to pdTRUE if a context switch
+  *         should be requested before the interrupt exits
+  * @retval true if the item was queued, false if it was still pending from
+  *         an earlier submission
+  */
+bool work_queue_submit_from_isr(work_queue_item_t *item, BaseType_t *higher_priority_task_woken)
+{
+	bool was_empty;
+
+	if (true != work_queue_push(item, &was_empty)) {
+		return false;
+	}
+
+	if (true == was_empty) {
+		vTaskNotifyGiveFromISR(work_queues[item->level].worker, higher_priority_task_woken);
+	}
+
+	return true;
+}
+
+/**
+  * @brief  Checks whether a work item is waiting to be run.
+  * @param  item: The item to check
+  * @retval true if the item was submitted and its function was not called yet
+  */
+bool work_queue_is_pending(const work_queue_item_t *item)
+{
+	configASSERT(item);
+
+	return item->pending != 0;
+}
+
+/**
+  * @brief  Returns the statistics of a level.
+  * @param  level: The level to query
+  * @param  stats: Filled in with the statistics
+  * @retval None
+  */
+void work_queue_get_stats(work_queue_level_t level, work_queue_stats_t *stats)
+{
+	uint32_t cycles_per_us;
+
+	configASSERT(level < WORK_QUEUE_LEVELS);
+	configASSERT(stats);
+
+	cycles_per_us = SystemCoreClock / 1000000UL;
+
+	/* The worker updates the counters, the copy is taken in one piece. */
+	taskENTER_CRITICAL();
+	{
+		stats->executed       = work_queues[level].executed;
+		stats->coalesced      = work_queues[level].coalesced;
+		stats->max_latency_us = work_queues[level].max_latency / cycles_per_us;
+		stats->max_run_us     = work_queues[level].max_run / cycles_per_us;
+	}
+	taskEXIT_CRITICAL();
+}
+
+/**
+  * @brief  Prints the statistics of every level.
+  * @param  buffer: Output buffer for the table
+  * @param  length: Size of the output buffer
+  * @retval None
+  */
+void work_queue_print(char *buffer, size_t length)
+{
+	work_queue_stats_t stats;
+	size_t written;
+	uint32_t i;
+
+	configASSERT(buffer);
+
+	written = snprintf(buffer, length,
+		"\r\nWorker      Priority  Executed  Coalesced  Max latency[us]  Max run[us]\r\n");
+
+	for (i = 0; (i < WORK_QUEUE_LEVELS) && (written < length); i++) {
+		work_queue_get_stats((work_queue_level_t)i, &stats);
+
+		written += snprintf(buffer + written, length - written, "%-10s  %8u  %8lu  %9lu  %15lu  %11lu\r\n",
+			work_queue_names[i],
+			( unsigned ) work_queue_priorities[i],
+			( unsigned long ) stats.executed,
+			( unsigned long ) stats.coalesced,
+			( unsigned long ) stats.max_latency_us,
+			( unsigned long ) stats.max_run_us);
+	}
+}
+
+static void work_queue_task(void *params)
+{
+	work_queue_t *queue = params;
+	work_queue_item_t *list;
+	work_queue_item_t *item;
+	work_queue_item_t *next;
+	uint32_t start;
+	uint32_t elapsed;
+
+	for (;;) {
+		ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+
+		/* Detach everything submitted so far, later submissions start a new
+		list and notify again. */
+		do {
+			list = (work_queue_item_t *)__LDREXW((volatile uint32_t *)&queue->head);
+		} while (__STREXW(0, (volatile uint32_t *)&queue->head) != 0);
+
+		/* The list is newest first, reverse it to run the items in the order
+		they were submitted. */
+		item = NULL;
+		while (list != NULL) {
+			next = list->next;
+			list->next = item;
+			item = list;
+			list = next;
+		}
+
+		while (item != NULL) {
+			next = item->next;
+
+			start = cycle_counter_get();
+			elapsed = start - item->submitted;
+			if (elapsed > queue->max_latency) {
+				queue->max_latency = elapsed;
+			}
+
+			/* The item may be submitted again from here on, its members must
+			have been read before. */
+			__DMB();
+			item->pending = 0;
+
+			item->function(item, item->arg);
+
+			elapsed = cycle_counter_get() - start;
+			if (elapsed > queue->max_run) {
+				queue->max_run = elapsed;
+			}
+			queue->executed++;
+
+			item = next;
+		}
+	}
+}
+
+static bool work_queue_push(work_queue_item_t *item, bool *was_empty)
+{
+	work_queue_t *queue;
+	work_queue_item_t *head;
+	uint32_t coalesced;
+
+	configASSERT(item);
+	configASSERT(item->function);
+
+	queue = &work_queues[item->level];
+
+	/* Claim the item, only the submitter that sets the pending flag may link
+	it into the list. */
+	do {
+		if (__LDREXW(&item->pending) != 0) {
+			__CLREX();
+
+			do {
+				coalesced = __LDREXW(&queue->coalesced);
+			} while (__STREXW(coalesced + 1U, &queue->coalesced) != 0);
+
+			return false;
+		}
+	} while (__STREXW(1, &item->pending) != 0);
+
+	item->submitted = cycle_counter_get();
+
+	do {
+		head = (work_queue_item_t *)__LDREXW((volatile uint32_t *)&queue->head);
+		item->next = head;
+
+		/* The item must be complete before it becomes visible to the
+		worker. */
+		__DMB();
+	} while (__STREXW((uint32_t)item, (volatile uint32_t *)&queue->head) != 0);
+
+	*was_empty = (head == NULL);
+
+	return true;
+}
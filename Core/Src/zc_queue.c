@@ -0,0 +1,314 @@
+/**
+  ******************************************************************************
+  * @file    zc_queue.c
+  * @brief   Zero copy queue, passes buffer ownership instead of copying.
+  *
+  *          A pool of fixed size buffers is shared by a producer and a
+  *          consumer through two FreeRTOS queues that only carry buffer
+  *          pointers.  The free queue holds the buffers nobody owns, the
+  *          full queue the buffers that were filled and sent.  A producer
+  *          acquires a buffer from the free queue, fills it in place and
+  *          sends it, the consumer receives it, uses it in place and
+  *          releases it back to the free queue.  Only the 4 byte pointer is
+  *          copied into and out of the queue storage, whatever the size of
+  *          the payload.
+  *
+  *          Blocking follows the FreeRTOS queue semantics: acquire blocks
+  *          while every buffer is in use, receive blocks while nothing has
+  *          been sent.  Sending and releasing never block, the queues are as
+  *          long as the pool so there is always room for a buffer that came
+  *          out of it.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "zc_queue.h"
+#include "FreeRTOS.h"
+#include "queue.h"
+
+struct zc_queue {
+	QueueHandle_t  free_queue;
+	QueueHandle_t  full_queue;
+	uint8_t       *pool;
+	size_t         item_size;
+	uint32_t       item_count;
+};
+
+/* Each buffer starts on a portBYTE_ALIGNMENT boundary, so any structure can
+be built in place. */
+#define ZC_QUEUE_ALIGN(size)    ( ( ( size ) + ( portBYTE_ALIGNMENT - 1U ) ) & ~( ( size_t ) portBYTE_ALIGNMENT_MASK ) )
+
+static bool zc_queue_owns(const zc_queue_t *queue, const void *item);
+
+/**
+  * @brief  Creates a zero copy queue and its buffer pool.
+  * @note   The control block, the pool and both pointer queues are allocated
+  *         from the FreeRTOS heap.
+  * @param  item_size: Size of one buffer in bytes
+  * @param  item_count: Number of buffers in the pool
+  * @retval The new queue, NULL if there was not enough heap
+  */
+zc_queue_t *zc_queue_create(size_t item_size, uint32_t item_count)
+{
+	zc_queue_t *queue;
+	uint32_t i;
+	void *item;
+
+	configASSERT(item_size > 0);
+	configASSERT(item_count > 0);
+
+	item_size = ZC_QUEUE_ALIGN(item_size);
+
+	/* The pool follows the control block in the same allocation. */
+	queue = pvPortMalloc(ZC_QUEUE_ALIGN(sizeof(zc_queue_t)) + (item_size * item_count));
+	if (queue == NULL) {
+		return NULL;
+	}
+
+	queue->pool       = (uint8_t *)queue + ZC_QUEUE_ALIGN(sizeof(zc_queue_t));
+	queue->item_size  = item_size;
+	queue->item_count = item_count;
+	queue->free_queue = xQueueCreate(item_count, sizeof(void *));
+	queue->full_queue = xQueueCreate(item_count, sizeof(void *));
+
+	if ((queue->free_queue == NULL) || (queue->full_queue == NULL)) {
+		zc_queue_delete(queue);
+		return NULL;
+	}
+
+	for (i = 0; i < item_count; i++) {
+		item = &queue->pool[i * item_size];
+		xQueueSendToBack(queue->free_queue, &item, 0);
+	}
+
+	return queue;
+}
+
+/**
+  * @brief  Deletes a zero copy queue.
+  * @note   No task may be blocked on the queue and no buffer may be in use.
+  * @param  queue: The queue to delete
+  * @retval None
+  */
+void zc_queue_delete(zc_queue_t *queue)
+{
+	configASSERT(queue);
+
+	if (queue->free_queue != NULL) {
+		vQueueDelete(queue->free_queue);
+	}
+
+	if (queue->full_queue != NULL) {
+		vQueueDelete(queue->full_queue);
+	}
+
+	vPortFree(queue);
+}
+
+/**
+  * @brief  Takes ownership of a free buffer.
+  * @param  queue: The queue the buffer belongs to
+  * @param  ticks_to_wait: Maximum time to wait for a buffer to be released
+  * @retval The buffer, NULL if none became free in time
+  */
+void *zc_queue_acquire(zc_queue_t *queue, TickType_t ticks_to_wait)
+{
+	void *item = NULL;
+
+	configASSERT(queue);
+
+	if (xQueueReceive(queue->free_queue, &item, ticks_to_wait) != pdPASS) {
+		item = NULL;
+	}
+
+	return item;
+}
+
+/**
+  * @brief  Takes ownership of a free buffer from an interrupt.
+  * @param  queue: The queue the buffer belongs to
+  * @param  higher_priority_task_woken: Set to pdTRUE if a context switch
+  *         should be requested before the interrupt exits
+  * @retval The buffer, NULL if all buffers are in use
+  */
+void *zc_queue_acquire_from_isr(zc_queue_t *queue, BaseType_t *higher_priority_task_woken)
+{
+	void *item = NULL;
+
+	configASSERT(queue);
+
+	if (xQueueReceiveFromISR(queue->free_queue, &item, higher_priority_task_woken) != pdPASS) {
+		item = NULL;
+	}
+
+	return item;
+}
+
+/**
+  * @brief  Hands a filled buffer over to the consumer.
+  * @note   The caller must not touch the buffer afterwards.
+  * @param  queue: The queue the buffer belongs to
+  * @param  item: A buffer returned by zc_queue_acquire()
+  * @retval None
+  */
+void zc_queue_send(zc_queue_t *queue, void *item)
+{
+	BaseType_t retv;
+
+	configASSERT(queue);
+	configASSERT(zc_queue_owns(queue, item));
+
+	retv = xQueueSendToBack(queue->full_queue, &item, 0);
+	configASSERT(retv == pdPASS);
+	( void ) retv;
+}
+
+/**
+  * @brief  Hands a filled buffer over to the consumer from an interrupt.
+  * @param  queue: The queue the buffer belongs to
+  * @param  item: A buffer returned by zc_queue_acquire_from_isr()
+  * @param  higher_priority_task_woken: Set to pdTRUE if a context switch
+  *         should be requested before the interrupt exits
+  * @retval None
+  */
+void zc_queue_send_from_isr(zc_queue_t *queue, void *item, BaseType_t *higher_priority_task_woken)
+{
+	BaseType_t retv;
+
+	configASSERT(queue);
+	configASSERT(zc_queue_owns(queue, item));
+
+	retv = xQueueSendToBackFromISR(queue->full_queue, &item, higher_priority_task_woken);
+	configASSERT(retv == pdPASS);
+	( void ) retv;
+}
+
+/**
+  * @brief  Takes ownership of the oldest buffer that was sent.
+  * @param  queue: The queue to receive from
+  * @param  ticks_to_wait: Maximum time to wait for a buffer to be sent
+  * @retval The buffer, NULL if nothing was sent in time.  It must be given
+  *         back with zc_queue_release() once it is no longer needed.
+  */
+void *zc_queue_receive(zc_queue_t *queue, TickType_t ticks_to_wait)
+{
+	void *item = NULL;
+
+	configASSERT(queue);
+
+	if (xQueueReceive(queue->full_queue, &item, ticks_to_wait) != pdPASS) {
+		item = NULL;
+	}
+
+	return item;
+}
+
+/**
+  * @brief  Takes ownership of the oldest buffer that was sent, from an
+  *         interrupt.
+  * @param  queue: The queue to receive from
+  * @param  higher_priority_task_woken: Set to pdTRUE if a context switch
+  *         should be requested before the interrupt exits
+  * @retval The buffer, NULL if the queue is empty
+  */
+void *zc_queue_receive_from_isr(zc_queue_t *queue, BaseType_t *higher_priority_task_woken)
+{
+	void *item = NULL;
+
+	configASSERT(queue);
+
+	if (xQueueReceiveFromISR(queue->full_queue, &item, higher_priority_task_woken) != pdPASS) {
+		item = NULL;
+	}
+
+	return item;
+}
+
+/**
+  * @brief  Returns a buffer to the pool.
+  * @param  queue: The queue the buffer belongs to
+  * @param  item: A buffer that was received or acquired
+  * @retval None
+  */
+void zc_queue_release(zc_queue_t *queue, void *item)
+{
+	BaseType_t retv;
+
+	configASSERT(queue);
+	configASSERT(zc_queue_owns(queue, item));
+
+	retv = xQueueSendToBack(queue->free_queue, &item, 0);
+	configASSERT(retv == pdPASS);
+	( void ) retv;
+}
+
+/**
+  * @brief  Returns a buffer to the pool from an interrupt.
+  * @param  queue: The queue the buffer belongs to
+  * @param  item: A buffer that was received or acquired
+  * @param  higher_priority_task_woken: Set to pdTRUE if a context switch
+  *         should be requested before the interrupt exits
+  * @retval None
+  */
+void zc_queue_release_from_isr(zc_queue_t *queue, void *item, BaseType_t *higher_priority_task_woken)
+{
+	BaseType_t retv;
+
+	configASSERT(queue);
+	configASSERT(zc_queue_owns(queue, item));
+
+	retv = xQueueSendToBackFromISR(queue->free_queue, &item, higher_priority_task_woken);
+	configASSERT(retv == pdPASS);
+	( void ) retv;
+}
+
+/**
+  * @brief  Returns the usable size of one buffer.
+  * @param  queue: The queue to query
+  * @retval The requested item size rounded up to portBYTE_ALIGNMENT
+  */
+size_t zc_queue_get_item_size(const zc_queue_t *queue)
+{
+	configASSERT(queue);
+
+	return queue->item_size;
+}
+
+/**
+  * @brief  Returns the number of buffers that can be acquired.
+  * @param  queue: The queue to query
+  * @retval Number of free buffers
+  */
+uint32_t zc_queue_get_free_count(const zc_queue_t *queue)
+{
+	configASSERT(queue);
+
+	return (uint32_t)uxQueueMessagesWaiting(queue->free_queue);
+}
+
+/**
+  * @brief  Returns the number of buffers sent but not yet received.
+  * @param  queue: The queue to query
+  * @retval Number of waiting buffers
+  */
+uint32_t zc_queue_get_waiting_count(const zc_queue_t *queue)
+{
+	configASSERT(queue);
+
+	return (uint32_t)uxQueueMessagesWaiting(queue->full_queue);
+}
+
+static bool zc_queue_owns(const zc_queue_t *queue, const void *item)
+{
+	const uint8_t *p = item;
+	size_t offset;
+
+	if ((p < queue->pool) || (p >= &queue->pool[queue->item_size * queue->item_count])) {
+		return false;
+	}
+
+	offset = (size_t)(p - queue->pool);
+
+	return (offset % queue->item_size) == 0;
+}
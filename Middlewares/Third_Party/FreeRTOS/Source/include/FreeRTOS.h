@@ -302,6 +302,29 @@
         #error If configUSE_TIMERS is set to 1 then configTIMER_TASK_STACK_DEPTH must also be defined.
     #endif /* configTIMER_TASK_STACK_DEPTH */
 
+/* Set configUSE_TIMER_WHEEL to 1 to keep the active timers in a hierarchical
+ * timing wheel instead of the two sorted active timer lists.  Starting,
+ * stopping and resetting a timer is then O(1) regardless of the number of
+ * active timers. */
+    #ifndef configUSE_TIMER_WHEEL
+        #define configUSE_TIMER_WHEEL    0
+    #endif
+
+/* Each level of the wheel has 32 slots and covers 32 times the span of the
+ * level below it, so the wheel covers 2^( 5 * configTIMER_WHEEL_LEVELS ) ticks.
+ * Timers that expire further out than that wait in an overflow list. */
+    #ifndef configTIMER_WHEEL_LEVELS
+        #define configTIMER_WHEEL_LEVELS    4
+    #endif
+
+    #if ( configUSE_TIMER_WHEEL == 1 )
+        #if ( configUSE_16_BIT_TICKS == 1 ) && ( ( configTIMER_WHEEL_LEVELS < 1 ) || ( configTIMER_WHEEL_LEVELS > 2 ) )
+            #error configTIMER_WHEEL_LEVELS must be 1 or 2 when configUSE_16_BIT_TICKS is 1.
+        #elif ( configTIMER_WHEEL_LEVELS < 1 ) || ( configTIMER_WHEEL_LEVELS > 6 )
+            #error configTIMER_WHEEL_LEVELS must be between 1 and 6.
+        #endif
+    #endif /* configUSE_TIMER_WHEEL */
+
 #endif /* configUSE_TIMERS */
 
 #ifndef portSET_INTERRUPT_MASK_FROM_ISR
@@ -834,6 +857,36 @@
     #define configUSE_TIME_SLICING    1
 #endif
 
+/* Set configUSE_EDF_SCHEDULING to 1 to schedule the periodic tasks registered
+ * with xTaskEdfRegister() earliest deadline first.  They all run at
+ * configEDF_PRIORITY, which should not be used by any other task, while the
+ * other priorities keep the fixed priority scheduling. */
+#ifndef configUSE_EDF_SCHEDULING
+    #define configUSE_EDF_SCHEDULING    0
+#endif
+
+#ifndef configEDF_PRIORITY
+    #define configEDF_PRIORITY    ( configMAX_PRIORITIES - 2 )
+#endif
+
+/* Upper bound of the summed densities ( WCET / min( deadline, period ) ) of
+ * the registered tasks, in parts per million.  1000000 admits any task set
+ * that EDF can schedule when each deadline equals the period, a lower value
+ * leaves room for the tasks above configEDF_PRIORITY and for interrupts. */
+#ifndef configEDF_MAX_DENSITY_PPM
+    #define configEDF_MAX_DENSITY_PPM    1000000UL
+#endif
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+    #if ( configEDF_PRIORITY < 1 ) || ( configEDF_PRIORITY >= configMAX_PRIORITIES )
+        #error configEDF_PRIORITY must be above the idle priority and below configMAX_PRIORITIES.
+    #endif
+
+    #if ( INCLUDE_xTaskDelayUntil != 1 ) || ( INCLUDE_vTaskPrioritySet != 1 )
+        #error configUSE_EDF_SCHEDULING requires INCLUDE_xTaskDelayUntil and INCLUDE_vTaskPrioritySet.
+    #endif
+#endif /* configUSE_EDF_SCHEDULING */
+
 #ifndef configINCLUDE_APPLICATION_DEFINED_PRIVILEGED_FUNCTIONS
     #define configINCLUDE_APPLICATION_DEFINED_PRIVILEGED_FUNCTIONS    0
 #endif
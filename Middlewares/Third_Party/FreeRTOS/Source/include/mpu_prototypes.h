@@ -120,6 +120,16 @@ BaseType_t MPU_xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut,
 void MPU_vTaskMissedYield( void ) FREERTOS_SYSTEM_CALL;
 BaseType_t MPU_xTaskGetSchedulerState( void ) FREERTOS_SYSTEM_CALL;
 BaseType_t MPU_xTaskCatchUpTicks( TickType_t xTicksToCatchUp ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xTaskEdfRegister( TaskHandle_t xTask,
+                                 TickType_t xPeriod,
+                                 TickType_t xRelativeDeadline,
+                                 uint32_t ulWcetUs ) FREERTOS_SYSTEM_CALL;
+void MPU_vTaskEdfUnregister( TaskHandle_t xTask,
+                             UBaseType_t uxPriority ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xTaskEdfWaitForNextPeriod( void ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xTaskEdfGetInfo( TaskHandle_t xTask,
+                                EdfTaskStatus_t * pxEdfStatus ) FREERTOS_SYSTEM_CALL;
+uint32_t MPU_ulTaskEdfGetDensity( void ) FREERTOS_SYSTEM_CALL;
 
 /* MPU versions of queue.h API functions. */
 BaseType_t MPU_xQueueGenericSend( QueueHandle_t xQueue,
@@ -208,6 +218,16 @@ BaseType_t MPU_xTimerGenericCommand( TimerHandle_t xTimer,
                                      const TickType_t xOptionalValue,
                                      BaseType_t * const pxHigherPriorityTaskWoken,
                                      const TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+void MPU_vTimerCommandBatchInit( TimerCommandBatch_t * pxBatch,
+                                 TimerBatchCommand_t * pxCommands,
+                                 UBaseType_t uxMaxCommands ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xTimerCommandBatchAdd( TimerCommandBatch_t * pxBatch,
+                                      BaseType_t xCommandID,
+                                      TimerHandle_t xTimer,
+                                      TickType_t xNewPeriod ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xTimerSendCommandBatch( TimerCommandBatch_t * pxBatch,
+                                       TickType_t xTicksToWait ) FREERTOS_SYSTEM_CALL;
+BaseType_t MPU_xTimerCommandBatchIsPending( const TimerCommandBatch_t * pxBatch ) FREERTOS_SYSTEM_CALL;
 
 /* MPU versions of event_group.h API functions. */
 EventGroupHandle_t MPU_xEventGroupCreate( void ) FREERTOS_SYSTEM_CALL;
@@ -84,6 +84,11 @@
         #define xTaskGenericNotifyStateClear           MPU_xTaskGenericNotifyStateClear
         #define ulTaskGenericNotifyValueClear          MPU_ulTaskGenericNotifyValueClear
         #define xTaskCatchUpTicks                      MPU_xTaskCatchUpTicks
+        #define xTaskEdfRegister                       MPU_xTaskEdfRegister
+        #define vTaskEdfUnregister                     MPU_vTaskEdfUnregister
+        #define xTaskEdfWaitForNextPeriod              MPU_xTaskEdfWaitForNextPeriod
+        #define xTaskEdfGetInfo                        MPU_xTaskEdfGetInfo
+        #define ulTaskEdfGetDensity                    MPU_ulTaskEdfGetDensity
 
         #define xTaskGetCurrentTaskHandle              MPU_xTaskGetCurrentTaskHandle
         #define vTaskSetTimeOutState                   MPU_vTaskSetTimeOutState
@@ -133,6 +138,10 @@
         #define xTimerGetPeriod                        MPU_xTimerGetPeriod
         #define xTimerGetExpiryTime                    MPU_xTimerGetExpiryTime
         #define xTimerGenericCommand                   MPU_xTimerGenericCommand
+        #define vTimerCommandBatchInit                 MPU_vTimerCommandBatchInit
+        #define xTimerCommandBatchAdd                  MPU_xTimerCommandBatchAdd
+        #define xTimerSendCommandBatch                 MPU_xTimerSendCommandBatch
+        #define xTimerCommandBatchIsPending            MPU_xTimerCommandBatchIsPending
 
 /* Map standard event_group.h API functions to the MPU equivalents. */
         #define xEventGroupCreate                      MPU_xEventGroupCreate
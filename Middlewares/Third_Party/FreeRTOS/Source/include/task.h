@@ -164,6 +164,19 @@ typedef struct xTASK_STATUS
     configSTACK_DEPTH_TYPE usStackHighWaterMark;  /* The minimum amount of stack space that has remained for the task since the task was created.  The closer this value is to zero the closer the task has come to overflowing its stack. */
 } TaskStatus_t;
 
+/* Used with the xTaskEdfGetInfo() function to return the parameters and the
+ * deadline statistics of a task scheduled earliest deadline first. */
+typedef struct xEDF_TASK_STATUS
+{
+    TickType_t xPeriod;           /* Time between the releases of two jobs. */
+    TickType_t xRelativeDeadline; /* Time from the release of a job to its deadline. */
+    uint32_t ulWcetUs;            /* Worst case execution time of a job, in microseconds, as given to xTaskEdfRegister(). */
+    TickType_t xDeadline;         /* Absolute deadline of the current job. */
+    uint32_t ulJobs;              /* Number of jobs completed. */
+    uint32_t ulMisses;            /* Number of jobs completed after their deadline. */
+    TickType_t xMaxLateness;      /* Largest time by which a job missed its deadline. */
+} EdfTaskStatus_t;
+
 /* Possible return values for eTaskConfirmSleepModeStatus(). */
 typedef enum
 {
@@ -2895,6 +2908,149 @@ BaseType_t xTaskCheckForTimeOut( TimeOut_t * const pxTimeOut,
  */
 BaseType_t xTaskCatchUpTicks( TickType_t xTicksToCatchUp ) PRIVILEGED_FUNCTION;
 
+/**
+ * task.h
+ * @code{c}
+ * BaseType_t xTaskEdfRegister( TaskHandle_t xTask, TickType_t xPeriod, TickType_t xRelativeDeadline, uint32_t ulWcetUs );
+ * @endcode
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * Makes a periodic task scheduled earliest deadline first.  The task is moved
+ * to configEDF_PRIORITY, where the ready task with the earliest absolute
+ * deadline runs first.  Tasks of other priorities are not affected, so the
+ * deadline scheduled tasks only get the processor time the tasks above
+ * configEDF_PRIORITY leave.
+ *
+ * The task is admitted if the summed densities ( ulWcetUs divided by the
+ * smaller of xRelativeDeadline and xPeriod ) of all registered tasks stay
+ * within configEDF_MAX_DENSITY_PPM.  When every deadline equals the period
+ * this is the exact EDF test ( utilisation <= 1 ), otherwise it is sufficient
+ * but pessimistic.
+ *
+ * The first job is released when this function is called.  The task calls
+ * xTaskEdfWaitForNextPeriod() at the end of every job.
+ *
+ * @param xTask The task to register, NULL for the calling task.
+ *
+ * @param xPeriod Time between the releases of two jobs, in ticks.
+ *
+ * @param xRelativeDeadline Time from the release of a job to its deadline, in
+ * ticks.
+ *
+ * @param ulWcetUs Worst case execution time of a job, in microseconds.
+ *
+ * @return pdPASS if the task was admitted, pdFAIL if the admission test
+ * failed or the task is already registered.
+ *
+ * Example usage:
+ * @code{c}
+ * void vSamplingTask( void * pvParameters )
+ * {
+ *     // 10 ms period, 5 ms deadline, at most 800 us per job.
+ *     xTaskEdfRegister( NULL, pdMS_TO_TICKS( 10 ), pdMS_TO_TICKS( 5 ), 800 );
+ *
+ *     for( ;; )
+ *     {
+ *         vSampleAndFilter();
+ *         xTaskEdfWaitForNextPeriod();
+ *     }
+ * }
+ * @endcode
+ * \defgroup xTaskEdfRegister xTaskEdfRegister
+ * \ingroup TaskCtrl
+ */
+BaseType_t xTaskEdfRegister( TaskHandle_t xTask,
+                             TickType_t xPeriod,
+                             TickType_t xRelativeDeadline,
+                             uint32_t ulWcetUs ) PRIVILEGED_FUNCTION;
+
+/**
+ * task.h
+ * @code{c}
+ * void vTaskEdfUnregister( TaskHandle_t xTask, UBaseType_t uxPriority );
+ * @endcode
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * Returns a task registered with xTaskEdfRegister() to fixed priority
+ * scheduling.  Deleting a registered task unregisters it as well.
+ *
+ * @param xTask The task to unregister, NULL for the calling task.
+ *
+ * @param uxPriority The fixed priority the task continues at.
+ *
+ * \defgroup vTaskEdfUnregister vTaskEdfUnregister
+ * \ingroup TaskCtrl
+ */
+void vTaskEdfUnregister( TaskHandle_t xTask,
+                         UBaseType_t uxPriority ) PRIVILEGED_FUNCTION;
+
+/**
+ * task.h
+ * @code{c}
+ * BaseType_t xTaskEdfWaitForNextPeriod( void );
+ * @endcode
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * Ends the current job of the calling task, which must be registered with
+ * xTaskEdfRegister(), and blocks until the next job is released.  A job that
+ * completes after its deadline is counted as a miss.  If the job overran the
+ * next release the function returns at once, so the late jobs are run back to
+ * back until the task has caught up.
+ *
+ * @return pdPASS if the job met its deadline, pdFAIL if it missed it.
+ *
+ * \defgroup xTaskEdfWaitForNextPeriod xTaskEdfWaitForNextPeriod
+ * \ingroup TaskCtrl
+ */
+BaseType_t xTaskEdfWaitForNextPeriod( void ) PRIVILEGED_FUNCTION;
+
+/**
+ * task.h
+ * @code{c}
+ * BaseType_t xTaskEdfGetInfo( TaskHandle_t xTask, EdfTaskStatus_t * pxEdfStatus );
+ * @endcode
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * Returns the deadline parameters and statistics of a task.
+ *
+ * @param xTask The task to query, NULL for the calling task.
+ *
+ * @param pxEdfStatus Filled in with the information about the task.
+ *
+ * @return pdTRUE if the task is registered with xTaskEdfRegister(), otherwise
+ * pdFALSE and pxEdfStatus is not changed.
+ *
+ * \defgroup xTaskEdfGetInfo xTaskEdfGetInfo
+ * \ingroup TaskUtils
+ */
+BaseType_t xTaskEdfGetInfo( TaskHandle_t xTask,
+                            EdfTaskStatus_t * pxEdfStatus ) PRIVILEGED_FUNCTION;
+
+/**
+ * task.h
+ * @code{c}
+ * uint32_t ulTaskEdfGetDensity( void );
+ * @endcode
+ *
+ * configUSE_EDF_SCHEDULING must be defined as 1 for this function to be
+ * available.
+ *
+ * @return The summed densities of the registered tasks, in parts per million,
+ * as used by the admission test.
+ *
+ * \defgroup ulTaskEdfGetDensity ulTaskEdfGetDensity
+ * \ingroup TaskUtils
+ */
+uint32_t ulTaskEdfGetDensity( void ) PRIVILEGED_FUNCTION;
+
 
 /*-----------------------------------------------------------
 * SCHEDULER INTERNALS AVAILABLE FOR PORTING PURPOSES
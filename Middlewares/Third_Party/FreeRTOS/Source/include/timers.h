@@ -69,6 +69,10 @@
 #define tmrCOMMAND_STOP_FROM_ISR                ( ( BaseType_t ) 8 )
 #define tmrCOMMAND_CHANGE_PERIOD_FROM_ISR       ( ( BaseType_t ) 9 )
 
+/* Carries a whole TimerCommandBatch_t.  Only sent by xTimerSendCommandBatch(),
+ * never through xTimerGenericCommand(). */
+#define tmrCOMMAND_BATCH                        ( ( BaseType_t ) 10 )
+
 
 /**
  * Type by which software timers are referenced.  For example, a call to
@@ -91,6 +95,29 @@ typedef void (* TimerCallbackFunction_t)( TimerHandle_t xTimer );
 typedef void (* PendedFunction_t)( void *,
                                    uint32_t );
 
+/*
+ * One operation of a command batch, see xTimerSendCommandBatch().
+ */
+typedef struct tmrBatchCommand
+{
+    BaseType_t xCommandID;  /*<< tmrCOMMAND_START, tmrCOMMAND_RESET, tmrCOMMAND_STOP, tmrCOMMAND_CHANGE_PERIOD or tmrCOMMAND_DELETE. */
+    TimerHandle_t xTimer;   /*<< The timer the command is applied to. */
+    TickType_t xNewPeriod;  /*<< The new period, only used by tmrCOMMAND_CHANGE_PERIOD. */
+} TimerBatchCommand_t;
+
+/*
+ * A set of timer commands that is sent to the timer service task as a single
+ * message.  The members are private, use vTimerCommandBatchInit() and the
+ * xTimerBatch...() macros to fill it in.
+ */
+typedef struct tmrCommandBatch
+{
+    TimerBatchCommand_t * pxCommands; /*<< Storage provided by the application. */
+    UBaseType_t uxMaxCommands;        /*<< Number of entries in pxCommands. */
+    UBaseType_t uxCommandCount;       /*<< Number of entries in use. */
+    volatile BaseType_t xPending;     /*<< pdTRUE while the batch waits for the timer service task. */
+} TimerCommandBatch_t;
+
 /**
  * TimerHandle_t xTimerCreate(  const char * const pcTimerName,
  *                              TickType_t xTimerPeriodInTicks,
@@ -1309,6 +1336,117 @@ TickType_t xTimerGetPeriod( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
  */
 TickType_t xTimerGetExpiryTime( TimerHandle_t xTimer ) PRIVILEGED_FUNCTION;
 
+/**
+ * void vTimerCommandBatchInit( TimerCommandBatch_t * pxBatch,
+ *                              TimerBatchCommand_t * pxCommands,
+ *                              UBaseType_t uxMaxCommands );
+ *
+ * Prepares an empty command batch.  A batch collects start, reset, stop,
+ * change period and delete commands for any number of timers, then
+ * xTimerSendCommandBatch() hands all of them to the timer service task in one
+ * message.  The timer service task applies the whole batch in one pass, so
+ * re-arming many timers together costs one queue send, one queue slot and at
+ * most one context switch instead of one per timer.
+ *
+ * @param pxBatch The batch to initialise.
+ *
+ * @param pxCommands An array of uxMaxCommands entries that holds the commands.
+ * It must remain valid for as long as the batch is in use.
+ *
+ * @param uxMaxCommands The number of commands the batch can hold.
+ *
+ * Example usage:
+ * @verbatim
+ * static TimerBatchCommand_t xCommands[ 8 ];
+ * static TimerCommandBatch_t xBatch;
+ *
+ * void vRearmTimers( TimerHandle_t * pxTimers, UBaseType_t uxCount )
+ * {
+ * UBaseType_t x;
+ *
+ *     vTimerCommandBatchInit( &xBatch, xCommands, 8 );
+ *
+ *     for( x = 0; x < uxCount; x++ )
+ *     {
+ *         xTimerBatchReset( &xBatch, pxTimers[ x ] );
+ *     }
+ *
+ *     xTimerSendCommandBatch( &xBatch, portMAX_DELAY );
+ * }
+ * @endverbatim
+ */
+void vTimerCommandBatchInit( TimerCommandBatch_t * pxBatch,
+                             TimerBatchCommand_t * pxCommands,
+                             UBaseType_t uxMaxCommands ) PRIVILEGED_FUNCTION;
+
+/**
+ * BaseType_t xTimerCommandBatchAdd( TimerCommandBatch_t * pxBatch,
+ *                                   BaseType_t xCommandID,
+ *                                   TimerHandle_t xTimer,
+ *                                   TickType_t xNewPeriod );
+ *
+ * Appends a command to a batch.  Normally used through the xTimerBatchStart(),
+ * xTimerBatchReset(), xTimerBatchStop(), xTimerBatchChangePeriod() and
+ * xTimerBatchDelete() macros.
+ *
+ * @return pdFAIL if the batch is full or has been sent and not yet processed
+ * by the timer service task, otherwise pdPASS.
+ */
+BaseType_t xTimerCommandBatchAdd( TimerCommandBatch_t * pxBatch,
+                                  BaseType_t xCommandID,
+                                  TimerHandle_t xTimer,
+                                  TickType_t xNewPeriod ) PRIVILEGED_FUNCTION;
+
+#define xTimerBatchStart( pxBatch, xTimer ) \
+    xTimerCommandBatchAdd( ( pxBatch ), tmrCOMMAND_START, ( xTimer ), 0U )
+
+#define xTimerBatchReset( pxBatch, xTimer ) \
+    xTimerCommandBatchAdd( ( pxBatch ), tmrCOMMAND_RESET, ( xTimer ), 0U )
+
+#define xTimerBatchStop( pxBatch, xTimer ) \
+    xTimerCommandBatchAdd( ( pxBatch ), tmrCOMMAND_STOP, ( xTimer ), 0U )
+
+#define xTimerBatchChangePeriod( pxBatch, xTimer, xNewPeriod ) \
+    xTimerCommandBatchAdd( ( pxBatch ), tmrCOMMAND_CHANGE_PERIOD, ( xTimer ), ( xNewPeriod ) )
+
+#define xTimerBatchDelete( pxBatch, xTimer ) \
+    xTimerCommandBatchAdd( ( pxBatch ), tmrCOMMAND_DELETE, ( xTimer ), 0U )
+
+/**
+ * BaseType_t xTimerSendCommandBatch( TimerCommandBatch_t * pxBatch,
+ *                                    TickType_t xTicksToWait );
+ *
+ * Sends every command of the batch to the timer service task as a single
+ * message.  Start and reset commands are timed from the moment this function
+ * is called, exactly as if xTimerStart() or xTimerReset() had been called for
+ * each timer at that time.  The commands are applied in the order they were
+ * added.
+ *
+ * The timer service task reads the commands from the batch itself, so the
+ * batch must not be changed until xTimerCommandBatchIsPending() returns
+ * pdFALSE.  When the calling task has a lower priority than the timer service
+ * task (configTIMER_TASK_PRIORITY) the batch has already been applied when
+ * this function returns.  Once applied the batch is empty and can be refilled.
+ *
+ * @param pxBatch The batch to send.
+ *
+ * @param xTicksToWait The time to wait for space on the timer command queue,
+ * ignored if called before the scheduler is started.
+ *
+ * @return pdFAIL if the batch is empty, still pending, or could not be queued
+ * within xTicksToWait ticks, otherwise pdPASS.
+ */
+BaseType_t xTimerSendCommandBatch( TimerCommandBatch_t * pxBatch,
+                                   TickType_t xTicksToWait ) PRIVILEGED_FUNCTION;
+
+/**
+ * BaseType_t xTimerCommandBatchIsPending( const TimerCommandBatch_t * pxBatch );
+ *
+ * @return pdTRUE if the batch has been sent but the timer service task has not
+ * applied it yet, otherwise pdFALSE.
+ */
+BaseType_t xTimerCommandBatchIsPending( const TimerCommandBatch_t * pxBatch ) PRIVILEGED_FUNCTION;
+
 /*
  * Functions beyond this part are not part of the public API and are intended
  * for use by the kernel only.
@@ -86,6 +86,8 @@
 /* Constants required to manipulate the VFP. */
 #define portFPCCR                             ( ( volatile uint32_t * ) 0xe000ef34 ) /* Floating point context control register. */
 #define portASPEN_AND_LSPEN_BITS              ( 0x3UL << 30UL )
+#define portCPACR                             ( ( volatile uint32_t * ) 0xe000ed88 ) /* Coprocessor access control register. */
+#define portCPACR_FPU_ENABLE_BITS             ( 0xfUL << 20UL )                      /* Full access to CP10 and CP11. */
 
 /* Constants required to set up the initial stack. */
 #define portINITIAL_XPSR                      ( 0x01000000 )
@@ -136,6 +138,14 @@ static void prvPortStartFirstTask( void ) __attribute__( ( naked ) );
  */
 static void vPortEnableVFP( void ) __attribute__( ( naked ) );
 
+/*
+ * Context switch counters, read by ulPortGetContextSwitchCount() and
+ * ulPortGetFpuContextSwitchCount().  The first one is incremented on every
+ * PendSV, the second one when the task switched out had a floating point
+ * context to save.  Only written by the PendSV handler.
+ */
+static volatile uint32_t ulContextSwitchCounts[ 2 ] __attribute__( ( used ) ) = { 0UL, 0UL };
+
 /*
  * Used to catch tasks that attempt to return from their implementing function.
  */
@@ -214,6 +224,15 @@ StackType_t * pxPortInitialiseStack( StackType_t * pxTopOfStack,
 
     pxTopOfStack -= 8; /* R11, R10, R9, R8, R7, R6, R5 and R4. */
 
+    #if ( configUSE_TASK_FPU_SUPPORT == 1 )
+    {
+        /* The CPACR is part of the task context.  A task starts without access
+         * to the FPU, see vPortTaskUsesFPU(). */
+        pxTopOfStack--;
+        *pxTopOfStack = ( StackType_t ) ( *( portCPACR ) & ~portCPACR_FPU_ENABLE_BITS );
+    }
+    #endif /* configUSE_TASK_FPU_SUPPORT */
+
     return pxTopOfStack;
 }
 /*-----------------------------------------------------------*/
@@ -250,7 +269,14 @@ void vPortSVCHandler( void )
         "	ldr	r3, pxCurrentTCBConst2		\n"/* Restore the context. */
         "	ldr r1, [r3]					\n"/* Use pxCurrentTCBConst to get the pxCurrentTCB address. */
         "	ldr r0, [r1]					\n"/* The first item in pxCurrentTCB is the task top of stack. */
-        "	ldmia r0!, {r4-r11, r14}		\n"/* Pop the registers that are not automatically saved on exception entry and the critical nesting count. */
+        #if ( configUSE_TASK_FPU_SUPPORT == 1 )
+            "	ldmia r0!, {r1, r4-r11, r14}	\n"/* Pop the CPACR and the registers that are not automatically saved on exception entry. */
+            "	ldr r2, cpacrConst2				\n"/* Give the task its FPU access. */
+            "	str r1, [r2]					\n"
+            "	dsb								\n"
+        #else
+            "	ldmia r0!, {r4-r11, r14}		\n"/* Pop the registers that are not automatically saved on exception entry and the critical nesting count. */
+        #endif
         "	msr psp, r0						\n"/* Restore the task stack pointer. */
         "	isb								\n"
         "	mov r0, #0 						\n"
@@ -259,6 +285,9 @@ void vPortSVCHandler( void )
         "									\n"
         "	.align 4						\n"
         "pxCurrentTCBConst2: .word pxCurrentTCB				\n"
+        #if ( configUSE_TASK_FPU_SUPPORT == 1 )
+            "cpacrConst2: .word 0xe000ed88					\n"
+        #endif
         );
 }
 /*-----------------------------------------------------------*/
@@ -448,11 +477,26 @@ void xPortPendSVHandler( void )
         "	ldr	r3, pxCurrentTCBConst			\n"/* Get the location of the current TCB. */
         "	ldr	r2, [r3]						\n"
         "										\n"
+        "	ldr r1, ulContextSwitchCountsConst	\n"/* Count the context switch. */
+        "	ldr r12, [r1]						\n"
+        "	add r12, r12, #1					\n"
+        "	str r12, [r1]						\n"
+        "										\n"
         "	tst r14, #0x10						\n"/* Is the task using the FPU context?  If so, push high vfp registers. */
-        "	it eq								\n"
-        "	vstmdbeq r0!, {s16-s31}				\n"
+        "	bne 1f								\n"
+        "	vstmdb r0!, {s16-s31}				\n"
+        "	ldr r12, [r1, #4]					\n"/* Count the context switch that saved floating point state. */
+        "	add r12, r12, #1					\n"
+        "	str r12, [r1, #4]					\n"
+        "1:										\n"
         "										\n"
-        "	stmdb r0!, {r4-r11, r14}			\n"/* Save the core registers. */
+        #if ( configUSE_TASK_FPU_SUPPORT == 1 )
+            "	ldr r1, cpacrConst					\n"/* The FPU access of the task is saved with its context. */
+            "	ldr r1, [r1]						\n"
+            "	stmdb r0!, {r1, r4-r11, r14}		\n"/* Save the CPACR and the core registers. */
+        #else
+            "	stmdb r0!, {r4-r11, r14}			\n"/* Save the core registers. */
+        #endif
         "	str r0, [r2]						\n"/* Save the new top of stack into the first member of the TCB. */
         "										\n"
         "	stmdb sp!, {r0, r3}					\n"
@@ -468,7 +512,15 @@ void xPortPendSVHandler( void )
         "	ldr r1, [r3]						\n"/* The first item in pxCurrentTCB is the task top of stack. */
         "	ldr r0, [r1]						\n"
         "										\n"
-        "	ldmia r0!, {r4-r11, r14}			\n"/* Pop the core registers. */
+        #if ( configUSE_TASK_FPU_SUPPORT == 1 )
+            "	ldmia r0!, {r1, r4-r11, r14}		\n"/* Pop the CPACR and the core registers. */
+            "	ldr r2, cpacrConst					\n"/* Restore the FPU access of the task before its FPU context. */
+            "	str r1, [r2]						\n"
+            "	dsb									\n"
+            "	isb									\n"
+        #else
+            "	ldmia r0!, {r4-r11, r14}			\n"/* Pop the core registers. */
+        #endif
         "										\n"
         "	tst r14, #0x10						\n"/* Is the task using the FPU context?  If so, pop the high vfp registers too. */
         "	it eq								\n"
@@ -488,6 +540,10 @@ void xPortPendSVHandler( void )
         "										\n"
         "	.align 4							\n"
         "pxCurrentTCBConst: .word pxCurrentTCB	\n"
+        "ulContextSwitchCountsConst: .word ulContextSwitchCounts	\n"
+        #if ( configUSE_TASK_FPU_SUPPORT == 1 )
+            "cpacrConst: .word 0xe000ed88			\n"
+        #endif
         ::"i" ( configMAX_SYSCALL_INTERRUPT_PRIORITY )
     );
 }
@@ -724,6 +780,37 @@ static void vPortEnableVFP( void )
 }
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_TASK_FPU_SUPPORT == 1 )
+
+    void vPortTaskUsesFPU( void )
+    {
+        /* Only the calling task gets access, the CPACR is saved and restored
+         * with its context from here on.  A read-modify-write interrupted by a
+         * context switch reads back the same value when the task resumes. */
+        configASSERT( xPortIsInsideInterrupt() == pdFALSE );
+
+        *( portCPACR ) |= portCPACR_FPU_ENABLE_BITS;
+
+        /* The first floating point instruction may follow immediately. */
+        __asm volatile ( "dsb" ::: "memory" );
+        __asm volatile ( "isb" );
+    }
+
+#endif /* configUSE_TASK_FPU_SUPPORT */
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetContextSwitchCount( void )
+{
+    return ulContextSwitchCounts[ 0 ];
+}
+/*-----------------------------------------------------------*/
+
+uint32_t ulPortGetFpuContextSwitchCount( void )
+{
+    return ulContextSwitchCounts[ 1 ];
+}
+/*-----------------------------------------------------------*/
+
 #if ( configASSERT_DEFINED == 1 )
 
     void vPortValidateInterruptPriority( void )
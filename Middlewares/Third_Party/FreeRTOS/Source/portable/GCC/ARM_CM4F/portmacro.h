@@ -114,6 +114,35 @@
     #define portTASK_FUNCTION( vFunction, pvParameters )          void vFunction( void * pvParameters )
 /*-----------------------------------------------------------*/
 
+/* Floating point support.  With configUSE_TASK_FPU_SUPPORT set to 2 (the
+ * default) every task may use the FPU.  With 1 a task starts without access to
+ * the FPU and must call portTASK_USES_FLOATING_POINT() before its first
+ * floating point instruction, a floating point instruction executed by any
+ * other task raises a UsageFault (NOCP), so only the tasks that declared it
+ * can ever have a floating point context to save.  Interrupts run with the
+ * FPU access of the interrupted task, so they must not use the FPU in that
+ * mode. */
+    #ifndef configUSE_TASK_FPU_SUPPORT
+        #define configUSE_TASK_FPU_SUPPORT    2
+    #endif
+
+    #if ( ( configUSE_TASK_FPU_SUPPORT != 1 ) && ( configUSE_TASK_FPU_SUPPORT != 2 ) )
+        #error configUSE_TASK_FPU_SUPPORT must be set to 1 or 2
+    #endif
+
+    #if ( configUSE_TASK_FPU_SUPPORT == 1 )
+        extern void vPortTaskUsesFPU( void );
+        #define portTASK_USES_FLOATING_POINT()    vPortTaskUsesFPU()
+    #else
+        #define portTASK_USES_FLOATING_POINT()
+    #endif
+
+/* Number of PendSV context switches, and of those that saved the floating
+ * point context of the task switched out. */
+    extern uint32_t ulPortGetContextSwitchCount( void );
+    extern uint32_t ulPortGetFpuContextSwitchCount( void );
+/*-----------------------------------------------------------*/
+
 /* Tickless idle/low power functionality. */
     #ifndef portSUPPRESS_TICKS_AND_SLEEP
         extern void vPortSuppressTicksAndSleep( TickType_t xExpectedIdleTime );
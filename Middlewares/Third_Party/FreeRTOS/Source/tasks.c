@@ -115,6 +115,34 @@
     #define configIDLE_TASK_NAME    "IDLE"
 #endif
 
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+/* The tasks at configEDF_PRIORITY are not selected in turn but by their
+ * deadline. */
+    #define taskGET_OWNER_OF_READY_LIST( pxTCB, uxPriority )                                   \
+    {                                                                                          \
+        if( ( uxPriority ) == ( UBaseType_t ) configEDF_PRIORITY )                             \
+        {                                                                                      \
+            ( pxTCB ) = prvEdfSelectTask( &( pxReadyTasksLists[ ( uxPriority ) ] ) );          \
+        }                                                                                      \
+        else                                                                                   \
+        {                                                                                      \
+            listGET_OWNER_OF_NEXT_ENTRY( ( pxTCB ), &( pxReadyTasksLists[ ( uxPriority ) ] ) ); \
+        }                                                                                      \
+    }
+
+/* pdTRUE if the tick time xA comes before xB.  Deadlines are compared
+ * relative to each other, so the comparison holds across a tick count
+ * overflow as long as they are less than half the tick range apart. */
+    #define taskEDF_IS_BEFORE( xA, xB )    ( ( TickType_t ) ( ( xA ) - ( xB ) ) > ( portMAX_DELAY >> 1 ) )
+
+#else /* configUSE_EDF_SCHEDULING */
+
+    #define taskGET_OWNER_OF_READY_LIST( pxTCB, uxPriority ) \
+    listGET_OWNER_OF_NEXT_ENTRY( ( pxTCB ), &( pxReadyTasksLists[ ( uxPriority ) ] ) )
+
+#endif /* configUSE_EDF_SCHEDULING */
+
 #if ( configUSE_PORT_OPTIMISED_TASK_SELECTION == 0 )
 
 /* If configUSE_PORT_OPTIMISED_TASK_SELECTION is 0 then task selection is
@@ -146,7 +174,7 @@
                                                                               \
         /* listGET_OWNER_OF_NEXT_ENTRY indexes through the list, so the tasks of \
          * the  same priority get an equal share of the processor time. */                    \
-        listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) ); \
+        taskGET_OWNER_OF_READY_LIST( pxCurrentTCB, uxTopPriority );                           \
         uxTopReadyPriority = uxTopPriority;                                                   \
     } /* taskSELECT_HIGHEST_PRIORITY_TASK */
 
@@ -176,7 +204,7 @@
         /* Find the highest priority list that contains ready tasks. */                         \
         portGET_HIGHEST_PRIORITY( uxTopPriority, uxTopReadyPriority );                          \
         configASSERT( listCURRENT_LIST_LENGTH( &( pxReadyTasksLists[ uxTopPriority ] ) ) > 0 ); \
-        listGET_OWNER_OF_NEXT_ENTRY( pxCurrentTCB, &( pxReadyTasksLists[ uxTopPriority ] ) );   \
+        taskGET_OWNER_OF_READY_LIST( pxCurrentTCB, uxTopPriority );                             \
     } /* taskSELECT_HIGHEST_PRIORITY_TASK() */
 
 /*-----------------------------------------------------------*/
@@ -329,6 +357,18 @@ typedef struct tskTaskControlBlock       /* The old naming convention is used to
     #if ( configUSE_POSIX_ERRNO == 1 )
         int iTaskErrno;
     #endif
+
+    #if ( configUSE_EDF_SCHEDULING == 1 )
+        TickType_t xEdfPeriod;           /*< Period of the task, 0 if the task is not scheduled by deadline. */
+        TickType_t xEdfRelativeDeadline; /*< Time from the release of a job to its deadline. */
+        TickType_t xEdfRelease;          /*< Release time of the current job. */
+        TickType_t xEdfDeadline;         /*< Absolute deadline of the current job, the key the task is selected by. */
+        TickType_t xEdfMaxLateness;      /*< Largest time by which a job completed after its deadline. */
+        uint32_t ulEdfWcetUs;            /*< Worst case execution time of a job as registered. */
+        uint32_t ulEdfDensity;           /*< Share of the admission bound held by the task, in parts per million. */
+        uint32_t ulEdfJobs;              /*< Number of jobs completed. */
+        uint32_t ulEdfMisses;            /*< Number of jobs completed after their deadline. */
+    #endif
 } tskTCB;
 
 /* The old tskTCB name is maintained above then typedefed to the new TCB_t name
@@ -405,12 +445,36 @@ PRIVILEGED_DATA static volatile UBaseType_t uxSchedulerSuspended = ( UBaseType_t
 
 #endif
 
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+    PRIVILEGED_DATA static uint32_t ulEdfTotalDensity = 0UL; /*< Summed densities of the deadline scheduled tasks, in parts per million. */
+
+#endif
+
 /*lint -restore */
 
 /*-----------------------------------------------------------*/
 
 /* File private functions. --------------------------------*/
 
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+/*
+ * Returns the task of the EDF ready list with the earliest deadline.  A task
+ * that is not deadline scheduled but runs at configEDF_PRIORITY, which can only
+ * happen when it inherited the priority from a deadline scheduled task blocked
+ * on a mutex it holds, is returned first.
+ */
+    static TCB_t * prvEdfSelectTask( List_t * const pxReadyList ) PRIVILEGED_FUNCTION;
+
+/*
+ * Returns the density of a deadline scheduled task to the admission bound and
+ * marks the task as not deadline scheduled.  Called from a critical section.
+ */
+    static void prvEdfRelease( TCB_t * const pxTCB ) PRIVILEGED_FUNCTION;
+
+#endif
+
 /**
  * Utility task that simply returns pdTRUE if the task referenced by xTask is
  * currently in the Suspended state, or pdFALSE if the task referenced by xTask
@@ -981,6 +1045,12 @@ static void prvInitialiseNewTask( TaskFunction_t pxTaskCode,
         }
     #endif
 
+    #if ( configUSE_EDF_SCHEDULING == 1 )
+        {
+            pxNewTCB->xEdfPeriod = ( TickType_t ) 0U;
+        }
+    #endif
+
     #if ( configUSE_TASK_NOTIFICATIONS == 1 )
         {
             memset( ( void * ) &( pxNewTCB->ulNotifiedValue[ 0 ] ), 0x00, sizeof( pxNewTCB->ulNotifiedValue ) );
@@ -1184,6 +1254,12 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
                 mtCOVERAGE_TEST_MARKER();
             }
 
+            #if ( configUSE_EDF_SCHEDULING == 1 )
+                {
+                    prvEdfRelease( pxTCB );
+                }
+            #endif
+
             /* Increment the uxTaskNumber also so kernel aware debuggers can
              * detect that the task lists need re-generating.  This is done before
              * portPRE_TASK_DELETE_HOOK() as in the Windows port that macro will
@@ -1386,6 +1462,249 @@ static void prvAddNewTaskToReadyList( TCB_t * pxNewTCB )
 #endif /* INCLUDE_vTaskDelay */
 /*-----------------------------------------------------------*/
 
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+    BaseType_t xTaskEdfRegister( TaskHandle_t xTask,
+                                 TickType_t xPeriod,
+                                 TickType_t xRelativeDeadline,
+                                 uint32_t ulWcetUs )
+    {
+        TCB_t * pxTCB;
+        TickType_t xDensityWindow;
+        uint64_t ullDensity;
+        BaseType_t xReturn = pdFAIL;
+
+        configASSERT( xPeriod > ( TickType_t ) 0U );
+        configASSERT( xRelativeDeadline > ( TickType_t ) 0U );
+
+        /* A job must complete within the smaller of its deadline and its
+         * period, its density is the share of that window it needs.  The
+         * window is converted from ticks to microseconds, and the result is in
+         * parts per million. */
+        xDensityWindow = ( xRelativeDeadline < xPeriod ) ? xRelativeDeadline : xPeriod;
+        ullDensity = ( ( uint64_t ) ulWcetUs * ( uint64_t ) configTICK_RATE_HZ ) / ( uint64_t ) xDensityWindow;
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+
+            if( ( pxTCB->xEdfPeriod == ( TickType_t ) 0U ) &&
+                ( ullDensity <= ( uint64_t ) ( configEDF_MAX_DENSITY_PPM - ulEdfTotalDensity ) ) )
+            {
+                ulEdfTotalDensity += ( uint32_t ) ullDensity;
+
+                pxTCB->ulEdfDensity = ( uint32_t ) ullDensity;
+                pxTCB->ulEdfWcetUs = ulWcetUs;
+                pxTCB->xEdfRelativeDeadline = xRelativeDeadline;
+                pxTCB->xEdfRelease = xTickCount;
+                pxTCB->xEdfDeadline = xTickCount + xRelativeDeadline;
+                pxTCB->xEdfMaxLateness = ( TickType_t ) 0U;
+                pxTCB->ulEdfJobs = 0UL;
+                pxTCB->ulEdfMisses = 0UL;
+
+                /* Set last, the task is deadline scheduled from here on. */
+                pxTCB->xEdfPeriod = xPeriod;
+
+                xReturn = pdPASS;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        if( xReturn == pdPASS )
+        {
+            /* The deadline is already set when the task enters the EDF ready
+             * list. */
+            vTaskPrioritySet( pxTCB, configEDF_PRIORITY );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+    void vTaskEdfUnregister( TaskHandle_t xTask,
+                             UBaseType_t uxPriority )
+    {
+        TCB_t * pxTCB;
+
+        configASSERT( uxPriority != ( UBaseType_t ) configEDF_PRIORITY );
+
+        pxTCB = prvGetTCBFromHandle( xTask );
+
+        /* Leave the EDF ready list before the deadline is dropped, so the task
+         * is never selected there as a task without a deadline. */
+        vTaskPrioritySet( pxTCB, uxPriority );
+
+        taskENTER_CRITICAL();
+        {
+            prvEdfRelease( pxTCB );
+        }
+        taskEXIT_CRITICAL();
+    }
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+    BaseType_t xTaskEdfWaitForNextPeriod( void )
+    {
+        TCB_t * const pxTCB = pxCurrentTCB;
+        const TickType_t xConstTickCount = xTaskGetTickCount();
+        BaseType_t xReturn = pdPASS;
+
+        configASSERT( pxTCB->xEdfPeriod != ( TickType_t ) 0U );
+
+        pxTCB->ulEdfJobs++;
+
+        if( taskEDF_IS_BEFORE( pxTCB->xEdfDeadline, xConstTickCount ) != pdFALSE )
+        {
+            pxTCB->ulEdfMisses++;
+
+            if( ( TickType_t ) ( xConstTickCount - pxTCB->xEdfDeadline ) > pxTCB->xEdfMaxLateness )
+            {
+                pxTCB->xEdfMaxLateness = xConstTickCount - pxTCB->xEdfDeadline;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            xReturn = pdFAIL;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        /* The deadline of the next job is set before the task blocks, so it is
+         * in place when the job is released.  Only this task writes it, and a
+         * 32-bit store cannot be seen half done by the scheduler. */
+        pxTCB->xEdfDeadline = pxTCB->xEdfRelease + pxTCB->xEdfPeriod + pxTCB->xEdfRelativeDeadline;
+
+        ( void ) xTaskDelayUntil( &( pxTCB->xEdfRelease ), pxTCB->xEdfPeriod );
+
+        return xReturn;
+    }
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+    BaseType_t xTaskEdfGetInfo( TaskHandle_t xTask,
+                                EdfTaskStatus_t * pxEdfStatus )
+    {
+        TCB_t * pxTCB;
+        BaseType_t xReturn = pdFALSE;
+
+        configASSERT( pxEdfStatus );
+
+        taskENTER_CRITICAL();
+        {
+            pxTCB = prvGetTCBFromHandle( xTask );
+
+            if( pxTCB->xEdfPeriod != ( TickType_t ) 0U )
+            {
+                pxEdfStatus->xPeriod = pxTCB->xEdfPeriod;
+                pxEdfStatus->xRelativeDeadline = pxTCB->xEdfRelativeDeadline;
+                pxEdfStatus->ulWcetUs = pxTCB->ulEdfWcetUs;
+                pxEdfStatus->xDeadline = pxTCB->xEdfDeadline;
+                pxEdfStatus->ulJobs = pxTCB->ulEdfJobs;
+                pxEdfStatus->ulMisses = pxTCB->ulEdfMisses;
+                pxEdfStatus->xMaxLateness = pxTCB->xEdfMaxLateness;
+                xReturn = pdTRUE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        taskEXIT_CRITICAL();
+
+        return xReturn;
+    }
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+    uint32_t ulTaskEdfGetDensity( void )
+    {
+        return ulEdfTotalDensity;
+    }
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+    static TCB_t * prvEdfSelectTask( List_t * const pxReadyList )
+    {
+        ListItem_t const * const pxEnd = listGET_END_MARKER( pxReadyList );
+        ListItem_t * pxItem;
+        TCB_t * pxTCB;
+        TCB_t * pxEarliest = NULL;
+
+        /* A short linear search, the EDF ready list only holds the deadline
+         * scheduled tasks that are ready. */
+        for( pxItem = listGET_HEAD_ENTRY( pxReadyList ); pxItem != pxEnd; pxItem = listGET_NEXT( pxItem ) )
+        {
+            pxTCB = listGET_LIST_ITEM_OWNER( pxItem );
+
+            if( pxTCB->xEdfPeriod == ( TickType_t ) 0U )
+            {
+                pxEarliest = pxTCB;
+                break;
+            }
+            else if( ( pxEarliest == NULL ) || ( taskEDF_IS_BEFORE( pxTCB->xEdfDeadline, pxEarliest->xEdfDeadline ) != pdFALSE ) )
+            {
+                pxEarliest = pxTCB;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+
+        configASSERT( pxEarliest );
+
+        return pxEarliest;
+    }
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
+#if ( configUSE_EDF_SCHEDULING == 1 )
+
+    static void prvEdfRelease( TCB_t * const pxTCB )
+    {
+        if( pxTCB->xEdfPeriod != ( TickType_t ) 0U )
+        {
+            ulEdfTotalDensity -= pxTCB->ulEdfDensity;
+            pxTCB->xEdfPeriod = ( TickType_t ) 0U;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+    }
+
+#endif /* configUSE_EDF_SCHEDULING */
+/*-----------------------------------------------------------*/
+
 #if ( ( INCLUDE_eTaskGetState == 1 ) || ( configUSE_TRACE_FACILITY == 1 ) || ( INCLUDE_xTaskAbortDelay == 1 ) )
 
     eTaskState eTaskGetState( TaskHandle_t xTask )
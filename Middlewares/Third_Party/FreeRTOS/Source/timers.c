@@ -71,6 +71,18 @@
     #define tmrSTATUS_IS_STATICALLY_ALLOCATED    ( ( uint8_t ) 0x02 )
     #define tmrSTATUS_IS_AUTORELOAD              ( ( uint8_t ) 0x04 )
 
+/* Timing wheel geometry.  Every level has 32 slots so the occupied slots of a
+ * level fit in one 32 bit bitmap.  Level n holds the timers that expire within
+ * 2^( 5 * ( n + 1 ) ) ticks, in slots that are 2^( 5 * n ) ticks wide. */
+    #if ( configUSE_TIMER_WHEEL == 1 )
+        #define tmrWHEEL_SLOT_BITS                 ( 5U )
+        #define tmrWHEEL_SLOTS                     ( ( UBaseType_t ) 1U << tmrWHEEL_SLOT_BITS )
+        #define tmrWHEEL_SLOT_MASK                 ( tmrWHEEL_SLOTS - ( UBaseType_t ) 1U )
+        #define tmrWHEEL_LEVEL_SHIFT( uxLevel )    ( ( uxLevel ) * tmrWHEEL_SLOT_BITS )
+        #define tmrWHEEL_LEVEL_SPAN( uxLevel )     ( ( TickType_t ) 1U << tmrWHEEL_LEVEL_SHIFT( uxLevel ) )
+        #define tmrWHEEL_HALF_RANGE                ( ( TickType_t ) ( ( ( TickType_t ) -1 ) >> 1U ) )
+    #endif
+
 /* The definition of the timers themselves. */
     typedef struct tmrTimerControl                  /* The old naming convention is used to prevent breaking kernel aware debuggers. */
     {
@@ -101,6 +113,13 @@
     } TimerParameter_t;
 
 
+    typedef struct tmrBatchParameters
+    {
+        TickType_t xCommandTime;        /*<< The time at which the batch was sent, used by its start and reset commands. */
+        TimerCommandBatch_t * pxBatch;  /*<< The batch of commands to apply. */
+    } BatchParameter_t;
+
+
     typedef struct tmrCallbackParameters
     {
         PendedFunction_t pxCallbackFunction; /* << The callback function to execute. */
@@ -116,6 +135,7 @@
         union
         {
             TimerParameter_t xTimerParameters;
+            BatchParameter_t xBatchParameters;
 
             /* Don't include xCallbackParameters if it is not going to be used as
              * it makes the structure (and therefore the timer queue) larger. */
@@ -134,10 +154,28 @@
  * xActiveTimerList1 and xActiveTimerList2 could be at function scope but that
  * breaks some kernel aware debuggers, and debuggers that reply on removing the
  * static qualifier. */
-    PRIVILEGED_DATA static List_t xActiveTimerList1;
-    PRIVILEGED_DATA static List_t xActiveTimerList2;
-    PRIVILEGED_DATA static List_t * pxCurrentTimerList;
-    PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+    #if ( configUSE_TIMER_WHEEL == 0 )
+        PRIVILEGED_DATA static List_t xActiveTimerList1;
+        PRIVILEGED_DATA static List_t xActiveTimerList2;
+        PRIVILEGED_DATA static List_t * pxCurrentTimerList;
+        PRIVILEGED_DATA static List_t * pxOverflowTimerList;
+    #else
+
+/* The timing wheel in which active timers are stored when configUSE_TIMER_WHEEL
+ * is 1.  The slot lists are not sorted, a timer is appended to the slot that
+ * contains its expiry time, so starting, stopping and resetting a timer does not
+ * depend on the number of active timers.  When the lower bits of the wheel time
+ * roll over to zero the next slot of the level above is cascaded, which moves
+ * its timers into the finer levels.  Timers that expire beyond the span of the
+ * wheel are kept in xTimerWheelOverflowList and re-inserted each time the top
+ * level rolls over.  xTimerWheelTime is the first tick that has not yet been
+ * processed, and a bit is set in ulTimerWheelBitmap for each slot that is not
+ * empty.  Only the timer service task is allowed to access these variables. */
+        PRIVILEGED_DATA static List_t xTimerWheel[ configTIMER_WHEEL_LEVELS ][ tmrWHEEL_SLOTS ];
+        PRIVILEGED_DATA static List_t xTimerWheelOverflowList;
+        PRIVILEGED_DATA static uint32_t ulTimerWheelBitmap[ configTIMER_WHEEL_LEVELS ];
+        PRIVILEGED_DATA static TickType_t xTimerWheelTime = ( TickType_t ) 0U;
+    #endif /* configUSE_TIMER_WHEEL */
 
 /* A queue that is used to send commands to the timer service task. */
     PRIVILEGED_DATA static QueueHandle_t xTimerQueue = NULL;
@@ -166,9 +204,26 @@
  */
     static void prvProcessReceivedCommands( void ) PRIVILEGED_FUNCTION;
 
+/*
+ * Apply a single start, reset, stop, change period or delete command to a
+ * timer.  xMessageValue has the same meaning as in a queued timer command.
+ */
+    static void prvProcessTimerCommand( Timer_t * const pxTimer,
+                                        const BaseType_t xCommandID,
+                                        const TickType_t xMessageValue,
+                                        const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
+
+/*
+ * Apply every command of a batch sent by xTimerSendCommandBatch(), then mark
+ * the batch as no longer pending.
+ */
+    static void prvProcessCommandBatch( TimerCommandBatch_t * const pxBatch,
+                                        const TickType_t xCommandTime ) PRIVILEGED_FUNCTION;
+
 /*
  * Insert the timer into either xActiveTimerList1, or xActiveTimerList2,
- * depending on if the expire time causes a timer counter overflow.
+ * depending on if the expire time causes a timer counter overflow.  When the
+ * timing wheel is used the timer is inserted into the wheel instead.
  */
     static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
                                                   const TickType_t xNextExpiryTime,
@@ -184,18 +239,48 @@
                                 TickType_t xExpiredTime,
                                 const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+/*
+ * Remove an active timer from the list that references it.
+ */
+    static void prvRemoveTimerFromActiveList( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
 /*
  * An active timer has reached its expire time.  Reload the timer if it is an
- * auto-reload timer, then call its callback.
+ * auto-reload timer, then call its callback.  When the timing wheel is used all
+ * the timers that expire at xNextExpireTime are processed.
  */
     static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
                                         const TickType_t xTimeNow ) PRIVILEGED_FUNCTION;
 
+    #if ( configUSE_TIMER_WHEEL == 0 )
+
 /*
  * The tick count has overflowed.  Switch the timer lists after ensuring the
  * current timer list does not still reference some timers.
  */
-    static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+        static void prvSwitchTimerLists( void ) PRIVILEGED_FUNCTION;
+
+    #else
+
+/*
+ * Place an active timer in the wheel slot, or the overflow list, that matches
+ * its expiry time relative to xTimerWheelTime.
+ */
+        static void prvWheelInsertTimer( Timer_t * const pxTimer ) PRIVILEGED_FUNCTION;
+
+/*
+ * Re-insert the timers referenced by pxList, moving them to finer levels.
+ */
+        static void prvWheelCascade( List_t * const pxList ) PRIVILEGED_FUNCTION;
+
+/*
+ * Return the distance from uxStartSlot to the first occupied slot in the
+ * bitmap, searching upwards and wrapping around.  ulBitmap must not be zero.
+ */
+        static UBaseType_t prvWheelFirstSlot( const uint32_t ulBitmap,
+                                              const UBaseType_t uxStartSlot ) PRIVILEGED_FUNCTION;
+
+    #endif /* configUSE_TIMER_WHEEL */
 
 /*
  * Obtain the current tick count, setting *pxTimerListsWereSwitched to pdTRUE
@@ -207,7 +292,8 @@
  * If the timer list contains any active timers then return the expire time of
  * the timer that will expire first and set *pxListWasEmpty to false.  If the
  * timer list does not contain any timers then return 0 and set *pxListWasEmpty
- * to pdTRUE.
+ * to pdTRUE.  When the timing wheel is used the returned time is the next tick
+ * at which a timer expires or a slot must be cascaded.
  */
     static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty ) PRIVILEGED_FUNCTION;
 
@@ -430,6 +516,111 @@
     }
 /*-----------------------------------------------------------*/
 
+    void vTimerCommandBatchInit( TimerCommandBatch_t * pxBatch,
+                                 TimerBatchCommand_t * pxCommands,
+                                 UBaseType_t uxMaxCommands )
+    {
+        configASSERT( pxBatch );
+        configASSERT( pxCommands );
+
+        pxBatch->pxCommands = pxCommands;
+        pxBatch->uxMaxCommands = uxMaxCommands;
+        pxBatch->uxCommandCount = ( UBaseType_t ) 0U;
+        pxBatch->xPending = pdFALSE;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTimerCommandBatchAdd( TimerCommandBatch_t * pxBatch,
+                                      BaseType_t xCommandID,
+                                      TimerHandle_t xTimer,
+                                      TickType_t xNewPeriod )
+    {
+        BaseType_t xReturn = pdFAIL;
+        TimerBatchCommand_t * pxCommand;
+
+        configASSERT( pxBatch );
+        configASSERT( xTimer );
+
+        /* Only the task level timer commands can be batched. */
+        configASSERT( ( xCommandID > tmrCOMMAND_START_DONT_TRACE ) && ( xCommandID < tmrFIRST_FROM_ISR_COMMAND ) );
+        configASSERT( ( xCommandID != tmrCOMMAND_CHANGE_PERIOD ) || ( xNewPeriod > 0 ) );
+
+        if( ( pxBatch->xPending == pdFALSE ) && ( pxBatch->uxCommandCount < pxBatch->uxMaxCommands ) )
+        {
+            pxCommand = &( pxBatch->pxCommands[ pxBatch->uxCommandCount ] );
+            pxCommand->xCommandID = xCommandID;
+            pxCommand->xTimer = xTimer;
+            pxCommand->xNewPeriod = xNewPeriod;
+            ( pxBatch->uxCommandCount )++;
+            xReturn = pdPASS;
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTimerSendCommandBatch( TimerCommandBatch_t * pxBatch,
+                                       TickType_t xTicksToWait )
+    {
+        BaseType_t xReturn = pdFAIL;
+        DaemonTaskMessage_t xMessage;
+
+        configASSERT( pxBatch );
+
+        if( ( xTimerQueue != NULL ) && ( pxBatch->xPending == pdFALSE ) && ( pxBatch->uxCommandCount > ( UBaseType_t ) 0U ) )
+        {
+            xMessage.xMessageID = tmrCOMMAND_BATCH;
+            xMessage.u.xBatchParameters.xCommandTime = xTaskGetTickCount();
+            xMessage.u.xBatchParameters.pxBatch = pxBatch;
+
+            /* Mark the batch before it is queued, the timer service task may
+             * preempt this task and apply it as soon as it is on the queue. */
+            pxBatch->xPending = pdTRUE;
+
+            /* The timer service task reads the commands from the caller's
+             * array rather than from the queue, so every write to the array
+             * and the count must be complete before the message is posted. */
+            portMEMORY_BARRIER();
+
+            if( xTaskGetSchedulerState() == taskSCHEDULER_RUNNING )
+            {
+                xReturn = xQueueSendToBack( xTimerQueue, &xMessage, xTicksToWait );
+            }
+            else
+            {
+                xReturn = xQueueSendToBack( xTimerQueue, &xMessage, tmrNO_DELAY );
+            }
+
+            if( xReturn != pdPASS )
+            {
+                pxBatch->xPending = pdFALSE;
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        return xReturn;
+    }
+/*-----------------------------------------------------------*/
+
+    BaseType_t xTimerCommandBatchIsPending( const TimerCommandBatch_t * pxBatch )
+    {
+        configASSERT( pxBatch );
+
+        return pxBatch->xPending;
+    }
+/*-----------------------------------------------------------*/
+
     TaskHandle_t xTimerGetTimerDaemonTaskHandle( void )
     {
         /* If xTimerGetTimerDaemonTaskHandle() is called before the scheduler has been
@@ -533,31 +724,131 @@
     }
 /*-----------------------------------------------------------*/
 
-    static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
-                                        const TickType_t xTimeNow )
+    static void prvRemoveTimerFromActiveList( Timer_t * const pxTimer )
     {
-        Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+        #if ( configUSE_TIMER_WHEEL == 1 )
+            {
+                List_t * const pxList = listLIST_ITEM_CONTAINER( &( pxTimer->xTimerListItem ) );
+                UBaseType_t uxIndex;
 
-        /* Remove the timer from the list of active timers.  A check has already
-         * been performed to ensure the list is not empty. */
+                ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
 
-        ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                /* Keep the bitmap of occupied slots up to date. */
+                if( ( pxList != &xTimerWheelOverflowList ) && ( listLIST_IS_EMPTY( pxList ) != pdFALSE ) )
+                {
+                    uxIndex = ( UBaseType_t ) ( pxList - &( xTimerWheel[ 0 ][ 0 ] ) );
+                    ulTimerWheelBitmap[ uxIndex >> tmrWHEEL_SLOT_BITS ] &= ~( 1UL << ( uxIndex & tmrWHEEL_SLOT_MASK ) );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+            }
+        #else /* if ( configUSE_TIMER_WHEEL == 1 ) */
+            {
+                ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+            }
+        #endif /* configUSE_TIMER_WHEEL */
+    }
+/*-----------------------------------------------------------*/
+
+    #if ( configUSE_TIMER_WHEEL == 0 )
 
-        /* If the timer is an auto-reload timer then calculate the next
-         * expiry time and re-insert the timer in the list of active timers. */
-        if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+        static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+                                            const TickType_t xTimeNow )
         {
-            prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            Timer_t * const pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxCurrentTimerList ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+
+            /* Remove the timer from the list of active timers.  A check has already
+             * been performed to ensure the list is not empty. */
+
+            ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+
+            /* If the timer is an auto-reload timer then calculate the next
+             * expiry time and re-insert the timer in the list of active timers. */
+            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+            {
+                prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+            }
+            else
+            {
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            }
+
+            /* Call the timer callback. */
+            traceTIMER_EXPIRED( pxTimer );
+            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
         }
-        else
+
+    #else /* if ( configUSE_TIMER_WHEEL == 0 ) */
+
+        static void prvProcessExpiredTimer( const TickType_t xNextExpireTime,
+                                            const TickType_t xTimeNow )
         {
-            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+            UBaseType_t uxLevel;
+            List_t * pxSlot;
+            Timer_t * pxTimer;
+
+            /* Advance the wheel to the tick being processed.  No slot has to be
+             * processed between the previous wheel time and this one, otherwise
+             * prvGetNextExpireTime() would have returned an earlier time. */
+            xTimerWheelTime = xNextExpireTime;
+
+            /* Cascade the slot of each level whose span starts at this tick,
+             * lowest level first.  Timers taken from a level always land in a
+             * later slot of the levels below, never in the slot that has just been
+             * emptied. */
+            for( uxLevel = ( UBaseType_t ) 1U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+            {
+                if( ( xTimerWheelTime & ( tmrWHEEL_LEVEL_SPAN( uxLevel ) - ( TickType_t ) 1U ) ) != ( TickType_t ) 0U )
+                {
+                    break;
+                }
+
+                prvWheelCascade( &( xTimerWheel[ uxLevel ][ ( xTimerWheelTime >> tmrWHEEL_LEVEL_SHIFT( uxLevel ) ) & tmrWHEEL_SLOT_MASK ] ) );
+            }
+
+            if( ( uxLevel == ( UBaseType_t ) configTIMER_WHEEL_LEVELS ) &&
+                ( ( xTimerWheelTime & ( tmrWHEEL_LEVEL_SPAN( configTIMER_WHEEL_LEVELS ) - ( TickType_t ) 1U ) ) == ( TickType_t ) 0U ) )
+            {
+                /* The whole wheel has rolled over, bring in the timers that now
+                 * fall within its span. */
+                prvWheelCascade( &xTimerWheelOverflowList );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+
+            /* Every timer in the level 0 slot of this tick expires now.  The wheel
+             * time is only moved past the tick once the slot is empty, so an
+             * auto-reload timer cannot be reinserted into the slot being
+             * drained. */
+            pxSlot = &( xTimerWheel[ 0 ][ xTimerWheelTime & tmrWHEEL_SLOT_MASK ] );
+
+            while( listLIST_IS_EMPTY( pxSlot ) == pdFALSE )
+            {
+                pxTimer = ( Timer_t * ) listGET_OWNER_OF_HEAD_ENTRY( pxSlot ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
+                prvRemoveTimerFromActiveList( pxTimer );
+
+                if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+                {
+                    prvReloadTimer( pxTimer, xNextExpireTime, xTimeNow );
+                }
+                else
+                {
+                    pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                }
+
+                /* Call the timer callback. */
+                traceTIMER_EXPIRED( pxTimer );
+                pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+            }
+
+            xTimerWheelTime = xNextExpireTime + ( TickType_t ) 1U;
         }
 
-        /* Call the timer callback. */
-        traceTIMER_EXPIRED( pxTimer );
-        pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
-    }
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static portTASK_FUNCTION( prvTimerTask, pvParameters )
@@ -613,8 +904,16 @@
 
             if( xTimerListsWereSwitched == pdFALSE )
             {
-                /* The tick count has not overflowed, has the timer expired? */
-                if( ( xListWasEmpty == pdFALSE ) && ( xNextExpireTime <= xTimeNow ) )
+                /* The tick count has not overflowed, has the timer expired?  The
+                 * wheel keeps timers across tick count overflows, so the times are
+                 * compared relative to each other. */
+                #if ( configUSE_TIMER_WHEEL == 1 )
+                    const BaseType_t xTimerExpired = ( ( TickType_t ) ( xTimeNow - xNextExpireTime ) <= tmrWHEEL_HALF_RANGE ) ? pdTRUE : pdFALSE;
+                #else
+                    const BaseType_t xTimerExpired = ( xNextExpireTime <= xTimeNow ) ? pdTRUE : pdFALSE;
+                #endif
+
+                if( ( xListWasEmpty == pdFALSE ) && ( xTimerExpired != pdFALSE ) )
                 {
                     ( void ) xTaskResumeAll();
                     prvProcessExpiredTimer( xNextExpireTime, xTimeNow );
@@ -627,12 +926,14 @@
                      * received - whichever comes first.  The following line cannot
                      * be reached unless xNextExpireTime > xTimeNow, except in the
                      * case when the current timer list is empty. */
-                    if( xListWasEmpty != pdFALSE )
-                    {
-                        /* The current timer list is empty - is the overflow list
-                         * also empty? */
-                        xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
-                    }
+                    #if ( configUSE_TIMER_WHEEL == 0 )
+                        if( xListWasEmpty != pdFALSE )
+                        {
+                            /* The current timer list is empty - is the overflow list
+                             * also empty? */
+                            xListWasEmpty = listLIST_IS_EMPTY( pxOverflowTimerList );
+                        }
+                    #endif
 
                     vQueueWaitForMessageRestricted( xTimerQueue, ( xNextExpireTime - xTimeNow ), xListWasEmpty );
 
@@ -658,104 +959,219 @@
     }
 /*-----------------------------------------------------------*/
 
-    static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
-    {
-        TickType_t xNextExpireTime;
+    #if ( configUSE_TIMER_WHEEL == 0 )
 
-        /* Timers are listed in expiry time order, with the head of the list
-         * referencing the task that will expire first.  Obtain the time at which
-         * the timer with the nearest expiry time will expire.  If there are no
-         * active timers then just set the next expire time to 0.  That will cause
-         * this task to unblock when the tick count overflows, at which point the
-         * timer lists will be switched and the next expiry time can be
-         * re-assessed.  */
-        *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
-
-        if( *pxListWasEmpty == pdFALSE )
+        static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            TickType_t xNextExpireTime;
+
+            /* Timers are listed in expiry time order, with the head of the list
+             * referencing the task that will expire first.  Obtain the time at which
+             * the timer with the nearest expiry time will expire.  If there are no
+             * active timers then just set the next expire time to 0.  That will cause
+             * this task to unblock when the tick count overflows, at which point the
+             * timer lists will be switched and the next expiry time can be
+             * re-assessed.  */
+            *pxListWasEmpty = listLIST_IS_EMPTY( pxCurrentTimerList );
+
+            if( *pxListWasEmpty == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            }
+            else
+            {
+                /* Ensure the task unblocks when the tick count rolls over. */
+                xNextExpireTime = ( TickType_t ) 0U;
+            }
+
+            return xNextExpireTime;
         }
-        else
+
+    #else /* if ( configUSE_TIMER_WHEEL == 0 ) */
+
+        static TickType_t prvGetNextExpireTime( BaseType_t * const pxListWasEmpty )
         {
-            /* Ensure the task unblocks when the tick count rolls over. */
-            xNextExpireTime = ( TickType_t ) 0U;
+            TickType_t xNextExpireTime = ( TickType_t ) 0U;
+            TickType_t xLevelTime;
+            TickType_t xCandidate;
+            UBaseType_t uxLevel;
+
+            *pxListWasEmpty = pdTRUE;
+
+            /* For every level find the first occupied slot, starting from the
+             * slot that is processed (level 0) or cascaded (upper levels) next.
+             * That gives the earliest tick at which the level needs attention,
+             * the smallest of those is the next expire time. */
+            for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+            {
+                if( ulTimerWheelBitmap[ uxLevel ] != 0UL )
+                {
+                    /* Round the wheel time up to the start of the next slot of
+                     * this level. */
+                    xLevelTime = ( xTimerWheelTime + ( tmrWHEEL_LEVEL_SPAN( uxLevel ) - ( TickType_t ) 1U ) ) & ~( tmrWHEEL_LEVEL_SPAN( uxLevel ) - ( TickType_t ) 1U );
+                    xCandidate = xLevelTime + ( ( TickType_t ) prvWheelFirstSlot( ulTimerWheelBitmap[ uxLevel ], ( UBaseType_t ) ( xLevelTime >> tmrWHEEL_LEVEL_SHIFT( uxLevel ) ) & tmrWHEEL_SLOT_MASK ) << tmrWHEEL_LEVEL_SHIFT( uxLevel ) );
+
+                    if( ( *pxListWasEmpty != pdFALSE ) ||
+                        ( ( TickType_t ) ( xCandidate - xTimerWheelTime ) < ( TickType_t ) ( xNextExpireTime - xTimerWheelTime ) ) )
+                    {
+                        xNextExpireTime = xCandidate;
+                        *pxListWasEmpty = pdFALSE;
+                    }
+                }
+            }
+
+            if( listLIST_IS_EMPTY( &xTimerWheelOverflowList ) == pdFALSE )
+            {
+                /* The overflow list is re-examined when the wheel rolls over. */
+                xCandidate = ( xTimerWheelTime + ( tmrWHEEL_LEVEL_SPAN( configTIMER_WHEEL_LEVELS ) - ( TickType_t ) 1U ) ) & ~( tmrWHEEL_LEVEL_SPAN( configTIMER_WHEEL_LEVELS ) - ( TickType_t ) 1U );
+
+                if( ( *pxListWasEmpty != pdFALSE ) ||
+                    ( ( TickType_t ) ( xCandidate - xTimerWheelTime ) < ( TickType_t ) ( xNextExpireTime - xTimerWheelTime ) ) )
+                {
+                    xNextExpireTime = xCandidate;
+                    *pxListWasEmpty = pdFALSE;
+                }
+            }
+
+            return xNextExpireTime;
         }
 
-        return xNextExpireTime;
-    }
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static TickType_t prvSampleTimeNow( BaseType_t * const pxTimerListsWereSwitched )
     {
         TickType_t xTimeNow;
-        PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
 
         xTimeNow = xTaskGetTickCount();
 
-        if( xTimeNow < xLastTime )
-        {
-            prvSwitchTimerLists();
-            *pxTimerListsWereSwitched = pdTRUE;
-        }
-        else
-        {
-            *pxTimerListsWereSwitched = pdFALSE;
-        }
+        #if ( configUSE_TIMER_WHEEL == 0 )
+            {
+                PRIVILEGED_DATA static TickType_t xLastTime = ( TickType_t ) 0U; /*lint !e956 Variable is only accessible to one task. */
 
-        xLastTime = xTimeNow;
+                if( xTimeNow < xLastTime )
+                {
+                    prvSwitchTimerLists();
+                    *pxTimerListsWereSwitched = pdTRUE;
+                }
+                else
+                {
+                    *pxTimerListsWereSwitched = pdFALSE;
+                }
+
+                xLastTime = xTimeNow;
+            }
+        #else /* if ( configUSE_TIMER_WHEEL == 0 ) */
+            {
+                /* The wheel handles tick count overflows itself.  While it is
+                 * empty its time is moved along with the tick count, so the
+                 * distance to a newly inserted expiry time is always small. */
+                UBaseType_t uxLevel;
+
+                for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+                {
+                    if( ulTimerWheelBitmap[ uxLevel ] != 0UL )
+                    {
+                        break;
+                    }
+                }
+
+                if( ( uxLevel == ( UBaseType_t ) configTIMER_WHEEL_LEVELS ) && ( listLIST_IS_EMPTY( &xTimerWheelOverflowList ) != pdFALSE ) )
+                {
+                    xTimerWheelTime = xTimeNow + ( TickType_t ) 1U;
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                *pxTimerListsWereSwitched = pdFALSE;
+            }
+        #endif /* configUSE_TIMER_WHEEL */
 
         return xTimeNow;
     }
 /*-----------------------------------------------------------*/
 
-    static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
-                                                  const TickType_t xNextExpiryTime,
-                                                  const TickType_t xTimeNow,
-                                                  const TickType_t xCommandTime )
-    {
-        BaseType_t xProcessTimerNow = pdFALSE;
-
-        listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
-        listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+    #if ( configUSE_TIMER_WHEEL == 0 )
 
-        if( xNextExpiryTime <= xTimeNow )
+        static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
+                                                      const TickType_t xNextExpiryTime,
+                                                      const TickType_t xTimeNow,
+                                                      const TickType_t xCommandTime )
         {
-            /* Has the expiry time elapsed between the command to start/reset a
-             * timer was issued, and the time the command was processed? */
-            if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+            BaseType_t xProcessTimerNow = pdFALSE;
+
+            listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
+            listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+
+            if( xNextExpiryTime <= xTimeNow )
             {
-                /* The time between a command being issued and the command being
-                 * processed actually exceeds the timers period.  */
-                xProcessTimerNow = pdTRUE;
+                /* Has the expiry time elapsed between the command to start/reset a
+                 * timer was issued, and the time the command was processed? */
+                if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
+                {
+                    /* The time between a command being issued and the command being
+                     * processed actually exceeds the timers period.  */
+                    xProcessTimerNow = pdTRUE;
+                }
+                else
+                {
+                    vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                }
             }
             else
             {
-                vListInsert( pxOverflowTimerList, &( pxTimer->xTimerListItem ) );
+                if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+                {
+                    /* If, since the command was issued, the tick count has overflowed
+                     * but the expiry time has not, then the timer must have already passed
+                     * its expiry time and should be processed immediately. */
+                    xProcessTimerNow = pdTRUE;
+                }
+                else
+                {
+                    vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                }
             }
+
+            return xProcessTimerNow;
         }
-        else
+
+    #else /* if ( configUSE_TIMER_WHEEL == 0 ) */
+
+        static BaseType_t prvInsertTimerInActiveList( Timer_t * const pxTimer,
+                                                      const TickType_t xNextExpiryTime,
+                                                      const TickType_t xTimeNow,
+                                                      const TickType_t xCommandTime )
         {
-            if( ( xTimeNow < xCommandTime ) && ( xNextExpiryTime >= xCommandTime ) )
+            BaseType_t xProcessTimerNow = pdFALSE;
+
+            listSET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ), xNextExpiryTime );
+            listSET_LIST_ITEM_OWNER( &( pxTimer->xTimerListItem ), pxTimer );
+
+            /* Has the expiry time elapsed between the command to start/reset a
+             * timer was issued, and the time the command was processed?  Unlike
+             * the list implementation this needs no special handling of a tick
+             * count overflow. */
+            if( ( ( TickType_t ) ( xTimeNow - xCommandTime ) ) >= pxTimer->xTimerPeriodInTicks ) /*lint !e961 MISRA exception as the casts are only redundant for some ports. */
             {
-                /* If, since the command was issued, the tick count has overflowed
-                 * but the expiry time has not, then the timer must have already passed
-                 * its expiry time and should be processed immediately. */
                 xProcessTimerNow = pdTRUE;
             }
             else
             {
-                vListInsert( pxCurrentTimerList, &( pxTimer->xTimerListItem ) );
+                prvWheelInsertTimer( pxTimer );
             }
+
+            return xProcessTimerNow;
         }
 
-        return xProcessTimerNow;
-    }
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static void prvProcessReceivedCommands( void )
     {
         DaemonTaskMessage_t xMessage;
-        Timer_t * pxTimer;
         BaseType_t xTimerListsWereSwitched;
         TickType_t xTimeNow;
 
@@ -783,146 +1199,298 @@
                 }
             #endif /* INCLUDE_xTimerPendFunctionCall */
 
-            /* Commands that are positive are timer commands rather than pended
-             * function calls. */
-            if( xMessage.xMessageID >= ( BaseType_t ) 0 )
+            if( xMessage.xMessageID == tmrCOMMAND_BATCH )
             {
+                /* A batch carries any number of timer commands. */
+                prvProcessCommandBatch( xMessage.u.xBatchParameters.pxBatch, xMessage.u.xBatchParameters.xCommandTime );
+            }
+            else if( xMessage.xMessageID >= ( BaseType_t ) 0 )
+            {
+                /* Commands that are positive are timer commands rather than pended
+                 * function calls.  In this case the xTimerListsWereSwitched
+                 * parameter is not used, but it must be present in the function
+                 * call.  prvSampleTimeNow() must be called after the message is
+                 * received from xTimerQueue so there is no possibility of a higher
+                 * priority task adding a message to the message queue with a time
+                 * that is ahead of the timer daemon task (because it pre-empted the
+                 * timer daemon task after the xTimeNow value was set). */
+                xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
                 /* The messages uses the xTimerParameters member to work on a
                  * software timer. */
-                pxTimer = xMessage.u.xTimerParameters.pxTimer;
+                prvProcessTimerCommand( xMessage.u.xTimerParameters.pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue, xTimeNow );
+            }
+            else
+            {
+                mtCOVERAGE_TEST_MARKER();
+            }
+        }
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvProcessCommandBatch( TimerCommandBatch_t * const pxBatch,
+                                        const TickType_t xCommandTime )
+    {
+        const TimerBatchCommand_t * pxCommand;
+        BaseType_t xTimerListsWereSwitched;
+        TickType_t xTimeNow;
+        TickType_t xMessageValue;
+        UBaseType_t uxIndex;
+
+        configASSERT( pxBatch );
+
+        /* Pairs with the barrier in xTimerSendCommandBatch(), the commands
+         * are read after the message that published them. */
+        portMEMORY_BARRIER();
+
+        /* One time sample serves the whole batch, all of its commands were
+         * issued at xCommandTime. */
+        xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
+
+        for( uxIndex = ( UBaseType_t ) 0U; uxIndex < pxBatch->uxCommandCount; uxIndex++ )
+        {
+            pxCommand = &( pxBatch->pxCommands[ uxIndex ] );
+
+            /* Translate the entry into the value a queued command would carry. */
+            if( pxCommand->xCommandID == tmrCOMMAND_CHANGE_PERIOD )
+            {
+                xMessageValue = pxCommand->xNewPeriod;
+            }
+            else
+            {
+                xMessageValue = xCommandTime;
+            }
+
+            prvProcessTimerCommand( pxCommand->xTimer, pxCommand->xCommandID, xMessageValue, xTimeNow );
+        }
+
+        /* The batch may be refilled by its owner from now on.  The array is
+         * no longer read and the count is cleared before the owner can see
+         * xPending cleared. */
+        pxBatch->uxCommandCount = ( UBaseType_t ) 0U;
+        portMEMORY_BARRIER();
+        pxBatch->xPending = pdFALSE;
+    }
+/*-----------------------------------------------------------*/
+
+    static void prvProcessTimerCommand( Timer_t * const pxTimer,
+                                        const BaseType_t xCommandID,
+                                        const TickType_t xMessageValue,
+                                        const TickType_t xTimeNow )
+    {
+        if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+        {
+            /* The timer is in a list, remove it. */
+            prvRemoveTimerFromActiveList( pxTimer );
+        }
+        else
+        {
+            mtCOVERAGE_TEST_MARKER();
+        }
+
+        traceTIMER_COMMAND_RECEIVED( pxTimer, xCommandID, xMessageValue );
 
-                if( listIS_CONTAINED_WITHIN( NULL, &( pxTimer->xTimerListItem ) ) == pdFALSE ) /*lint !e961. The cast is only redundant when NULL is passed into the macro. */
+        switch( xCommandID )
+        {
+            case tmrCOMMAND_START:
+            case tmrCOMMAND_START_FROM_ISR:
+            case tmrCOMMAND_RESET:
+            case tmrCOMMAND_RESET_FROM_ISR:
+                /* Start or restart a timer. */
+                pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+
+                if( prvInsertTimerInActiveList( pxTimer, xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessageValue ) != pdFALSE )
                 {
-                    /* The timer is in a list, remove it. */
-                    ( void ) uxListRemove( &( pxTimer->xTimerListItem ) );
+                    /* The timer expired before it was added to the active
+                     * timer list.  Process it now. */
+                    if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
+                    {
+                        prvReloadTimer( pxTimer, xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
+                    }
+                    else
+                    {
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                    }
+
+                    /* Call the timer callback. */
+                    traceTIMER_EXPIRED( pxTimer );
+                    pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
                 }
                 else
                 {
                     mtCOVERAGE_TEST_MARKER();
                 }
 
-                traceTIMER_COMMAND_RECEIVED( pxTimer, xMessage.xMessageID, xMessage.u.xTimerParameters.xMessageValue );
-
-                /* In this case the xTimerListsWereSwitched parameter is not used, but
-                 *  it must be present in the function call.  prvSampleTimeNow() must be
-                 *  called after the message is received from xTimerQueue so there is no
-                 *  possibility of a higher priority task adding a message to the message
-                 *  queue with a time that is ahead of the timer daemon task (because it
-                 *  pre-empted the timer daemon task after the xTimeNow value was set). */
-                xTimeNow = prvSampleTimeNow( &xTimerListsWereSwitched );
-
-                switch( xMessage.xMessageID )
-                {
-                    case tmrCOMMAND_START:
-                    case tmrCOMMAND_START_FROM_ISR:
-                    case tmrCOMMAND_RESET:
-                    case tmrCOMMAND_RESET_FROM_ISR:
-                        /* Start or restart a timer. */
-                        pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
-
-                        if( prvInsertTimerInActiveList( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow, xMessage.u.xTimerParameters.xMessageValue ) != pdFALSE )
+                break;
+
+            case tmrCOMMAND_STOP:
+            case tmrCOMMAND_STOP_FROM_ISR:
+                /* The timer has already been removed from the active list. */
+                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                break;
+
+            case tmrCOMMAND_CHANGE_PERIOD:
+            case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
+                pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
+                pxTimer->xTimerPeriodInTicks = xMessageValue;
+                configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
+
+                /* The new period does not really have a reference, and can
+                 * be longer or shorter than the old one.  The command time is
+                 * therefore set to the current time, and as the period cannot
+                 * be zero the next expiry time can only be in the future,
+                 * meaning (unlike for the xTimerStart() case above) there is
+                 * no fail case that needs to be handled here. */
+                ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
+                break;
+
+            case tmrCOMMAND_DELETE:
+                #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
+                    {
+                        /* The timer has already been removed from the active list,
+                         * just free up the memory if the memory was dynamically
+                         * allocated. */
+                        if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
                         {
-                            /* The timer expired before it was added to the active
-                             * timer list.  Process it now. */
-                            if( ( pxTimer->ucStatus & tmrSTATUS_IS_AUTORELOAD ) != 0 )
-                            {
-                                prvReloadTimer( pxTimer, xMessage.u.xTimerParameters.xMessageValue + pxTimer->xTimerPeriodInTicks, xTimeNow );
-                            }
-                            else
-                            {
-                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                            }
-
-                            /* Call the timer callback. */
-                            traceTIMER_EXPIRED( pxTimer );
-                            pxTimer->pxCallbackFunction( ( TimerHandle_t ) pxTimer );
+                            vPortFree( pxTimer );
                         }
                         else
                         {
-                            mtCOVERAGE_TEST_MARKER();
+                            pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
                         }
+                    }
+                #else /* if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
+                    {
+                        /* If dynamic allocation is not enabled, the memory
+                         * could not have been dynamically allocated. So there is
+                         * no need to free the memory - just mark the timer as
+                         * "not active". */
+                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
+                    }
+                #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
+                break;
 
-                        break;
+            default:
+                /* Don't expect to get here. */
+                break;
+        }
+    }
+/*-----------------------------------------------------------*/
 
-                    case tmrCOMMAND_STOP:
-                    case tmrCOMMAND_STOP_FROM_ISR:
-                        /* The timer has already been removed from the active list. */
-                        pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                        break;
+    #if ( configUSE_TIMER_WHEEL == 0 )
 
-                    case tmrCOMMAND_CHANGE_PERIOD:
-                    case tmrCOMMAND_CHANGE_PERIOD_FROM_ISR:
-                        pxTimer->ucStatus |= tmrSTATUS_IS_ACTIVE;
-                        pxTimer->xTimerPeriodInTicks = xMessage.u.xTimerParameters.xMessageValue;
-                        configASSERT( ( pxTimer->xTimerPeriodInTicks > 0 ) );
-
-                        /* The new period does not really have a reference, and can
-                         * be longer or shorter than the old one.  The command time is
-                         * therefore set to the current time, and as the period cannot
-                         * be zero the next expiry time can only be in the future,
-                         * meaning (unlike for the xTimerStart() case above) there is
-                         * no fail case that needs to be handled here. */
-                        ( void ) prvInsertTimerInActiveList( pxTimer, ( xTimeNow + pxTimer->xTimerPeriodInTicks ), xTimeNow, xTimeNow );
-                        break;
+        static void prvSwitchTimerLists( void )
+        {
+            TickType_t xNextExpireTime;
+            List_t * pxTemp;
+
+            /* The tick count has overflowed.  The timer lists must be switched.
+             * If there are any timers still referenced from the current timer list
+             * then they must have expired and should be processed before the lists
+             * are switched. */
+            while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+            {
+                xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
 
-                    case tmrCOMMAND_DELETE:
-                        #if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 )
-                            {
-                                /* The timer has already been removed from the active list,
-                                 * just free up the memory if the memory was dynamically
-                                 * allocated. */
-                                if( ( pxTimer->ucStatus & tmrSTATUS_IS_STATICALLY_ALLOCATED ) == ( uint8_t ) 0 )
-                                {
-                                    vPortFree( pxTimer );
-                                }
-                                else
-                                {
-                                    pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                                }
-                            }
-                        #else /* if ( configSUPPORT_DYNAMIC_ALLOCATION == 1 ) */
-                            {
-                                /* If dynamic allocation is not enabled, the memory
-                                 * could not have been dynamically allocated. So there is
-                                 * no need to free the memory - just mark the timer as
-                                 * "not active". */
-                                pxTimer->ucStatus &= ( ( uint8_t ) ~tmrSTATUS_IS_ACTIVE );
-                            }
-                        #endif /* configSUPPORT_DYNAMIC_ALLOCATION */
-                        break;
+                /* Process the expired timer.  For auto-reload timers, be careful to
+                 * process only expirations that occur on the current list.  Further
+                 * expirations must wait until after the lists are switched. */
+                prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            }
 
-                    default:
-                        /* Don't expect to get here. */
-                        break;
+            pxTemp = pxCurrentTimerList;
+            pxCurrentTimerList = pxOverflowTimerList;
+            pxOverflowTimerList = pxTemp;
+        }
+
+    #else /* if ( configUSE_TIMER_WHEEL == 0 ) */
+
+        static void prvWheelInsertTimer( Timer_t * const pxTimer )
+        {
+            const TickType_t xExpiryTime = listGET_LIST_ITEM_VALUE( &( pxTimer->xTimerListItem ) );
+            const TickType_t xTicksToExpiry = xExpiryTime - xTimerWheelTime;
+            UBaseType_t uxLevel;
+            UBaseType_t uxSlot;
+
+            /* The level is chosen by how far away the expiry time is, the slot
+             * within the level by the expiry time itself. */
+            for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+            {
+                if( xTicksToExpiry < tmrWHEEL_LEVEL_SPAN( uxLevel + ( UBaseType_t ) 1U ) )
+                {
+                    break;
                 }
             }
+
+            if( uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS )
+            {
+                uxSlot = ( UBaseType_t ) ( xExpiryTime >> tmrWHEEL_LEVEL_SHIFT( uxLevel ) ) & tmrWHEEL_SLOT_MASK;
+                vListInsertEnd( &( xTimerWheel[ uxLevel ][ uxSlot ] ), &( pxTimer->xTimerListItem ) );
+                ulTimerWheelBitmap[ uxLevel ] |= ( 1UL << uxSlot );
+            }
+            else
+            {
+                vListInsertEnd( &xTimerWheelOverflowList, &( pxTimer->xTimerListItem ) );
+            }
         }
-    }
 /*-----------------------------------------------------------*/
 
-    static void prvSwitchTimerLists( void )
-    {
-        TickType_t xNextExpireTime;
-        List_t * pxTemp;
+        static void prvWheelCascade( List_t * const pxList )
+        {
+            ListItem_t const * const pxEnd = listGET_END_MARKER( pxList );
+            ListItem_t * pxItem = listGET_HEAD_ENTRY( pxList );
+            ListItem_t * pxNextItem;
+            Timer_t * pxTimer;
+
+            /* Walk the list once.  The timers of a wheel slot always move to a
+             * lower level, but timers in the overflow list that are still beyond
+             * the span of the wheel are left where they are. */
+            while( pxItem != pxEnd )
+            {
+                pxNextItem = listGET_NEXT( pxItem );
+                pxTimer = ( Timer_t * ) listGET_LIST_ITEM_OWNER( pxItem ); /*lint !e9087 !e9079 void * is used as this macro is used with tasks and co-routines too.  Alignment is known to be fine as the type of the pointer stored and retrieved is the same. */
 
-        /* The tick count has overflowed.  The timer lists must be switched.
-         * If there are any timers still referenced from the current timer list
-         * then they must have expired and should be processed before the lists
-         * are switched. */
-        while( listLIST_IS_EMPTY( pxCurrentTimerList ) == pdFALSE )
+                if( ( pxList != &xTimerWheelOverflowList ) ||
+                    ( ( TickType_t ) ( listGET_LIST_ITEM_VALUE( pxItem ) - xTimerWheelTime ) < tmrWHEEL_LEVEL_SPAN( configTIMER_WHEEL_LEVELS ) ) )
+                {
+                    prvRemoveTimerFromActiveList( pxTimer );
+                    prvWheelInsertTimer( pxTimer );
+                }
+                else
+                {
+                    mtCOVERAGE_TEST_MARKER();
+                }
+
+                pxItem = pxNextItem;
+            }
+        }
+/*-----------------------------------------------------------*/
+
+        static UBaseType_t prvWheelFirstSlot( const uint32_t ulBitmap,
+                                              const UBaseType_t uxStartSlot )
         {
-            xNextExpireTime = listGET_ITEM_VALUE_OF_HEAD_ENTRY( pxCurrentTimerList );
+            /* Rotate the bitmap so uxStartSlot becomes bit 0, then count the
+             * trailing zeros. */
+            uint32_t ulRotated = ( ulBitmap >> uxStartSlot ) | ( ulBitmap << ( ( tmrWHEEL_SLOTS - uxStartSlot ) & tmrWHEEL_SLOT_MASK ) );
+            UBaseType_t uxDistance;
 
-            /* Process the expired timer.  For auto-reload timers, be careful to
-             * process only expirations that occur on the current list.  Further
-             * expirations must wait until after the lists are switched. */
-            prvProcessExpiredTimer( xNextExpireTime, tmrMAX_TIME_BEFORE_OVERFLOW );
+            #if defined( __GNUC__ )
+                {
+                    uxDistance = ( UBaseType_t ) __builtin_ctz( ulRotated );
+                }
+            #else
+                {
+                    for( uxDistance = ( UBaseType_t ) 0U; ( ulRotated & 1UL ) == 0UL; uxDistance++ )
+                    {
+                        ulRotated >>= 1U;
+                    }
+                }
+            #endif
+
+            return uxDistance;
         }
 
-        pxTemp = pxCurrentTimerList;
-        pxCurrentTimerList = pxOverflowTimerList;
-        pxOverflowTimerList = pxTemp;
-    }
+    #endif /* configUSE_TIMER_WHEEL */
 /*-----------------------------------------------------------*/
 
     static void prvCheckForValidListAndQueue( void )
@@ -934,10 +1502,31 @@
         {
             if( xTimerQueue == NULL )
             {
-                vListInitialise( &xActiveTimerList1 );
-                vListInitialise( &xActiveTimerList2 );
-                pxCurrentTimerList = &xActiveTimerList1;
-                pxOverflowTimerList = &xActiveTimerList2;
+                #if ( configUSE_TIMER_WHEEL == 0 )
+                    {
+                        vListInitialise( &xActiveTimerList1 );
+                        vListInitialise( &xActiveTimerList2 );
+                        pxCurrentTimerList = &xActiveTimerList1;
+                        pxOverflowTimerList = &xActiveTimerList2;
+                    }
+                #else
+                    {
+                        UBaseType_t uxLevel;
+                        UBaseType_t uxSlot;
+
+                        for( uxLevel = ( UBaseType_t ) 0U; uxLevel < ( UBaseType_t ) configTIMER_WHEEL_LEVELS; uxLevel++ )
+                        {
+                            for( uxSlot = ( UBaseType_t ) 0U; uxSlot < tmrWHEEL_SLOTS; uxSlot++ )
+                            {
+                                vListInitialise( &( xTimerWheel[ uxLevel ][ uxSlot ] ) );
+                            }
+
+                            ulTimerWheelBitmap[ uxLevel ] = 0UL;
+                        }
+
+                        vListInitialise( &xTimerWheelOverflowList );
+                    }
+                #endif /* configUSE_TIMER_WHEEL */
 
                 #if ( configSUPPORT_STATIC_ALLOCATION == 1 )
                     {
@@ -0,0 +1,140 @@
+/**
+  ******************************************************************************
+  * @file    flash_file.c
+  * @brief   Flash operations of the configuration store backed by a file.
+  *
+  *          The two sectors are an image file mapped into memory, so the
+  *          store reads them through their address as it does on the
+  *          target.  An erase sets a sector to 0xFF and programming can only
+  *          clear bits, as the NOR flash.  The power can be cut after a
+  *          number of program operations to leave a record or a compaction
+  *          unfinished.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "flash_file.h"
+
+#include <assert.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const uint8_t *flash_file_address(uint32_t sector);
+static bool flash_file_erase(uint32_t sector);
+static bool flash_file_program(uint32_t sector, uint32_t offset, const uint32_t *words, uint32_t count);
+
+static config_flash_t flash_file = {
+	0,
+	flash_file_address,
+	flash_file_erase,
+	flash_file_program
+};
+
+static uint8_t *flash_file_map;
+static int32_t flash_file_budget = -1;
+
+const config_flash_t *flash_file_open(const char *path, uint32_t sector_size)
+{
+	size_t size = (size_t)sector_size * CONFIG_FLASH_SECTORS;
+	struct stat st;
+	bool created;
+	int fd;
+
+	assert(flash_file_map == NULL);
+	assert((sector_size % sizeof(uint32_t)) == 0);
+
+	fd = open(path, O_RDWR | O_CREAT, 0644);
+	if (fd < 0) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+
+	created = (fstat(fd, &st) == 0) && (st.st_size == 0);
+	if ((true == created) && (ftruncate(fd, (off_t)size) != 0)) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+
+	flash_file_map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	close(fd);
+	if (flash_file_map == MAP_FAILED) {
+		perror(path);
+		exit(EXIT_FAILURE);
+	}
+
+	if (true == created) {
+		memset(flash_file_map, 0xFF, size);
+	}
+
+	flash_file.sector_size = sector_size;
+	flash_file_budget = -1;
+
+	return &flash_file;
+}
+
+void flash_file_close(void)
+{
+	assert(flash_file_map != NULL);
+
+	msync(flash_file_map, (size_t)flash_file.sector_size * CONFIG_FLASH_SECTORS, MS_SYNC);
+	munmap(flash_file_map, (size_t)flash_file.sector_size * CONFIG_FLASH_SECTORS);
+	flash_file_map = NULL;
+}
+
+void flash_file_set_budget(int32_t budget)
+{
+	flash_file_budget = budget;
+}
+
+uint8_t *flash_file_image(uint32_t sector)
+{
+	assert(sector < CONFIG_FLASH_SECTORS);
+
+	return flash_file_map + (size_t)sector * flash_file.sector_size;
+}
+
+static const uint8_t *flash_file_address(uint32_t sector)
+{
+	return flash_file_image(sector);
+}
+
+static bool flash_file_erase(uint32_t sector)
+{
+	if (flash_file_budget == 0) {
+		return false;
+	}
+
+	memset(flash_file_image(sector), 0xFF, flash_file.sector_size);
+
+	return true;
+}
+
+static bool flash_file_program(uint32_t sector, uint32_t offset, const uint32_t *words, uint32_t count)
+{
+	uint32_t *image;
+	uint32_t i;
+
+	assert((offset % sizeof(uint32_t)) == 0);
+	assert(offset + count * sizeof(uint32_t) <= flash_file.sector_size);
+
+	if (flash_file_budget == 0) {
+		return false;
+	}
+
+	if (flash_file_budget > 0) {
+		flash_file_budget--;
+	}
+
+	image = (uint32_t *)(flash_file_image(sector) + offset);
+	for (i = 0; i < count; i++) {
+		image[i] &= words[i];
+	}
+
+	return true;
+}
@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    flash_file.h
+  * @brief   This file contains all the function prototypes for
+  *          the flash_file.c file
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __FLASH_FILE_H__
+#define __FLASH_FILE_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "config_flash.h"
+
+/* Maps the image file of the two sectors, it is created erased if it does
+not exist.  Closing and opening the file again is a reset of the target. */
+const config_flash_t *flash_file_open(const char *path, uint32_t sector_size);
+void flash_file_close(void);
+
+/* Number of program operations that complete before the power is cut, the
+later ones and every erase fail without changing the image.  A negative
+budget is unlimited. */
+void flash_file_set_budget(int32_t budget);
+
+/* The image, for the checks of the tests. */
+uint8_t *flash_file_image(uint32_t sector);
+
+#endif /* __FLASH_FILE_H__ */
@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file    FreeRTOS.h
+  * @brief   Host stand-in of the FreeRTOS types and macros used by the
+  *          modules under test
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __STUB_FREERTOS_H__
+#define __STUB_FREERTOS_H__
+
+#include <stdint.h>
+#include <assert.h>
+
+typedef long BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t TickType_t;
+
+#define pdFALSE                         ( ( BaseType_t ) 0 )
+#define pdTRUE                          ( ( BaseType_t ) 1 )
+#define pdPASS                          ( pdTRUE )
+#define pdFAIL                          ( pdFALSE )
+
+#define configTICK_RATE_HZ              1000U
+#define portMAX_DELAY                   ( TickType_t ) 0xffffffffUL
+#define pdMS_TO_TICKS( xTimeInMs )      ( ( TickType_t ) ( xTimeInMs ) )
+
+#define configASSERT( x )               assert( x )
+#define PRIVILEGED_DATA
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#define __DMB()                         __sync_synchronize()
+
+#endif /* __STUB_FREERTOS_H__ */
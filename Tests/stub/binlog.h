@@ -0,0 +1,15 @@
+/**
+  ******************************************************************************
+  * @file    binlog.h
+  * @brief   Host stand-in of the binary log, the messages are discarded
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __STUB_BINLOG_H__
+#define __STUB_BINLOG_H__
+
+#define BINLOG(...)                     ( ( void ) 0 )
+
+#endif /* __STUB_BINLOG_H__ */
@@ -0,0 +1,69 @@
+/**
+  ******************************************************************************
+  * @file    rtc.h
+  * @brief   Host stand-in of the RTC, which never holds a calendar
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __STUB_RTC_H__
+#define __STUB_RTC_H__
+
+#include <stdint.h>
+#include <stdbool.h>
+
+typedef struct {
+	uint8_t  Hours;
+	uint8_t  Minutes;
+	uint8_t  Seconds;
+	uint8_t  TimeFormat;
+	uint32_t SubSeconds;
+	uint32_t SecondFraction;
+} RTC_TimeTypeDef;
+
+typedef struct {
+	uint8_t WeekDay;
+	uint8_t Month;
+	uint8_t Date;
+	uint8_t Year;
+} RTC_DateTypeDef;
+
+#define RTC_BACKUP_CALENDAR         0U
+#define RTC_BACKUP_CLOCK_SOURCE     1U
+#define RTC_BACKUP_CLOCK_DRIFT      2U
+#define RTC_BACKUP_CLOCK_CHECK      3U
+
+static inline bool RTC_IsReady(void)
+{
+	return true;
+}
+
+static inline bool RTC_IsRestored(void)
+{
+	return false;
+}
+
+static inline bool RTC_GetCalendar(RTC_TimeTypeDef *sTime, RTC_DateTypeDef *sDate)
+{
+	*sTime = (RTC_TimeTypeDef){ 0 };
+	*sDate = (RTC_DateTypeDef){ 0 };
+
+	return false;
+}
+
+static inline bool RTC_SetCalendar(const RTC_TimeTypeDef *sTime, const RTC_DateTypeDef *sDate, uint64_t start_us)
+{
+	return false;
+}
+
+static inline uint32_t RTC_ReadBackup(uint32_t index)
+{
+	return 0;
+}
+
+static inline void RTC_WriteBackup(uint32_t index, uint32_t value)
+{
+}
+
+#endif /* __STUB_RTC_H__ */
@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file    semphr.h
+  * @brief   Host stand-in of the FreeRTOS semaphores, the tests run in a
+  *          single thread so a take always succeeds
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __STUB_SEMPHR_H__
+#define __STUB_SEMPHR_H__
+
+#include "FreeRTOS.h"
+
+typedef void * SemaphoreHandle_t;
+
+static inline SemaphoreHandle_t xSemaphoreCreateMutex( void )
+{
+	return ( SemaphoreHandle_t ) 1;
+}
+
+static inline BaseType_t xSemaphoreTake( SemaphoreHandle_t xSemaphore, TickType_t xBlockTime )
+{
+	( void ) xSemaphore;
+	( void ) xBlockTime;
+
+	return pdPASS;
+}
+
+static inline BaseType_t xSemaphoreGive( SemaphoreHandle_t xSemaphore )
+{
+	( void ) xSemaphore;
+
+	return pdPASS;
+}
+
+#endif /* __STUB_SEMPHR_H__ */
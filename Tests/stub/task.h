@@ -0,0 +1,29 @@
+/**
+  ******************************************************************************
+  * @file    task.h
+  * @brief   Host stand-in of the FreeRTOS task API, the tests run in a
+  *          single thread
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __STUB_TASK_H__
+#define __STUB_TASK_H__
+
+#include "FreeRTOS.h"
+
+static inline void vTaskSuspendAll( void )
+{
+}
+
+static inline BaseType_t xTaskResumeAll( void )
+{
+	return pdFALSE;
+}
+
+static inline void vTaskDelay( const TickType_t xTicksToDelay )
+{
+}
+
+#endif /* __STUB_TASK_H__ */
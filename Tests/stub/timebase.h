@@ -0,0 +1,20 @@
+/**
+  ******************************************************************************
+  * @file    timebase.h
+  * @brief   Host stand-in of the microsecond timebase, which stands still
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __STUB_TIMEBASE_H__
+#define __STUB_TIMEBASE_H__
+
+#include <stdint.h>
+
+static inline uint64_t timebase_get_us64(void)
+{
+	return 0;
+}
+
+#endif /* __STUB_TIMEBASE_H__ */
@@ -0,0 +1,30 @@
+/**
+  ******************************************************************************
+  * @file    timers.h
+  * @brief   Host stand-in of the FreeRTOS software timers, which never fire
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __STUB_TIMERS_H__
+#define __STUB_TIMERS_H__
+
+#include "FreeRTOS.h"
+
+typedef void * TimerHandle_t;
+typedef void ( *TimerCallbackFunction_t )( TimerHandle_t xTimer );
+
+static inline TimerHandle_t xTimerCreate( const char * const pcTimerName, const TickType_t xTimerPeriodInTicks,
+										  const UBaseType_t uxAutoReload, void * const pvTimerID,
+										  TimerCallbackFunction_t pxCallbackFunction )
+{
+	return ( TimerHandle_t ) 1;
+}
+
+static inline BaseType_t xTimerStart( TimerHandle_t xTimer, TickType_t xTicksToWait )
+{
+	return pdPASS;
+}
+
+#endif /* __STUB_TIMERS_H__ */
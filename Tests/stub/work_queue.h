@@ -0,0 +1,42 @@
+/**
+  ******************************************************************************
+  * @file    work_queue.h
+  * @brief   Host stand-in of the work queue, the submitted items run when
+  *          the test calls work_queue_run()
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __STUB_WORK_QUEUE_H__
+#define __STUB_WORK_QUEUE_H__
+
+#include <stdbool.h>
+#include "FreeRTOS.h"
+
+typedef enum {
+	WORK_QUEUE_HIGH = 0,
+	WORK_QUEUE_MEDIUM,
+	WORK_QUEUE_LOW,
+	WORK_QUEUE_LEVELS
+} work_queue_level_t;
+
+typedef struct work_queue_item work_queue_item_t;
+
+typedef void ( *work_queue_function_t )( work_queue_item_t *item, void *arg );
+
+struct work_queue_item {
+	work_queue_item_t     *next;
+	work_queue_function_t  function;
+	void                  *arg;
+	bool                   pending;
+};
+
+void work_queue_item_init(work_queue_item_t *item, work_queue_function_t function, void *arg, work_queue_level_t level);
+bool work_queue_submit(work_queue_item_t *item);
+bool work_queue_is_pending(const work_queue_item_t *item);
+
+/* Runs the submitted items, returns their number. */
+unsigned work_queue_run(void);
+
+#endif /* __STUB_WORK_QUEUE_H__ */
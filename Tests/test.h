@@ -0,0 +1,38 @@
+/**
+  ******************************************************************************
+  * @file    test.h
+  * @brief   Checks of the host tests
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#ifndef __TEST_H__
+#define __TEST_H__
+
+#include <stdio.h>
+
+/* A failed check is reported and the test goes on, main() returns the
+number of failures. */
+#define TEST_CHECK(cond)                                                      \
+	do {                                                                      \
+		test_checks++;                                                        \
+		if (!(cond)) {                                                        \
+			test_failures++;                                                  \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond);   \
+		}                                                                     \
+	} while (0)
+
+#define TEST_RUN(test)                                                        \
+	do {                                                                      \
+		printf("%s\n", #test);                                                \
+		test();                                                               \
+	} while (0)
+
+#define TEST_REPORT()                                                         \
+	( printf("%u checks, %u failed\n", test_checks, test_failures), (int)(test_failures != 0) )
+
+static unsigned test_checks;
+static unsigned test_failures;
+
+#endif /* __TEST_H__ */
@@ -0,0 +1,396 @@
+/**
+  ******************************************************************************
+  * @file    test_config_store.c
+  * @brief   Host tests of the configuration store on a file-backed flash.
+  *
+  *          A reset of the target is simulated by closing the image file,
+  *          opening it again and calling config_store_init(), which has to
+  *          find the active sector and rebuild the index from the flash
+  *          alone.  The power is cut in the middle of a record and of a
+  *          compaction by limiting the number of program operations.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "config_store.h"
+#include "flash_file.h"
+#include "work_queue.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define TEST_IMAGE                      "config_flash.img"
+#define TEST_SECTOR_SIZE                1024U
+
+typedef struct {
+	unsigned long active;
+	unsigned long generation;
+	unsigned long used;
+	unsigned long keys;
+	unsigned long writes;
+	unsigned long compactions;
+	unsigned long erases;
+	unsigned long corrupt;
+} test_stats_t;
+
+static char test_output[ 2048 ];
+static char test_counter[ 16 ];
+
+static void test_reset(void)
+{
+	flash_file_close();
+	config_store_init(flash_file_open(TEST_IMAGE, TEST_SECTOR_SIZE));
+}
+
+static void test_stats(test_stats_t *stats)
+{
+	unsigned long size;
+	unsigned long live;
+	unsigned long max_keys;
+	int n;
+
+	config_store_print(test_output, sizeof(test_output));
+
+	n = sscanf(test_output,
+		" Sector %lu, generation %lu, used %lu of %lu bytes, live %lu bytes, %lu of %lu keys"
+		" Writes: %lu, compactions: %lu, erases: %lu, corrupt records: %lu",
+		&stats->active, &stats->generation, &stats->used, &size, &live, &stats->keys, &max_keys,
+		&stats->writes, &stats->compactions, &stats->erases, &stats->corrupt);
+	TEST_CHECK(n == 11);
+	TEST_CHECK(size == TEST_SECTOR_SIZE);
+}
+
+static bool test_value_is(const char *key, const char *expected)
+{
+	char value[ CONFIG_STORE_VALUE_MAX + 1U ];
+
+	return (true == config_store_get(key, value, sizeof(value))) && (strcmp(value, expected) == 0);
+}
+
+static bool test_listed(const char *line)
+{
+	config_store_print(test_output, sizeof(test_output));
+
+	return strstr(test_output, line) != NULL;
+}
+
+static void test_format(void)
+{
+	test_stats_t stats;
+	char value[ 16 ];
+
+	unlink(TEST_IMAGE);
+	config_store_init(flash_file_open(TEST_IMAGE, TEST_SECTOR_SIZE));
+
+	test_stats(&stats);
+	TEST_CHECK(stats.active == 0);
+	TEST_CHECK(stats.generation == 0);
+	TEST_CHECK(stats.used == 16);
+	TEST_CHECK(stats.keys == 0);
+	TEST_CHECK(true != config_store_get("missing", value, sizeof(value)));
+
+	test_reset();
+	test_stats(&stats);
+	TEST_CHECK(stats.active == 0);
+	TEST_CHECK(stats.generation == 0);
+	TEST_CHECK(stats.used == 16);
+}
+
+static void test_set_get_delete_list(void)
+{
+	test_stats_t before;
+	test_stats_t after;
+	char value[ 16 ];
+	uint32_t number;
+
+	TEST_CHECK(true == config_store_set("baud", "115200"));
+	TEST_CHECK(true == config_store_set("name", "F407 discovery"));
+	TEST_CHECK(true == config_store_set("mask", "0x1F"));
+	TEST_CHECK(true == test_value_is("baud", "115200"));
+	TEST_CHECK(true == test_value_is("name", "F407 discovery"));
+
+	TEST_CHECK(true == config_store_get_u32("baud", &number) && (number == 115200));
+	TEST_CHECK(true == config_store_get_u32("mask", &number) && (number == 0x1F));
+	TEST_CHECK(true != config_store_get_u32("name", &number));
+
+	/* The value does not fit, the terminator included. */
+	TEST_CHECK(true != config_store_get("baud", value, 6));
+	TEST_CHECK(true == config_store_get("baud", value, 7));
+
+	/* An unchanged value is not written again. */
+	test_stats(&before);
+	TEST_CHECK(true == config_store_set("baud", "115200"));
+	test_stats(&after);
+	TEST_CHECK(after.writes == before.writes);
+	TEST_CHECK(after.used == before.used);
+
+	TEST_CHECK(true == config_store_set("baud", "9600"));
+	TEST_CHECK(true == test_value_is("baud", "9600"));
+	test_stats(&after);
+	TEST_CHECK(after.writes == before.writes + 1U);
+	TEST_CHECK(after.keys == 3);
+
+	TEST_CHECK(true != config_store_set("", "1"));
+	TEST_CHECK(true != config_store_set("two words", "1"));
+	TEST_CHECK(true != config_store_set("01234567890123456", "1"));
+	TEST_CHECK(true != config_store_set("empty", ""));
+	TEST_CHECK(true != config_store_set("tab", "a\tb"));
+	TEST_CHECK(true != config_store_get("two words", value, sizeof(value)));
+
+	TEST_CHECK(true == test_listed("baud = 9600\r\n"));
+	TEST_CHECK(true == test_listed("name = F407 discovery\r\n"));
+	TEST_CHECK(true == test_listed("mask = 0x1F\r\n"));
+
+	TEST_CHECK(true == config_store_delete("mask"));
+	TEST_CHECK(true != config_store_delete("mask"));
+	TEST_CHECK(true != config_store_get("mask", value, sizeof(value)));
+	TEST_CHECK(true != test_listed("mask ="));
+	test_stats(&after);
+	TEST_CHECK(after.keys == 2);
+
+	test_reset();
+	TEST_CHECK(true == test_value_is("baud", "9600"));
+	TEST_CHECK(true == test_value_is("name", "F407 discovery"));
+	TEST_CHECK(true != config_store_get("mask", value, sizeof(value)));
+	test_stats(&after);
+	TEST_CHECK(after.keys == 2);
+}
+
+static void test_max_keys(void)
+{
+	test_stats_t stats;
+	char key[ 16 ];
+	uint32_t i;
+
+	test_stats(&stats);
+
+	for (i = stats.keys; i < CONFIG_STORE_MAX_KEYS; i++) {
+		snprintf(key, sizeof(key), "key%u", ( unsigned ) (i & 0xFFU));
+		TEST_CHECK(true == config_store_set(key, "1"));
+		work_queue_run();
+	}
+
+	TEST_CHECK(true != config_store_set("one_more", "1"));
+
+	/* A key that exists can still be changed, a deleted one frees a place. */
+	TEST_CHECK(true == config_store_set("baud", "19200"));
+	TEST_CHECK(true == config_store_delete("key10"));
+	TEST_CHECK(true == config_store_set("one_more", "1"));
+	work_queue_run();
+
+	test_reset();
+	test_stats(&stats);
+	TEST_CHECK(stats.keys == CONFIG_STORE_MAX_KEYS);
+	TEST_CHECK(true == test_value_is("one_more", "1"));
+	TEST_CHECK(true == test_value_is("baud", "19200"));
+
+	for (i = 2; i < CONFIG_STORE_MAX_KEYS; i++) {
+		snprintf(key, sizeof(key), "key%u", ( unsigned ) (i & 0xFFU));
+		( void ) config_store_delete(key);
+		work_queue_run();
+	}
+
+	TEST_CHECK(true == config_store_delete("one_more"));
+}
+
+static void test_torn_record(void)
+{
+	test_stats_t before;
+	test_stats_t after;
+
+	TEST_CHECK(true == config_store_set("torn", "old"));
+	work_queue_run();
+	test_stats(&before);
+
+	/* The power is cut after the header, key and value are programmed and
+	before the CRC. */
+	flash_file_set_budget(1);
+	TEST_CHECK(true != config_store_set("torn", "new"));
+
+	test_reset();
+	test_stats(&after);
+	TEST_CHECK(true == test_value_is("torn", "old"));
+	TEST_CHECK(after.corrupt == before.corrupt + 1U);
+	TEST_CHECK(after.used == before.used + 16U);
+	TEST_CHECK(after.keys == before.keys);
+
+	/* The log goes on after the torn record. */
+	TEST_CHECK(true == config_store_set("torn", "newer"));
+	test_reset();
+	TEST_CHECK(true == test_value_is("torn", "newer"));
+	TEST_CHECK(true == test_value_is("baud", "19200"));
+	TEST_CHECK(true == config_store_delete("torn"));
+	work_queue_run();
+}
+
+static void test_compaction(void)
+{
+	test_stats_t before;
+	test_stats_t stats;
+	char value[ 16 ];
+	uint32_t i;
+
+	test_stats(&before);
+
+	/* The background work compacts the log once the sector is filling up
+	and erases the sector left behind. */
+	for (i = 0; i < 200; i++) {
+		snprintf(value, sizeof(value), "%lu", ( unsigned long ) i);
+		TEST_CHECK(true == config_store_set("counter", value));
+		work_queue_run();
+	}
+
+	test_stats(&stats);
+	TEST_CHECK(stats.compactions > before.compactions);
+	TEST_CHECK(stats.generation == before.generation + (stats.compactions - before.compactions));
+	TEST_CHECK(stats.active == ((before.active + stats.compactions - before.compactions) & 1U));
+	TEST_CHECK(stats.used <= (TEST_SECTOR_SIZE / 100U) * CONFIG_STORE_COMPACT_THRESHOLD);
+	TEST_CHECK(true == test_value_is("counter", "199"));
+	TEST_CHECK(true == test_value_is("baud", "19200"));
+	TEST_CHECK(true == test_value_is("name", "F407 discovery"));
+	TEST_CHECK(memcmp(flash_file_image(stats.active ^ 1U), "\xFF\xFF\xFF\xFF", 4) == 0);
+
+	/* Without the worker the sector fills up and the set compacts it. */
+	before = stats;
+	for (i = 0; i < 200; i++) {
+		snprintf(value, sizeof(value), "%lu", ( unsigned long ) i);
+		TEST_CHECK(true == config_store_set("counter", value));
+	}
+
+	test_stats(&stats);
+	TEST_CHECK(stats.compactions > before.compactions);
+	TEST_CHECK(true == test_value_is("counter", "199"));
+
+	test_reset();
+	test_stats(&before);
+	TEST_CHECK(before.active == stats.active);
+	TEST_CHECK(before.generation == stats.generation);
+	TEST_CHECK(true == test_value_is("counter", "199"));
+	TEST_CHECK(true == test_value_is("name", "F407 discovery"));
+	work_queue_run();
+}
+
+/* Writes values until the next set schedules a compaction. */
+static void test_fill_until_compaction(void)
+{
+	test_stats_t before;
+	test_stats_t stats;
+	uint32_t i;
+
+	test_stats(&before);
+
+	for (i = 0; i < 200; i++) {
+		snprintf(test_counter, sizeof(test_counter), "x%lu", ( unsigned long ) i);
+		TEST_CHECK(true == config_store_set("counter", test_counter));
+
+		test_stats(&stats);
+		if (stats.used > (TEST_SECTOR_SIZE / 100U) * CONFIG_STORE_COMPACT_THRESHOLD) {
+			break;
+		}
+	}
+
+	TEST_CHECK(stats.compactions == before.compactions);
+}
+
+static void test_interrupted_compaction(void)
+{
+	test_stats_t before;
+	test_stats_t stats;
+
+	/* baud, name and counter are live. */
+	work_queue_run();
+	test_fill_until_compaction();
+	test_stats(&before);
+	TEST_CHECK(before.keys == 3);
+
+	/* The live records are copied but the header of the new sector is not
+	programmed, the old sector stays the active one. */
+	flash_file_set_budget(( int32_t ) before.keys);
+	work_queue_run();
+
+	test_reset();
+	test_stats(&stats);
+	TEST_CHECK(stats.active == before.active);
+	TEST_CHECK(stats.generation == before.generation);
+	TEST_CHECK(stats.used == before.used);
+	TEST_CHECK(true == test_value_is("counter", test_counter));
+	TEST_CHECK(true == test_value_is("baud", "19200"));
+
+	/* The next compaction erases the half written sector first. */
+	TEST_CHECK(true == config_store_set("baud", "38400"));
+	work_queue_run();
+	test_stats(&stats);
+	TEST_CHECK(stats.active == (before.active ^ 1U));
+	TEST_CHECK(stats.generation == before.generation + 1U);
+	TEST_CHECK(true == test_value_is("baud", "38400"));
+
+	/* The header of the new sector is programmed, the power is cut before
+	the old sector is erased.  Both sectors have a valid header after the
+	reset and the one with the higher generation is used. */
+	test_fill_until_compaction();
+	test_stats(&before);
+	flash_file_set_budget(( int32_t ) before.keys + 2);
+	work_queue_run();
+
+	TEST_CHECK(memcmp(flash_file_image(before.active), "CFG1", 4) == 0);
+	TEST_CHECK(memcmp(flash_file_image(before.active ^ 1U), "CFG1", 4) == 0);
+
+	test_reset();
+	test_stats(&stats);
+	TEST_CHECK(stats.active == (before.active ^ 1U));
+	TEST_CHECK(stats.generation == before.generation + 1U);
+	TEST_CHECK(stats.keys == before.keys);
+	TEST_CHECK(true == test_value_is("counter", test_counter));
+	TEST_CHECK(true == test_value_is("baud", "38400"));
+	TEST_CHECK(true == test_value_is("name", "F407 discovery"));
+
+	/* The old sector is erased by the background work. */
+	TEST_CHECK(true == config_store_set("baud", "57600"));
+	work_queue_run();
+	TEST_CHECK(memcmp(flash_file_image(before.active), "\xFF\xFF\xFF\xFF", 4) == 0);
+}
+
+static void test_generation_wrap(void)
+{
+	config_flash_t const *flash;
+	uint32_t header[ 4 ];
+	test_stats_t stats;
+
+	/* Sector 0 at the last generation, sector 1 one compaction later. */
+	flash_file_close();
+	unlink(TEST_IMAGE);
+	flash = flash_file_open(TEST_IMAGE, TEST_SECTOR_SIZE);
+
+	header[0] = 0x31474643UL;
+	header[1] = 0xFFFFFFFFUL;
+	header[2] = ~header[1];
+	header[3] = 0xFFFFFFFFUL;
+	TEST_CHECK(true == flash->program(0, 0, header, 4));
+	header[1] = 0;
+	header[2] = ~header[1];
+	TEST_CHECK(true == flash->program(1, 0, header, 4));
+
+	config_store_init(flash);
+	test_stats(&stats);
+	TEST_CHECK(stats.active == 1);
+	TEST_CHECK(stats.generation == 0);
+}
+
+int main(void)
+{
+	TEST_RUN(test_format);
+	TEST_RUN(test_set_get_delete_list);
+	TEST_RUN(test_max_keys);
+	TEST_RUN(test_torn_record);
+	TEST_RUN(test_compaction);
+	TEST_RUN(test_interrupted_compaction);
+	TEST_RUN(test_generation_wrap);
+
+	flash_file_close();
+	unlink(TEST_IMAGE);
+
+	return TEST_REPORT();
+}
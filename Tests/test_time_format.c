@@ -0,0 +1,440 @@
+/**
+  ******************************************************************************
+  * @file    test_time_format.c
+  * @brief   Host tests of the time formats.
+  *
+  *          The formatted text is compared with the one of strftime() on
+  *          gmtime() over 1970 - 2103, in several offsets from UTC, and
+  *          parsed back.  The calendar conversions of timekeeping.c are
+  *          linked in, its clock is not used.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "time_format.h"
+#include "test.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define TEST_US_PER_SECOND              1000000ULL
+
+/* The last second formatted, the local time must fit 32 bits. */
+#define TEST_LAST_SECOND                4200000000ULL
+
+static const int32_t test_offsets[] = { 0, 60, -60, 330, -330, 1439, -1439 };
+
+/* Seconds since 1970 of a UTC time. */
+static uint64_t test_epoch(int year, int month, int day, int hours, int minutes, int seconds)
+{
+	struct tm tm = { 0 };
+
+	tm.tm_year = year - 1900;
+	tm.tm_mon  = month - 1;
+	tm.tm_mday = day;
+	tm.tm_hour = hours;
+	tm.tm_min  = minutes;
+	tm.tm_sec  = seconds;
+
+	return (uint64_t)timegm(&tm);
+}
+
+/* The text of a pattern by strftime(), %f, %L, %s and %z are replaced
+first as strftime() has none of them or formats them differently. */
+static void test_reference(const char *pattern, int32_t tz_offset_min, uint64_t epoch_us, char *buffer, size_t length)
+{
+	char converted[ 128 ];
+	struct tm tm;
+	time_t local;
+	size_t n = 0;
+
+	for (; *pattern != '\0'; pattern++) {
+		if ((pattern[0] != '%') || (pattern[1] == '\0')) {
+			converted[n++] = *pattern;
+			continue;
+		}
+
+		pattern++;
+		switch (*pattern) {
+		case 'f':
+			n += sprintf(&converted[n], "%06lu", ( unsigned long ) (epoch_us % TEST_US_PER_SECOND));
+			break;
+		case 'L':
+			n += sprintf(&converted[n], "%03lu", ( unsigned long ) (epoch_us % TEST_US_PER_SECOND / 1000U));
+			break;
+		case 's':
+			n += sprintf(&converted[n], "%llu", ( unsigned long long ) (epoch_us / TEST_US_PER_SECOND));
+			break;
+		case 'z':
+			if (tz_offset_min == 0) {
+				converted[n++] = 'Z';
+			} else {
+				n += sprintf(&converted[n], "%c%02d:%02d", (tz_offset_min < 0) ? '-' : '+',
+					abs(tz_offset_min) / 60, abs(tz_offset_min) % 60);
+			}
+			break;
+		default:
+			converted[n++] = '%';
+			converted[n++] = *pattern;
+			break;
+		}
+	}
+	converted[n] = '\0';
+
+	local = (time_t)(epoch_us / TEST_US_PER_SECOND) + (time_t)tz_offset_min * 60;
+	gmtime_r(&local, &tm);
+	strftime(buffer, length, converted, &tm);
+}
+
+static bool test_parse(const char *pattern, int32_t tz_offset_min, const char *text, uint64_t base_us, uint64_t *epoch_us)
+{
+	time_format_t format;
+
+	if (true != time_format_compile(&format, pattern, tz_offset_min)) {
+		return false;
+	}
+
+	return time_format_parse_us(&format, text, strlen(text), base_us, epoch_us);
+}
+
+/* Formats and parses back one time, the parsed time is truncated to the
+resolution of the pattern. */
+static void test_round_trip_one(time_format_t *format, const char *pattern, int32_t tz_offset_min,
+								uint64_t epoch_us, uint64_t resolution_us)
+{
+	char text[ 64 ];
+	char reference[ 64 ];
+	uint64_t parsed;
+	size_t n;
+
+	n = time_format_us(format, epoch_us, text, sizeof(text));
+	test_reference(pattern, tz_offset_min, epoch_us, reference, sizeof(reference));
+
+	TEST_CHECK(n == strlen(text));
+	TEST_CHECK(n <= format->max_length);
+	if (strcmp(text, reference) != 0) {
+		printf("%s, offset %ld: %s, expected %s\n", pattern, ( long ) tz_offset_min, text, reference);
+		TEST_CHECK(strcmp(text, reference) == 0);
+		return;
+	}
+
+	TEST_CHECK(true == time_format_parse_us(format, text, n, 0, &parsed));
+	TEST_CHECK(parsed == epoch_us - epoch_us % resolution_us);
+}
+
+static void test_round_trip(void)
+{
+	static const struct {
+		const char *pattern;
+		uint64_t    resolution_us;
+	} patterns[] = {
+		{ TIME_FORMAT_ISO8601,                      1 },
+		{ TIME_FORMAT_EPOCH,                        1 },
+		{ "%s",                                     TEST_US_PER_SECOND },
+		{ "%Y%m%dT%H%M%S%z",                        TEST_US_PER_SECOND },
+		{ "%a %b %e %H:%M:%S.%L %Y %%",             1000 },
+		{ "%d.%m.%Y %H:%M:%S,%f",                   1 },
+	};
+	static const uint64_t boundaries[] = {
+		86400ULL,
+		946684799ULL,           /* 1999-12-31 23:59:59 */
+		946684800ULL,           /* 2000-01-01 */
+		951782400ULL,           /* 2000-02-29 */
+		951868800ULL,           /* 2000-03-01 */
+		1709164800ULL,          /* 2024-02-29 */
+		4102444799ULL,          /* 2099-12-31 23:59:59 */
+		4102444800ULL,          /* 2100-01-01 */
+		4107456000ULL,          /* 2100-02-28 */
+		4107542400ULL,          /* 2100-03-01 */
+		TEST_LAST_SECOND,
+	};
+	time_format_t format;
+	uint64_t seconds;
+	uint32_t p;
+	uint32_t o;
+	uint32_t b;
+
+	for (p = 0; p < sizeof(patterns) / sizeof(patterns[0]); p++) {
+		for (o = 0; o < sizeof(test_offsets) / sizeof(test_offsets[0]); o++) {
+			TEST_CHECK(true == time_format_compile(&format, patterns[p].pattern, test_offsets[o]));
+
+			/* A step that is not a whole number of days or hours. */
+			for (seconds = 86400ULL; seconds <= TEST_LAST_SECOND; seconds += 86400ULL * 37U + 3671U) {
+				test_round_trip_one(&format, patterns[p].pattern, test_offsets[o],
+					seconds * TEST_US_PER_SECOND + (seconds * 7919U) % TEST_US_PER_SECOND,
+					patterns[p].resolution_us);
+			}
+
+			for (b = 0; b < sizeof(boundaries) / sizeof(boundaries[0]); b++) {
+				test_round_trip_one(&format, patterns[p].pattern, test_offsets[o],
+					boundaries[b] * TEST_US_PER_SECOND, patterns[p].resolution_us);
+				test_round_trip_one(&format, patterns[p].pattern, test_offsets[o],
+					boundaries[b] * TEST_US_PER_SECOND - 1U, patterns[p].resolution_us);
+			}
+		}
+	}
+
+	/* Consecutive seconds across midnight use the cached date. */
+	TEST_CHECK(true == time_format_compile(&format, TIME_FORMAT_ISO8601, 330));
+	for (seconds = 951868800ULL - 20000U; seconds < 951868800ULL + 20000U; seconds += 7U) {
+		test_round_trip_one(&format, TIME_FORMAT_ISO8601, 330, seconds * TEST_US_PER_SECOND + 999999U, 1);
+	}
+}
+
+static void test_iso8601_offsets(void)
+{
+	time_format_t format;
+	timekeeping_calendar_t calendar = { 0 };
+	uint64_t utc = test_epoch(2026, 10, 18, 12, 34, 56) * TEST_US_PER_SECOND;
+	uint64_t epoch_us;
+	int32_t offset;
+	char text[ 64 ];
+
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-18T12:34:56Z", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-18T14:34:56.5+02:00", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc + 500000U);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-18T11:04:56,123-0130", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc + 123000U);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-19T12:33:56+23:59", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-17T12:35:56-23:59", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc);
+
+	/* The offset of the text wins over the one of the format. */
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 120, "2026-10-18T12:34:56Z", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc);
+
+	TEST_CHECK(true == time_format_compile(&format, TIME_FORMAT_ISO8601, 0));
+	TEST_CHECK(true == time_format_parse(&format, "2026-10-18T12:34:56-05:45", 25, &calendar, &offset));
+	TEST_CHECK(offset == -345);
+	TEST_CHECK((calendar.year == 2026) && (calendar.month == 10) && (calendar.day == 18));
+	TEST_CHECK((calendar.hours == 12) && (calendar.minutes == 34) && (calendar.seconds == 56));
+	TEST_CHECK(calendar.weekday == 7);
+
+	TEST_CHECK(true == time_format_compile(&format, TIME_FORMAT_ISO8601, -345));
+	TEST_CHECK(time_format_us(&format, utc, text, sizeof(text)) == 32);
+	TEST_CHECK(strcmp(text, "2026-10-18T06:49:56.000000-05:45") == 0);
+
+	TEST_CHECK(true != test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-18T12:34:56+24:00", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-18T12:34:56+02:60", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-18T12:34:56+2:00", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-18T12:34:56+02", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-18T12:34:56 02:00", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_ISO8601, 0, "2026-10-18T12:34:56z", 0, &epoch_us));
+
+	TEST_CHECK(true != time_format_compile(&format, TIME_FORMAT_ISO8601, 1440));
+	TEST_CHECK(true != time_format_compile(&format, TIME_FORMAT_ISO8601, -1440));
+}
+
+static void test_conversions(void)
+{
+	time_format_t format;
+	uint64_t utc = test_epoch(2025, 10, 5, 8, 7, 6) * TEST_US_PER_SECOND + 45678U;
+	uint64_t epoch_us;
+	char text[ 64 ];
+
+	/* %s is UTC in any offset. */
+	TEST_CHECK(true == time_format_compile(&format, "%s", 600));
+	TEST_CHECK(time_format_us(&format, utc, text, sizeof(text)) > 0);
+	TEST_CHECK(strcmp(text, "1759651626") == 0);
+	TEST_CHECK(true == test_parse("%s", 600, "1759651626", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc - 45678U);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_EPOCH, 0, "0", 0, &epoch_us));
+	TEST_CHECK(epoch_us == 0);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_EPOCH, 0, "4294967295.999999", 0, &epoch_us));
+	TEST_CHECK(epoch_us == 4294967296ULL * TEST_US_PER_SECOND - 1U);
+	TEST_CHECK(true != test_parse(TIME_FORMAT_EPOCH, 0, "4294967296", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_EPOCH, 0, "99999999999", 0, &epoch_us));
+
+	/* %L and %f, a shorter fraction is scaled, the decimals after the
+	sixth are dropped. */
+	TEST_CHECK(true == time_format_compile(&format, "%S.%L|%f", 0));
+	TEST_CHECK(time_format_us(&format, utc, text, sizeof(text)) > 0);
+	TEST_CHECK(strcmp(text, "06.045|045678") == 0);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_EPOCH, 0, "1759651626.5", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc - 45678U + 500000U);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_EPOCH, 0, "1759651626,045678", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_EPOCH, 0, "1759651626.0456789", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc);
+	TEST_CHECK(true == test_parse("%s.%L", 0, "1759651626.04", 0, &epoch_us));
+	TEST_CHECK(epoch_us == utc - 45678U + 40000U);
+	TEST_CHECK(true != test_parse("%s.%L", 0, "1759651626.0456", 0, &epoch_us));
+
+	/* %a and %b names, the weekday is not checked against the date. */
+	TEST_CHECK(true == time_format_compile(&format, "%a %b %e %Y", 0));
+	TEST_CHECK(time_format_us(&format, utc, text, sizeof(text)) > 0);
+	TEST_CHECK(strcmp(text, "Sun Oct  5 2025") == 0);
+	TEST_CHECK(true == test_parse("%a %b %e %Y", 0, "Sun Oct  5 2025", utc, &epoch_us));
+	TEST_CHECK(epoch_us == utc);
+	TEST_CHECK(true == test_parse("%a %b %e %Y", 0, "Mon Oct 05 2025", utc, &epoch_us));
+	TEST_CHECK(epoch_us == utc);
+	TEST_CHECK(true == test_parse("%b %e %Y", 0, "Dec 31 2025", utc, &epoch_us));
+	TEST_CHECK(epoch_us == test_epoch(2025, 12, 31, 8, 7, 6) * TEST_US_PER_SECOND + 45678U);
+	TEST_CHECK(true != test_parse("%a %b %e %Y", 0, "Sun oct  5 2025", utc, &epoch_us));
+	TEST_CHECK(true != test_parse("%a %b %e %Y", 0, "Xyz Oct  5 2025", utc, &epoch_us));
+	TEST_CHECK(true != test_parse("%b %e %Y", 0, "Oc 5 2025", utc, &epoch_us));
+
+	/* The fields that are not in the format are taken from the base. */
+	TEST_CHECK(true == test_parse(TIME_FORMAT_TIME, 0, "23:59:59", utc, &epoch_us));
+	TEST_CHECK(epoch_us == test_epoch(2025, 10, 5, 23, 59, 59) * TEST_US_PER_SECOND + 45678U);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_TIME, 60, "01:00:00", utc, &epoch_us));
+	TEST_CHECK(epoch_us == test_epoch(2025, 10, 5, 0, 0, 0) * TEST_US_PER_SECOND + 45678U);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_DATE, 0, "18/10/26", utc, &epoch_us));
+	TEST_CHECK(epoch_us == test_epoch(2026, 10, 18, 8, 7, 6) * TEST_US_PER_SECOND + 45678U);
+
+	TEST_CHECK(true == time_format_compile(&format, "100%% %H", 0));
+	TEST_CHECK(time_format_us(&format, utc, text, sizeof(text)) == 7);
+	TEST_CHECK(strcmp(text, "100% 08") == 0);
+
+	TEST_CHECK(true != time_format_compile(&format, "%Q", 0));
+	TEST_CHECK(true != time_format_compile(&format, "%", 0));
+	TEST_CHECK(true != time_format_compile(&format, "%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y%Y", 0));
+}
+
+static void test_leap_days(void)
+{
+	uint64_t epoch_us;
+	char text[ 64 ];
+	time_format_t format;
+
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 0, "2000-02-29T00:00:00Z", 0, &epoch_us));
+	TEST_CHECK(epoch_us == 951782400ULL * TEST_US_PER_SECOND);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 0, "2024-02-29T12:00:00Z", 0, &epoch_us));
+	TEST_CHECK(epoch_us == test_epoch(2024, 2, 29, 12, 0, 0) * TEST_US_PER_SECOND);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 0, "2096-02-29T00:00:00Z", 0, &epoch_us));
+
+	/* 2100 is not a leap year, 2000 is. */
+	TEST_CHECK(true != test_parse(TIME_FORMAT_ISO8601, 0, "2100-02-29T00:00:00Z", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_ISO8601, 0, "2026-02-29T00:00:00Z", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_ISO8601, 0, "2025-04-31T00:00:00Z", 0, &epoch_us));
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 0, "2100-02-28T23:59:59Z", 0, &epoch_us));
+	TEST_CHECK(epoch_us == 4107542399ULL * TEST_US_PER_SECOND);
+	TEST_CHECK(true == test_parse(TIME_FORMAT_ISO8601, 0, "2100-03-01T00:00:00Z", 0, &epoch_us));
+	TEST_CHECK(epoch_us == 4107542400ULL * TEST_US_PER_SECOND);
+
+	/* A day in a leap year that reaches the next one in the local time. */
+	TEST_CHECK(true == time_format_compile(&format, TIME_FORMAT_ISO8601, 60));
+	TEST_CHECK(time_format_us(&format, test_epoch(2000, 12, 31, 23, 30, 0) * TEST_US_PER_SECOND, text, sizeof(text)) > 0);
+	TEST_CHECK(strcmp(text, "2001-01-01T00:30:00.000000+01:00") == 0);
+	TEST_CHECK(time_format_us(&format, test_epoch(2099, 12, 31, 23, 0, 0) * TEST_US_PER_SECOND, text, sizeof(text)) > 0);
+	TEST_CHECK(strcmp(text, "2100-01-01T00:00:00.000000+01:00") == 0);
+	TEST_CHECK(time_format_us(&format, test_epoch(2000, 2, 28, 23, 0, 0) * TEST_US_PER_SECOND, text, sizeof(text)) > 0);
+	TEST_CHECK(strcmp(text, "2000-02-29T00:00:00.000000+01:00") == 0);
+	TEST_CHECK(time_format_us(&format, test_epoch(2100, 2, 28, 23, 0, 0) * TEST_US_PER_SECOND, text, sizeof(text)) > 0);
+	TEST_CHECK(strcmp(text, "2100-03-01T00:00:00.000000+01:00") == 0);
+}
+
+static void test_malformed(void)
+{
+	static const char * const texts[] = {
+		"",
+		"2026",
+		"2026-10-18",
+		"2026-10-18T12:34",
+		"2026-10-18T12:34:56",
+		"2026-10-18T12:34:56.",
+		"2026-10-18T12:34:56.5",
+		"2026-10-18T12:34:56+",
+		"2026-10-18T12:34:56+02:0",
+		"2026-10-18T12:34:56ZZ",
+		"2026-10-18T12:34:56Z ",
+		" 2026-10-18T12:34:56Z",
+		"2026/10/18T12:34:56Z",
+		"2026-1-18T12:34:56Z",
+		"2026-10-18 12:34:56Z",
+		"2026-10-18T12:34:5xZ",
+		"2026-13-18T12:34:56Z",
+		"2026-00-18T12:34:56Z",
+		"2026-10-00T12:34:56Z",
+		"2026-10-32T12:34:56Z",
+		"2026-10-18T24:00:00Z",
+		"2026-10-18T12:60:00Z",
+		"2026-10-18T12:34:60Z",
+		"1969-12-31T23:59:59Z",
+		"2026-10-18T12:34:56.abcZ",
+		"+026-10-18T12:34:56Z",
+	};
+	time_format_t format;
+	uint64_t epoch_us = 12345;
+	uint32_t i;
+
+	for (i = 0; i < sizeof(texts) / sizeof(texts[0]); i++) {
+		if (true == test_parse(TIME_FORMAT_ISO8601, 0, texts[i], 0, &epoch_us)) {
+			printf("accepted: \"%s\"\n", texts[i]);
+			TEST_CHECK(false);
+		}
+	}
+
+	TEST_CHECK(true != test_parse(TIME_FORMAT_TIME, 0, "1:00:00", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_TIME, 0, "01:00", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_DATE, 0, "32/10/26", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_DATE, 0, "29/02/26", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_EPOCH, 0, "", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_EPOCH, 0, "-1", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_EPOCH, 0, "12x", 0, &epoch_us));
+	TEST_CHECK(true != test_parse(TIME_FORMAT_EPOCH, 0, "12.", 0, &epoch_us));
+
+	/* Nothing is changed by a text that does not parse. */
+	TEST_CHECK(epoch_us == 12345);
+
+	/* The length is the end of the text, not the terminator. */
+	TEST_CHECK(true == time_format_compile(&format, TIME_FORMAT_ISO8601, 0));
+	TEST_CHECK(true != time_format_parse_us(&format, "2026-10-18T12:34:56Z", 19, 0, &epoch_us));
+	TEST_CHECK(true == time_format_parse_us(&format, "2026-10-18T12:34:56Zjunk", 20, 0, &epoch_us));
+	TEST_CHECK(epoch_us == test_epoch(2026, 10, 18, 12, 34, 56) * TEST_US_PER_SECOND);
+}
+
+static void test_buffer_too_small(void)
+{
+	time_format_t format;
+	char text[ 64 ];
+	uint64_t utc = test_epoch(2026, 10, 18, 12, 34, 56) * TEST_US_PER_SECOND;
+
+	/* The buffer must hold the longest text, "+hh:mm" rather than "Z". */
+	TEST_CHECK(true == time_format_compile(&format, TIME_FORMAT_ISO8601, 0));
+	TEST_CHECK(format.max_length == 32);
+
+	memset(text, 'x', sizeof(text));
+	TEST_CHECK(time_format_us(&format, utc, text, format.max_length) == 0);
+	TEST_CHECK(text[0] == '\0');
+	TEST_CHECK(text[1] == 'x');
+
+	TEST_CHECK(time_format_us(&format, utc, text, 1) == 0);
+	TEST_CHECK(text[0] == '\0');
+
+	text[0] = 'x';
+	TEST_CHECK(time_format_us(&format, utc, text, 0) == 0);
+	TEST_CHECK(text[0] == 'x');
+
+	memset(text, 'x', sizeof(text));
+	TEST_CHECK(time_format_us(&format, utc, text, format.max_length + 1U) == 27);
+	TEST_CHECK(strcmp(text, "2026-10-18T12:34:56.000000Z") == 0);
+
+	TEST_CHECK(true == time_format_compile(&format, TIME_FORMAT_ISO8601, 90));
+	TEST_CHECK(time_format_us(&format, utc, text, format.max_length + 1U) == 32);
+	TEST_CHECK(strcmp(text, "2026-10-18T14:04:56.000000+01:30") == 0);
+
+	/* %s takes up to 10 digits. */
+	TEST_CHECK(true == time_format_compile(&format, "%s", 0));
+	TEST_CHECK(format.max_length == 10);
+	TEST_CHECK(time_format_us(&format, 0, text, 11) == 1);
+	TEST_CHECK(strcmp(text, "0") == 0);
+	TEST_CHECK(time_format_us(&format, 0, text, 10) == 0);
+}
+
+int main(void)
+{
+	TEST_RUN(test_round_trip);
+	TEST_RUN(test_iso8601_offsets);
+	TEST_RUN(test_conversions);
+	TEST_RUN(test_leap_days);
+	TEST_RUN(test_malformed);
+	TEST_RUN(test_buffer_too_small);
+
+	return TEST_REPORT();
+}
@@ -0,0 +1,60 @@
+/**
+  ******************************************************************************
+  * @file    work_queue_stub.c
+  * @brief   Host stand-in of the work queue.  The submitted items are kept
+  *          in a list and run by work_queue_run(), so a test decides when
+  *          the background work is done.
+  ******************************************************************************
+  *
+  *
+  ******************************************************************************
+  */
+#include "work_queue.h"
+
+#include <stddef.h>
+
+static work_queue_item_t *work_queue_head;
+
+void work_queue_item_init(work_queue_item_t *item, work_queue_function_t function, void *arg, work_queue_level_t level)
+{
+	( void ) level;
+
+	item->next = NULL;
+	item->function = function;
+	item->arg = arg;
+	item->pending = false;
+}
+
+bool work_queue_submit(work_queue_item_t *item)
+{
+	if (true == item->pending) {
+		return false;
+	}
+
+	item->pending = true;
+	item->next = work_queue_head;
+	work_queue_head = item;
+
+	return true;
+}
+
+bool work_queue_is_pending(const work_queue_item_t *item)
+{
+	return item->pending;
+}
+
+unsigned work_queue_run(void)
+{
+	work_queue_item_t *item;
+	unsigned count = 0;
+
+	while (work_queue_head != NULL) {
+		item = work_queue_head;
+		work_queue_head = item->next;
+		item->pending = false;
+		item->function(item, item->arg);
+		count++;
+	}
+
+	return count;
+}
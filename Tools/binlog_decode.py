@@ -0,0 +1,232 @@
+#!/usr/bin/env python3
+"""Formats the messages of the deferred logger (Core/Src/binlog.c).
+
+The target sends every BINLOG() message COBS encoded and terminated by a zero
+byte, as 32 bit little endian words:
+
+    header    offset of the format string in .binlog_formats << 8
+              | number of arguments << 4
+    timestamp microseconds, wraps every ~71.6 minutes
+    arguments 0 to 4 raw words
+
+The format strings are read from the .binlog_formats section of the ELF file
+the target was programmed with, the strings %s points to from the loaded
+sections.
+
+Usage:
+    binlog_decode.py firmware.elf /dev/ttyUSB0 [--baud 921600]
+    binlog_decode.py firmware.elf capture.bin
+"""
+
+import argparse
+import re
+import struct
+import sys
+
+FORMATS_SECTION = '.binlog_formats'
+HEADER_DROPPED = 0xFFFFFF
+
+SHF_ALLOC = 0x2
+SHT_PROGBITS = 1
+SHT_SYMTAB = 2
+STT_FUNC = 2
+
+CONVERSION = re.compile(r'%([-+ #0]*)(\d*)(?:\.(\d+))?(hh|h|ll|l|z|j|t)?([diuxXocsp%])')
+
+
+class Elf:
+    """The sections of an ELF file, just what the decoder needs."""
+
+    def __init__(self, path):
+        with open(path, 'rb') as f:
+            self.data = f.read()
+
+        if self.data[:4] != b'\x7fELF':
+            raise ValueError('%s is not an ELF file' % path)
+
+        is64 = self.data[4] == 2
+        endian = '<' if self.data[5] == 1 else '>'
+        self.is64 = is64
+        self.endian = endian
+
+        if is64:
+            shoff, = struct.unpack_from(endian + 'Q', self.data, 0x28)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', self.data, 0x3A)
+            entry = endian + 'IIQQQQIIQQ'
+        else:
+            shoff, = struct.unpack_from(endian + 'I', self.data, 0x20)
+            shentsize, shnum, shstrndx = struct.unpack_from(endian + 'HHH', self.data, 0x2E)
+            entry = endian + 'IIIIIIIIII'
+
+        headers = [struct.unpack_from(entry, self.data, shoff + i * shentsize) for i in range(shnum)]
+        names = headers[shstrndx]
+
+        self.sections = []
+        for name, kind, flags, addr, offset, size, link, _, _, entsize in headers:
+            start = names[4] + name
+            self.sections.append({
+                'name': self.data[start:self.data.index(b'\0', start)].decode(),
+                'type': kind,
+                'flags': flags,
+                'addr': addr,
+                'data': self.data[offset:offset + size],
+                'link': link,
+                'entsize': entsize,
+            })
+
+    def section(self, name):
+        for section in self.sections:
+            if section['name'] == name:
+                return section
+        raise KeyError('no %s section, is the firmware built with binlog.c?' % name)
+
+    def functions(self):
+        """The functions of the symbol table as (address, size, name), sorted,
+        the Thumb bit cleared from the addresses."""
+        functions = []
+        for section in self.sections:
+            if section['type'] != SHT_SYMTAB:
+                continue
+            names = self.sections[section['link']]['data']
+            entry = self.endian + ('IBBHQQ' if self.is64 else 'IIIBBH')
+            for offset in range(0, len(section['data']), section['entsize']):
+                fields = struct.unpack_from(entry, section['data'], offset)
+                if self.is64:
+                    name, info, _, _, value, size = fields
+                else:
+                    name, value, size, info, _, _ = fields
+                if (info & 0xF) == STT_FUNC and value:
+                    end = names.index(b'\0', name)
+                    functions.append((value & ~1, size, names[name:end].decode(errors='replace')))
+        functions.sort()
+        return functions
+
+    def string_at(self, address):
+        """Reads a NUL terminated string from a section loaded to the target."""
+        for section in self.sections:
+            if ((section['flags'] & SHF_ALLOC) and (section['type'] == SHT_PROGBITS) and
+                    (section['addr'] <= address < section['addr'] + len(section['data']))):
+                data = section['data']
+                start = address - section['addr']
+                end = data.find(b'\0', start)
+                return data[start:end if end >= 0 else len(data)].decode(errors='replace')
+        return None
+
+
+def cobs_decode(frame):
+    out = bytearray()
+    i = 0
+    while i < len(frame):
+        code = frame[i]
+        if code == 0 or i + code > len(frame) + 1:
+            raise ValueError('bad COBS frame')
+        out += frame[i + 1:i + code]
+        i += code
+        if code < 0xFF and i < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def format_message(elf, fmt, args):
+    """Applies the C format string to the raw 32 bit arguments."""
+    args = list(args)
+
+    def convert(match):
+        flags, width, precision, _, conversion = match.groups()
+        if conversion == '%':
+            return '%'
+        if not args:
+            return '<missing>'
+        value = args.pop(0)
+        spec = '%' + flags + width + ('.' + precision if precision else '')
+        if conversion in 'di':
+            return (spec + 'd') % (value - (1 << 32) if value & 0x80000000 else value)
+        if conversion == 'u':
+            return (spec + 'd') % value
+        if conversion in 'xXo':
+            return (spec + conversion) % value
+        if conversion == 'c':
+            return (spec + 'c') % chr(value & 0xFF)
+        if conversion == 'p':
+            return (spec + 's') % ('0x%08x' % value)
+        text = elf.string_at(value)
+        return (spec + 's') % (text if text is not None else '<0x%08x>' % value)
+
+    return CONVERSION.sub(convert, fmt)
+
+
+def decode(elf, read, out):
+    formats = elf.section(FORMATS_SECTION)['data']
+    epoch = 0
+    last = None
+    buffered = bytearray()
+
+    while True:
+        chunk = read()
+        if not chunk:
+            break
+        buffered += chunk
+
+        while b'\0' in buffered:
+            frame, _, buffered = bytes(buffered).partition(b'\0')
+            buffered = bytearray(buffered)
+            if not frame:
+                continue
+
+            try:
+                message = cobs_decode(frame)
+                words = struct.unpack('<%dI' % (len(message) // 4), message)
+            except (ValueError, struct.error):
+                out.write('<garbled frame: %s>\n' % frame.hex())
+                continue
+
+            if len(words) < 2:
+                out.write('<short frame: %s>\n' % frame.hex())
+                continue
+
+            header, timestamp, args = words[0], words[1], words[2:]
+            offset = header >> 8
+
+            # Extend the 32 bit timestamp.
+            if last is not None and timestamp < last:
+                epoch += 1 << 32
+            last = timestamp
+            seconds = (epoch + timestamp) / 1e6
+
+            if offset == HEADER_DROPPED:
+                text = '<%u messages dropped>' % args[0]
+            elif offset < len(formats):
+                end = formats.find(b'\0', offset)
+                text = format_message(elf, formats[offset:end].decode(errors='replace'), args)
+            else:
+                text = '<unknown format 0x%06x, wrong ELF file?>' % offset
+
+            out.write('[%12.6f] %s\n' % (seconds, text))
+            out.flush()
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Formats the messages of the deferred logger.')
+    parser.add_argument('elf', help='ELF file the target was programmed with')
+    parser.add_argument('input', help='serial port or file with the captured output')
+    parser.add_argument('--baud', type=int, help='open the input as a serial port at this baud rate (needs pyserial)')
+    options = parser.parse_args()
+
+    elf = Elf(options.elf)
+
+    if options.baud:
+        import serial
+        port = serial.Serial(options.input, options.baud)
+        read = lambda: port.read(max(1, port.in_waiting))
+    else:
+        stream = open(options.input, 'rb', buffering=0)
+        read = lambda: stream.read(256)
+
+    try:
+        decode(elf, read, sys.stdout)
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == '__main__':
+    main()
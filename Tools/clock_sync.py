@@ -0,0 +1,75 @@
+#!/usr/bin/env python3
+"""Synchronizes the clock of the target (Core/Src/timekeeping.c) to the host.
+
+Sends "clock sync <seconds>.<microseconds>" on the console UART, with the
+time at which the target receives the end of the line: the time the line is
+written plus its transmission time.  The delay of a USB serial adapter is
+not known, it is a few milliseconds and varies, the target estimates the
+drift only from references some minutes apart for that reason.
+
+The first reference sets the clock, every later one gives the drift of the
+target since the previous one, keep the script running for a while.
+
+Usage:
+    clock_sync.py /dev/ttyUSB0
+    clock_sync.py /dev/ttyUSB0 --interval 600 --count 6
+
+Needs pyserial.
+"""
+
+import argparse
+import sys
+import time
+
+try:
+    import serial
+except ImportError:
+    sys.exit('clock_sync.py: pyserial is needed, pip install pyserial')
+
+
+def sync(port, baud_rate):
+    """Sends one reference and returns the answer of the target."""
+    port.reset_input_buffer()
+
+    # 10 bits a character, the reference is the time the '\n' arrives.
+    now = time.time()
+    line = 'clock sync %.6f\n' % now
+    now += len(line) * 10.0 / baud_rate
+    line = 'clock sync %.6f\n' % now
+
+    port.write(line.encode())
+    port.flush()
+
+    answer = b''
+    deadline = time.monotonic() + 2.0
+    while time.monotonic() < deadline:
+        answer += port.read(port.in_waiting or 1)
+        for text in answer.decode(errors='replace').splitlines(keepends=True):
+            if text.startswith(('Offset', 'Invalid')) and text.endswith('\n'):
+                return text.strip()
+
+    return 'no answer'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Synchronizes the clock of the target to the host.')
+    parser.add_argument('port', help='serial port of the console')
+    parser.add_argument('--baud', type=int, default=115200, help='baud rate of the console, 115200 by default')
+    parser.add_argument('--interval', type=float, default=300.0, help='seconds between the references, 300 by default')
+    parser.add_argument('--count', type=int, default=0, help='number of references, 0 to run until interrupted')
+    options = parser.parse_args()
+
+    with serial.Serial(options.port, options.baud, timeout=0.1) as port:
+        sent = 0
+        try:
+            while options.count == 0 or sent < options.count:
+                print('%s  %s' % (time.strftime('%H:%M:%S'), sync(port, options.baud)), flush=True)
+                sent += 1
+                if options.count == 0 or sent < options.count:
+                    time.sleep(options.interval)
+        except KeyboardInterrupt:
+            pass
+
+
+if __name__ == '__main__':
+    main()
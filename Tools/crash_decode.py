@@ -0,0 +1,245 @@
+#!/usr/bin/env python3
+"""Decodes the crash record of Core/Src/crash_dump.c.
+
+"crash-dump raw" prints the record as lines of hexadecimal 32 bit words:
+
+    0000: 43525348 00401006 00000001 ...
+
+The addresses in the record are resolved with the symbols of the ELF file the
+target was programmed with, the assertion file names and the deferred logger
+messages are read from it as Tools/binlog_decode.py does.  With
+arm-none-eabi-addr2line on the path the program counter and the link
+register are given with their source lines as well.
+
+Usage:
+    crash_decode.py firmware.elf capture.txt
+    crash_decode.py firmware.elf -          (paste the output, end with ^D)
+"""
+
+import argparse
+import bisect
+import re
+import shutil
+import struct
+import subprocess
+import sys
+
+from binlog_decode import Elf, FORMATS_SECTION, HEADER_DROPPED, format_message
+
+MAGIC = 0x43525348
+LINE = re.compile(r'^\s*([0-9a-fA-F]{4}):((?:\s+[0-9a-fA-F]{8})+)\s*$')
+
+REASONS = ['none', 'hard fault', 'memory management fault', 'bus fault', 'usage fault',
+           'assertion failed', 'stack overflow']
+
+CFSR_FLAGS = [
+    (0, 'IACCVIOL'), (1, 'DACCVIOL'), (3, 'MUNSTKERR'), (4, 'MSTKERR'), (5, 'MLSPERR'), (7, 'MMARVALID'),
+    (8, 'IBUSERR'), (9, 'PRECISERR'), (10, 'IMPRECISERR'), (11, 'UNSTKERR'), (12, 'STKERR'), (13, 'LSPERR'),
+    (15, 'BFARVALID'), (16, 'UNDEFINSTR'), (17, 'INVSTATE'), (18, 'INVPC'), (19, 'NOCP'),
+    (24, 'UNALIGNED'), (25, 'DIVBYZERO'),
+]
+HFSR_FLAGS = [(1, 'VECTTBL'), (30, 'FORCED'), (31, 'DEBUGEVT')]
+
+FRAME_NAMES = ['R0', 'R1', 'R2', 'R3', 'R12', 'LR', 'PC', 'xPSR']
+
+# Where the flash of the STM32F407 is, a stack word in it may be a return
+# address.
+FLASH_START = 0x08000000
+FLASH_END = 0x08100000
+
+
+def crc32_mpeg2(words):
+    """CRC-32/MPEG-2 over 32 bit words, what the STM32F4 CRC unit computes."""
+    crc = 0xFFFFFFFF
+    for word in words:
+        crc ^= word
+        for _ in range(32):
+            crc = ((crc << 1) ^ 0x04C11DB7) if crc & 0x80000000 else (crc << 1)
+            crc &= 0xFFFFFFFF
+    return crc
+
+
+def read_words(lines):
+    """Collects the words of the raw output, other lines are ignored."""
+    words = {}
+    for line in lines:
+        match = LINE.match(line)
+        if match:
+            offset = int(match.group(1), 16) // 4
+            for i, word in enumerate(match.group(2).split()):
+                words[offset + i] = int(word, 16)
+
+    if not words:
+        raise ValueError('no "crash-dump raw" output found')
+
+    count = max(words) + 1
+    missing = [i for i in range(count) if i not in words]
+    if missing:
+        raise ValueError('words missing from the output, first at offset 0x%04x' % (missing[0] * 4))
+
+    return [words[i] for i in range(count)]
+
+
+class Symbols:
+    def __init__(self, elf):
+        self.functions = elf.functions()
+        self.starts = [address for address, _, _ in self.functions]
+
+    def name(self, address):
+        """function+offset for an address in a function, None otherwise."""
+        address &= ~1
+        i = bisect.bisect_right(self.starts, address) - 1
+        if i < 0:
+            return None
+        start, size, name = self.functions[i]
+        if address >= start + max(size, 1):
+            return None
+        return '%s+0x%x' % (name, address - start)
+
+
+def parse(words):
+    """Splits the words into the fields of crash_dump_t."""
+    if words[0] != MAGIC:
+        raise ValueError('no crash record, magic 0x%08x' % words[0])
+
+    layout = words[1]
+    stack_max, log_max, message_words = layout >> 16, (layout >> 8) & 0xFF, layout & 0xFF
+    expected = 34 + stack_max + 1 + log_max * message_words + 1
+    if len(words) != expected:
+        raise ValueError('%d words, the layout 0x%08x needs %d' % (len(words), layout, expected))
+
+    crc = crc32_mpeg2(words[:-1])
+    if crc != words[-1]:
+        raise ValueError('CRC 0x%08x does not match 0x%08x' % (crc, words[-1]))
+
+    record = {
+        'reason': words[2],
+        'count': words[3],
+        'uptime_ms': words[4],
+        'frame': words[5:13],
+        'callee': words[13:21],
+        'sp': words[21],
+        'exc_return': words[22],
+        'cfsr': words[23],
+        'hfsr': words[24],
+        'mmfar': words[25],
+        'bfar': words[26],
+        'file': words[27],
+        'line': words[28],
+        'task': struct.pack('<4I', *words[29:33]).split(b'\0')[0].decode(errors='replace'),
+    }
+
+    stack_words = min(words[33], stack_max)
+    record['stack'] = words[34:34 + stack_words]
+
+    base = 34 + stack_max
+    log_messages = min(words[base], log_max)
+    record['log'] = [words[base + 1 + i * message_words:base + 1 + (i + 1) * message_words]
+                     for i in range(log_messages)]
+
+    return record
+
+
+def flags(value, names):
+    return ' '.join(name for bit, name in names if value & (1 << bit))
+
+
+def addr2line(elf_path, addresses):
+    tool = shutil.which('arm-none-eabi-addr2line')
+    if tool is None:
+        return {}
+    try:
+        output = subprocess.run([tool, '-e', elf_path, '-f', '-C'] + ['0x%x' % (a & ~1) for a in addresses],
+                                capture_output=True, text=True, check=True).stdout.splitlines()
+    except (OSError, subprocess.CalledProcessError):
+        return {}
+    return {address: output[2 * i + 1] for i, address in enumerate(addresses) if 2 * i + 1 < len(output)}
+
+
+def report(elf, elf_path, record, out):
+    symbols = Symbols(elf)
+
+    def describe(value):
+        name = symbols.name(value)
+        return '0x%08x %s' % (value, name) if name else '0x%08x' % value
+
+    reason = record['reason']
+    out.write('Crash %d: %s, task "%s", %d ms after the start\n' % (
+        record['count'], REASONS[reason] if reason < len(REASONS) else 'unknown %d' % reason,
+        record['task'], record['uptime_ms']))
+
+    if reason == 5:
+        name = elf.string_at(record['file'])
+        out.write('Assertion in %s, line %d\n' % (name if name else '0x%08x' % record['file'], record['line']))
+
+    frame = record['frame']
+    pc, lr = frame[6], frame[5]
+    lines = addr2line(elf_path, [pc, lr])
+
+    out.write('\n')
+    for name, value in zip(FRAME_NAMES, frame):
+        out.write('%-4s %s\n' % (name, describe(value) if name in ('PC', 'LR') else '0x%08x' % value))
+    for i, value in enumerate(record['callee']):
+        out.write('%-4s 0x%08x\n' % ('R%d' % (i + 4), value))
+    out.write('SP   0x%08x\nEXC_RETURN 0x%08x\n' % (record['sp'], record['exc_return']))
+    for name, value in (('PC', pc), ('LR', lr)):
+        if value in lines:
+            out.write('%s at %s\n' % (name, lines[value]))
+
+    out.write('\nCFSR  0x%08x %s\n' % (record['cfsr'], flags(record['cfsr'], CFSR_FLAGS)))
+    out.write('HFSR  0x%08x %s\n' % (record['hfsr'], flags(record['hfsr'], HFSR_FLAGS)))
+    if record['cfsr'] & (1 << 7):
+        out.write('MMFAR 0x%08x\n' % record['mmfar'])
+    if record['cfsr'] & (1 << 15):
+        out.write('BFAR  0x%08x\n' % record['bfar'])
+
+    # Words in the flash that resolve to a function are likely return
+    # addresses, they give a rough backtrace.
+    out.write('\nStack at 0x%08x, %d words:\n' % (record['sp'], len(record['stack'])))
+    for i, value in enumerate(record['stack']):
+        name = symbols.name(value) if (value & 1) and FLASH_START <= value < FLASH_END else None
+        out.write('  0x%08x: 0x%08x%s\n' % (record['sp'] + 4 * i, value, '  <- ' + name if name else ''))
+
+    try:
+        formats = elf.section(FORMATS_SECTION)['data']
+    except KeyError:
+        formats = None
+
+    out.write('\nLast %d log messages:\n' % len(record['log']))
+    for message in record['log']:
+        header, timestamp, args = message[0], message[1], message[2:2 + ((message[0] >> 4) & 0x07)]
+        offset = header >> 8
+        if offset == HEADER_DROPPED:
+            text = '<%u messages dropped>' % args[0]
+        elif formats is not None and offset < len(formats):
+            end = formats.find(b'\0', offset)
+            text = format_message(elf, formats[offset:end].decode(errors='replace'), args)
+        else:
+            text = '<unknown format 0x%06x, wrong ELF file?>' % offset
+        out.write('  [%12.6f] %s\n' % (timestamp / 1e6, text))
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Decodes the crash record printed by "crash-dump raw".')
+    parser.add_argument('elf', help='ELF file the target was programmed with')
+    parser.add_argument('input', help='file with the captured output, - for the standard input')
+    options = parser.parse_args()
+
+    elf = Elf(options.elf)
+
+    if options.input == '-':
+        lines = sys.stdin.readlines()
+    else:
+        with open(options.input, errors='replace') as f:
+            lines = f.readlines()
+
+    try:
+        record = parse(read_words(lines))
+    except ValueError as error:
+        sys.exit('crash_decode.py: %s' % error)
+
+    report(elf, options.elf, record, sys.stdout)
+
+
+if __name__ == '__main__':
+    main()
@@ -60,6 +60,19 @@ defined in linker script */
 Reset_Handler:  
   ldr   sp, =_estack     /* set stack pointer */
 
+/* Start the DWT cycle counter from zero, the boot profile (boot_profile.c)
+   measures the startup from here. */
+  ldr r0, =0xE000EDFC    /* CoreDebug->DEMCR */
+  ldr r1, [r0]
+  orr r1, r1, #0x01000000 /* TRCENA */
+  str r1, [r0]
+  ldr r0, =0xE0001000    /* DWT->CTRL */
+  movs r1, #0
+  str r1, [r0, #4]       /* DWT->CYCCNT */
+  ldr r1, [r0]
+  orr r1, r1, #1         /* CYCCNTENA */
+  str r1, [r0]
+
 /* Copy the data segment initializers from flash to SRAM */  
   ldr r0, =_sdata
   ldr r1, =_edata
@@ -76,6 +89,23 @@ LoopCopyDataInit:
   adds r4, r0, r3
   cmp r4, r1
   bcc CopyDataInit
+
+/* Copy the CCM RAM initializers from flash to CCM RAM */
+  ldr r0, =_sccmram
+  ldr r1, =_eccmram
+  ldr r2, =_siccmram
+  movs r3, #0
+  b LoopCopyCcmInit
+
+CopyCcmInit:
+  ldr r4, [r2, r3]
+  str r4, [r0, r3]
+  adds r3, r3, #4
+
+LoopCopyCcmInit:
+  adds r4, r0, r3
+  cmp r4, r1
+  bcc CopyCcmInit
   
 /* Zero fill the bss segment. */
   ldr r2, =_sbss